@@ -58,6 +58,7 @@ void
     c64->cpu.clearErrorState();
     c64->drive1.cpu.clearErrorState();
     c64->drive2.cpu.clearErrorState();
+    c64->driveThread.clearStop();
     c64->restartTimer();
     
     while (likely(success)) {
@@ -74,13 +75,20 @@ void
 // Class methods
 //
 
-C64::C64()
+C64::C64() : driveThread(this)
 {
     setDescription("C64");
     debug("Creating virtual C64[%p]\n", this);
 
     p = NULL;
     warp = false;
+    runAheadFrames = 0;
+    fastCpu = false;
+    runningAhead = false;
+    runningBatch = false;
+    runAheadState = NULL;
+    runAheadCapacity = 0;
+    resetRunAheadInfo();
     alwaysWarp = false;
     warpLoad = false;
     
@@ -100,6 +108,7 @@ C64::C64()
         &iec,
         &drive1,
         &drive2,
+        &virtualDrive,
         &datasette,
         &mouse1350,
         &mouse1351,
@@ -126,6 +135,10 @@ C64::C64()
     
     registerSnapshotItems(items, sizeof(items));
 
+    // Start with an empty event table
+    for (unsigned i = 0; i < EVENT_SLOT_COUNT; i++) eventCycle[i] = UINT64_MAX;
+    nextEvent = 0;
+    
     // Set initial hardware configuration
     mouse = &mouse1350;
     mousePort = 0;
@@ -133,8 +146,9 @@ C64::C64()
     drive1.powerOn();
     drive2.powerOff();
     
-    // Initialize mach timer info
-    mach_timebase_info(&timebase);
+    // Synchronize with the default system clock
+    hostClock = &systemClock;
+    resetPacingInfo();
 
     snapshotInterval = 3;
 
@@ -146,6 +160,8 @@ C64::~C64()
     debug(1, "Destroying virtual C64[%p]\n", this);
     
     halt();
+    driveThread.terminate();
+    delete [] runAheadState;
 }
 
 void
@@ -166,6 +182,7 @@ C64::reset()
     
     rasterCycle = 1;
     nanoTargetTime = 0UL;
+    updateEventTable();
     ping();
 }
 
@@ -271,102 +288,28 @@ C64::setModel(C64Model m)
 }
 
 void
-C64::updateVicFunctionTable()
+C64::updateExecutors()
 {
-    // Assign model independent execution functions
-    vicfunc[0] = NULL;
-    vicfunc[12] = &VIC::cycle12;
-    vicfunc[13] = &VIC::cycle13;
-    vicfunc[14] = &VIC::cycle14;
-    vicfunc[15] = &VIC::cycle15;
-    vicfunc[16] = &VIC::cycle16;
-    vicfunc[17] = &VIC::cycle17;
-    vicfunc[18] = &VIC::cycle18;
-    
-    for (unsigned cycle = 19; cycle <= 54; cycle++)
-        vicfunc[cycle] = &VIC::cycle19to54;
-
-    vicfunc[56] = &VIC::cycle56;
+    bool threaded = driveThread.isActive();
     
-    // Assign model specific execution functions
     switch (vic.getModel()) {
             
         case PAL_6569_R1:
         case PAL_6569_R3:
         case PAL_8565:
             
-            vicfunc[1] = &VIC::cycle1pal;
-            vicfunc[2] = &VIC::cycle2pal;
-            vicfunc[3] = &VIC::cycle3pal;
-            vicfunc[4] = &VIC::cycle4pal;
-            vicfunc[5] = &VIC::cycle5pal;
-            vicfunc[6] = &VIC::cycle6pal;
-            vicfunc[7] = &VIC::cycle7pal;
-            vicfunc[8] = &VIC::cycle8pal;
-            vicfunc[9] = &VIC::cycle9pal;
-            vicfunc[10] = &VIC::cycle10pal;
-            vicfunc[11] = &VIC::cycle11pal;
-            vicfunc[55] = &VIC::cycle55pal;
-            vicfunc[57] = &VIC::cycle57pal;
-            vicfunc[58] = &VIC::cycle58pal;
-            vicfunc[59] = &VIC::cycle59pal;
-            vicfunc[60] = &VIC::cycle60pal;
-            vicfunc[61] = &VIC::cycle61pal;
-            vicfunc[62] = &VIC::cycle62pal;
-            vicfunc[63] = &VIC::cycle63pal;
-            vicfunc[64] = NULL;
-            vicfunc[65] = NULL;
+            selectExecutors<VIC_FAMILY_PAL>(threaded);
             break;
             
         case NTSC_6567_R56A:
             
-            vicfunc[1] = &VIC::cycle1pal;
-            vicfunc[2] = &VIC::cycle2pal;
-            vicfunc[3] = &VIC::cycle3pal;
-            vicfunc[4] = &VIC::cycle4pal;
-            vicfunc[5] = &VIC::cycle5pal;
-            vicfunc[6] = &VIC::cycle6pal;
-            vicfunc[7] = &VIC::cycle7pal;
-            vicfunc[8] = &VIC::cycle8pal;
-            vicfunc[9] = &VIC::cycle9pal;
-            vicfunc[10] = &VIC::cycle10pal;
-            vicfunc[11] = &VIC::cycle11pal;
-            vicfunc[55] = &VIC::cycle55ntsc;
-            vicfunc[57] = &VIC::cycle57ntsc;
-            vicfunc[58] = &VIC::cycle58ntsc;
-            vicfunc[59] = &VIC::cycle59ntsc;
-            vicfunc[60] = &VIC::cycle60ntsc;
-            vicfunc[61] = &VIC::cycle61ntsc;
-            vicfunc[62] = &VIC::cycle62ntsc;
-            vicfunc[63] = &VIC::cycle63ntsc;
-            vicfunc[64] = &VIC::cycle64ntsc;
-            vicfunc[65] = NULL;
+            selectExecutors<VIC_FAMILY_NTSC_OLD>(threaded);
             break;
             
         case NTSC_6567:
         case NTSC_8562:
             
-            vicfunc[1] = &VIC::cycle1ntsc;
-            vicfunc[2] = &VIC::cycle2ntsc;
-            vicfunc[3] = &VIC::cycle3ntsc;
-            vicfunc[4] = &VIC::cycle4ntsc;
-            vicfunc[5] = &VIC::cycle5ntsc;
-            vicfunc[6] = &VIC::cycle6ntsc;
-            vicfunc[7] = &VIC::cycle7ntsc;
-            vicfunc[8] = &VIC::cycle8ntsc;
-            vicfunc[9] = &VIC::cycle9ntsc;
-            vicfunc[10] = &VIC::cycle10ntsc;
-            vicfunc[11] = &VIC::cycle11ntsc;
-            vicfunc[55] = &VIC::cycle55ntsc;
-            vicfunc[57] = &VIC::cycle57ntsc;
-            vicfunc[58] = &VIC::cycle58ntsc;
-            vicfunc[59] = &VIC::cycle59ntsc;
-            vicfunc[60] = &VIC::cycle60ntsc;
-            vicfunc[61] = &VIC::cycle61ntsc;
-            vicfunc[62] = &VIC::cycle62ntsc;
-            vicfunc[63] = &VIC::cycle63ntsc;
-            vicfunc[64] = &VIC::cycle64ntsc;
-            vicfunc[65] = &VIC::cycle65ntsc;
+            selectExecutors<VIC_FAMILY_NTSC>(threaded);
             break;
             
         default:
@@ -374,6 +317,24 @@ C64::updateVicFunctionTable()
     }
 }
 
+template <VICFamily family> void
+C64::selectExecutors(bool threaded)
+{
+    cycleExecutor = threaded ?
+    &C64::executeCycle<family, true> :
+    &C64::executeCycle<family, false>;
+    
+    if (fastCpu) {
+        lineExecutor = threaded ?
+        &C64::executeLineFast<family, true> :
+        &C64::executeLineFast<family, false>;
+    } else {
+        lineExecutor = threaded ?
+        &C64::executeLine<family, true> :
+        &C64::executeLine<family, false>;
+    }
+}
+
 void
 C64::powerUp()
 {
@@ -452,6 +413,7 @@ C64::step()
     cpu.clearErrorState();
     drive1.cpu.clearErrorState();
     drive2.cpu.clearErrorState();
+    driveThread.clearStop();
 
     // Wait until the execution of the next command has begun
     while (cpu.inFetchPhase()) executeOneCycle();
@@ -469,6 +431,7 @@ C64::stepOver()
     cpu.clearErrorState();
     drive1.cpu.clearErrorState();
     drive2.cpu.clearErrorState();
+    driveThread.clearStop();
     
     // If the next instruction is a JSR instruction, ...
     if (mem.spypeek(cpu.getPC()) == 0x20) {
@@ -484,15 +447,34 @@ C64::stepOver()
 
 bool
 C64::executeOneLine()
+{
+    bool result = _executeOneLine();
+    
+    synchronizeDrives();
+    return result;
+}
+
+bool
+C64::_executeOneLine()
 {
     if (rasterCycle == 1)
     beginRasterLine();
     
-    int lastCycle = vic.getCyclesPerRasterline();
+    return (this->*lineExecutor)();
+}
+
+template <VICFamily family, bool threadedDrives> bool
+C64::executeLine()
+{
+    const unsigned lastCycle =
+    family == VIC_FAMILY_PAL ? 63 : family == VIC_FAMILY_NTSC_OLD ? 64 : 65;
+    assert(lastCycle == vic.getCyclesPerRasterline());
+    
     for (unsigned i = rasterCycle; i <= lastCycle; i++) {
-        if (!_executeOneCycle()) {
+        if (!executeCycle<family, threadedDrives>()) {
             if (i == lastCycle)
             endRasterLine();
+            synchronizeDrives();
             return false;
         }
     }
@@ -500,11 +482,154 @@ C64::executeOneLine()
     return true;
 }
 
+template <VICFamily family, bool threadedDrives> bool
+C64::executeLineFast()
+{
+    const unsigned lastCycle =
+    family == VIC_FAMILY_PAL ? 63 : family == VIC_FAMILY_NTSC_OLD ? 64 : 65;
+    assert(lastCycle == vic.getCyclesPerRasterline());
+    
+    while (rasterCycle <= lastCycle) {
+        
+        bool result;
+        
+        // Run the next instruction in one go if it can't be told apart
+        if (rasterCycle + MAX_INSTRUCTION_CYCLES - 1 <= lastCycle &&
+            cpu.inFetchPhase() &&
+            cpu.rdyLine &&
+            !cpu.interruptPending() &&
+            mem.isPlainMemory(cpu.banksOfNextInstruction())) {
+            
+            result = executeInstructionFast<family, threadedDrives>();
+            
+        } else {
+            
+            result = executeCycle<family, threadedDrives>();
+        }
+        
+        if (!result) {
+            if (rasterCycle > lastCycle)
+            endRasterLine();
+            synchronizeDrives();
+            return false;
+        }
+    }
+    endRasterLine();
+    return true;
+}
+
+template <VICFamily family, bool threadedDrives> bool
+C64::executeInstructionFast()
+{
+    uint8_t result;
+    uint64_t start = cpu.cycle;
+    uint8_t flagI = cpu.getI();
+    
+    // Execute the instruction without looking at the other components
+    do {
+        cpu.cycle++;
+        result = cpu.executeOneCycle();
+    } while (result && !cpu.inFetchPhase());
+    
+    uint64_t end = cpu.cycle;
+    assert(end - start <= MAX_INSTRUCTION_CYCLES);
+    
+    // Let the other components catch up
+    for (uint64_t cycle = start + 1; cycle <= end; cycle++) {
+        
+        cpu.cycle = cycle;
+        executeVicCycle<family>(rasterCycle);
+        if (cycle >= nextEvent) executeEventsLow(cycle);
+        if (cycle >= nextEvent) result &= executeEventsHigh<threadedDrives>(cycle);
+        rasterCycle++;
+    }
+    
+    // Pick up interrupts that have been triggered during the catch-up phase
+    if (cpu.getI() == flagI) cpu.repollInterrupts();
+    
+    return result;
+}
+
 bool
 C64::executeOneFrame()
+{
+    if (runAheadFrames == 0) {
+        return _executeOneFrame();
+    }
+    
+    // Emulate the current frame without showing it
+    vic.discardFrame = true;
+    bool result = _executeOneFrame();
+    vic.discardFrame = false;
+    if (!result) return false;
+    
+    // Emulate some frames ahead and roll back
+    runAhead();
+    
+    // Count some sheep (zzzzzz) ...
+    if (!getWarp()) {
+        synchronizeTiming();
+    }
+    return true;
+}
+
+bool
+C64::executeFrames(uint64_t count)
+{
+    bool result = true;
+    
+    suspend();
+    runningBatch = true;
+    cpu.clearErrorState();
+    drive1.cpu.clearErrorState();
+    drive2.cpu.clearErrorState();
+    driveThread.clearStop();
+    
+    for (uint64_t i = 0; i < count && result; i++) {
+        result = _executeOneFrame();
+    }
+    
+    runningBatch = false;
+    resume();
+    return result;
+}
+
+bool
+C64::executeCycles(uint64_t count)
+{
+    bool result = true;
+    
+    suspend();
+    runningBatch = true;
+    cpu.clearErrorState();
+    drive1.cpu.clearErrorState();
+    drive2.cpu.clearErrorState();
+    driveThread.clearStop();
+    
+    while (count && result) {
+        
+        // Execute full rasterlines whenever possible
+        unsigned cycles = vic.getCyclesPerRasterline();
+        if (rasterCycle == 1 && count >= cycles) {
+            result = _executeOneLine();
+            count -= cycles;
+        } else {
+            result = executeOneCycle();
+            count--;
+        }
+    }
+    synchronizeDrives();
+    
+    runningBatch = false;
+    resume();
+    return result;
+}
+
+bool
+C64::_executeOneFrame()
 {
     do {
-        if (!executeOneLine())
+        if (!_executeOneLine())
         return false;
     } while (rasterLine != 0);
     return true;
@@ -520,11 +645,12 @@ C64::executeOneCycle()
     bool result = _executeOneCycle();
     if (isLastCycle) endRasterLine();
     
+    synchronizeDrives();
     return result;
 }
 
-bool
-C64::_executeOneCycle()
+template <VICFamily family, bool threadedDrives> bool
+C64::executeCycle()
 {
     uint8_t result = true;
     uint64_t cycle = ++cpu.cycle;
@@ -548,22 +674,171 @@ C64::_executeOneCycle()
     // '-------------------------------------|-------------------|--'
     
     // First clock phase (o2 low)
-    (vic.*vicfunc[rasterCycle])();
-    if (cycle >= cia1.wakeUpCycle) cia1.executeOneCycle(); else cia1.idleCounter++;
-    if (cycle >= cia2.wakeUpCycle) cia2.executeOneCycle(); else cia2.idleCounter++;
-    if (iec.isDirtyC64Side) iec.updateIecLinesC64Side();
+    executeVicCycle<family>(rasterCycle);
+    if (cycle >= nextEvent) executeEventsLow(cycle);
     
     // Second clock phase (o2 high)
     result &= cpu.executeOneCycle();
-    if (drive1.isPoweredOn()) result &= drive1.execute(durationOfOneCycle);
-    if (drive2.isPoweredOn()) result &= drive2.execute(durationOfOneCycle);
-    // if (iec.isDirtyDriveSide) iec.updateIecLinesDriveSide();
-    datasette.execute();
+    if (cycle >= nextEvent) result &= executeEventsHigh<threadedDrives>(cycle);
     
     rasterCycle++;
     return result;
 }
 
+template <VICFamily family> void
+C64::executeVicCycle(unsigned cycle)
+{
+    // The first and the last cycles of a rasterline are model specific
+    const bool palHead = family != VIC_FAMILY_NTSC;
+    const bool palTail = family == VIC_FAMILY_PAL;
+    
+    switch (cycle) {
+            
+        case 1: if (palHead) vic.cycle1pal(); else vic.cycle1ntsc(); break;
+        case 2: if (palHead) vic.cycle2pal(); else vic.cycle2ntsc(); break;
+        case 3: if (palHead) vic.cycle3pal(); else vic.cycle3ntsc(); break;
+        case 4: if (palHead) vic.cycle4pal(); else vic.cycle4ntsc(); break;
+        case 5: if (palHead) vic.cycle5pal(); else vic.cycle5ntsc(); break;
+        case 6: if (palHead) vic.cycle6pal(); else vic.cycle6ntsc(); break;
+        case 7: if (palHead) vic.cycle7pal(); else vic.cycle7ntsc(); break;
+        case 8: if (palHead) vic.cycle8pal(); else vic.cycle8ntsc(); break;
+        case 9: if (palHead) vic.cycle9pal(); else vic.cycle9ntsc(); break;
+        case 10: if (palHead) vic.cycle10pal(); else vic.cycle10ntsc(); break;
+        case 11: if (palHead) vic.cycle11pal(); else vic.cycle11ntsc(); break;
+        case 12: vic.cycle12(); break;
+        case 13: vic.cycle13(); break;
+        case 14: vic.cycle14(); break;
+        case 15: vic.cycle15(); break;
+        case 16: vic.cycle16(); break;
+        case 17: vic.cycle17(); break;
+        case 18: vic.cycle18(); break;
+        case 19: case 20: case 21: case 22: case 23: case 24:
+        case 25: case 26: case 27: case 28: case 29: case 30:
+        case 31: case 32: case 33: case 34: case 35: case 36:
+        case 37: case 38: case 39: case 40: case 41: case 42:
+        case 43: case 44: case 45: case 46: case 47: case 48:
+        case 49: case 50: case 51: case 52: case 53: case 54:
+            vic.cycle19to54(); break;
+        case 55: if (palTail) vic.cycle55pal(); else vic.cycle55ntsc(); break;
+        case 56: vic.cycle56(); break;
+        case 57: if (palTail) vic.cycle57pal(); else vic.cycle57ntsc(); break;
+        case 58: if (palTail) vic.cycle58pal(); else vic.cycle58ntsc(); break;
+        case 59: if (palTail) vic.cycle59pal(); else vic.cycle59ntsc(); break;
+        case 60: if (palTail) vic.cycle60pal(); else vic.cycle60ntsc(); break;
+        case 61: if (palTail) vic.cycle61pal(); else vic.cycle61ntsc(); break;
+        case 62: if (palTail) vic.cycle62pal(); else vic.cycle62ntsc(); break;
+        case 63: if (palTail) vic.cycle63pal(); else vic.cycle63ntsc(); break;
+        case 64: assert(family != VIC_FAMILY_PAL); vic.cycle64ntsc(); break;
+        case 65: assert(family == VIC_FAMILY_NTSC); vic.cycle65ntsc(); break;
+            
+        default:
+            assert(false);
+    }
+}
+
+void
+C64::executeEventsLow(uint64_t cycle)
+{
+    if (cycle >= eventCycle[CIA1_SLOT]) cia1.executeOneCycle();
+    if (cycle >= eventCycle[CIA2_SLOT]) cia2.executeOneCycle();
+    if (cycle >= eventCycle[IEC_SLOT]) iec.updateIecLinesC64Side();
+}
+
+template <bool threadedDrives> bool
+C64::executeEventsHigh(uint64_t cycle)
+{
+    bool result = true;
+    
+    if (threadedDrives) {
+        
+        // Let the drive thread catch up in the background
+        if (cycle >= MIN(eventCycle[DRIVE1_SLOT], eventCycle[DRIVE2_SLOT])) {
+            result &= driveThread.grant(cycle);
+        }
+        
+    } else {
+        
+        if (cycle >= eventCycle[DRIVE1_SLOT]) result &= executeDrive(&drive1, DRIVE1_SLOT, cycle);
+        if (cycle >= eventCycle[DRIVE2_SLOT]) result &= executeDrive(&drive2, DRIVE2_SLOT, cycle);
+    }
+    // if (iec.isDirtyDriveSide) iec.updateIecLinesDriveSide();
+    if (cycle >= eventCycle[DATASETTE_SLOT]) datasette.execute();
+    
+    // Determine when we need to look at the event table again
+    nextEvent = eventCycle[0];
+    for (unsigned i = 1; i < EVENT_SLOT_COUNT; i++) {
+        if (eventCycle[i] < nextEvent) nextEvent = eventCycle[i];
+    }
+    
+    return result;
+}
+
+bool
+C64::executeDrive(VC1541 *drive, EventSlot slot, uint64_t cycle)
+{
+    unsigned nr = slot - DRIVE1_SLOT;
+    
+    // Emulate all cycles since the drive has been executed the last time
+    uint64_t cycles = eventCycle[slot] ? cycle - driveIdleSince[nr] : 1;
+    bool result = drive->execute(cycles * durationOfOneCycle);
+    
+    // Postpone the next execution if the drive is trapped in an idle loop
+    uint64_t idleCycles = drive->idleCycles(durationOfOneCycle);
+    if (idleCycles > 1) {
+        eventCycle[slot] = cycle + idleCycles;
+        driveIdleSince[nr] = cycle;
+    } else {
+        eventCycle[slot] = 0;
+    }
+    
+    return result;
+}
+
+void
+C64::wakeUpDrive(VC1541 *drive, uint64_t cycle)
+{
+    if (!drive->isIdle()) return;
+    
+    EventSlot slot = (drive == &drive1) ? DRIVE1_SLOT : DRIVE2_SLOT;
+    unsigned nr = slot - DRIVE1_SLOT;
+    
+    // Make up for the postponed cycles
+    if (eventCycle[slot]) {
+        assert(!driveThread.isActive());
+        assert(cycle >= driveIdleSince[nr]);
+        drive->execute((cycle - driveIdleSince[nr]) * durationOfOneCycle);
+        scheduleEvent(slot, 0);
+    }
+    
+    drive->wakeUp();
+}
+
+void
+C64::synchronizeDrives()
+{
+    driveThread.synchronize(cpu.cycle);
+    wakeUpDrive(&drive1, cpu.cycle);
+    wakeUpDrive(&drive2, cpu.cycle);
+}
+
+void
+C64::updateEventTable()
+{
+    eventCycle[CIA1_SLOT] = cia1.wakeUpCycle;
+    eventCycle[CIA2_SLOT] = cia2.wakeUpCycle;
+    eventCycle[IEC_SLOT] = iec.isDirtyC64Side ? 0 : UINT64_MAX;
+    eventCycle[DRIVE1_SLOT] = drive1.isPoweredOn() ? 0 : UINT64_MAX;
+    eventCycle[DRIVE2_SLOT] = drive2.isPoweredOn() ? 0 : UINT64_MAX;
+    eventCycle[DATASETTE_SLOT] =
+    (datasette.getPlayKey() && datasette.getMotor()) ? 0 : UINT64_MAX;
+    
+    // Force the main loop to process the table in the next cycle
+    nextEvent = 0;
+    
+    // The cycle counter might have changed
+    if (driveThread.isActive()) driveThread.rebase(cpu.cycle);
+}
+
 void
 C64::beginRasterLine()
 {
@@ -585,11 +860,20 @@ C64::endRasterLine()
         rasterLine = 0;
         endFrame();
     }
+    
+    // Apply the freeze list before the selected rasterline is drawn
+    if (rasterLine == mem.getFreezeLine() ||
+        (rasterLine == 0 && mem.getFreezeLine() >= vic.getRasterlinesPerFrame())) {
+        mem.applyFreezes();
+    }
 }
 
 void
 C64::endFrame()
 {
+    // Wait for the drives
+    synchronizeDrives();
+    
     frame++;
     vic.endFrame();
     
@@ -609,6 +893,11 @@ C64::endFrame()
     // Update mouse coordinates
     if (mousePort != 0) mouse->execute();
     
+    // Frames emulated ahead or in batch mode are not synchronized
+    if (runningAhead || runningBatch) {
+        return;
+    }
+    
     // Take a snapshot once in a while
     if (snapshotInterval > 0 &&
         frame % ((unsigned)(vic.getFramesPerSecond() * snapshotInterval)) == 0) {
@@ -616,11 +905,124 @@ C64::endFrame()
     }
     
     // Count some sheep (zzzzzz) ...
-    if (!getWarp()) {
+    // In run-ahead mode, this is done in executeOneFrame()
+    if (runAheadFrames == 0 && !getWarp()) {
             synchronizeTiming();
     }
 }
 
+void
+C64::setRunAheadFrames(unsigned frames)
+{
+    if (frames > MAX_RUN_AHEAD_FRAMES) {
+        warn("Run-ahead is limited to %d frames.\n", MAX_RUN_AHEAD_FRAMES);
+        frames = MAX_RUN_AHEAD_FRAMES;
+    }
+    
+    suspend();
+    runAheadFrames = frames;
+    resetRunAheadInfo();
+    resume();
+}
+
+RunAheadInfo
+C64::getRunAheadInfo()
+{
+    RunAheadInfo info;
+    
+    info.frames = runAheadPasses;
+    info.lastCost = lastRunAheadCost;
+    info.maxCost = maxRunAheadCost;
+    info.avgCost = runAheadPasses ? runAheadCostSum / runAheadPasses : 0.0;
+    
+    return info;
+}
+
+void
+C64::resetRunAheadInfo()
+{
+    runAheadPasses = 0;
+    lastRunAheadCost = 0;
+    maxRunAheadCost = 0;
+    runAheadCostSum = 0.0;
+}
+
+void
+C64::runAhead()
+{
+    uint64_t start = hostClock->now();
+    
+    saveRunAheadState();
+    runningAhead = true;
+    
+    // Emulate all frames ahead and show the last one only
+    for (unsigned i = 1; i <= runAheadFrames; i++) {
+        vic.discardFrame = (i != runAheadFrames);
+        if (!_executeOneFrame()) break;
+    }
+    vic.discardFrame = false;
+    
+    // Roll back
+    restoreRunAheadState();
+    runningAhead = false;
+    
+    // Measure costs
+    uint64_t cost = (hostClock->now() - start) / 1000;
+    lastRunAheadCost = cost;
+    if (cost > maxRunAheadCost) maxRunAheadCost = cost;
+    runAheadCostSum += (double)cost;
+    runAheadPasses++;
+}
+
+void
+C64::saveRunAheadState()
+{
+    size_t size = stateSize();
+    
+    // Grow buffer if needed
+    if (size > runAheadCapacity) {
+        delete [] runAheadState;
+        runAheadState = new uint8_t[size];
+        runAheadCapacity = size;
+    }
+    
+    uint8_t *ptr = runAheadState;
+    saveToBuffer(&ptr);
+    
+    // Save the dirty page bitmaps (they are not part of the snapshot)
+    mem.getDirtyPages(runAheadDirtyPages[0]);
+    drive1.mem.getDirtyPages(runAheadDirtyPages[1]);
+    drive2.mem.getDirtyPages(runAheadDirtyPages[2]);
+    runAheadDirtyColorPages = mem.getDirtyColorPages();
+}
+
+void
+C64::restoreRunAheadState()
+{
+    uint8_t live[64];
+    uint8_t *ptr;
+    
+    // The keyboard might have been used while we were running ahead. Hence,
+    // we preserve the current keyboard state.
+    assert(keyboard.stateSize() <= sizeof(live));
+    ptr = live;
+    keyboard.saveToBuffer(&ptr);
+    
+    ptr = runAheadState;
+    loadFromBuffer(&ptr);
+    updateEventTable();
+    
+    // Loading the state has marked all pages dirty. As the RAM contents are
+    // the ones of the saved state, the saved dirty page bitmaps still apply.
+    mem.setDirtyPages(runAheadDirtyPages[0]);
+    drive1.mem.setDirtyPages(runAheadDirtyPages[1]);
+    drive2.mem.setDirtyPages(runAheadDirtyPages[2]);
+    mem.setDirtyColorPages(runAheadDirtyColorPages);
+    
+    ptr = live;
+    keyboard.loadFromBuffer(&ptr);
+}
+
 void
 C64::setMouseModel(MouseModel value)
 {
@@ -734,21 +1136,69 @@ C64::setWarpLoad(bool b)
 }
 
 void
-C64::restartTimer()
+C64::setThreadedDrives(bool value)
+{
+    suspend();
+    if (value) driveThread.launch(); else driveThread.terminate();
+    updateExecutors();
+    resume();
+}
+
+void
+C64::setFastCpu(bool value)
 {
-    uint64_t kernelNow = mach_absolute_time();
-    uint64_t nanoNow = abs_to_nanos(kernelNow);
+    suspend();
+    fastCpu = value;
+    updateExecutors();
+    resume();
+}
+
+void
+C64::setHostClock(HostClock *clock)
+{
+    suspend();
+    hostClock = clock ? clock : &systemClock;
+    restartTimer();
+    resume();
+}
+
+PacingInfo
+C64::getPacingInfo()
+{
+    PacingInfo info;
+    
+    info.frames = pacedFrames;
+    info.restarts = timerRestarts;
+    info.minJitter = pacedFrames ? minJitter : 0;
+    info.maxJitter = pacedFrames ? maxJitter : 0;
+    info.avgJitter = pacedFrames ? jitterSum / pacedFrames : 0.0;
+    info.rmsJitter = pacedFrames ? sqrt(jitterSquareSum / pacedFrames) : 0.0;
     
-    nanoTargetTime = nanoNow + vic.getFrameDelay();
+    return info;
+}
+
+void
+C64::resetPacingInfo()
+{
+    pacedFrames = 0;
+    timerRestarts = 0;
+    minJitter = INT64_MAX;
+    maxJitter = INT64_MIN;
+    jitterSum = 0.0;
+    jitterSquareSum = 0.0;
+}
+
+void
+C64::restartTimer()
+{
+    nanoTargetTime = hostClock->now() + vic.getFrameDelay();
 }
 
 void
 C64::synchronizeTiming()
 {
-    const uint64_t earlyWakeup = 1500000; /* 1.5 milliseconds */
-    
     // Get current time in nano seconds
-    uint64_t nanoAbsTime = abs_to_nanos(mach_absolute_time());
+    uint64_t nanoAbsTime = hostClock->now();
     
     // Check how long we're supposed to sleep
     int64_t timediff = (int64_t)nanoTargetTime - (int64_t)nanoAbsTime;
@@ -759,16 +1209,20 @@ C64::synchronizeTiming()
         
         debug(2, "Emulator lost synchronization (%lld). Restarting timer.\n", timediff);
         restartTimer();
+        timerRestarts++;
     }
     
-    // Convert nanoTargetTime into kernel unit
-    int64_t kernelTargetTime = nanos_to_abs(nanoTargetTime);
-    
     // Sleep and update target timer
-    // debug(2, "%p Sleeping for %lld\n", this, kernelTargetTime - mach_absolute_time());
-    int64_t jitter = sleepUntil(kernelTargetTime, earlyWakeup);
+    int64_t jitter = hostClock->sleepUntil(nanoTargetTime);
     nanoTargetTime += vic.getFrameDelay();
     
+    // Record jitter
+    pacedFrames++;
+    if (jitter < minJitter) minJitter = jitter;
+    if (jitter > maxJitter) maxJitter = jitter;
+    jitterSum += (double)jitter;
+    jitterSquareSum += (double)jitter * (double)jitter;
+    
     // debug(2, "Jitter = %d", jitter);
     if (jitter > 1000000000 /* 1 sec */) {
         
@@ -777,6 +1231,7 @@ C64::synchronizeTiming()
         
         debug(2, "Jitter exceeds limit (%lld). Restarting synchronization timer.\n", jitter);
         restartTimer();
+        timerRestarts++;
     }
 }
 
@@ -786,6 +1241,7 @@ void C64::loadFromSnapshotUnsafe(Snapshot *snapshot)
     
     if (snapshot && (ptr = snapshot->getData())) {
         loadFromBuffer(&ptr);
+        updateEventTable();
         keyboard.releaseAll(); // Avoid constantly pressed keys
         ping();
     }
@@ -861,19 +1317,24 @@ C64::flash(AnyC64File *file)
         
         case BASIC_ROM_FILE:
         file->flash(mem.rom, 0xA000);
+        mem.markAllModified();
         break;
         
         case CHAR_ROM_FILE:
         file->flash(mem.rom, 0xD000);
+        mem.markAllModified();
         break;
         
         case KERNAL_ROM_FILE:
         file->flash(mem.rom, 0xE000);
+        mem.markAllModified();
         break;
         
         case VC1541_ROM_FILE:
         file->flash(drive1.mem.rom);
         file->flash(drive2.mem.rom);
+        drive1.mem.markAllModified();
+        drive2.mem.markAllModified();
         break;
         
         case V64_FILE:
@@ -902,6 +1363,8 @@ C64::flash(AnyArchive *file, unsigned item)
         case P00_FILE:
         file->selectItem(item);
         file->flashItem(mem.ram);
+        mem.markAllModified();
+        mem.markAllDirty();
         break;
         
         default:
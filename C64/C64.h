@@ -30,6 +30,7 @@
 
 // General
 #include "MessageQueue.h"
+#include "HostClock.h"
 
 // Loading and saving
 #include "Snapshot.h"
@@ -64,6 +65,8 @@
 
 // Peripherals
 #include "Drive.h"
+#include "DriveThread.h"
+#include "VirtualDrive.h"
 #include "Datasette.h"
 #include "Mouse1350.h"
 #include "Mouse1351.h"
@@ -128,6 +131,17 @@ class C64 : public VirtualComponent {
     //! @brief    A second VC1541 floppy drive (with device number 9)
     VC1541 drive2 = VC1541(2);
     
+    /*! @brief    Host thread emulating the drives
+     *  @details  Only used if threaded drive emulation is enabled.
+     *  @see      setThreadedDrives()
+     */
+    DriveThread driveThread;
+    
+    /*! @brief    High-level drive serving Kernal LOAD and SAVE requests
+     *  @details  Only active if an archive has been mounted.
+     */
+    VirtualDrive virtualDrive;
+    
     //! @brief    A Commodore 1530 (C2N) Datasette
     Datasette datasette;
     
@@ -187,13 +201,53 @@ class C64 : public VirtualComponent {
      */
     uint64_t durationOfOneCycle;
     
-    //! @brief    VICII function table.
-    /*! @details  Stores a pointer to the VICII method that is executed
-     *            in a certain rasterline cycle.
-     *  @note     vicfunc[0] is a stub. It is never called, because the first
-     *            rasterline cycle is numbered 1.
+    /*! @brief    Executes a single cycle.
+     *  @details  Points to a specialization of executeCycle() that matches the
+     *            current machine configuration.
+     *  @see      updateExecutors()
+     */
+    bool (C64::*cycleExecutor)();
+    
+    /*! @brief    Executes the remaining cycles of the current rasterline.
+     *  @details  Points to a specialization of executeLineFast() or
+     *            executeLine() that matches the current machine configuration.
+     *  @see      updateExecutors()
+     */
+    bool (C64::*lineExecutor)();
+    
+    /*! @brief    Indicates if the CPU executes whole instructions at once.
+     *  @see      setFastCpu()
      */
-    void (VIC::*vicfunc[66])(void);
+    bool fastCpu;
+    
+    
+    //
+    // Event scheduling
+    //
+    
+    /*! @brief    Event table
+     *  @details  Each slot stores the cycle in which the associated component
+     *            needs to be executed next. Slots of idle components store
+     *            UINT64_MAX. The table is not part of a snapshot, because it
+     *            can be rebuilt from the component states at any time.
+     *  @see      updateEventTable()
+     */
+    uint64_t eventCycle[EVENT_SLOT_COUNT];
+    
+    /*! @brief    Cycle in which an idle drive has been executed the last time
+     *  @details  If a drive is trapped in an idle loop, its event is postponed.
+     *            All missed cycles are emulated in a single chunk afterwards.
+     */
+    uint64_t driveIdleSince[2];
+    
+    /*! @brief    Cycle of the earliest scheduled event
+     *  @details  As long as the current cycle is smaller than this value,
+     *            the main loop only executes the VICII and the CPU.
+     *  @note     The value may be smaller than the minimum of the event table
+     *            (e.g., after an event has been canceled). This is harmless.
+     *            It is recomputed each time the event table is processed.
+     */
+    uint64_t nextEvent;
     
     
     //
@@ -211,11 +265,14 @@ class C64 : public VirtualComponent {
     
     private:
     
-    /*! @brief    System timer information
+    //! @brief    Default clock of the host computer
+    SystemClock systemClock;
+    
+    /*! @brief    Clock used for synchronizing the emulation with real time
      *  @details  Used to put the emulation thread to sleep for the proper
-     *            amount of time.
+     *            amount of time. Points to systemClock by default.
      */
-    mach_timebase_info_data_t timebase;
+    HostClock *hostClock;
     
     /*! @brief    Wake-up time of the synchronization timer in nanoseconds
      *  @details  This value is recomputed each time the emulator thread is
@@ -223,6 +280,18 @@ class C64 : public VirtualComponent {
      */
     uint64_t nanoTargetTime;
     
+    //! @brief    Number of frames that have been synchronized
+    uint64_t pacedFrames;
+    
+    //! @brief    Number of synchronization timer restarts
+    uint64_t timerRestarts;
+    
+    //! @brief    Smallest and largest measured jitter in nanoseconds
+    int64_t minJitter, maxJitter;
+    
+    //! @brief    Accumulated jitter values (used to compute mean and RMS)
+    double jitterSum, jitterSquareSum;
+    
     /*! @brief    Indicates if c64 is currently running at maximum speed
      *            (with timing synchronization disabled)
      */
@@ -237,6 +306,52 @@ class C64 : public VirtualComponent {
     bool warpLoad;
     
     
+    //
+    // Run-ahead
+    //
+    
+    /*! @brief    Number of frames emulated ahead of time
+     *  @details  A value of 0 disables run-ahead mode.
+     */
+    unsigned runAheadFrames;
+    
+    //! @brief    Indicates that the emulator is currently running ahead
+    bool runningAhead;
+    
+    //! @brief    Indicates that the emulator is executing a batch job
+    bool runningBatch;
+    
+    /*! @brief    Emulator state saved before running ahead
+     *  @details  The buffer is reused in each frame. It is only reallocated
+     *            if the size of the emulator state grows, e.g., when a tape
+     *            or a cartridge has been inserted.
+     */
+    uint8_t *runAheadState;
+    
+    //! @brief    Capacity of runAheadState in bytes
+    size_t runAheadCapacity;
+    
+    /*! @brief    Dirty page bitmaps saved before running ahead
+     *  @details  Rolling back restores the RAM contents of the saved state.
+     *            Hence, the bitmaps of the saved state remain valid and are
+     *            put back instead of marking all pages dirty. The entries
+     *            refer to the C64 memory and to the memories of both drives.
+     */
+    uint64_t runAheadDirtyPages[3][4];
+    
+    //! @brief    Dirty page bitmap of the color RAM saved before running ahead
+    uint8_t runAheadDirtyColorPages;
+    
+    //! @brief    Number of measured run-ahead passes
+    uint64_t runAheadPasses;
+    
+    //! @brief    Costs of the latest and the most expensive run-ahead pass
+    uint64_t lastRunAheadCost, maxRunAheadCost;
+    
+    //! @brief    Accumulated run-ahead costs (used to compute the mean)
+    double runAheadCostSum;
+    
+    
     //
     // Operation modes
     //
@@ -328,10 +443,42 @@ class C64 : public VirtualComponent {
      */
     void setModel(C64Model m);
     
-    //! @brief    Updates the VIC function table
-    /*! @details  This function is invoked by VIC::setModel(), only.
+    /*! @brief    Selects the cycle and line executors
+     *  @details  This function is invoked whenever the VICII model or the
+     *            drive threading mode changes.
      */
-    void updateVicFunctionTable();
+    void updateExecutors();
+    
+    //! @brief    Selects the executors for a VICII model family
+    template <VICFamily family> void selectExecutors(bool threaded);
+    
+    //! @brief    Returns true if the drives are emulated on a separate thread.
+    bool getThreadedDrives() { return driveThread.isActive(); }
+    
+    /*! @brief    Enables or disables threaded drive emulation.
+     *  @details  In threaded mode, both VC1541 drives are emulated on a
+     *            separate host thread running in parallel with the C64. The
+     *            two sides synchronize when the C64 looks at the serial bus
+     *            and at the end of each frame. The emulation result is the
+     *            same as in single-threaded mode.
+     */
+    void setThreadedDrives(bool value);
+    
+    //! @brief    Returns true if the fast CPU mode is enabled.
+    bool getFastCpu() { return fastCpu; }
+    
+    /*! @brief    Enables or disables the fast CPU mode.
+     *  @details  In fast mode, the CPU executes whole instructions at once
+     *            and the other components catch up afterwards. Instructions
+     *            accessing I/O space or cartridge memory and interrupt
+     *            sequences are still executed cycle by cycle. The mode speeds
+     *            up Basic and compute-heavy programs, but it is not cycle
+     *            exact: The VICII may see RAM writes a few cycles early, a
+     *            bad line may stop the CPU one instruction late, and
+     *            interrupts may be recognized one instruction late. Hence,
+     *            the mode is disabled by default.
+     */
+    void setFastCpu(bool value);
     
     
     //
@@ -351,8 +498,12 @@ class C64 : public VirtualComponent {
     //! @brief    Gets a notification message from message queue
     Message getMessage() { return queue.getMessage(); }
     
-    //! @brief    Feeds a notification message into message queue
-    void putMessage(MessageType msg, uint64_t data = 0) { queue.putMessage(msg, data); }
+    /*! @brief    Feeds a notification message into message queue
+     *  @note     Messages are discarded while the emulator is running ahead.
+     */
+    void putMessage(MessageType msg, uint64_t data = 0) {
+        if (!runningAhead && !runningBatch) queue.putMessage(msg, data);
+    }
     
     
     //
@@ -423,13 +574,84 @@ class C64 : public VirtualComponent {
      */
     bool executeOneFrame();
     
+    /*! @brief    Executes a certain number of frames as fast as possible.
+     *  @details  The frames are executed back to back in the calling thread.
+     *            Timing synchronization, warp mode handling, auto snapshots,
+     *            audio output, and GUI messages are skipped. If the emulator
+     *            thread is running, it is suspended in the meantime. The first
+     *            frame ends at the next frame boundary, i.e., it may be
+     *            shorter than a full frame. Run-ahead mode is not applied.
+     *  @return   false, if execution has been stopped by a breakpoint.
+     */
+    bool executeFrames(uint64_t count);
+    
+    /*! @brief    Executes a certain number of CPU cycles as fast as possible.
+     *  @details  Works like executeFrames(), but counts CPU cycles.
+     *  @return   false, if execution has been stopped by a breakpoint.
+     */
+    bool executeCycles(uint64_t count);
+    
+    //! @brief    Returns true if the emulator is executing a batch job.
+    bool isRunningBatch() { return runningBatch; }
+    
     private:
     
+    //! @brief    Work horse for executeOneFrame()
+    bool _executeOneFrame();
+    
+    //! @brief    Work horse for executeOneLine()
+    bool _executeOneLine();
+    
     //! @brief    Executes a single CPU cycle
     bool executeOneCycle();
     
     //! @brief    Work horse for executeOneCycle()
-    bool _executeOneCycle();
+    bool _executeOneCycle() { return (this->*cycleExecutor)(); }
+    
+    /*! @brief    Executes a single cycle
+     *  @details  The function is specialized for each VICII model family and
+     *            for both drive threading modes. Hence, the VICII cycle
+     *            functions are called directly instead of through a function
+     *            table and the event code needs no runtime checks.
+     */
+    template <VICFamily family, bool threadedDrives> bool executeCycle();
+    
+    //! @brief    Executes the remaining cycles of the current rasterline
+    template <VICFamily family, bool threadedDrives> bool executeLine();
+    
+    /*! @brief    Executes the remaining cycles of the current rasterline
+     *  @details  Used in fast CPU mode. Runs executeInstructionFast() for all
+     *            instructions that can't be distinguished from a cycle exact
+     *            execution by their memory accesses and falls back to
+     *            executeCycle() otherwise.
+     *  @see      setFastCpu()
+     */
+    template <VICFamily family, bool threadedDrives> bool executeLineFast();
+    
+    /*! @brief    Executes a single CPU instruction in one go
+     *  @details  The CPU runs until it reaches the next fetch phase. Afterwards,
+     *            the VICII, the CIAs, and the drives are clocked for the
+     *            elapsed cycles.
+     */
+    template <VICFamily family, bool threadedDrives> bool executeInstructionFast();
+    
+    //! @brief    Executes the VICII cycle function for a rasterline cycle
+    template <VICFamily family> void executeVicCycle(unsigned cycle);
+    
+    //! @brief    Executes all components that are due in the o2 low phase
+    void executeEventsLow(uint64_t cycle);
+    
+    //! @brief    Executes all components that are due in the o2 high phase
+    template <bool threadedDrives> bool executeEventsHigh(uint64_t cycle);
+    
+    //! @brief    Executes a drive and postpones the next execution if possible
+    bool executeDrive(VC1541 *drive, EventSlot slot, uint64_t cycle);
+    
+    /*! @brief    Brings the drives into a state that can be accessed from
+     *            outside the main loop.
+     *  @details  Waits for the drive thread and leaves all skipped idle loops.
+     */
+    void synchronizeDrives();
     
     //! @brief    Invoked before executing the first cycle of a rasterline
     void beginRasterLine();
@@ -441,6 +663,85 @@ class C64 : public VirtualComponent {
     void endFrame();
     
     
+    //
+    //! @functiongroup Scheduling events
+    //
+    
+    public:
+    
+    /*! @brief    Requests the execution of a component.
+     *  @details  The component associated with the specified slot is executed
+     *            in the main loop in each cycle starting with the specified
+     *            cycle, until the event is canceled or rescheduled.
+     */
+    void scheduleEvent(EventSlot slot, uint64_t cycle) {
+        eventCycle[slot] = cycle;
+        if (cycle < nextEvent) nextEvent = cycle;
+    }
+    
+    //! @brief    Removes a component from the main loop.
+    void cancelEvent(EventSlot slot) { eventCycle[slot] = UINT64_MAX; }
+    
+    /*! @brief    Lets a drive leave its idle loop.
+     *  @details  Needs to be called before anything is changed the drive could
+     *            observe. If the drive event has been postponed, the drive is
+     *            emulated up to the specified cycle first.
+     */
+    void wakeUpDrive(VC1541 *drive, uint64_t cycle);
+    
+    /*! @brief    Rebuilds the event table.
+     *  @details  The table is computed from scratch out of the component
+     *            states. This function needs to be called whenever the state
+     *            of the virtual computer has been changed as a whole, e.g.,
+     *            after a reset or after a snapshot has been restored.
+     */
+    void updateEventTable();
+    
+    
+    //
+    //! @functiongroup Running ahead
+    //
+    
+    //! @brief    Maximum number of frames that can be emulated ahead
+    static const unsigned MAX_RUN_AHEAD_FRAMES = 8;
+    
+    //! @brief    Returns the number of frames emulated ahead of time.
+    unsigned getRunAheadFrames() { return runAheadFrames; }
+    
+    /*! @brief    Enables or disables run-ahead mode.
+     *  @details  In run-ahead mode, executeOneFrame() emulates the specified
+     *            number of additional frames after each frame and rolls back
+     *            afterwards. Only the last frame emulated ahead is shown and
+     *            audio is only produced by the rolled back frame. This hides
+     *            the input lag many games add internally.
+     *  @param    frames is the number of frames to emulate ahead. Passing 0
+     *            disables run-ahead mode.
+     */
+    void setRunAheadFrames(unsigned frames);
+    
+    //! @brief    Returns true if the emulator is currently running ahead.
+    bool isRunningAhead() { return runningAhead; }
+    
+    //! @brief    Returns the run-ahead statistics.
+    RunAheadInfo getRunAheadInfo();
+    
+    //! @brief    Clears the run-ahead statistics.
+    void resetRunAheadInfo();
+    
+    private:
+    
+    //! @brief    Emulates the run-ahead frames and rolls back afterwards.
+    void runAhead();
+    
+    //! @brief    Saves the emulator state into runAheadState.
+    void saveRunAheadState();
+    
+    //! @brief    Restores the emulator state from runAheadState.
+    void restoreRunAheadState();
+    
+    public:
+    
+    
     //
     //! @functiongroup Handling mice
     //
@@ -470,15 +771,23 @@ class C64 : public VirtualComponent {
     //! @functiongroup Managing the execution thread
     //
     
-    private:
+    public:
+    
+    //! @brief    Returns the clock used for synchronizing the emulation.
+    HostClock *getHostClock() { return hostClock; }
     
-    //! @brief    Converts kernel time to nanoseconds.
-    uint64_t abs_to_nanos(uint64_t abs) { return abs * timebase.numer / timebase.denom; }
+    /*! @brief    Plugs in a custom clock.
+     *  @details  Passing NULL switches back to the default system clock. The
+     *            caller is responsible for keeping the clock object alive.
+     */
+    void setHostClock(HostClock *clock);
     
-    //! @brief    Converts nanoseconds to kernel time.
-    uint64_t nanos_to_abs(uint64_t nanos) { return nanos * timebase.denom / timebase.numer; }
+    //! @brief    Returns the frame pacing statistics.
+    PacingInfo getPacingInfo();
+    
+    //! @brief    Clears the frame pacing statistics.
+    void resetPacingInfo();
     
-    public:
     
     //! @brief    Updates variable warp and returns the new value.
     /*! @details  As a side effect, messages are sent to the GUI if the
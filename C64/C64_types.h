@@ -64,6 +64,58 @@ static const C64Configuration configurations[] = {
     { NTSC_6567_R56A, false, MOS_6526_OLD, false, MOS_6581, true, GLUE_DISCRETE, INIT_PATTERN_C64 }
 };
 
+/*! @brief    VICII model families
+ *  @details  All models of the same family execute the same sequence of
+ *            VICII cycle functions. The main loop is specialized for each
+ *            family (see C64::updateExecutors).
+ */
+typedef enum {
+    VIC_FAMILY_PAL = 0,   // 63 cycles per rasterline
+    VIC_FAMILY_NTSC_OLD,  // 64 cycles per rasterline (6567R56A)
+    VIC_FAMILY_NTSC       // 65 cycles per rasterline
+} VICFamily;
+
+/*! @brief    Event slots
+ *  @details  Each slot represents a component that is executed by the main
+ *            loop only if it has work to do (see C64::scheduleEvent).
+ */
+typedef enum {
+    CIA1_SLOT = 0,
+    CIA2_SLOT,
+    IEC_SLOT,
+    DRIVE1_SLOT,
+    DRIVE2_SLOT,
+    DATASETTE_SLOT,
+    EVENT_SLOT_COUNT
+} EventSlot;
+
+/*! @brief    Frame pacing statistics
+ *  @details  Collected by the emulator thread while synchronizing the frame
+ *            rate with the real time. The jitter of a frame is the time
+ *            between the scheduled and the actual wakeup time. All time
+ *            values are measured in nanoseconds.
+ */
+typedef struct {
+    uint64_t frames;
+    uint64_t restarts;
+    int64_t minJitter;
+    int64_t maxJitter;
+    double avgJitter;
+    double rmsJitter;
+} PacingInfo;
+
+/*! @brief    Run-ahead statistics
+ *  @details  The cost of a frame comprises the time needed to save the
+ *            emulator state, to emulate all frames ahead, and to restore the
+ *            saved state. All time values are measured in microseconds.
+ */
+typedef struct {
+    uint64_t frames;
+    uint64_t lastCost;
+    uint64_t maxCost;
+    double avgCost;
+} RunAheadInfo;
+
 /*! @brief    Message types
  *  @details  List of all possible message id's
  */
@@ -135,7 +187,10 @@ typedef enum {
 
     // Peripherals (Expansion port)
     MSG_CARTRIDGE,
-    MSG_NO_CARTRIDGE
+    MSG_NO_CARTRIDGE,
+
+    // Debugging
+    MSG_CPU_WATCHPOINT_REACHED
 
 } MessageType;
 
@@ -59,7 +59,7 @@ CIA::CIA()
         { &INT,              sizeof(INT),              CLEAR_ON_RESET },
         { &tiredness,        sizeof(tiredness),        CLEAR_ON_RESET },
         { &wakeUpCycle,      sizeof(wakeUpCycle),      CLEAR_ON_RESET },
-        { &idleCounter,      sizeof(idleCounter),      CLEAR_ON_RESET },
+        { &sleepCycle,       sizeof(sleepCycle),       CLEAR_ON_RESET },
         { NULL,              0,                        0 }};
 
     registerSnapshotItems(items, sizeof(items));
@@ -306,19 +306,19 @@ CIA::spypeek(uint16_t addr)
             
         case 0x04: // CIA_TIMER_A_LOW
             running = delay & CIACountA3;
-            return LO_BYTE(counterA - (running ? (uint16_t)idleCounter : 0));
+            return LO_BYTE(counterA - (running ? (uint16_t)idleCycles() : 0));
             
         case 0x05: // CIA_TIMER_A_HIGH
             running = delay & CIACountA3;
-            return HI_BYTE(counterA - (running ? (uint16_t)idleCounter : 0));
+            return HI_BYTE(counterA - (running ? (uint16_t)idleCycles() : 0));
             
         case 0x06: // CIA_TIMER_B_LOW
             running = delay & CIACountB3;
-            return LO_BYTE(counterB - (running ? (uint16_t)idleCounter : 0));
+            return LO_BYTE(counterB - (running ? (uint16_t)idleCycles() : 0));
             
         case 0x07: // CIA_TIMER_B_HIGH
             running = delay & CIACountB3;
-            return HI_BYTE(counterB - (running ? (uint16_t)idleCounter : 0));
+            return HI_BYTE(counterB - (running ? (uint16_t)idleCycles() : 0));
             
         case 0x08: // CIA_TIME_OF_DAY_SEC_FRAC
             return tod.getTodTenth();
@@ -1094,10 +1094,21 @@ CIA::executeOneCycle()
     }
 }
 
+uint64_t
+CIA::idleCycles()
+{
+    if (wakeUpCycle == 0)
+        return 0;
+    
+    // The CIA gets executed again in the wakeup cycle
+    uint64_t cycle = MIN(c64->cpu.cycle, wakeUpCycle - 1);
+    return cycle - sleepCycle;
+}
+
 void
 CIA::sleep()
 {
-    assert(idleCounter == 0);
+    assert(wakeUpCycle == 0);
     
     // Determine maximum possible sleep cycles based on timer counts
     uint64_t cycle = c64->cpu.cycle;
@@ -1108,14 +1119,20 @@ CIA::sleep()
     if (!(feed & CIACountA0)) sleepA = UINT64_MAX;
     if (!(feed & CIACountB0)) sleepB = UINT64_MAX;
     
+    sleepCycle = cycle;
     wakeUpCycle = MIN(sleepA, sleepB);
-    // setWakeUpCycle(MIN(sleepA, sleepB));
+    
+    // Let the main loop skip this CIA until the wakeup cycle is reached
+    c64->scheduleEvent(eventSlot, wakeUpCycle);
 }
 
 void
 CIA::wakeUp()
 {
-    // uint64_t idleCycles = idleCounter;
+    if (wakeUpCycle == 0)
+        return;
+    
+    uint64_t idleCounter = idleCycles();
     
     // Make up for missed cycles
     if (idleCounter) {
@@ -1127,11 +1144,9 @@ CIA::wakeUp()
             assert(counterB >= idleCounter);
             counterB -= idleCounter;
         }
-        idleCounter = 0;
-        // resetIdleCounter();
     }
     wakeUpCycle = 0;
-    // setWakeUpCycle(0);
+    c64->scheduleEvent(eventSlot, 0);
 }
 
 
@@ -1143,6 +1158,7 @@ CIA1::CIA1()
 {
     setDescription("CIA1");
 	debug(3, "  Creating CIA1 at address %p...\n", this);
+    eventSlot = CIA1_SLOT;
 }
 
 CIA1::~CIA1()
@@ -1284,6 +1300,7 @@ CIA2::CIA2()
 {
     setDescription("CIA2");
 	debug(3, "  Creating CIA2 at address %p...\n", this);
+    eventSlot = CIA2_SLOT;
 }
 
 CIA2::~CIA2()
@@ -1340,6 +1357,9 @@ CIA2::portAinternal()
 uint8_t
 CIA2::portAexternal()
 {
+    // The drives must have caught up before we can look at the bus lines
+    c64->driveThread.synchronize(c64->cpu.cycle - 1);
+    
     uint8_t result = 0x3F;
     result |= (c64->iec.clockLine ? 0x40 : 0x00);
     result |= (c64->iec.dataLine ? 0x80 : 0x00);
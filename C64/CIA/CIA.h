@@ -239,14 +239,19 @@ private:
      */
     uint8_t tiredness;
 
+    //! @brief    Cycle in which the CIA has been put into idle state
+    uint64_t sleepCycle;
+    
+protected:
+    
+    //! @brief    Event slot used to register with the main loop
+    EventSlot eventSlot;
+    
 public:
     
     //! @brief    Wakeup cycle
     uint64_t wakeUpCycle;
     
-    //! @brief    Number of skipped executions
-    uint64_t idleCounter;
-    
 public:	
 	
 	//! @brief    Constructor
@@ -426,6 +431,12 @@ public:
     
 private:
     
+    /*! @brief    Returns the number of skipped executions
+     *  @details  A sleeping CIA is not executed by the main loop. The number
+     *            of missed cycles is derived from the CPU cycle counter.
+     */
+    uint64_t idleCycles();
+    
     //! @brief    Puts the CIA into idle state.
     void sleep();
     
@@ -39,6 +39,11 @@ CPU::CPU(CPUModel model, Memory *mem)
 	for (int i = 0; i <  65536; i++) {
 		breakpoint[i] = NO_BREAKPOINT;	
 	}
+    numConditions = 0;
+    traceWriter = NULL;
+    profiler = NULL;
+    listingHex = true;
+    memset(listingVersion, 0, sizeof(listingVersion));
     
     // Register snapshot items
     SnapshotItem items[] = {
@@ -78,6 +83,8 @@ CPU::CPU(CPUModel model, Memory *mem)
 CPU::~CPU()
 {
 	debug(3, "  Releasing CPU...\n");
+    delete traceWriter;
+    delete profiler;
 }
 
 void
@@ -243,6 +250,65 @@ CPU::getLengthOfInstruction(uint8_t opcode)
 	return 1;
 }
 
+uint16_t
+CPU::banksOfNextInstruction()
+{
+    #define BANK(addr) (uint16_t)(1 << ((uint16_t)(addr) >> 12))
+
+    uint8_t opcode = mem->spypeek(regPC);
+    uint8_t lo = mem->spypeek(regPC + 1);
+    uint8_t hi = mem->spypeek(regPC + 2);
+    uint16_t operand = LO_HI(lo, hi);
+    uint16_t base;
+
+    // Opcode and operand fetches, zero page, and stack
+    uint16_t banks = BANK(regPC) | BANK(regPC + 2) | BANK(0x0000);
+
+    switch (actionFunc[opcode]) {
+
+        case JAM:
+        case SHA_ind_y: case SHA_abs_y: case SHX_abs_y: case SHY_abs_x:
+        case TAS_abs_y:
+            return 0xFFFF;
+
+        case BRK:
+            return banks | BANK(0xFFFE);
+
+        default:
+            break;
+    }
+
+    switch (addressingMode[opcode]) {
+
+        case ADDR_ABSOLUTE:
+        case ADDR_INDIRECT:
+            return banks | BANK(operand);
+
+        case ADDR_ABSOLUTE_X:
+            return banks | BANK(operand) | BANK(operand + regX);
+
+        case ADDR_ABSOLUTE_Y:
+            return banks | BANK(operand) | BANK(operand + regY);
+
+        case ADDR_INDIRECT_X:
+            lo += regX;
+            base = LO_HI(mem->spypeek(lo), mem->spypeek((uint8_t)(lo + 1)));
+            return banks | BANK(base);
+
+        case ADDR_INDIRECT_Y:
+            base = LO_HI(mem->spypeek(lo), mem->spypeek((uint8_t)(lo + 1)));
+            return banks | BANK(base) | BANK(base + regY);
+
+        case ADDR_RELATIVE:
+            return banks | BANK(regPC + 2 + (int8_t)lo);
+
+        default:
+            return banks;
+    }
+
+    #undef BANK
+}
+
 
 void 
 CPU::setErrorState(ErrorState state)
@@ -262,6 +328,9 @@ CPU::setErrorState(ErrorState state)
         case CPU_HARD_BREAKPOINT_REACHED:
             c64->putMessage(MSG_CPU_HARD_BREAKPOINT_REACHED);
             return;
+        case CPU_WATCHPOINT_REACHED:
+            c64->putMessage(MSG_CPU_WATCHPOINT_REACHED);
+            return;
         case CPU_ILLEGAL_INSTRUCTION:
             c64->putMessage(MSG_CPU_ILLEGAL_INSTRUCTION);
             return;
@@ -270,6 +339,60 @@ CPU::setErrorState(ErrorState state)
     }
 }
 
+bool
+CPU::setConditionalBreakpoint(uint16_t addr, const char *expression)
+{
+    unsigned i;
+    
+    // Reuse the slot of an existing condition at the same address
+    for (i = 0; i < numConditions && conditionAddr[i] != addr; i++);
+    if (i == maxConditions) return false;
+    
+    Condition cond;
+    if (!cond.compile(expression)) return false;
+    
+    conditionAddr[i] = addr;
+    condition[i] = cond;
+    if (i == numConditions) numConditions++;
+    
+    breakpoint[addr] |= CONDITIONAL_BREAKPOINT;
+    return true;
+}
+
+void
+CPU::deleteConditionalBreakpoint(uint16_t addr)
+{
+    for (unsigned i = 0; i < numConditions; i++) {
+        
+        if (conditionAddr[i] == addr) {
+            
+            numConditions--;
+            conditionAddr[i] = conditionAddr[numConditions];
+            condition[i] = condition[numConditions];
+            break;
+        }
+    }
+    breakpoint[addr] &= ~CONDITIONAL_BREAKPOINT;
+}
+
+const char *
+CPU::breakpointCondition(uint16_t addr)
+{
+    for (unsigned i = 0; i < numConditions; i++) {
+        if (conditionAddr[i] == addr) return condition[i].getSource();
+    }
+    return NULL;
+}
+
+bool
+CPU::conditionHolds(uint16_t addr)
+{
+    for (unsigned i = 0; i < numConditions; i++) {
+        if (conditionAddr[i] == addr) return condition[i].eval(this, mem);
+    }
+    return false;
+}
+
 unsigned
 CPU::recordedInstructions()
 {
@@ -279,6 +402,9 @@ CPU::recordedInstructions()
 void
 CPU::recordInstruction()
 {
+    // Run-ahead frames are rolled back and emulated again later
+    if (c64->isRunningAhead()) return;
+    
     RecordedInstruction i;
     uint8_t opcode = mem->spypeek(pc);
     unsigned length = getLengthOfInstruction(opcode);
@@ -301,9 +427,69 @@ CPU::recordInstruction()
     if (writePtr == readPtr) {
         readPtr = (readPtr + 1) % traceBufferSize;
     }
+    
+    if (traceWriter) traceWriter->record(i, length);
     // debug("readPtr = %d writePtr = %d size = %d\n", readPtr, writePtr, recordedInstructions());
 }
 
+bool
+CPU::startStreaming(const char *path)
+{
+    TraceWriter *writer = new TraceWriter();
+    
+    if (!writer->open(path)) {
+        delete writer;
+        return false;
+    }
+    
+    suspend();
+    stopStreaming();
+    traceWriter = writer;
+    startTracing();
+    resume();
+    
+    return true;
+}
+
+bool
+CPU::stopStreaming()
+{
+    if (!traceWriter) return true;
+    
+    suspend();
+    stopTracing();
+    bool success = traceWriter->close();
+    debug(2, "Streamed %llu instructions (%llu stalls)\n",
+          (unsigned long long)traceWriter->numRecords(),
+          (unsigned long long)traceWriter->numStalls());
+    delete traceWriter;
+    traceWriter = NULL;
+    resume();
+    
+    return success;
+}
+
+void
+CPU::startProfiling()
+{
+    suspend();
+    if (profiler) {
+        profiler->clear();
+    } else {
+        profiler = new Profiler();
+    }
+    resume();
+}
+
+void
+CPU::stopProfiling()
+{
+    suspend();
+    delete profiler;
+    profiler = NULL;
+    resume();
+}
+
 RecordedInstruction
 CPU::readRecordedInstruction()
 {
@@ -346,7 +532,7 @@ CPU::disassemble(RecordedInstruction instr, bool hex)
         case ADDR_ZERO_PAGE_Y:
         case ADDR_INDIRECT_X:
         case ADDR_INDIRECT_Y: {
-            uint8_t value = mem->spypeek(instr.pc + 1);
+            uint8_t value = instr.byte2;
             hex ? sprint8x(operand, value) : sprint8d(operand, value);
             break;
         }
@@ -355,12 +541,12 @@ CPU::disassemble(RecordedInstruction instr, bool hex)
         case ADDR_ABSOLUTE:
         case ADDR_ABSOLUTE_X:
         case ADDR_ABSOLUTE_Y: {
-            uint16_t value = LO_HI(mem->spypeek(instr.pc + 1),mem->spypeek(instr.pc + 2));
+            uint16_t value = LO_HI(instr.byte2, instr.byte3);
             hex ? sprint16x(operand, value) : sprint16d(operand, value);
             break;
         }
         case ADDR_RELATIVE: {
-            uint16_t value = instr.pc + 2 + (int8_t)mem->spypeek(instr.pc + 1);
+            uint16_t value = instr.pc + 2 + (int8_t)instr.byte2;
             hex ? sprint16x(operand, value) : sprint16d(operand, value);
             break;
         }
@@ -481,4 +667,64 @@ CPU::disassemble(uint16_t addr, bool hex)
     return disassemble(instr, hex);
 }
 
+unsigned
+CPU::disassemble(uint16_t addr, unsigned count, bool hex, DisassembledInstruction *result)
+{
+    // Reuse the cached lines starting at addr (if any)
+    size_t first = 0;
+    while (first < listing.size() && listing[first].addr != addr) first++;
+    if (first == listing.size() || hex != listingHex) {
+        listing.clear();
+        listingHex = hex;
+    } else {
+        listing.erase(listing.begin(), listing.begin() + first);
+    }
+    
+    // Drop the cached lines from the first modified one on
+    for (size_t i = 0; i < listing.size(); i++) {
+        if (!isUpToDate(listing[i])) {
+            listing.resize(i);
+            break;
+        }
+    }
+    
+    // Decode the missing lines
+    uint32_t next = listing.empty() ? addr : listing.back().addr + listing.back().size;
+    while (listing.size() < count && next <= 0xFFFF) {
+        
+        DisassembledInstruction line = disassemble((uint16_t)next, hex);
+        uint16_t last = line.addr + line.size - 1;
+        listingVersion[line.addr >> 8] = mem->pageVersion[line.addr >> 8];
+        listingVersion[last >> 8] = mem->pageVersion[last >> 8];
+        
+        listing.push_back(line);
+        next += line.size;
+    }
+    
+    // Copy the lines and fill in the current register values
+    unsigned n = (unsigned)MIN(listing.size(), count);
+    if (n == 0) return 0;
+    
+    DisassembledInstruction regs = disassemble(addr, hex);
+    for (unsigned i = 0; i < n; i++) {
+        
+        result[i] = listing[i];
+        memcpy(result[i].a, regs.a, sizeof(regs.a));
+        memcpy(result[i].x, regs.x, sizeof(regs.x));
+        memcpy(result[i].y, regs.y, sizeof(regs.y));
+        memcpy(result[i].sp, regs.sp, sizeof(regs.sp));
+        memcpy(result[i].flags, regs.flags, sizeof(regs.flags));
+    }
+    return n;
+}
 
+bool
+CPU::isUpToDate(const DisassembledInstruction &line)
+{
+    uint8_t first = line.addr >> 8;
+    uint8_t last = (uint16_t)(line.addr + line.size - 1) >> 8;
+    
+    return
+    listingVersion[first] == mem->pageVersion[first] && mem->isCacheable(first << 8) &&
+    listingVersion[last] == mem->pageVersion[last] && mem->isCacheable(last << 8);
+}
@@ -25,6 +25,10 @@
 #include "CPU_types.h"
 #include "CPUInstructions.h"
 #include "TimeDelayed.h"
+#include "Condition.h"
+#include "TraceStream.h"
+#include "Profiler.h"
+#include <vector>
 
 class Memory;
 
@@ -32,6 +36,8 @@ class Memory;
  */
 class CPU : public VirtualComponent {
     
+    friend class Condition;
+    
     //
     // Types
     //
@@ -98,12 +104,24 @@ class CPU : public VirtualComponent {
     const char *mnemonic[256];
     
     /*! @brief    Adressing mode of each opcode
-     *  @note     Used by the disassembler, only.
+     *  @note     Used by the disassembler and by banksOfNextInstruction().
      */
     AddressingMode addressingMode[256];
     
     //! @brief    Breakpoint tag for each memory cell
     uint8_t breakpoint[65536];
+    
+    //! @brief    Maximum number of conditional breakpoints
+    static const unsigned maxConditions = 32;
+    
+    //! @brief    Locations of all conditional breakpoints
+    uint16_t conditionAddr[maxConditions];
+    
+    //! @brief    Conditions of all conditional breakpoints
+    Condition condition[maxConditions];
+    
+    //! @brief    Number of conditional breakpoints
+    unsigned numConditions;
 
     
     //
@@ -291,6 +309,36 @@ class CPU : public VirtualComponent {
     
     //! @brief  Trace buffer write pointer
     unsigned writePtr;
+    
+    /*! @brief  Streaming trace sink
+     *  @details If set, each recorded instruction is written to a file, too.
+     *  @see    startStreaming()
+     */
+    TraceWriter *traceWriter;
+    
+    /*! @brief  Guest code profiler
+     *  @details If set, each instruction fetch is reported to the profiler.
+     *  @see    startProfiling()
+     */
+    Profiler *profiler;
+    
+    
+    //
+    // Disassembly cache
+    //
+    
+    /*! @brief  Most recent range disassembly
+     *  @details Consecutive instructions starting at listing[0].addr. The
+     *           register fields are not kept up to date.
+     *  @see    disassemble(uint16_t, unsigned, bool, DisassembledInstruction *)
+     */
+    std::vector<DisassembledInstruction> listing;
+    
+    //! @brief  Number format of the cached listing
+    bool listingHex;
+    
+    //! @brief  Page versions the cached listing is based on
+    uint32_t listingVersion[256];
 
     
     //
@@ -530,6 +578,52 @@ class CPU : public VirtualComponent {
      *  @details  The fetch cycle is the first microinstruction of each command.
      */
     bool inFetchPhase() { return next == fetch; }
+    
+    /*! @brief    Returns the logical state of the CPU as a single value.
+     *  @details  The value comprises all registers except the program counter
+     *            and the state of the interrupt logic. It is only meaningful
+     *            if taken in the fetch phase. The VC1541 uses this function to
+     *            detect idle loops.
+     */
+    uint64_t getLogicalState() {
+        return
+        (uint64_t)regA | (uint64_t)regX << 8 | (uint64_t)regY << 16 |
+        (uint64_t)regSP << 24 | (uint64_t)regP << 32 | (uint64_t)irqLine << 40 |
+        (uint64_t)nmiLine << 48 | (uint64_t)doIrq << 56 | (uint64_t)doNmi << 57 |
+        (uint64_t)(levelDetector.current() != 0) << 58 |
+        (uint64_t)(edgeDetector.current() != 0) << 59; }
+    
+    /*! @brief    Returns true if no change on an interrupt line is in flight.
+     *  @details  If this function returns true, the interrupt logic behaves
+     *            the same way, no matter how many cycles elapse.
+     */
+    bool interruptLinesSettled() {
+        return
+        levelDetector.delayed() == levelDetector.current() &&
+        edgeDetector.delayed() == edgeDetector.current(); }
+    
+    //! @brief    Returns true if an interrupt sequence is about to start.
+    bool interruptPending() { return doIrq || doNmi; }
+    
+    /*! @brief    Polls the interrupt lines once more.
+     *  @details  Used by the fast CPU mode of the C64 which clocks the other
+     *            components after the CPU has finished an instruction. If
+     *            they have changed an interrupt line in the meantime, the
+     *            change is picked up as if it had been polled in time.
+     *  @see      C64::setFastCpu()
+     */
+    void repollInterrupts() {
+        doIrq |= (levelDetector.delayed() && !getI());
+        doNmi |= edgeDetector.delayed(); }
+    
+    /*! @brief    Returns the memory banks the next instruction may access.
+     *  @details  Bit n is set if the instruction may access the 4KB bank
+     *            starting at address n * $1000. The result is conservative
+     *            and only meaningful in the fetch phase, if no interrupt is
+     *            pending. Instructions with an unstable target address
+     *            report all banks.
+     */
+    uint16_t banksOfNextInstruction();
 	
     
     //
@@ -579,6 +673,48 @@ class CPU : public VirtualComponent {
     
 	//! @brief    Sets or deletes a hard breakpoint at the specified address.
 	void toggleSoftBreakpoint(uint16_t addr) { breakpoint[addr] ^= SOFT_BREAKPOINT; }
+
+    //! @brief    Checks if a trap is set at the provided address.
+    bool trap(uint16_t addr) { return (breakpoint[addr] & TRAP) != 0; }
+    
+    /*! @brief    Sets a trap at the provided address.
+     *  @details  When the CPU fetches an opcode from a trapped memory cell,
+     *            it hands over control to the virtual drive.
+     *  @see      VirtualDrive::executeTrap()
+     */
+    void setTrap(uint16_t addr) { breakpoint[addr] |= TRAP; }
+    
+    //! @brief    Deletes a trap at the provided address.
+    void deleteTrap(uint16_t addr) { breakpoint[addr] &= ~TRAP; }
+    
+    //! @brief    Checks if a conditional breakpoint is set at the provided address.
+    bool conditionalBreakpoint(uint16_t addr) {
+        return (breakpoint[addr] & CONDITIONAL_BREAKPOINT) != 0; }
+    
+    /*! @brief    Sets a conditional breakpoint at the provided address.
+     *  @details  Execution halts when the CPU fetches an opcode from this
+     *            address and the condition holds. An existing condition at
+     *            the same address is replaced. See class Condition for the
+     *            syntax.
+     *  @return   false, if the condition is malformed or if all conditional
+     *            breakpoints are in use.
+     */
+    bool setConditionalBreakpoint(uint16_t addr, const char *condition);
+    
+    //! @brief    Deletes a conditional breakpoint at the provided address.
+    void deleteConditionalBreakpoint(uint16_t addr);
+    
+    /*! @brief    Returns the condition of a conditional breakpoint.
+     *  @return   NULL, if no conditional breakpoint is set at the address.
+     */
+    const char *breakpointCondition(uint16_t addr);
+    
+    private:
+    
+    //! @brief    Evaluates the condition of a conditional breakpoint.
+    bool conditionHolds(uint16_t addr);
+    
+    public:
     
     
     //
@@ -591,9 +727,43 @@ class CPU : public VirtualComponent {
     //! @brief   Returns the number of recorded instructions.
     unsigned recordedInstructions(); 
     
-    //! @brief   Records an instruction.
+    /*! @brief   Records an instruction.
+     *  @details Does nothing while the emulator runs ahead, because run-ahead
+     *           frames are rolled back and emulated again.
+     */
     void recordInstruction();
     
+    /*! @brief   Streams the trace into a file.
+     *  @details Enables tracing and writes all recorded instructions into
+     *           the specified file. Encoding and writing is done by a
+     *           background thread. Use TraceReader to decode the file.
+     *  @return  false, if the file cannot be created.
+     */
+    bool startStreaming(const char *path);
+    
+    /*! @brief   Stops streaming and closes the trace file.
+     *  @return  false, if writing the trace file has failed.
+     */
+    bool stopStreaming();
+    
+    //! @brief   Returns true if the trace is streamed into a file.
+    bool isStreaming() { return traceWriter != NULL; }
+    
+    /*! @brief   Starts profiling the executed code.
+     *  @details Creates a profiler that counts instructions and cycles per
+     *           PC and keeps track of the call graph. If the profiler is
+     *           running already, the collected data is discarded.
+     */
+    void startProfiling();
+    
+    //! @brief   Stops profiling and deletes the collected data.
+    void stopProfiling();
+    
+    /*! @brief   Returns the profiler.
+     *  @return  NULL, if profiling is switched off.
+     */
+    Profiler *getProfiler() { return profiler; }
+    
     /*! @brief   Reads and removes a recorded instruction from the trace buffer.
      *  @note    The trace buffer must not be empty.
      */
@@ -618,6 +788,25 @@ class CPU : public VirtualComponent {
     
     //! @brief    Disassembles the current instruction.
     DisassembledInstruction disassemble(bool hex) { return disassemble(pc, hex); }
+    
+    /*! @brief    Disassembles consecutive instructions.
+     *  @details  Decodes up to count instructions, starting at addr, into the
+     *            provided array. The decoded lines are cached. The next call
+     *            for the same start address only decodes the instructions
+     *            that overlap a modified memory page. Pages that aren't RAM
+     *            or Rom are decoded each time.
+     *  @return   The number of decoded instructions. It is smaller than count
+     *            if the end of the address space is reached.
+     */
+    unsigned disassemble(uint16_t addr, unsigned count, bool hex,
+                         DisassembledInstruction *result);
+    
+    private:
+    
+    //! @brief    Checks if a cached line still matches the memory contents.
+    bool isUpToDate(const DisassembledInstruction &line);
+    
+    public:
 
 };
 
@@ -455,10 +455,20 @@ bool
 CPU::executeOneCycle()
 {
     uint8_t instr;
+    bool watchpoint;
     
+#ifdef CPU_THREADED_DISPATCH
+    
+    static void *const dispatchTable[] = { MICRO_INSTRUCTION_LABELS };
+    
+    assert(next <= TAS_abs_y_4);
+    goto *dispatchTable[next];
+    {
+#else
     switch (next) {
+#endif
             
-        case fetch:
+        MICRO_CASE(fetch)
             
             /* DEBUG */
             /*
@@ -471,30 +481,47 @@ CPU::executeOneCycle()
             
             pc = regPC;
             
+            // Check if the previous instruction has hit a watchpoint. This is
+            // done first, because an interrupt would delay the report until
+            // the first instruction of the interrupt handler.
+            watchpoint = mem->watchpointReached;
+            if (unlikely(watchpoint)) {
+                mem->watchpointReached = false;
+                setErrorState(CPU_WATCHPOINT_REACHED);
+                debug(1, "Watchpoint reached\n");
+            }
+            
             // Check interrupt lines
             if (unlikely(doNmi)) {
                 
                 // if (tracingEnabled()) debug("NMI (source = %02X)\n", nmiLine);
                 IDLE_FETCH
+                if (unlikely(profiler != NULL)) profiler->interrupt(pc, cycle);
                 edgeDetector.clear();
                 next = nmi_2;
                 doNmi = false;
                 doIrq = false; // NMI wins
-                return true;
+                return !watchpoint;
                 
             } else if (unlikely(doIrq)) {
                 
                 // if (tracingEnabled()) debug("IRQ (source = %02X)\n", irqLine);
                 IDLE_FETCH
+                if (unlikely(profiler != NULL)) profiler->interrupt(pc, cycle);
                 next = irq_2;
                 doIrq = false;
-                return true;
+                return !watchpoint;
             }
             
             // Execute fetch phase
             FETCH_OPCODE
             next = actionFunc[instr];
             
+            if (unlikely(profiler != NULL)) {
+                profiler->instruction(pc, instr, cycle);
+            }
+            mem->coverExec(pc);
+            
             // Disassemble command if requested
             if (unlikely(tracingEnabled())) {
   
@@ -521,14 +548,27 @@ CPU::executeOneCycle()
             }
             
             
+            // Stop if the previous instruction has hit a watchpoint
+            if (unlikely(watchpoint)) {
+                return false;
+            }
+            
             // Check breakpoint tag
             if (unlikely(breakpoint[pc] != NO_BREAKPOINT)) {
                 if (breakpoint[pc] & SOFT_BREAKPOINT) {
                     // Soft breakpoints get deleted when reached
                     breakpoint[pc] &= ~SOFT_BREAKPOINT;
                     setErrorState(CPU_SOFT_BREAKPOINT_REACHED);
-                } else {
+                } else if (breakpoint[pc] & HARD_BREAKPOINT) {
+                    setErrorState(CPU_HARD_BREAKPOINT_REACHED);
+                } else if ((breakpoint[pc] & CONDITIONAL_BREAKPOINT) &&
+                           conditionHolds(pc)) {
                     setErrorState(CPU_HARD_BREAKPOINT_REACHED);
+                } else {
+                    // Let the virtual drive emulate the trapped routine
+                    if ((breakpoint[pc] & TRAP) &&
+                        c64->virtualDrive.executeTrap(pc)) next = fetch;
+                    return true;
                 }
                 debug(1, "Breakpoint reached\n");
                 return false;
@@ -540,12 +580,12 @@ CPU::executeOneCycle()
         // Illegal instructions
         //
             
-        case JAM:
+        MICRO_CASE(JAM)
             
             setErrorState(CPU_ILLEGAL_INSTRUCTION);
             CONTINUE
 
-        case JAM_2:
+        MICRO_CASE(JAM_2)
             POLL_INT
             DONE
 
@@ -553,17 +593,17 @@ CPU::executeOneCycle()
         // IRQ handling
         //
             
-        case irq_2:
+        MICRO_CASE(irq_2)
             
             IDLE_READ_IMPLIED
             CONTINUE
             
-        case irq_3:
+        MICRO_CASE(irq_3)
             
             PUSH_PCH
             CONTINUE
             
-        case irq_4:
+        MICRO_CASE(irq_4)
             
             PUSH_PCL
             // Check for interrupt hijacking
@@ -577,19 +617,19 @@ CPU::executeOneCycle()
             }
             CONTINUE
             
-        case irq_5:
+        MICRO_CASE(irq_5)
             
             mem->poke(0x100+(regSP--), getPWithClearedB());
             CONTINUE
             
-        case irq_6:
+        MICRO_CASE(irq_6)
             
             READ_FROM(0xFFFE)
             setPCL(regD);
             setI(1);
             CONTINUE
             
-        case irq_7:
+        MICRO_CASE(irq_7)
             
             READ_FROM(0xFFFF)
             setPCH(regD);
@@ -599,34 +639,34 @@ CPU::executeOneCycle()
         // NMI handling
         // 
         
-        case nmi_2:
+        MICRO_CASE(nmi_2)
 
             IDLE_READ_IMPLIED
             CONTINUE
             
-        case nmi_3:
+        MICRO_CASE(nmi_3)
             
             PUSH_PCH
             CONTINUE
             
-        case nmi_4:
+        MICRO_CASE(nmi_4)
             
             PUSH_PCL
             CONTINUE
             
-        case nmi_5:
+        MICRO_CASE(nmi_5)
             
             mem->poke(0x100+(regSP--), getPWithClearedB());
             CONTINUE
             
-        case nmi_6:
+        MICRO_CASE(nmi_6)
             
             READ_FROM(0xFFFA)
             setPCL(regD);
             setI(1);
             CONTINUE
             
-        case nmi_7:
+        MICRO_CASE(nmi_7)
 
             READ_FROM(0xFFFB)
             setPCH(regD);
@@ -636,7 +676,7 @@ CPU::executeOneCycle()
         // Adressing mode: Immediate (shared behavior)
         //
 
-        case BRK: case RTI: case RTS:
+        MICRO_CASE(BRK) MICRO_CASE(RTI) MICRO_CASE(RTS)
             
             IDLE_READ_IMMEDIATE
             CONTINUE
@@ -645,7 +685,7 @@ CPU::executeOneCycle()
         // Adressing mode: Implied (shared behavior)
         //
 
-        case PHA: case PHP: case PLA: case PLP:
+        MICRO_CASE(PHA) MICRO_CASE(PHP) MICRO_CASE(PLA) MICRO_CASE(PLP)
             
             IDLE_READ_IMPLIED
             CONTINUE
@@ -654,21 +694,21 @@ CPU::executeOneCycle()
         // Adressing mode: Zero-Page  (shared behavior)
         //
         
-        case ADC_zpg: case AND_zpg: case ASL_zpg: case BIT_zpg:
-        case CMP_zpg: case CPX_zpg: case CPY_zpg: case DEC_zpg:
-        case EOR_zpg: case INC_zpg: case LDA_zpg: case LDX_zpg:
-        case LDY_zpg: case LSR_zpg: case NOP_zpg: case ORA_zpg:
-        case ROL_zpg: case ROR_zpg: case SBC_zpg: case STA_zpg:
-        case STX_zpg: case STY_zpg: case DCP_zpg: case ISC_zpg:
-        case LAX_zpg: case RLA_zpg: case RRA_zpg: case SAX_zpg:
-        case SLO_zpg: case SRE_zpg:
+        MICRO_CASE(ADC_zpg) MICRO_CASE(AND_zpg) MICRO_CASE(ASL_zpg) MICRO_CASE(BIT_zpg)
+        MICRO_CASE(CMP_zpg) MICRO_CASE(CPX_zpg) MICRO_CASE(CPY_zpg) MICRO_CASE(DEC_zpg)
+        MICRO_CASE(EOR_zpg) MICRO_CASE(INC_zpg) MICRO_CASE(LDA_zpg) MICRO_CASE(LDX_zpg)
+        MICRO_CASE(LDY_zpg) MICRO_CASE(LSR_zpg) MICRO_CASE(NOP_zpg) MICRO_CASE(ORA_zpg)
+        MICRO_CASE(ROL_zpg) MICRO_CASE(ROR_zpg) MICRO_CASE(SBC_zpg) MICRO_CASE(STA_zpg)
+        MICRO_CASE(STX_zpg) MICRO_CASE(STY_zpg) MICRO_CASE(DCP_zpg) MICRO_CASE(ISC_zpg)
+        MICRO_CASE(LAX_zpg) MICRO_CASE(RLA_zpg) MICRO_CASE(RRA_zpg) MICRO_CASE(SAX_zpg)
+        MICRO_CASE(SLO_zpg) MICRO_CASE(SRE_zpg)
             
             FETCH_ADDR_LO
             CONTINUE
             
-        case ASL_zpg_2: case DEC_zpg_2: case INC_zpg_2: case LSR_zpg_2:
-        case ROL_zpg_2: case ROR_zpg_2: case DCP_zpg_2: case ISC_zpg_2:
-        case RLA_zpg_2: case RRA_zpg_2: case SLO_zpg_2: case SRE_zpg_2:
+        MICRO_CASE(ASL_zpg_2) MICRO_CASE(DEC_zpg_2) MICRO_CASE(INC_zpg_2) MICRO_CASE(LSR_zpg_2)
+        MICRO_CASE(ROL_zpg_2) MICRO_CASE(ROR_zpg_2) MICRO_CASE(DCP_zpg_2) MICRO_CASE(ISC_zpg_2)
+        MICRO_CASE(RLA_zpg_2) MICRO_CASE(RRA_zpg_2) MICRO_CASE(SLO_zpg_2) MICRO_CASE(SRE_zpg_2)
             
             READ_FROM_ZERO_PAGE
             CONTINUE
@@ -677,38 +717,38 @@ CPU::executeOneCycle()
         // Adressing mode: Zero-Page Indexed (shared behavior)
         //
             
-        case ADC_zpg_x: case AND_zpg_x: case ASL_zpg_x: case CMP_zpg_x:
-        case DEC_zpg_x: case EOR_zpg_x: case INC_zpg_x: case LDA_zpg_x:
-        case LDY_zpg_x: case LSR_zpg_x: case NOP_zpg_x: case ORA_zpg_x:
-        case ROL_zpg_x: case ROR_zpg_x: case SBC_zpg_x: case STA_zpg_x:
-        case STY_zpg_x: case DCP_zpg_x: case ISC_zpg_x: case RLA_zpg_x:
-        case RRA_zpg_x: case SLO_zpg_x: case SRE_zpg_x:
+        MICRO_CASE(ADC_zpg_x) MICRO_CASE(AND_zpg_x) MICRO_CASE(ASL_zpg_x) MICRO_CASE(CMP_zpg_x)
+        MICRO_CASE(DEC_zpg_x) MICRO_CASE(EOR_zpg_x) MICRO_CASE(INC_zpg_x) MICRO_CASE(LDA_zpg_x)
+        MICRO_CASE(LDY_zpg_x) MICRO_CASE(LSR_zpg_x) MICRO_CASE(NOP_zpg_x) MICRO_CASE(ORA_zpg_x)
+        MICRO_CASE(ROL_zpg_x) MICRO_CASE(ROR_zpg_x) MICRO_CASE(SBC_zpg_x) MICRO_CASE(STA_zpg_x)
+        MICRO_CASE(STY_zpg_x) MICRO_CASE(DCP_zpg_x) MICRO_CASE(ISC_zpg_x) MICRO_CASE(RLA_zpg_x)
+        MICRO_CASE(RRA_zpg_x) MICRO_CASE(SLO_zpg_x) MICRO_CASE(SRE_zpg_x)
           
-        case LDX_zpg_y: case STX_zpg_y: case LAX_zpg_y: case SAX_zpg_y:
+        MICRO_CASE(LDX_zpg_y) MICRO_CASE(STX_zpg_y) MICRO_CASE(LAX_zpg_y) MICRO_CASE(SAX_zpg_y)
             
             FETCH_ADDR_LO
             CONTINUE
            
-        case ADC_zpg_x_2: case AND_zpg_x_2: case ASL_zpg_x_2: case CMP_zpg_x_2:
-        case DEC_zpg_x_2: case EOR_zpg_x_2: case INC_zpg_x_2: case LDA_zpg_x_2:
-        case LDY_zpg_x_2: case LSR_zpg_x_2: case NOP_zpg_x_2: case ORA_zpg_x_2:
-        case ROL_zpg_x_2: case ROR_zpg_x_2: case SBC_zpg_x_2: case DCP_zpg_x_2:
-        case ISC_zpg_x_2: case RLA_zpg_x_2: case RRA_zpg_x_2: case SLO_zpg_x_2:
-        case SRE_zpg_x_2: case STA_zpg_x_2: case STY_zpg_x_2:
+        MICRO_CASE(ADC_zpg_x_2) MICRO_CASE(AND_zpg_x_2) MICRO_CASE(ASL_zpg_x_2) MICRO_CASE(CMP_zpg_x_2)
+        MICRO_CASE(DEC_zpg_x_2) MICRO_CASE(EOR_zpg_x_2) MICRO_CASE(INC_zpg_x_2) MICRO_CASE(LDA_zpg_x_2)
+        MICRO_CASE(LDY_zpg_x_2) MICRO_CASE(LSR_zpg_x_2) MICRO_CASE(NOP_zpg_x_2) MICRO_CASE(ORA_zpg_x_2)
+        MICRO_CASE(ROL_zpg_x_2) MICRO_CASE(ROR_zpg_x_2) MICRO_CASE(SBC_zpg_x_2) MICRO_CASE(DCP_zpg_x_2)
+        MICRO_CASE(ISC_zpg_x_2) MICRO_CASE(RLA_zpg_x_2) MICRO_CASE(RRA_zpg_x_2) MICRO_CASE(SLO_zpg_x_2)
+        MICRO_CASE(SRE_zpg_x_2) MICRO_CASE(STA_zpg_x_2) MICRO_CASE(STY_zpg_x_2)
             
             READ_FROM_ZERO_PAGE
             ADD_INDEX_X
             CONTINUE
         
-        case LDX_zpg_y_2: case LAX_zpg_y_2: case STX_zpg_y_2: case SAX_zpg_y_2:
+        MICRO_CASE(LDX_zpg_y_2) MICRO_CASE(LAX_zpg_y_2) MICRO_CASE(STX_zpg_y_2) MICRO_CASE(SAX_zpg_y_2)
             
             READ_FROM_ZERO_PAGE
             ADD_INDEX_Y
             CONTINUE
            
-        case ASL_zpg_x_3: case DEC_zpg_x_3: case INC_zpg_x_3: case LSR_zpg_x_3:
-        case ROL_zpg_x_3: case ROR_zpg_x_3: case DCP_zpg_x_3: case ISC_zpg_x_3:
-        case RLA_zpg_x_3: case RRA_zpg_x_3: case SLO_zpg_x_3: case SRE_zpg_x_3:
+        MICRO_CASE(ASL_zpg_x_3) MICRO_CASE(DEC_zpg_x_3) MICRO_CASE(INC_zpg_x_3) MICRO_CASE(LSR_zpg_x_3)
+        MICRO_CASE(ROL_zpg_x_3) MICRO_CASE(ROR_zpg_x_3) MICRO_CASE(DCP_zpg_x_3) MICRO_CASE(ISC_zpg_x_3)
+        MICRO_CASE(RLA_zpg_x_3) MICRO_CASE(RRA_zpg_x_3) MICRO_CASE(SLO_zpg_x_3) MICRO_CASE(SRE_zpg_x_3)
             
             READ_FROM_ZERO_PAGE
             CONTINUE
@@ -718,33 +758,33 @@ CPU::executeOneCycle()
         // Adressing mode: Absolute (shared behavior)
         //
             
-        case ADC_abs: case AND_abs: case ASL_abs: case BIT_abs:
-        case CMP_abs: case CPX_abs: case CPY_abs: case DEC_abs:
-        case EOR_abs: case INC_abs: case LDA_abs: case LDX_abs:
-        case LDY_abs: case LSR_abs: case NOP_abs: case ORA_abs:
-        case ROL_abs: case ROR_abs: case SBC_abs: case STA_abs:
-        case STX_abs: case STY_abs: case DCP_abs: case ISC_abs:
-        case LAX_abs: case RLA_abs: case RRA_abs: case SAX_abs:
-        case SLO_abs: case SRE_abs:
+        MICRO_CASE(ADC_abs) MICRO_CASE(AND_abs) MICRO_CASE(ASL_abs) MICRO_CASE(BIT_abs)
+        MICRO_CASE(CMP_abs) MICRO_CASE(CPX_abs) MICRO_CASE(CPY_abs) MICRO_CASE(DEC_abs)
+        MICRO_CASE(EOR_abs) MICRO_CASE(INC_abs) MICRO_CASE(LDA_abs) MICRO_CASE(LDX_abs)
+        MICRO_CASE(LDY_abs) MICRO_CASE(LSR_abs) MICRO_CASE(NOP_abs) MICRO_CASE(ORA_abs)
+        MICRO_CASE(ROL_abs) MICRO_CASE(ROR_abs) MICRO_CASE(SBC_abs) MICRO_CASE(STA_abs)
+        MICRO_CASE(STX_abs) MICRO_CASE(STY_abs) MICRO_CASE(DCP_abs) MICRO_CASE(ISC_abs)
+        MICRO_CASE(LAX_abs) MICRO_CASE(RLA_abs) MICRO_CASE(RRA_abs) MICRO_CASE(SAX_abs)
+        MICRO_CASE(SLO_abs) MICRO_CASE(SRE_abs)
             
             FETCH_ADDR_LO
             CONTINUE
            
-        case ADC_abs_2: case AND_abs_2: case ASL_abs_2: case BIT_abs_2:
-        case CMP_abs_2: case CPX_abs_2: case CPY_abs_2: case DEC_abs_2:
-        case EOR_abs_2: case INC_abs_2: case LDA_abs_2: case LDX_abs_2:
-        case LDY_abs_2: case LSR_abs_2: case NOP_abs_2: case ORA_abs_2:
-        case ROL_abs_2: case ROR_abs_2: case SBC_abs_2: case STA_abs_2:
-        case STX_abs_2: case STY_abs_2: case DCP_abs_2: case ISC_abs_2:
-        case LAX_abs_2: case RLA_abs_2: case RRA_abs_2: case SAX_abs_2:
-        case SLO_abs_2: case SRE_abs_2:
+        MICRO_CASE(ADC_abs_2) MICRO_CASE(AND_abs_2) MICRO_CASE(ASL_abs_2) MICRO_CASE(BIT_abs_2)
+        MICRO_CASE(CMP_abs_2) MICRO_CASE(CPX_abs_2) MICRO_CASE(CPY_abs_2) MICRO_CASE(DEC_abs_2)
+        MICRO_CASE(EOR_abs_2) MICRO_CASE(INC_abs_2) MICRO_CASE(LDA_abs_2) MICRO_CASE(LDX_abs_2)
+        MICRO_CASE(LDY_abs_2) MICRO_CASE(LSR_abs_2) MICRO_CASE(NOP_abs_2) MICRO_CASE(ORA_abs_2)
+        MICRO_CASE(ROL_abs_2) MICRO_CASE(ROR_abs_2) MICRO_CASE(SBC_abs_2) MICRO_CASE(STA_abs_2)
+        MICRO_CASE(STX_abs_2) MICRO_CASE(STY_abs_2) MICRO_CASE(DCP_abs_2) MICRO_CASE(ISC_abs_2)
+        MICRO_CASE(LAX_abs_2) MICRO_CASE(RLA_abs_2) MICRO_CASE(RRA_abs_2) MICRO_CASE(SAX_abs_2)
+        MICRO_CASE(SLO_abs_2) MICRO_CASE(SRE_abs_2)
             
             FETCH_ADDR_HI
             CONTINUE
             
-        case ASL_abs_3: case DEC_abs_3: case INC_abs_3: case LSR_abs_3:
-        case ROL_abs_3: case ROR_abs_3: case DCP_abs_3: case ISC_abs_3:
-        case RLA_abs_3: case RRA_abs_3: case SLO_abs_3: case SRE_abs_3:
+        MICRO_CASE(ASL_abs_3) MICRO_CASE(DEC_abs_3) MICRO_CASE(INC_abs_3) MICRO_CASE(LSR_abs_3)
+        MICRO_CASE(ROL_abs_3) MICRO_CASE(ROR_abs_3) MICRO_CASE(DCP_abs_3) MICRO_CASE(ISC_abs_3)
+        MICRO_CASE(RLA_abs_3) MICRO_CASE(RRA_abs_3) MICRO_CASE(SLO_abs_3) MICRO_CASE(SRE_abs_3)
             
             READ_FROM_ADDRESS
             CONTINUE
@@ -753,63 +793,63 @@ CPU::executeOneCycle()
         // Adressing mode: Absolute Indexed (shared behavior)
         //
             
-        case ADC_abs_x: case AND_abs_x: case ASL_abs_x: case CMP_abs_x:
-        case DEC_abs_x: case EOR_abs_x: case INC_abs_x: case LDA_abs_x:
-        case LDY_abs_x: case LSR_abs_x: case NOP_abs_x: case ORA_abs_x:
-        case ROL_abs_x: case ROR_abs_x: case SBC_abs_x: case STA_abs_x:
-        case DCP_abs_x: case ISC_abs_x: case RLA_abs_x: case RRA_abs_x:
-        case SHY_abs_x: case SLO_abs_x: case SRE_abs_x:
+        MICRO_CASE(ADC_abs_x) MICRO_CASE(AND_abs_x) MICRO_CASE(ASL_abs_x) MICRO_CASE(CMP_abs_x)
+        MICRO_CASE(DEC_abs_x) MICRO_CASE(EOR_abs_x) MICRO_CASE(INC_abs_x) MICRO_CASE(LDA_abs_x)
+        MICRO_CASE(LDY_abs_x) MICRO_CASE(LSR_abs_x) MICRO_CASE(NOP_abs_x) MICRO_CASE(ORA_abs_x)
+        MICRO_CASE(ROL_abs_x) MICRO_CASE(ROR_abs_x) MICRO_CASE(SBC_abs_x) MICRO_CASE(STA_abs_x)
+        MICRO_CASE(DCP_abs_x) MICRO_CASE(ISC_abs_x) MICRO_CASE(RLA_abs_x) MICRO_CASE(RRA_abs_x)
+        MICRO_CASE(SHY_abs_x) MICRO_CASE(SLO_abs_x) MICRO_CASE(SRE_abs_x)
             
-        case ADC_abs_y: case AND_abs_y: case CMP_abs_y: case EOR_abs_y:
-        case LDA_abs_y: case LDX_abs_y: case LSR_abs_y: case ORA_abs_y:
-        case SBC_abs_y: case STA_abs_y: case DCP_abs_y: case ISC_abs_y:
-        case LAS_abs_y: case LAX_abs_y: case RLA_abs_y: case RRA_abs_y:
-        case SHA_abs_y: case SHX_abs_y: case SLO_abs_y: case SRE_abs_y:
-        case TAS_abs_y:
+        MICRO_CASE(ADC_abs_y) MICRO_CASE(AND_abs_y) MICRO_CASE(CMP_abs_y) MICRO_CASE(EOR_abs_y)
+        MICRO_CASE(LDA_abs_y) MICRO_CASE(LDX_abs_y) MICRO_CASE(LSR_abs_y) MICRO_CASE(ORA_abs_y)
+        MICRO_CASE(SBC_abs_y) MICRO_CASE(STA_abs_y) MICRO_CASE(DCP_abs_y) MICRO_CASE(ISC_abs_y)
+        MICRO_CASE(LAS_abs_y) MICRO_CASE(LAX_abs_y) MICRO_CASE(RLA_abs_y) MICRO_CASE(RRA_abs_y)
+        MICRO_CASE(SHA_abs_y) MICRO_CASE(SHX_abs_y) MICRO_CASE(SLO_abs_y) MICRO_CASE(SRE_abs_y)
+        MICRO_CASE(TAS_abs_y)
             
             FETCH_ADDR_LO
             CONTINUE
             
-        case ADC_abs_x_2: case AND_abs_x_2: case ASL_abs_x_2: case CMP_abs_x_2:
-        case DEC_abs_x_2: case EOR_abs_x_2: case INC_abs_x_2: case LDA_abs_x_2:
-        case LDY_abs_x_2: case LSR_abs_x_2: case NOP_abs_x_2: case ORA_abs_x_2:
-        case ROL_abs_x_2: case ROR_abs_x_2: case SBC_abs_x_2: case STA_abs_x_2:
-        case DCP_abs_x_2: case ISC_abs_x_2: case RLA_abs_x_2: case RRA_abs_x_2:
-        case SHY_abs_x_2: case SLO_abs_x_2: case SRE_abs_x_2:
+        MICRO_CASE(ADC_abs_x_2) MICRO_CASE(AND_abs_x_2) MICRO_CASE(ASL_abs_x_2) MICRO_CASE(CMP_abs_x_2)
+        MICRO_CASE(DEC_abs_x_2) MICRO_CASE(EOR_abs_x_2) MICRO_CASE(INC_abs_x_2) MICRO_CASE(LDA_abs_x_2)
+        MICRO_CASE(LDY_abs_x_2) MICRO_CASE(LSR_abs_x_2) MICRO_CASE(NOP_abs_x_2) MICRO_CASE(ORA_abs_x_2)
+        MICRO_CASE(ROL_abs_x_2) MICRO_CASE(ROR_abs_x_2) MICRO_CASE(SBC_abs_x_2) MICRO_CASE(STA_abs_x_2)
+        MICRO_CASE(DCP_abs_x_2) MICRO_CASE(ISC_abs_x_2) MICRO_CASE(RLA_abs_x_2) MICRO_CASE(RRA_abs_x_2)
+        MICRO_CASE(SHY_abs_x_2) MICRO_CASE(SLO_abs_x_2) MICRO_CASE(SRE_abs_x_2)
             
             FETCH_ADDR_HI
             ADD_INDEX_X
             CONTINUE
             
-        case ADC_abs_y_2: case AND_abs_y_2: case CMP_abs_y_2: case EOR_abs_y_2:
-        case LDA_abs_y_2: case LDX_abs_y_2: case LSR_abs_y_2: case ORA_abs_y_2:
-        case SBC_abs_y_2: case STA_abs_y_2: case DCP_abs_y_2: case ISC_abs_y_2:
-        case LAS_abs_y_2: case LAX_abs_y_2: case RLA_abs_y_2: case RRA_abs_y_2:
-        case SHA_abs_y_2: case SHX_abs_y_2: case SLO_abs_y_2: case SRE_abs_y_2:
-        case TAS_abs_y_2:
+        MICRO_CASE(ADC_abs_y_2) MICRO_CASE(AND_abs_y_2) MICRO_CASE(CMP_abs_y_2) MICRO_CASE(EOR_abs_y_2)
+        MICRO_CASE(LDA_abs_y_2) MICRO_CASE(LDX_abs_y_2) MICRO_CASE(LSR_abs_y_2) MICRO_CASE(ORA_abs_y_2)
+        MICRO_CASE(SBC_abs_y_2) MICRO_CASE(STA_abs_y_2) MICRO_CASE(DCP_abs_y_2) MICRO_CASE(ISC_abs_y_2)
+        MICRO_CASE(LAS_abs_y_2) MICRO_CASE(LAX_abs_y_2) MICRO_CASE(RLA_abs_y_2) MICRO_CASE(RRA_abs_y_2)
+        MICRO_CASE(SHA_abs_y_2) MICRO_CASE(SHX_abs_y_2) MICRO_CASE(SLO_abs_y_2) MICRO_CASE(SRE_abs_y_2)
+        MICRO_CASE(TAS_abs_y_2)
             
             FETCH_ADDR_HI
             ADD_INDEX_Y
             CONTINUE
             
-        case ASL_abs_x_3: case DEC_abs_x_3: case INC_abs_x_3: case LSR_abs_x_3:
-        case ROL_abs_x_3: case ROR_abs_x_3: case DCP_abs_x_3: case ISC_abs_x_3:
-        case RLA_abs_x_3: case RRA_abs_x_3: case STA_abs_x_3: case SLO_abs_x_3:
-        case SRE_abs_x_3:
+        MICRO_CASE(ASL_abs_x_3) MICRO_CASE(DEC_abs_x_3) MICRO_CASE(INC_abs_x_3) MICRO_CASE(LSR_abs_x_3)
+        MICRO_CASE(ROL_abs_x_3) MICRO_CASE(ROR_abs_x_3) MICRO_CASE(DCP_abs_x_3) MICRO_CASE(ISC_abs_x_3)
+        MICRO_CASE(RLA_abs_x_3) MICRO_CASE(RRA_abs_x_3) MICRO_CASE(STA_abs_x_3) MICRO_CASE(SLO_abs_x_3)
+        MICRO_CASE(SRE_abs_x_3)
         
-        case LSR_abs_y_3: case STA_abs_y_3: case DCP_abs_y_3: case ISC_abs_y_3:
-        case RLA_abs_y_3: case RRA_abs_y_3: case SLO_abs_y_3: case SRE_abs_y_3:
+        MICRO_CASE(LSR_abs_y_3) MICRO_CASE(STA_abs_y_3) MICRO_CASE(DCP_abs_y_3) MICRO_CASE(ISC_abs_y_3)
+        MICRO_CASE(RLA_abs_y_3) MICRO_CASE(RRA_abs_y_3) MICRO_CASE(SLO_abs_y_3) MICRO_CASE(SRE_abs_y_3)
             
             READ_FROM_ADDRESS
             if (PAGE_BOUNDARY_CROSSED) { FIX_ADDR_HI }
             CONTINUE
             
-        case ASL_abs_x_4: case DEC_abs_x_4: case INC_abs_x_4: case LSR_abs_x_4:
-        case ROL_abs_x_4: case ROR_abs_x_4: case DCP_abs_x_4: case ISC_abs_x_4:
-        case RLA_abs_x_4: case RRA_abs_x_4: case SLO_abs_x_4: case SRE_abs_x_4:
+        MICRO_CASE(ASL_abs_x_4) MICRO_CASE(DEC_abs_x_4) MICRO_CASE(INC_abs_x_4) MICRO_CASE(LSR_abs_x_4)
+        MICRO_CASE(ROL_abs_x_4) MICRO_CASE(ROR_abs_x_4) MICRO_CASE(DCP_abs_x_4) MICRO_CASE(ISC_abs_x_4)
+        MICRO_CASE(RLA_abs_x_4) MICRO_CASE(RRA_abs_x_4) MICRO_CASE(SLO_abs_x_4) MICRO_CASE(SRE_abs_x_4)
             
-        case DCP_abs_y_4: case LSR_abs_y_4: case ISC_abs_y_4: case RLA_abs_y_4:
-        case RRA_abs_y_4: case SLO_abs_y_4: case SRE_abs_y_4:
+        MICRO_CASE(DCP_abs_y_4) MICRO_CASE(LSR_abs_y_4) MICRO_CASE(ISC_abs_y_4) MICRO_CASE(RLA_abs_y_4)
+        MICRO_CASE(RRA_abs_y_4) MICRO_CASE(SLO_abs_y_4) MICRO_CASE(SRE_abs_y_4)
             
             READ_FROM_ADDRESS
             CONTINUE
@@ -818,50 +858,50 @@ CPU::executeOneCycle()
         // Adressing mode: Indexed Indirect (shared behavior)
         //
     
-        case ADC_ind_x: case AND_ind_x: case ASL_ind_x: case CMP_ind_x:
-        case DEC_ind_x: case EOR_ind_x: case INC_ind_x: case LDA_ind_x:
-        case LDX_ind_x: case LDY_ind_x: case LSR_ind_x: case ORA_ind_x:
-        case ROL_ind_x: case ROR_ind_x: case SBC_ind_x: case STA_ind_x:
-        case DCP_ind_x: case ISC_ind_x: case LAX_ind_x: case RLA_ind_x:
-        case RRA_ind_x: case SAX_ind_x: case SLO_ind_x: case SRE_ind_x:
+        MICRO_CASE(ADC_ind_x) MICRO_CASE(AND_ind_x) MICRO_CASE(ASL_ind_x) MICRO_CASE(CMP_ind_x)
+        MICRO_CASE(DEC_ind_x) MICRO_CASE(EOR_ind_x) MICRO_CASE(INC_ind_x) MICRO_CASE(LDA_ind_x)
+        MICRO_CASE(LDX_ind_x) MICRO_CASE(LDY_ind_x) MICRO_CASE(LSR_ind_x) MICRO_CASE(ORA_ind_x)
+        MICRO_CASE(ROL_ind_x) MICRO_CASE(ROR_ind_x) MICRO_CASE(SBC_ind_x) MICRO_CASE(STA_ind_x)
+        MICRO_CASE(DCP_ind_x) MICRO_CASE(ISC_ind_x) MICRO_CASE(LAX_ind_x) MICRO_CASE(RLA_ind_x)
+        MICRO_CASE(RRA_ind_x) MICRO_CASE(SAX_ind_x) MICRO_CASE(SLO_ind_x) MICRO_CASE(SRE_ind_x)
             
             FETCH_POINTER_ADDR
             CONTINUE
             
-        case ADC_ind_x_2: case AND_ind_x_2: case ASL_ind_x_2: case CMP_ind_x_2:
-        case DEC_ind_x_2: case EOR_ind_x_2: case INC_ind_x_2: case LDA_ind_x_2:
-        case LDX_ind_x_2: case LDY_ind_x_2: case LSR_ind_x_2: case ORA_ind_x_2:
-        case ROL_ind_x_2: case ROR_ind_x_2: case SBC_ind_x_2: case STA_ind_x_2:
-        case DCP_ind_x_2: case ISC_ind_x_2: case LAX_ind_x_2: case RLA_ind_x_2:
-        case RRA_ind_x_2: case SAX_ind_x_2: case SLO_ind_x_2: case SRE_ind_x_2:
+        MICRO_CASE(ADC_ind_x_2) MICRO_CASE(AND_ind_x_2) MICRO_CASE(ASL_ind_x_2) MICRO_CASE(CMP_ind_x_2)
+        MICRO_CASE(DEC_ind_x_2) MICRO_CASE(EOR_ind_x_2) MICRO_CASE(INC_ind_x_2) MICRO_CASE(LDA_ind_x_2)
+        MICRO_CASE(LDX_ind_x_2) MICRO_CASE(LDY_ind_x_2) MICRO_CASE(LSR_ind_x_2) MICRO_CASE(ORA_ind_x_2)
+        MICRO_CASE(ROL_ind_x_2) MICRO_CASE(ROR_ind_x_2) MICRO_CASE(SBC_ind_x_2) MICRO_CASE(STA_ind_x_2)
+        MICRO_CASE(DCP_ind_x_2) MICRO_CASE(ISC_ind_x_2) MICRO_CASE(LAX_ind_x_2) MICRO_CASE(RLA_ind_x_2)
+        MICRO_CASE(RRA_ind_x_2) MICRO_CASE(SAX_ind_x_2) MICRO_CASE(SLO_ind_x_2) MICRO_CASE(SRE_ind_x_2)
             
             IDLE_READ_FROM_ADDRESS_INDIRECT
             ADD_INDEX_X_INDIRECT
             CONTINUE
             
-        case ADC_ind_x_3: case AND_ind_x_3: case ASL_ind_x_3: case CMP_ind_x_3:
-        case DEC_ind_x_3: case EOR_ind_x_3: case INC_ind_x_3: case LDA_ind_x_3:
-        case LDX_ind_x_3: case LDY_ind_x_3: case LSR_ind_x_3: case ORA_ind_x_3:
-        case ROL_ind_x_3: case ROR_ind_x_3: case SBC_ind_x_3: case STA_ind_x_3:
-        case DCP_ind_x_3: case ISC_ind_x_3: case LAX_ind_x_3: case RLA_ind_x_3:
-        case RRA_ind_x_3: case SAX_ind_x_3: case SLO_ind_x_3: case SRE_ind_x_3:
+        MICRO_CASE(ADC_ind_x_3) MICRO_CASE(AND_ind_x_3) MICRO_CASE(ASL_ind_x_3) MICRO_CASE(CMP_ind_x_3)
+        MICRO_CASE(DEC_ind_x_3) MICRO_CASE(EOR_ind_x_3) MICRO_CASE(INC_ind_x_3) MICRO_CASE(LDA_ind_x_3)
+        MICRO_CASE(LDX_ind_x_3) MICRO_CASE(LDY_ind_x_3) MICRO_CASE(LSR_ind_x_3) MICRO_CASE(ORA_ind_x_3)
+        MICRO_CASE(ROL_ind_x_3) MICRO_CASE(ROR_ind_x_3) MICRO_CASE(SBC_ind_x_3) MICRO_CASE(STA_ind_x_3)
+        MICRO_CASE(DCP_ind_x_3) MICRO_CASE(ISC_ind_x_3) MICRO_CASE(LAX_ind_x_3) MICRO_CASE(RLA_ind_x_3)
+        MICRO_CASE(RRA_ind_x_3) MICRO_CASE(SAX_ind_x_3) MICRO_CASE(SLO_ind_x_3) MICRO_CASE(SRE_ind_x_3)
             
             FETCH_ADDR_LO_INDIRECT
             CONTINUE
             
-        case ADC_ind_x_4: case AND_ind_x_4: case ASL_ind_x_4: case CMP_ind_x_4:
-        case DEC_ind_x_4: case EOR_ind_x_4: case INC_ind_x_4: case LDA_ind_x_4:
-        case LDX_ind_x_4: case LDY_ind_x_4: case LSR_ind_x_4: case ORA_ind_x_4:
-        case ROL_ind_x_4: case ROR_ind_x_4: case SBC_ind_x_4: case STA_ind_x_4:
-        case DCP_ind_x_4: case ISC_ind_x_4: case LAX_ind_x_4: case RLA_ind_x_4:
-        case RRA_ind_x_4: case SAX_ind_x_4: case SLO_ind_x_4: case SRE_ind_x_4:
+        MICRO_CASE(ADC_ind_x_4) MICRO_CASE(AND_ind_x_4) MICRO_CASE(ASL_ind_x_4) MICRO_CASE(CMP_ind_x_4)
+        MICRO_CASE(DEC_ind_x_4) MICRO_CASE(EOR_ind_x_4) MICRO_CASE(INC_ind_x_4) MICRO_CASE(LDA_ind_x_4)
+        MICRO_CASE(LDX_ind_x_4) MICRO_CASE(LDY_ind_x_4) MICRO_CASE(LSR_ind_x_4) MICRO_CASE(ORA_ind_x_4)
+        MICRO_CASE(ROL_ind_x_4) MICRO_CASE(ROR_ind_x_4) MICRO_CASE(SBC_ind_x_4) MICRO_CASE(STA_ind_x_4)
+        MICRO_CASE(DCP_ind_x_4) MICRO_CASE(ISC_ind_x_4) MICRO_CASE(LAX_ind_x_4) MICRO_CASE(RLA_ind_x_4)
+        MICRO_CASE(RRA_ind_x_4) MICRO_CASE(SAX_ind_x_4) MICRO_CASE(SLO_ind_x_4) MICRO_CASE(SRE_ind_x_4)
             
             FETCH_ADDR_HI_INDIRECT
             CONTINUE
             
-        case ASL_ind_x_5: case DEC_ind_x_5: case INC_ind_x_5: case LSR_ind_x_5:
-        case ROL_ind_x_5: case ROR_ind_x_5: case DCP_ind_x_5: case ISC_ind_x_5:
-        case RLA_ind_x_5: case RRA_ind_x_5: case SLO_ind_x_5: case SRE_ind_x_5:
+        MICRO_CASE(ASL_ind_x_5) MICRO_CASE(DEC_ind_x_5) MICRO_CASE(INC_ind_x_5) MICRO_CASE(LSR_ind_x_5)
+        MICRO_CASE(ROL_ind_x_5) MICRO_CASE(ROR_ind_x_5) MICRO_CASE(DCP_ind_x_5) MICRO_CASE(ISC_ind_x_5)
+        MICRO_CASE(RLA_ind_x_5) MICRO_CASE(RRA_ind_x_5) MICRO_CASE(SLO_ind_x_5) MICRO_CASE(SRE_ind_x_5)
             
             READ_FROM_ADDRESS
             CONTINUE
@@ -870,43 +910,43 @@ CPU::executeOneCycle()
         // Adressing mode: Indirect Indexed (shared behavior)
         //
             
-        case ADC_ind_y: case AND_ind_y: case CMP_ind_y: case EOR_ind_y:
-        case LDA_ind_y: case LDX_ind_y: case LDY_ind_y: case LSR_ind_y:
-        case ORA_ind_y: case SBC_ind_y: case STA_ind_y: case DCP_ind_y:
-        case ISC_ind_y: case LAX_ind_y: case RLA_ind_y: case RRA_ind_y:
-        case SHA_ind_y: case SLO_ind_y: case SRE_ind_y:
+        MICRO_CASE(ADC_ind_y) MICRO_CASE(AND_ind_y) MICRO_CASE(CMP_ind_y) MICRO_CASE(EOR_ind_y)
+        MICRO_CASE(LDA_ind_y) MICRO_CASE(LDX_ind_y) MICRO_CASE(LDY_ind_y) MICRO_CASE(LSR_ind_y)
+        MICRO_CASE(ORA_ind_y) MICRO_CASE(SBC_ind_y) MICRO_CASE(STA_ind_y) MICRO_CASE(DCP_ind_y)
+        MICRO_CASE(ISC_ind_y) MICRO_CASE(LAX_ind_y) MICRO_CASE(RLA_ind_y) MICRO_CASE(RRA_ind_y)
+        MICRO_CASE(SHA_ind_y) MICRO_CASE(SLO_ind_y) MICRO_CASE(SRE_ind_y)
             
             FETCH_POINTER_ADDR
             CONTINUE
            
-        case ADC_ind_y_2: case AND_ind_y_2: case CMP_ind_y_2: case EOR_ind_y_2:
-        case LDA_ind_y_2: case LDX_ind_y_2: case LDY_ind_y_2: case LSR_ind_y_2:
-        case ORA_ind_y_2: case SBC_ind_y_2: case STA_ind_y_2: case DCP_ind_y_2:
-        case ISC_ind_y_2: case LAX_ind_y_2: case RLA_ind_y_2: case RRA_ind_y_2:
-        case SHA_ind_y_2: case SLO_ind_y_2: case SRE_ind_y_2:
+        MICRO_CASE(ADC_ind_y_2) MICRO_CASE(AND_ind_y_2) MICRO_CASE(CMP_ind_y_2) MICRO_CASE(EOR_ind_y_2)
+        MICRO_CASE(LDA_ind_y_2) MICRO_CASE(LDX_ind_y_2) MICRO_CASE(LDY_ind_y_2) MICRO_CASE(LSR_ind_y_2)
+        MICRO_CASE(ORA_ind_y_2) MICRO_CASE(SBC_ind_y_2) MICRO_CASE(STA_ind_y_2) MICRO_CASE(DCP_ind_y_2)
+        MICRO_CASE(ISC_ind_y_2) MICRO_CASE(LAX_ind_y_2) MICRO_CASE(RLA_ind_y_2) MICRO_CASE(RRA_ind_y_2)
+        MICRO_CASE(SHA_ind_y_2) MICRO_CASE(SLO_ind_y_2) MICRO_CASE(SRE_ind_y_2)
             
             FETCH_ADDR_LO_INDIRECT
             CONTINUE
             
-        case ADC_ind_y_3: case AND_ind_y_3: case CMP_ind_y_3: case EOR_ind_y_3:
-        case LDA_ind_y_3: case LDX_ind_y_3: case LDY_ind_y_3: case LSR_ind_y_3:
-        case ORA_ind_y_3: case SBC_ind_y_3: case STA_ind_y_3: case DCP_ind_y_3:
-        case ISC_ind_y_3: case LAX_ind_y_3: case RLA_ind_y_3: case RRA_ind_y_3:
-        case SHA_ind_y_3: case SLO_ind_y_3: case SRE_ind_y_3:
+        MICRO_CASE(ADC_ind_y_3) MICRO_CASE(AND_ind_y_3) MICRO_CASE(CMP_ind_y_3) MICRO_CASE(EOR_ind_y_3)
+        MICRO_CASE(LDA_ind_y_3) MICRO_CASE(LDX_ind_y_3) MICRO_CASE(LDY_ind_y_3) MICRO_CASE(LSR_ind_y_3)
+        MICRO_CASE(ORA_ind_y_3) MICRO_CASE(SBC_ind_y_3) MICRO_CASE(STA_ind_y_3) MICRO_CASE(DCP_ind_y_3)
+        MICRO_CASE(ISC_ind_y_3) MICRO_CASE(LAX_ind_y_3) MICRO_CASE(RLA_ind_y_3) MICRO_CASE(RRA_ind_y_3)
+        MICRO_CASE(SHA_ind_y_3) MICRO_CASE(SLO_ind_y_3) MICRO_CASE(SRE_ind_y_3)
             
             FETCH_ADDR_HI_INDIRECT
             ADD_INDEX_Y
             CONTINUE
         
-        case LSR_ind_y_4: case STA_ind_y_4: case DCP_ind_y_4: case ISC_ind_y_4:
-        case RLA_ind_y_4: case RRA_ind_y_4: case SLO_ind_y_4: case SRE_ind_y_4:
+        MICRO_CASE(LSR_ind_y_4) MICRO_CASE(STA_ind_y_4) MICRO_CASE(DCP_ind_y_4) MICRO_CASE(ISC_ind_y_4)
+        MICRO_CASE(RLA_ind_y_4) MICRO_CASE(RRA_ind_y_4) MICRO_CASE(SLO_ind_y_4) MICRO_CASE(SRE_ind_y_4)
             
             READ_FROM_ADDRESS
             if (PAGE_BOUNDARY_CROSSED) { FIX_ADDR_HI }
             CONTINUE
             
-        case LSR_ind_y_5: case DCP_ind_y_5: case ISC_ind_y_5: case RLA_ind_y_5:
-        case RRA_ind_y_5: case SLO_ind_y_5: case SRE_ind_y_5:
+        MICRO_CASE(LSR_ind_y_5) MICRO_CASE(DCP_ind_y_5) MICRO_CASE(ISC_ind_y_5) MICRO_CASE(RLA_ind_y_5)
+        MICRO_CASE(RRA_ind_y_5) MICRO_CASE(SLO_ind_y_5) MICRO_CASE(SRE_ind_y_5)
             
             READ_FROM_ADDRESS
             CONTINUE
@@ -915,8 +955,8 @@ CPU::executeOneCycle()
         // Adressing mode: Relative (shared behavior)
         //
             
-        case BCC_rel_2: case BCS_rel_2: case BEQ_rel_2: case BMI_rel_2:
-        case BNE_rel_2: case BPL_rel_2: case BVC_rel_2: case BVS_rel_2:
+        MICRO_CASE(BCC_rel_2) MICRO_CASE(BCS_rel_2) MICRO_CASE(BEQ_rel_2) MICRO_CASE(BMI_rel_2)
+        MICRO_CASE(BNE_rel_2) MICRO_CASE(BPL_rel_2) MICRO_CASE(BVC_rel_2) MICRO_CASE(BVS_rel_2)
         {
             IDLE_READ_IMPLIED
             uint8_t pc_hi = HI_BYTE(regPC);
@@ -929,13 +969,13 @@ CPU::executeOneCycle()
             DONE
         }
             
-        case branch_3_underflow:
+        MICRO_CASE(branch_3_underflow)
             
             IDLE_READ_FROM(regPC + 0x100)
             POLL_INT_AGAIN
             DONE
             
-        case branch_3_overflow:
+        MICRO_CASE(branch_3_overflow)
             
             IDLE_READ_FROM(regPC - 0x100)
             POLL_INT_AGAIN
@@ -949,24 +989,24 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              / / / - - /
 
-        case ADC_imm:
+        MICRO_CASE(ADC_imm)
 
             READ_IMMEDIATE
             adc(regD);
             POLL_INT
             DONE
 
-        case ADC_zpg_2:
-        case ADC_zpg_x_3:
+        MICRO_CASE(ADC_zpg_2)
+        MICRO_CASE(ADC_zpg_x_3)
             
             READ_FROM_ZERO_PAGE
             adc(regD);
             POLL_INT
             DONE
 
-        case ADC_abs_x_3:
-        case ADC_abs_y_3:
-        case ADC_ind_y_4:
+        MICRO_CASE(ADC_abs_x_3)
+        MICRO_CASE(ADC_abs_y_3)
+        MICRO_CASE(ADC_ind_y_4)
             
             READ_FROM_ADDRESS
             if (PAGE_BOUNDARY_CROSSED) {
@@ -978,11 +1018,11 @@ CPU::executeOneCycle()
                 DONE
             }
             
-        case ADC_abs_3:
-        case ADC_abs_x_4:
-        case ADC_abs_y_4:
-        case ADC_ind_x_5:
-        case ADC_ind_y_5:
+        MICRO_CASE(ADC_abs_3)
+        MICRO_CASE(ADC_abs_x_4)
+        MICRO_CASE(ADC_abs_y_4)
+        MICRO_CASE(ADC_ind_x_5)
+        MICRO_CASE(ADC_ind_y_5)
             
             READ_FROM_ADDRESS
             adc(regD);
@@ -997,24 +1037,24 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              / / - - - -
 
-        case AND_imm:
+        MICRO_CASE(AND_imm)
             
             READ_IMMEDIATE
             loadA(regA & regD);
             POLL_INT
             DONE
 
-        case AND_zpg_2:
-        case AND_zpg_x_3:
+        MICRO_CASE(AND_zpg_2)
+        MICRO_CASE(AND_zpg_x_3)
             
             READ_FROM_ZERO_PAGE
             loadA(regA & regD);
             POLL_INT
             DONE
             
-        case AND_abs_x_3:
-        case AND_abs_y_3:
-        case AND_ind_y_4:
+        MICRO_CASE(AND_abs_x_3)
+        MICRO_CASE(AND_abs_y_3)
+        MICRO_CASE(AND_ind_y_4)
             
             READ_FROM_ADDRESS
             if (PAGE_BOUNDARY_CROSSED) {
@@ -1026,11 +1066,11 @@ CPU::executeOneCycle()
                 DONE
             }
             
-        case AND_abs_3:
-        case AND_abs_x_4:
-        case AND_abs_y_4:
-        case AND_ind_x_5:
-        case AND_ind_y_5:
+        MICRO_CASE(AND_abs_3)
+        MICRO_CASE(AND_abs_x_4)
+        MICRO_CASE(AND_abs_y_4)
+        MICRO_CASE(AND_ind_x_5)
+        MICRO_CASE(AND_ind_y_5)
             
             READ_FROM_ADDRESS
             loadA(regA & regD);
@@ -1048,38 +1088,38 @@ CPU::executeOneCycle()
         #define DO_ASL_ACC setC(regA & 0x80); loadA(regA << 1);
         #define DO_ASL setC(regD & 0x80); regD = regD << 1;
 
-        case ASL_acc:
+        MICRO_CASE(ASL_acc)
             
             IDLE_READ_IMPLIED
             DO_ASL_ACC
             POLL_INT
             DONE
             
-        case ASL_zpg_3:
-        case ASL_zpg_x_4:
+        MICRO_CASE(ASL_zpg_3)
+        MICRO_CASE(ASL_zpg_x_4)
             
             WRITE_TO_ZERO_PAGE
             DO_ASL
             CONTINUE
            
-        case ASL_abs_4:
-        case ASL_abs_x_5:
-        case ASL_ind_x_6:
+        MICRO_CASE(ASL_abs_4)
+        MICRO_CASE(ASL_abs_x_5)
+        MICRO_CASE(ASL_ind_x_6)
             
             WRITE_TO_ADDRESS
             DO_ASL
             CONTINUE
             
-        case ASL_zpg_4:
-        case ASL_zpg_x_5:
+        MICRO_CASE(ASL_zpg_4)
+        MICRO_CASE(ASL_zpg_x_5)
             
             WRITE_TO_ZERO_PAGE_AND_SET_FLAGS
             POLL_INT
             DONE
             
-        case ASL_abs_5:
-        case ASL_abs_x_6:
-        case ASL_ind_x_7:
+        MICRO_CASE(ASL_abs_5)
+        MICRO_CASE(ASL_abs_x_6)
+        MICRO_CASE(ASL_ind_x_7)
             
             WRITE_TO_ADDRESS_AND_SET_FLAGS
             POLL_INT
@@ -1093,7 +1133,7 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              - - - - - -
     
-        case BCC_rel:
+        MICRO_CASE(BCC_rel)
             
             READ_IMMEDIATE
             POLL_INT
@@ -1112,7 +1152,7 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              - - - - - -
 
-        case BCS_rel:
+        MICRO_CASE(BCS_rel)
             
             READ_IMMEDIATE
             POLL_INT
@@ -1131,7 +1171,7 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              - - - - - -
             
-        case BEQ_rel:
+        MICRO_CASE(BEQ_rel)
             
             READ_IMMEDIATE
             POLL_INT
@@ -1150,7 +1190,7 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              / / - - - /
             
-        case BIT_zpg_2:
+        MICRO_CASE(BIT_zpg_2)
             
             READ_FROM_ZERO_PAGE
             setN(regD & 128);
@@ -1159,7 +1199,7 @@ CPU::executeOneCycle()
             POLL_INT
             DONE
 
-        case BIT_abs_3:
+        MICRO_CASE(BIT_abs_3)
             
             READ_FROM_ADDRESS
             setN(regD & 128);
@@ -1176,7 +1216,7 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              - - - - - -
 
-        case BMI_rel:
+        MICRO_CASE(BMI_rel)
             
             READ_IMMEDIATE
             POLL_INT
@@ -1195,7 +1235,7 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              - - - - - -
             
-        case BNE_rel:
+        MICRO_CASE(BNE_rel)
             
             READ_IMMEDIATE
             POLL_INT
@@ -1214,7 +1254,7 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              - - - - - -
 
-        case BPL_rel:
+        MICRO_CASE(BPL_rel)
             
             READ_IMMEDIATE
             POLL_INT
@@ -1233,13 +1273,13 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V    B
         //              - - - 1 - -    1
             
-        case BRK_2:
+        MICRO_CASE(BRK_2)
             
             setB(1);
             PUSH_PCH
             CONTINUE
             
-        case BRK_3:
+        MICRO_CASE(BRK_3)
         
             PUSH_PCL
             
@@ -1256,19 +1296,19 @@ CPU::executeOneCycle()
                 CONTINUE
             }
             
-        case BRK_4:
+        MICRO_CASE(BRK_4)
             
             PUSH_P
             CONTINUE
             
-        case BRK_5:
+        MICRO_CASE(BRK_5)
             
             READ_FROM(0xFFFE);
             setPCL(regD);
             setI(1);
             CONTINUE
             
-        case BRK_6:
+        MICRO_CASE(BRK_6)
             
             READ_FROM(0xFFFF);
             setPCH(regD);
@@ -1278,19 +1318,19 @@ CPU::executeOneCycle()
                            // after a BRK command, but not NMIs.
             DONE
             
-        case BRK_nmi_4:
+        MICRO_CASE(BRK_nmi_4)
             
             PUSH_P
             CONTINUE
             
-        case BRK_nmi_5:
+        MICRO_CASE(BRK_nmi_5)
             
             READ_FROM(0xFFFA);
             setPCL(regD);
             setI(1);
             CONTINUE
             
-        case BRK_nmi_6:
+        MICRO_CASE(BRK_nmi_6)
             
             READ_FROM(0xFFFB);
             setPCH(regD);
@@ -1305,7 +1345,7 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              - - - - - -
 
-        case BVC_rel:
+        MICRO_CASE(BVC_rel)
             
             READ_IMMEDIATE
             POLL_INT
@@ -1324,7 +1364,7 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              - - - - - -
 
-        case BVS_rel:
+        MICRO_CASE(BVS_rel)
             
             READ_IMMEDIATE
             POLL_INT
@@ -1343,7 +1383,7 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              - - 0 - - -
 
-        case CLC:
+        MICRO_CASE(CLC)
             
             IDLE_READ_IMPLIED
             setC(0);
@@ -1358,7 +1398,7 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              - - - - 0 -
 
-        case CLD:
+        MICRO_CASE(CLD)
             
             IDLE_READ_IMPLIED
             setD(0);
@@ -1373,7 +1413,7 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              - - - 0 - -
 
-        case CLI:
+        MICRO_CASE(CLI)
             
             POLL_INT
             setI(0);
@@ -1388,7 +1428,7 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              - - - - - 0
 
-        case CLV:
+        MICRO_CASE(CLV)
             
             IDLE_READ_IMPLIED
             setV(0);
@@ -1403,24 +1443,24 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              / / / - - -
 
-        case CMP_imm:
+        MICRO_CASE(CMP_imm)
             
             READ_IMMEDIATE
             cmp(regA, regD);
             POLL_INT
             DONE
 
-        case CMP_zpg_2:
-        case CMP_zpg_x_3:
+        MICRO_CASE(CMP_zpg_2)
+        MICRO_CASE(CMP_zpg_x_3)
             
             READ_FROM_ZERO_PAGE
             cmp(regA, regD);
             POLL_INT
             DONE
 
-        case CMP_abs_x_3:
-        case CMP_abs_y_3:
-        case CMP_ind_y_4:
+        MICRO_CASE(CMP_abs_x_3)
+        MICRO_CASE(CMP_abs_y_3)
+        MICRO_CASE(CMP_ind_y_4)
             
             READ_FROM_ADDRESS
             if (PAGE_BOUNDARY_CROSSED) {
@@ -1432,11 +1472,11 @@ CPU::executeOneCycle()
                 DONE
             }
             
-        case CMP_abs_3:
-        case CMP_abs_x_4:
-        case CMP_abs_y_4:
-        case CMP_ind_x_5:
-        case CMP_ind_y_5:
+        MICRO_CASE(CMP_abs_3)
+        MICRO_CASE(CMP_abs_x_4)
+        MICRO_CASE(CMP_abs_y_4)
+        MICRO_CASE(CMP_ind_x_5)
+        MICRO_CASE(CMP_ind_y_5)
             
             READ_FROM_ADDRESS
             cmp(regA, regD);
@@ -1451,21 +1491,21 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              / / / - - -
 
-        case CPX_imm:
+        MICRO_CASE(CPX_imm)
             
             READ_IMMEDIATE
             cmp(regX, regD);
             POLL_INT
             DONE
             
-        case CPX_zpg_2:
+        MICRO_CASE(CPX_zpg_2)
             
             READ_FROM_ZERO_PAGE
             cmp(regX, regD);
             POLL_INT
             DONE
             
-        case CPX_abs_3:
+        MICRO_CASE(CPX_abs_3)
             
             READ_FROM_ADDRESS
             cmp(regX, regD);
@@ -1480,21 +1520,21 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              / / / - - -
 
-        case CPY_imm:
+        MICRO_CASE(CPY_imm)
             
             READ_IMMEDIATE
             cmp(regY, regD);
             POLL_INT
             DONE
 
-        case CPY_zpg_2:
+        MICRO_CASE(CPY_zpg_2)
             
             READ_FROM_ZERO_PAGE
             cmp(regY, regD);
             POLL_INT
             DONE
 
-        case CPY_abs_3:
+        MICRO_CASE(CPY_abs_3)
             
             READ_FROM_ADDRESS
             cmp(regY, regD);
@@ -1511,31 +1551,31 @@ CPU::executeOneCycle()
             
         #define DO_DEC regD--;
             
-        case DEC_zpg_3:
-        case DEC_zpg_x_4:
+        MICRO_CASE(DEC_zpg_3)
+        MICRO_CASE(DEC_zpg_x_4)
             
             WRITE_TO_ZERO_PAGE
             DO_DEC
             CONTINUE
             
-        case DEC_zpg_4:
-        case DEC_zpg_x_5:
+        MICRO_CASE(DEC_zpg_4)
+        MICRO_CASE(DEC_zpg_x_5)
             
             WRITE_TO_ZERO_PAGE_AND_SET_FLAGS
             POLL_INT
             DONE
             
-        case DEC_abs_4:
-        case DEC_abs_x_5:
-        case DEC_ind_x_6:
+        MICRO_CASE(DEC_abs_4)
+        MICRO_CASE(DEC_abs_x_5)
+        MICRO_CASE(DEC_ind_x_6)
             
             WRITE_TO_ADDRESS
             DO_DEC
             CONTINUE
             
-        case DEC_abs_5:
-        case DEC_abs_x_6:
-        case DEC_ind_x_7:
+        MICRO_CASE(DEC_abs_5)
+        MICRO_CASE(DEC_abs_x_6)
+        MICRO_CASE(DEC_ind_x_7)
             
             WRITE_TO_ADDRESS_AND_SET_FLAGS
             POLL_INT
@@ -1549,7 +1589,7 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              / / - - - -
 
-        case DEX:
+        MICRO_CASE(DEX)
             
             IDLE_READ_IMPLIED
             loadX(regX - 1);
@@ -1564,7 +1604,7 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              / / - - - -
 
-        case DEY:
+        MICRO_CASE(DEY)
             
             IDLE_READ_IMPLIED
             loadY(regY - 1);
@@ -1581,24 +1621,24 @@ CPU::executeOneCycle()
 
         #define DO_EOR loadA(regA ^ regD);
             
-        case EOR_imm:
+        MICRO_CASE(EOR_imm)
             
             READ_IMMEDIATE
             DO_EOR
             POLL_INT
             DONE
             
-        case EOR_zpg_2:
-        case EOR_zpg_x_3:
+        MICRO_CASE(EOR_zpg_2)
+        MICRO_CASE(EOR_zpg_x_3)
             
             READ_FROM_ZERO_PAGE
             DO_EOR
             POLL_INT
             DONE
             
-        case EOR_abs_x_3:
-        case EOR_abs_y_3:
-        case EOR_ind_y_4:
+        MICRO_CASE(EOR_abs_x_3)
+        MICRO_CASE(EOR_abs_y_3)
+        MICRO_CASE(EOR_ind_y_4)
             
             READ_FROM_ADDRESS
             if (PAGE_BOUNDARY_CROSSED) {
@@ -1610,11 +1650,11 @@ CPU::executeOneCycle()
                 DONE
             }
 
-        case EOR_abs_3:
-        case EOR_abs_x_4:
-        case EOR_abs_y_4:
-        case EOR_ind_x_5:
-        case EOR_ind_y_5:
+        MICRO_CASE(EOR_abs_3)
+        MICRO_CASE(EOR_abs_x_4)
+        MICRO_CASE(EOR_abs_y_4)
+        MICRO_CASE(EOR_ind_x_5)
+        MICRO_CASE(EOR_ind_y_5)
             
             READ_FROM_ADDRESS
             DO_EOR
@@ -1631,31 +1671,31 @@ CPU::executeOneCycle()
             
         #define DO_INC regD++;
             
-        case INC_zpg_3:
-        case INC_zpg_x_4:
+        MICRO_CASE(INC_zpg_3)
+        MICRO_CASE(INC_zpg_x_4)
             
             WRITE_TO_ZERO_PAGE
             DO_INC
             CONTINUE
             
-        case INC_zpg_4:
-        case INC_zpg_x_5:
+        MICRO_CASE(INC_zpg_4)
+        MICRO_CASE(INC_zpg_x_5)
             
             WRITE_TO_ZERO_PAGE_AND_SET_FLAGS
             POLL_INT
             DONE
           
-        case INC_abs_4:
-        case INC_abs_x_5:
-        case INC_ind_x_6:
+        MICRO_CASE(INC_abs_4)
+        MICRO_CASE(INC_abs_x_5)
+        MICRO_CASE(INC_ind_x_6)
             
             WRITE_TO_ADDRESS
             DO_INC
             CONTINUE
             
-        case INC_abs_5:
-        case INC_abs_x_6:
-        case INC_ind_x_7:
+        MICRO_CASE(INC_abs_5)
+        MICRO_CASE(INC_abs_x_6)
+        MICRO_CASE(INC_ind_x_7)
             
             WRITE_TO_ADDRESS_AND_SET_FLAGS
             POLL_INT
@@ -1669,7 +1709,7 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              / / - - - -
 
-        case INX:
+        MICRO_CASE(INX)
             
             IDLE_READ_IMPLIED
             loadX(regX + 1);
@@ -1684,7 +1724,7 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              / / - - - -
 
-        case INY:
+        MICRO_CASE(INY)
             
             IDLE_READ_IMPLIED
             loadY(regY + 1);
@@ -1699,36 +1739,36 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              - - - - - -
           
-        case JMP_abs:
+        MICRO_CASE(JMP_abs)
             
             FETCH_ADDR_LO
             CONTINUE
             
-        case JMP_abs_2:
+        MICRO_CASE(JMP_abs_2)
             
             FETCH_ADDR_HI
             regPC = LO_HI(regADL, regADH);
             POLL_INT
             DONE
 
-        case JMP_abs_ind:
+        MICRO_CASE(JMP_abs_ind)
             
             FETCH_ADDR_LO
             CONTINUE
             
-        case JMP_abs_ind_2:
+        MICRO_CASE(JMP_abs_ind_2)
             
             FETCH_ADDR_HI
             CONTINUE
             
-        case JMP_abs_ind_3:
+        MICRO_CASE(JMP_abs_ind_3)
             
             READ_FROM_ADDRESS
             setPCL(regD);
             regADL++;
             CONTINUE
             
-        case JMP_abs_ind_4:
+        MICRO_CASE(JMP_abs_ind_4)
             
             READ_FROM_ADDRESS
             setPCH(regD);
@@ -1743,27 +1783,27 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              - - - - - -
             
-        case JSR:
+        MICRO_CASE(JSR)
             
             FETCH_ADDR_LO
             CONTINUE
             
-        case JSR_2:
+        MICRO_CASE(JSR_2)
             
             IDLE_PULL
             CONTINUE
             
-        case JSR_3:
+        MICRO_CASE(JSR_3)
             
             PUSH_PCH
             CONTINUE
             
-        case JSR_4:
+        MICRO_CASE(JSR_4)
             
             PUSH_PCL
             CONTINUE
             
-        case JSR_5:
+        MICRO_CASE(JSR_5)
             
             FETCH_ADDR_HI
             regPC = LO_HI(regADL, regADH);
@@ -1778,24 +1818,24 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              / / - - - -
 
-        case LDA_imm:
+        MICRO_CASE(LDA_imm)
             
             READ_IMMEDIATE
             loadA(regD);
             POLL_INT
             DONE
 
-        case LDA_zpg_2:
-        case LDA_zpg_x_3:
+        MICRO_CASE(LDA_zpg_2)
+        MICRO_CASE(LDA_zpg_x_3)
             
             READ_FROM_ZERO_PAGE
             loadA(regD);
             POLL_INT
             DONE
           
-        case LDA_abs_x_3:
-        case LDA_abs_y_3:
-        case LDA_ind_y_4:
+        MICRO_CASE(LDA_abs_x_3)
+        MICRO_CASE(LDA_abs_y_3)
+        MICRO_CASE(LDA_ind_y_4)
             
             READ_FROM_ADDRESS
             if (PAGE_BOUNDARY_CROSSED) {
@@ -1807,11 +1847,11 @@ CPU::executeOneCycle()
                 DONE
             }
             
-        case LDA_abs_3:
-        case LDA_abs_x_4:
-        case LDA_abs_y_4:
-        case LDA_ind_x_5:
-        case LDA_ind_y_5:
+        MICRO_CASE(LDA_abs_3)
+        MICRO_CASE(LDA_abs_x_4)
+        MICRO_CASE(LDA_abs_y_4)
+        MICRO_CASE(LDA_ind_x_5)
+        MICRO_CASE(LDA_ind_y_5)
             
             READ_FROM_ADDRESS
             loadA(regD);
@@ -1826,23 +1866,23 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              / / - - - -
 
-        case LDX_imm:
+        MICRO_CASE(LDX_imm)
             
             READ_IMMEDIATE
             loadX(regD);
             POLL_INT
             DONE
 
-        case LDX_zpg_2:
-        case LDX_zpg_y_3:
+        MICRO_CASE(LDX_zpg_2)
+        MICRO_CASE(LDX_zpg_y_3)
             
             READ_FROM_ZERO_PAGE
             loadX(regD);
             POLL_INT
             DONE
 
-        case LDX_abs_y_3:
-        case LDX_ind_y_4:
+        MICRO_CASE(LDX_abs_y_3)
+        MICRO_CASE(LDX_ind_y_4)
             
             READ_FROM_ADDRESS
             if (PAGE_BOUNDARY_CROSSED) {
@@ -1854,10 +1894,10 @@ CPU::executeOneCycle()
                 DONE
             }
             
-        case LDX_abs_3:
-        case LDX_abs_y_4:
-        case LDX_ind_x_5:
-        case LDX_ind_y_5:
+        MICRO_CASE(LDX_abs_3)
+        MICRO_CASE(LDX_abs_y_4)
+        MICRO_CASE(LDX_ind_x_5)
+        MICRO_CASE(LDX_ind_y_5)
             
             READ_FROM_ADDRESS
             loadX(regD);
@@ -1872,23 +1912,23 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              / / - - - -
  
-        case LDY_imm:
+        MICRO_CASE(LDY_imm)
             
             READ_IMMEDIATE
             loadY(regD);
             POLL_INT
             DONE
             
-        case LDY_zpg_2:
-        case LDY_zpg_x_3:
+        MICRO_CASE(LDY_zpg_2)
+        MICRO_CASE(LDY_zpg_x_3)
             
             READ_FROM_ZERO_PAGE
             loadY(regD);
             POLL_INT
             DONE
 
-        case LDY_abs_x_3:
-        case LDY_ind_y_4:
+        MICRO_CASE(LDY_abs_x_3)
+        MICRO_CASE(LDY_ind_y_4)
             
             READ_FROM_ADDRESS
             if (PAGE_BOUNDARY_CROSSED) {
@@ -1900,10 +1940,10 @@ CPU::executeOneCycle()
                 DONE
             }
 
-        case LDY_abs_3:
-        case LDY_abs_x_4:
-        case LDY_ind_x_5:
-        case LDY_ind_y_5:
+        MICRO_CASE(LDY_abs_3)
+        MICRO_CASE(LDY_abs_x_4)
+        MICRO_CASE(LDY_ind_x_5)
+        MICRO_CASE(LDY_ind_y_5)
             
             READ_FROM_ADDRESS
             loadY(regD);
@@ -1918,42 +1958,42 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              0 / / - - -
 
-        case LSR_acc:
+        MICRO_CASE(LSR_acc)
             
             IDLE_READ_IMPLIED
             setC(regA & 1); loadA(regA >> 1);
             POLL_INT
             DONE
 
-        case LSR_zpg_3:
-        case LSR_zpg_x_4:
+        MICRO_CASE(LSR_zpg_3)
+        MICRO_CASE(LSR_zpg_x_4)
             
             WRITE_TO_ZERO_PAGE
             setC(regD & 1); regD = regD >> 1;
             CONTINUE
             
-        case LSR_zpg_4:
-        case LSR_zpg_x_5:
+        MICRO_CASE(LSR_zpg_4)
+        MICRO_CASE(LSR_zpg_x_5)
             
             WRITE_TO_ZERO_PAGE_AND_SET_FLAGS
             POLL_INT
             DONE
             
-        case LSR_abs_4:
-        case LSR_abs_x_5:
-        case LSR_abs_y_5:
-        case LSR_ind_x_6:
-        case LSR_ind_y_6:
+        MICRO_CASE(LSR_abs_4)
+        MICRO_CASE(LSR_abs_x_5)
+        MICRO_CASE(LSR_abs_y_5)
+        MICRO_CASE(LSR_ind_x_6)
+        MICRO_CASE(LSR_ind_y_6)
             
             WRITE_TO_ADDRESS
             setC(regD & 1); regD = regD >> 1;
             CONTINUE
             
-        case LSR_abs_5:
-        case LSR_abs_x_6:
-        case LSR_abs_y_6:
-        case LSR_ind_x_7:
-        case LSR_ind_y_7:
+        MICRO_CASE(LSR_abs_5)
+        MICRO_CASE(LSR_abs_x_6)
+        MICRO_CASE(LSR_abs_y_6)
+        MICRO_CASE(LSR_ind_x_7)
+        MICRO_CASE(LSR_ind_y_7)
             
             WRITE_TO_ADDRESS_AND_SET_FLAGS
             POLL_INT
@@ -1967,26 +2007,26 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              - - - - - -
 
-        case NOP:
+        MICRO_CASE(NOP)
             
             IDLE_READ_IMPLIED
             POLL_INT
             DONE
 
-        case NOP_imm:
+        MICRO_CASE(NOP_imm)
             
             IDLE_READ_IMMEDIATE
             POLL_INT
             DONE
 
-        case NOP_zpg_2:
-        case NOP_zpg_x_3:
+        MICRO_CASE(NOP_zpg_2)
+        MICRO_CASE(NOP_zpg_x_3)
             
             IDLE_READ_FROM_ZERO_PAGE
             POLL_INT
             DONE
             
-        case NOP_abs_x_3:
+        MICRO_CASE(NOP_abs_x_3)
             
             IDLE_READ_FROM_ADDRESS
             if (PAGE_BOUNDARY_CROSSED) {
@@ -1997,8 +2037,8 @@ CPU::executeOneCycle()
                 DONE
             }
             
-        case NOP_abs_3:
-        case NOP_abs_x_4:
+        MICRO_CASE(NOP_abs_3)
+        MICRO_CASE(NOP_abs_x_4)
             
             IDLE_READ_FROM_ADDRESS
             POLL_INT
@@ -2012,24 +2052,24 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              / / - - - -
 
-        case ORA_imm:
+        MICRO_CASE(ORA_imm)
             
             READ_IMMEDIATE
             loadA(regA | regD);
             POLL_INT
             DONE
             
-        case ORA_zpg_2:
-        case ORA_zpg_x_3:
+        MICRO_CASE(ORA_zpg_2)
+        MICRO_CASE(ORA_zpg_x_3)
             
             READ_FROM_ZERO_PAGE
             loadA(regA | regD);
             POLL_INT
             DONE
 
-        case ORA_abs_x_3:
-        case ORA_abs_y_3:
-        case ORA_ind_y_4:
+        MICRO_CASE(ORA_abs_x_3)
+        MICRO_CASE(ORA_abs_y_3)
+        MICRO_CASE(ORA_ind_y_4)
             
             READ_FROM_ADDRESS
             if (PAGE_BOUNDARY_CROSSED) {
@@ -2041,11 +2081,11 @@ CPU::executeOneCycle()
                 DONE
             }
             
-        case ORA_abs_3:
-        case ORA_abs_x_4:
-        case ORA_abs_y_4:
-        case ORA_ind_x_5:
-        case ORA_ind_y_5:
+        MICRO_CASE(ORA_abs_3)
+        MICRO_CASE(ORA_abs_x_4)
+        MICRO_CASE(ORA_abs_y_4)
+        MICRO_CASE(ORA_ind_x_5)
+        MICRO_CASE(ORA_ind_y_5)
             
             READ_FROM_ADDRESS
             loadA(regA | regD);
@@ -2060,7 +2100,7 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              - - - - - -
             
-        case PHA_2:
+        MICRO_CASE(PHA_2)
             
             PUSH_A
             POLL_INT
@@ -2074,7 +2114,7 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              - - - - - -
             
-        case PHP_2:
+        MICRO_CASE(PHP_2)
             
             PUSH_P
             POLL_INT
@@ -2088,12 +2128,12 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              - - - - - -
             
-        case PLA_2:
+        MICRO_CASE(PLA_2)
             
             regSP++;
             CONTINUE
             
-        case PLA_3:
+        MICRO_CASE(PLA_3)
             
             PULL_A
             POLL_INT
@@ -2107,13 +2147,13 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              / / / / / /
             
-        case PLP_2:
+        MICRO_CASE(PLP_2)
 
             IDLE_PULL
             regSP++;
             CONTINUE
             
-        case PLP_3:
+        MICRO_CASE(PLP_3)
 
             POLL_INT // Interrupts are polled before P is pulled
             PULL_P
@@ -2132,38 +2172,38 @@ CPU::executeOneCycle()
         #define DO_ROL_ACC { int c = !!getC(); setC(regA & 0x80); loadA((regA << 1) | c); }
         #define DO_ROL { int c = !!getC(); setC(regD & 0x80); regD = (regD << 1) | c; }
 
-        case ROL_acc:
+        MICRO_CASE(ROL_acc)
             
             IDLE_READ_IMPLIED
             DO_ROL_ACC
             POLL_INT
             DONE
             
-        case ROL_zpg_3:
-        case ROL_zpg_x_4:
+        MICRO_CASE(ROL_zpg_3)
+        MICRO_CASE(ROL_zpg_x_4)
             
             WRITE_TO_ZERO_PAGE
             DO_ROL
             CONTINUE
             
-        case ROL_zpg_4:
-        case ROL_zpg_x_5:
+        MICRO_CASE(ROL_zpg_4)
+        MICRO_CASE(ROL_zpg_x_5)
             
             WRITE_TO_ZERO_PAGE_AND_SET_FLAGS
             POLL_INT
             DONE
             
-        case ROL_abs_4:
-        case ROL_abs_x_5:
-        case ROL_ind_x_6:
+        MICRO_CASE(ROL_abs_4)
+        MICRO_CASE(ROL_abs_x_5)
+        MICRO_CASE(ROL_ind_x_6)
             
             WRITE_TO_ADDRESS
             DO_ROL
             CONTINUE
             
-        case ROL_abs_5:
-        case ROL_abs_x_6:
-        case ROL_ind_x_7:
+        MICRO_CASE(ROL_abs_5)
+        MICRO_CASE(ROL_abs_x_6)
+        MICRO_CASE(ROL_ind_x_7)
             
             WRITE_TO_ADDRESS_AND_SET_FLAGS
             POLL_INT
@@ -2182,38 +2222,38 @@ CPU::executeOneCycle()
         #define DO_ROR_ACC { int c = !!getC(); setC(regA & 0x1); loadA((regA >> 1) | (c << 7)); }
         #define DO_ROR { int c = !!getC(); setC(regD & 0x1); regD = (regD >> 1) | (c << 7); }
             
-        case ROR_acc:
+        MICRO_CASE(ROR_acc)
             
             IDLE_READ_IMPLIED
             DO_ROR_ACC
             POLL_INT
             DONE
             
-        case ROR_zpg_3:
-        case ROR_zpg_x_4:
+        MICRO_CASE(ROR_zpg_3)
+        MICRO_CASE(ROR_zpg_x_4)
             
             WRITE_TO_ZERO_PAGE
             DO_ROR
             CONTINUE
             
-        case ROR_zpg_4:
-        case ROR_zpg_x_5:
+        MICRO_CASE(ROR_zpg_4)
+        MICRO_CASE(ROR_zpg_x_5)
             
             WRITE_TO_ZERO_PAGE_AND_SET_FLAGS
             POLL_INT
             DONE
             
-        case ROR_abs_4:
-        case ROR_abs_x_5:
-        case ROR_ind_x_6:
+        MICRO_CASE(ROR_abs_4)
+        MICRO_CASE(ROR_abs_x_5)
+        MICRO_CASE(ROR_ind_x_6)
             
             WRITE_TO_ADDRESS
             DO_ROR
             CONTINUE
             
-        case ROR_abs_5:
-        case ROR_abs_x_6:
-        case ROR_ind_x_7:
+        MICRO_CASE(ROR_abs_5)
+        MICRO_CASE(ROR_abs_x_6)
+        MICRO_CASE(ROR_ind_x_7)
             
             WRITE_TO_ADDRESS_AND_SET_FLAGS
             POLL_INT
@@ -2227,25 +2267,25 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              / / / / / /
             
-        case RTI_2:
+        MICRO_CASE(RTI_2)
             
             IDLE_PULL
             regSP++;
             CONTINUE
             
-        case RTI_3:
+        MICRO_CASE(RTI_3)
             
             PULL_P
             regSP++;
             CONTINUE
             
-        case RTI_4:
+        MICRO_CASE(RTI_4)
             
             PULL_PCL
             regSP++;
             CONTINUE
             
-        case RTI_5:
+        MICRO_CASE(RTI_5)
             
             PULL_PCH
             POLL_INT
@@ -2259,24 +2299,24 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              - - - - - -
             
-        case RTS_2:
+        MICRO_CASE(RTS_2)
             
             IDLE_PULL
             regSP++;
             CONTINUE
             
-        case RTS_3:
+        MICRO_CASE(RTS_3)
             
             PULL_PCL
             regSP++;
             CONTINUE
             
-        case RTS_4:
+        MICRO_CASE(RTS_4)
             
             PULL_PCH
             CONTINUE
             
-        case RTS_5:
+        MICRO_CASE(RTS_5)
             
             IDLE_READ_IMMEDIATE
             POLL_INT
@@ -2290,24 +2330,24 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              / / / - - /
   
-        case SBC_imm:
+        MICRO_CASE(SBC_imm)
             
             READ_IMMEDIATE
             sbc(regD);
             POLL_INT
             DONE
             
-        case SBC_zpg_2:
-        case SBC_zpg_x_3:
+        MICRO_CASE(SBC_zpg_2)
+        MICRO_CASE(SBC_zpg_x_3)
             
             READ_FROM_ZERO_PAGE
             sbc(regD);
             POLL_INT
             DONE
             
-        case SBC_abs_x_3:
-        case SBC_abs_y_3:
-        case SBC_ind_y_4:
+        MICRO_CASE(SBC_abs_x_3)
+        MICRO_CASE(SBC_abs_y_3)
+        MICRO_CASE(SBC_ind_y_4)
             
             READ_FROM_ADDRESS
             if (PAGE_BOUNDARY_CROSSED) {
@@ -2319,11 +2359,11 @@ CPU::executeOneCycle()
                 DONE
             }
             
-        case SBC_abs_3:
-        case SBC_abs_x_4:
-        case SBC_abs_y_4:
-        case SBC_ind_x_5:
-        case SBC_ind_y_5:
+        MICRO_CASE(SBC_abs_3)
+        MICRO_CASE(SBC_abs_x_4)
+        MICRO_CASE(SBC_abs_y_4)
+        MICRO_CASE(SBC_ind_x_5)
+        MICRO_CASE(SBC_ind_y_5)
             
             READ_FROM_ADDRESS
             sbc(regD);
@@ -2338,7 +2378,7 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              - - 1 - - -
 
-        case SEC:
+        MICRO_CASE(SEC)
             
             IDLE_READ_IMPLIED
             setC(1);
@@ -2353,7 +2393,7 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              - - - - 1 -
 
-        case SED:
+        MICRO_CASE(SED)
             
             IDLE_READ_IMPLIED
             setD(1);
@@ -2368,12 +2408,12 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              - - - 1 - -
 
-        case SEI:
+        MICRO_CASE(SEI)
             
             POLL_IRQ
             setI(1);
             
-        case SEI_cont: // fallthrough
+        MICRO_CASE(SEI_cont) // fallthrough
             
             next = SEI_cont;
             IDLE_READ_IMPLIED
@@ -2388,25 +2428,25 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              - - - - - -
             
-        case STA_zpg_2:
-        case STA_zpg_x_3:
+        MICRO_CASE(STA_zpg_2)
+        MICRO_CASE(STA_zpg_x_3)
             
             regD = regA;
             WRITE_TO_ZERO_PAGE
             POLL_INT
             DONE
             
-        case STA_abs_3:
-        case STA_abs_x_4:
+        MICRO_CASE(STA_abs_3)
+        MICRO_CASE(STA_abs_x_4)
             
             regD = regA;
             WRITE_TO_ADDRESS
             POLL_INT
             DONE
             
-        case STA_abs_y_4:
-        case STA_ind_x_5:
-        case STA_ind_y_5:
+        MICRO_CASE(STA_abs_y_4)
+        MICRO_CASE(STA_ind_x_5)
+        MICRO_CASE(STA_ind_y_5)
             
             regD = regA;
             WRITE_TO_ADDRESS
@@ -2421,15 +2461,15 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              - - - - - -
             
-        case STX_zpg_2:
-        case STX_zpg_y_3:
+        MICRO_CASE(STX_zpg_2)
+        MICRO_CASE(STX_zpg_y_3)
             
             regD = regX;
             WRITE_TO_ZERO_PAGE
             POLL_INT
             DONE
             
-        case STX_abs_3:
+        MICRO_CASE(STX_abs_3)
             
             regD = regX;
             WRITE_TO_ADDRESS
@@ -2444,15 +2484,15 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              - - - - - -
             
-        case STY_zpg_2:
-        case STY_zpg_x_3:
+        MICRO_CASE(STY_zpg_2)
+        MICRO_CASE(STY_zpg_x_3)
             
             regD = regY;
             WRITE_TO_ZERO_PAGE
             POLL_INT
             DONE
             
-        case STY_abs_3:
+        MICRO_CASE(STY_abs_3)
             
             regD = regY;
             WRITE_TO_ADDRESS
@@ -2467,7 +2507,7 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              / / - - - -
 
-        case TAX:
+        MICRO_CASE(TAX)
             
             IDLE_READ_IMPLIED
             loadX(regA);
@@ -2482,7 +2522,7 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              / / - - - -
 
-        case TAY:
+        MICRO_CASE(TAY)
             
             IDLE_READ_IMPLIED
             loadY(regA);
@@ -2497,7 +2537,7 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              / / - - - -
 
-        case TSX:
+        MICRO_CASE(TSX)
             
             IDLE_READ_IMPLIED
             loadX(regSP);
@@ -2512,7 +2552,7 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              / / - - - -
 
-        case TXA:
+        MICRO_CASE(TXA)
             
             IDLE_READ_IMPLIED
             loadA(regX);
@@ -2527,7 +2567,7 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              - - - - - -
 
-        case TXS:
+        MICRO_CASE(TXS)
             
             IDLE_READ_IMPLIED
             regSP = regX;
@@ -2542,7 +2582,7 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              / / - - - -
 
-        case TYA:
+        MICRO_CASE(TYA)
             
             IDLE_READ_IMPLIED
             loadA(regY);
@@ -2562,7 +2602,7 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              / / / - - -
 
-        case ALR_imm:
+        MICRO_CASE(ALR_imm)
             
             READ_IMMEDIATE
             regA = regA & regD;
@@ -2579,7 +2619,7 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              / / / - - -
 
-        case ANC_imm:
+        MICRO_CASE(ANC_imm)
             
             READ_IMMEDIATE
             loadA(regA & regD);
@@ -2595,7 +2635,7 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              / / / - - /
 
-        case ARR_imm:
+        MICRO_CASE(ARR_imm)
         {
             READ_IMMEDIATE
             
@@ -2636,7 +2676,7 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              / / / - - -
 
-        case AXS_imm:
+        MICRO_CASE(AXS_imm)
         {
             READ_IMMEDIATE
             
@@ -2657,36 +2697,36 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              / / / - - -
             
-        case DCP_zpg_3:
-        case DCP_zpg_x_4:
+        MICRO_CASE(DCP_zpg_3)
+        MICRO_CASE(DCP_zpg_x_4)
             
             WRITE_TO_ZERO_PAGE
             regD--;
             CONTINUE
             
-        case DCP_zpg_4:
-        case DCP_zpg_x_5:
+        MICRO_CASE(DCP_zpg_4)
+        MICRO_CASE(DCP_zpg_x_5)
             
             WRITE_TO_ZERO_PAGE_AND_SET_FLAGS
             cmp(regA, regD);
             POLL_INT
             DONE
             
-        case DCP_abs_4:
-        case DCP_abs_x_5:
-        case DCP_abs_y_5:
-        case DCP_ind_x_6:
-        case DCP_ind_y_6:
+        MICRO_CASE(DCP_abs_4)
+        MICRO_CASE(DCP_abs_x_5)
+        MICRO_CASE(DCP_abs_y_5)
+        MICRO_CASE(DCP_ind_x_6)
+        MICRO_CASE(DCP_ind_y_6)
             
             WRITE_TO_ADDRESS
             regD--;
             CONTINUE
             
-        case DCP_abs_5:
-        case DCP_abs_x_6:
-        case DCP_abs_y_6:
-        case DCP_ind_x_7:
-        case DCP_ind_y_7:
+        MICRO_CASE(DCP_abs_5)
+        MICRO_CASE(DCP_abs_x_6)
+        MICRO_CASE(DCP_abs_y_6)
+        MICRO_CASE(DCP_ind_x_7)
+        MICRO_CASE(DCP_ind_y_7)
             
             WRITE_TO_ADDRESS_AND_SET_FLAGS
             cmp(regA, regD);
@@ -2701,36 +2741,36 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              / / / - - /
             
-        case ISC_zpg_3:
-        case ISC_zpg_x_4:
+        MICRO_CASE(ISC_zpg_3)
+        MICRO_CASE(ISC_zpg_x_4)
             
             WRITE_TO_ZERO_PAGE
             regD++;
             CONTINUE
             
-        case ISC_zpg_4:
-        case ISC_zpg_x_5:
+        MICRO_CASE(ISC_zpg_4)
+        MICRO_CASE(ISC_zpg_x_5)
             
             WRITE_TO_ZERO_PAGE_AND_SET_FLAGS
             sbc(regD);
             POLL_INT
             DONE
 
-        case ISC_abs_4:
-        case ISC_abs_x_5:
-        case ISC_abs_y_5:
-        case ISC_ind_x_6:
-        case ISC_ind_y_6:
+        MICRO_CASE(ISC_abs_4)
+        MICRO_CASE(ISC_abs_x_5)
+        MICRO_CASE(ISC_abs_y_5)
+        MICRO_CASE(ISC_ind_x_6)
+        MICRO_CASE(ISC_ind_y_6)
             
             WRITE_TO_ADDRESS
             regD++;
             CONTINUE
             
-        case ISC_abs_5:
-        case ISC_abs_x_6:
-        case ISC_abs_y_6:
-        case ISC_ind_x_7:
-        case ISC_ind_y_7:
+        MICRO_CASE(ISC_abs_5)
+        MICRO_CASE(ISC_abs_x_6)
+        MICRO_CASE(ISC_abs_y_6)
+        MICRO_CASE(ISC_ind_x_7)
+        MICRO_CASE(ISC_ind_y_7)
             
             WRITE_TO_ADDRESS_AND_SET_FLAGS
             sbc(regD);
@@ -2745,7 +2785,7 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              / / - - - -
             
-        case LAS_abs_y_3:
+        MICRO_CASE(LAS_abs_y_3)
             
             READ_FROM_ADDRESS
             if (PAGE_BOUNDARY_CROSSED) {
@@ -2760,7 +2800,7 @@ CPU::executeOneCycle()
                 DONE
             }
             
-        case LAS_abs_y_4:
+        MICRO_CASE(LAS_abs_y_4)
             
             READ_FROM_ADDRESS
             regD &= regSP;
@@ -2778,8 +2818,8 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              / / - - - -
             
-        case LAX_zpg_2:
-        case LAX_zpg_y_3:
+        MICRO_CASE(LAX_zpg_2)
+        MICRO_CASE(LAX_zpg_y_3)
             
             READ_FROM_ZERO_PAGE
             loadA(regD);
@@ -2787,8 +2827,8 @@ CPU::executeOneCycle()
             POLL_INT
             DONE
             
-        case LAX_abs_y_3:
-        case LAX_ind_y_4:
+        MICRO_CASE(LAX_abs_y_3)
+        MICRO_CASE(LAX_ind_y_4)
             
             READ_FROM_ADDRESS
             if (PAGE_BOUNDARY_CROSSED) {
@@ -2801,10 +2841,10 @@ CPU::executeOneCycle()
                 DONE
             }
             
-        case LAX_abs_3:
-        case LAX_abs_y_4:
-        case LAX_ind_x_5:
-        case LAX_ind_y_5:
+        MICRO_CASE(LAX_abs_3)
+        MICRO_CASE(LAX_abs_y_4)
+        MICRO_CASE(LAX_ind_x_5)
+        MICRO_CASE(LAX_ind_y_5)
             
             READ_FROM_ADDRESS;
             loadA(regD);
@@ -2820,36 +2860,36 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              / / / - - -
             
-        case RLA_zpg_3:
-        case RLA_zpg_x_4:
+        MICRO_CASE(RLA_zpg_3)
+        MICRO_CASE(RLA_zpg_x_4)
             
             WRITE_TO_ZERO_PAGE
             DO_ROL
             CONTINUE
             
-        case RLA_zpg_4:
-        case RLA_zpg_x_5:
+        MICRO_CASE(RLA_zpg_4)
+        MICRO_CASE(RLA_zpg_x_5)
             
             WRITE_TO_ZERO_PAGE
             loadA(regA & regD);
             POLL_INT
             DONE
             
-        case RLA_abs_4:
-        case RLA_abs_x_5:
-        case RLA_abs_y_5:
-        case RLA_ind_x_6:
-        case RLA_ind_y_6:
+        MICRO_CASE(RLA_abs_4)
+        MICRO_CASE(RLA_abs_x_5)
+        MICRO_CASE(RLA_abs_y_5)
+        MICRO_CASE(RLA_ind_x_6)
+        MICRO_CASE(RLA_ind_y_6)
             
             WRITE_TO_ADDRESS
             DO_ROL
             CONTINUE
             
-        case RLA_abs_5:
-        case RLA_abs_x_6:
-        case RLA_abs_y_6:
-        case RLA_ind_x_7:
-        case RLA_ind_y_7:
+        MICRO_CASE(RLA_abs_5)
+        MICRO_CASE(RLA_abs_x_6)
+        MICRO_CASE(RLA_abs_y_6)
+        MICRO_CASE(RLA_ind_x_7)
+        MICRO_CASE(RLA_ind_y_7)
             
             WRITE_TO_ADDRESS
             loadA(regA & regD);
@@ -2863,36 +2903,36 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              / / / - - /
             
-        case RRA_zpg_3:
-        case RRA_zpg_x_4:
+        MICRO_CASE(RRA_zpg_3)
+        MICRO_CASE(RRA_zpg_x_4)
             
             WRITE_TO_ZERO_PAGE
             DO_ROR
             CONTINUE
             
-        case RRA_zpg_4:
-        case RRA_zpg_x_5:
+        MICRO_CASE(RRA_zpg_4)
+        MICRO_CASE(RRA_zpg_x_5)
             
             WRITE_TO_ZERO_PAGE
             adc(regD);
             POLL_INT
             DONE
 
-        case RRA_abs_4:
-        case RRA_abs_x_5:
-        case RRA_abs_y_5:
-        case RRA_ind_x_6:
-        case RRA_ind_y_6:
+        MICRO_CASE(RRA_abs_4)
+        MICRO_CASE(RRA_abs_x_5)
+        MICRO_CASE(RRA_abs_y_5)
+        MICRO_CASE(RRA_ind_x_6)
+        MICRO_CASE(RRA_ind_y_6)
             
             WRITE_TO_ADDRESS
             DO_ROR
             CONTINUE
             
-        case RRA_abs_5:
-        case RRA_abs_x_6:
-        case RRA_abs_y_6:
-        case RRA_ind_x_7:
-        case RRA_ind_y_7:
+        MICRO_CASE(RRA_abs_5)
+        MICRO_CASE(RRA_abs_x_6)
+        MICRO_CASE(RRA_abs_y_6)
+        MICRO_CASE(RRA_ind_x_7)
+        MICRO_CASE(RRA_ind_y_7)
             
             WRITE_TO_ADDRESS
             adc(regD);
@@ -2907,16 +2947,16 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              - - - - - -
             
-        case SAX_zpg_2:
-        case SAX_zpg_y_3:
+        MICRO_CASE(SAX_zpg_2)
+        MICRO_CASE(SAX_zpg_y_3)
             
             regD = regA & regX;
             WRITE_TO_ZERO_PAGE
             POLL_INT
             DONE
 
-        case SAX_abs_3:
-        case SAX_ind_x_5:
+        MICRO_CASE(SAX_abs_3)
+        MICRO_CASE(SAX_ind_x_5)
             
             regD = regA & regX;
             WRITE_TO_ADDRESS
@@ -2931,7 +2971,7 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              - - - - - -
             
-        case SHA_abs_y_3:
+        MICRO_CASE(SHA_abs_y_3)
             
             IDLE_READ_FROM_ADDRESS
             
@@ -2954,13 +2994,13 @@ CPU::executeOneCycle()
             
             CONTINUE
             
-        case SHA_abs_y_4:
+        MICRO_CASE(SHA_abs_y_4)
             
             WRITE_TO_ADDRESS
             POLL_INT
             DONE
             
-        case SHA_ind_y_4:
+        MICRO_CASE(SHA_ind_y_4)
             
             IDLE_READ_FROM_ADDRESS
             
@@ -2983,7 +3023,7 @@ CPU::executeOneCycle()
 
             CONTINUE
             
-        case SHA_ind_y_5:
+        MICRO_CASE(SHA_ind_y_5)
             
             WRITE_TO_ADDRESS
             POLL_INT
@@ -2997,7 +3037,7 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              - - - - - -
        
-        case SHX_abs_y_3:
+        MICRO_CASE(SHX_abs_y_3)
             
             IDLE_READ_FROM_ADDRESS
             
@@ -3020,7 +3060,7 @@ CPU::executeOneCycle()
             
             CONTINUE
            
-        case SHX_abs_y_4:
+        MICRO_CASE(SHX_abs_y_4)
             
             WRITE_TO_ADDRESS
             POLL_INT
@@ -3034,7 +3074,7 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              - - - - - -
             
-        case SHY_abs_x_3:
+        MICRO_CASE(SHY_abs_x_3)
             
             IDLE_READ_FROM_ADDRESS
             
@@ -3057,7 +3097,7 @@ CPU::executeOneCycle()
 
             CONTINUE
             
-        case SHY_abs_x_4:
+        MICRO_CASE(SHY_abs_x_4)
             
             WRITE_TO_ADDRESS
             POLL_INT
@@ -3073,36 +3113,36 @@ CPU::executeOneCycle()
 
         #define DO_SLO setC(regD & 128); regD <<= 1;
 
-        case SLO_zpg_3:
-        case SLO_zpg_x_4:
+        MICRO_CASE(SLO_zpg_3)
+        MICRO_CASE(SLO_zpg_x_4)
             
             WRITE_TO_ZERO_PAGE
             DO_SLO
             CONTINUE
             
-        case SLO_zpg_4:
-        case SLO_zpg_x_5:
+        MICRO_CASE(SLO_zpg_4)
+        MICRO_CASE(SLO_zpg_x_5)
             
             WRITE_TO_ZERO_PAGE
             loadA(regA | regD);
             POLL_INT
             DONE
             
-        case SLO_abs_4:
-        case SLO_abs_x_5:
-        case SLO_abs_y_5:
-        case SLO_ind_x_6:
-        case SLO_ind_y_6:
+        MICRO_CASE(SLO_abs_4)
+        MICRO_CASE(SLO_abs_x_5)
+        MICRO_CASE(SLO_abs_y_5)
+        MICRO_CASE(SLO_ind_x_6)
+        MICRO_CASE(SLO_ind_y_6)
             
             WRITE_TO_ADDRESS
             DO_SLO
             CONTINUE
             
-        case SLO_abs_5:
-        case SLO_abs_x_6:
-        case SLO_abs_y_6:
-        case SLO_ind_x_7:
-        case SLO_ind_y_7:
+        MICRO_CASE(SLO_abs_5)
+        MICRO_CASE(SLO_abs_x_6)
+        MICRO_CASE(SLO_abs_y_6)
+        MICRO_CASE(SLO_ind_x_7)
+        MICRO_CASE(SLO_ind_y_7)
             
             WRITE_TO_ADDRESS
             loadA(regA | regD);
@@ -3119,36 +3159,36 @@ CPU::executeOneCycle()
 
         #define DO_SRE setC(regD & 1); regD >>= 1;
 
-        case SRE_zpg_3:
-        case SRE_zpg_x_4:
+        MICRO_CASE(SRE_zpg_3)
+        MICRO_CASE(SRE_zpg_x_4)
             
             WRITE_TO_ZERO_PAGE
             DO_SRE
             CONTINUE
             
-        case SRE_zpg_4:
-        case SRE_zpg_x_5:
+        MICRO_CASE(SRE_zpg_4)
+        MICRO_CASE(SRE_zpg_x_5)
             
             WRITE_TO_ZERO_PAGE
             loadA(regA ^ regD);
             POLL_INT
             DONE
             
-        case SRE_abs_4:
-        case SRE_abs_x_5:
-        case SRE_abs_y_5:
-        case SRE_ind_x_6:
-        case SRE_ind_y_6:
+        MICRO_CASE(SRE_abs_4)
+        MICRO_CASE(SRE_abs_x_5)
+        MICRO_CASE(SRE_abs_y_5)
+        MICRO_CASE(SRE_ind_x_6)
+        MICRO_CASE(SRE_ind_y_6)
             
             WRITE_TO_ADDRESS
             DO_SRE
             CONTINUE
             
-        case SRE_abs_5:
-        case SRE_abs_x_6:
-        case SRE_abs_y_6:
-        case SRE_ind_x_7:
-        case SRE_ind_y_7:
+        MICRO_CASE(SRE_abs_5)
+        MICRO_CASE(SRE_abs_x_6)
+        MICRO_CASE(SRE_abs_y_6)
+        MICRO_CASE(SRE_ind_x_7)
+        MICRO_CASE(SRE_ind_y_7)
             
             WRITE_TO_ADDRESS
             loadA(regA ^ regD);
@@ -3163,7 +3203,7 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              - - - - - -
             
-        case TAS_abs_y_3:
+        MICRO_CASE(TAS_abs_y_3)
             
             IDLE_READ_FROM_ADDRESS
             
@@ -3188,7 +3228,7 @@ CPU::executeOneCycle()
 
             CONTINUE
             
-        case TAS_abs_y_4:
+        MICRO_CASE(TAS_abs_y_4)
             
             WRITE_TO_ADDRESS
             POLL_INT
@@ -3201,7 +3241,7 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              / / - - - -
 
-        case ANE_imm:
+        MICRO_CASE(ANE_imm)
             
             READ_IMMEDIATE
             loadA(regX & regD & (regA | 0xEE));
@@ -3216,7 +3256,7 @@ CPU::executeOneCycle()
         // Flags:       N Z C I D V
         //              / / - - - -
 
-        case LXA_imm:
+        MICRO_CASE(LXA_imm)
             
             READ_IMMEDIATE
             regX = regD & (regA | 0xEE);
@@ -3224,7 +3264,7 @@ CPU::executeOneCycle()
             POLL_INT
             DONE
             
-        default:
+        MICRO_DEFAULT
             
             panic("UNIMPLEMENTED OPCODE: %d (%02X)\n", next, next);
             assert(false);
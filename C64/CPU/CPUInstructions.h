@@ -19,302 +19,328 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+/* List of all micro instructions. The list is expanded into the
+ * MicroInstruction enumeration and into the jump table of the threaded
+ * dispatcher. Hence, both always match.
+ */
+#define MICRO_INSTRUCTIONS(X) \
+    X(fetch) \
+    \
+    X(JAM) X(JAM_2) \
+    \
+    X(irq_2) X(irq_3) X(irq_4) X(irq_5) X(irq_6) X(irq_7) \
+    X(nmi_2) X(nmi_3) X(nmi_4) X(nmi_5) X(nmi_6) X(nmi_7) \
+    \
+    X(ADC_imm) \
+    X(ADC_zpg)   X(ADC_zpg_2) \
+    X(ADC_zpg_x) X(ADC_zpg_x_2) X(ADC_zpg_x_3) \
+    X(ADC_abs)   X(ADC_abs_2)   X(ADC_abs_3) \
+    X(ADC_abs_x) X(ADC_abs_x_2) X(ADC_abs_x_3) X(ADC_abs_x_4) \
+    X(ADC_abs_y) X(ADC_abs_y_2) X(ADC_abs_y_3) X(ADC_abs_y_4) \
+    X(ADC_ind_x) X(ADC_ind_x_2) X(ADC_ind_x_3) X(ADC_ind_x_4) X(ADC_ind_x_5) \
+    X(ADC_ind_y) X(ADC_ind_y_2) X(ADC_ind_y_3) X(ADC_ind_y_4) X(ADC_ind_y_5) \
+    \
+    X(AND_imm) \
+    X(AND_zpg)   X(AND_zpg_2) \
+    X(AND_zpg_x) X(AND_zpg_x_2) X(AND_zpg_x_3) \
+    X(AND_abs)   X(AND_abs_2)   X(AND_abs_3) \
+    X(AND_abs_x) X(AND_abs_x_2) X(AND_abs_x_3) X(AND_abs_x_4) \
+    X(AND_abs_y) X(AND_abs_y_2) X(AND_abs_y_3) X(AND_abs_y_4) \
+    X(AND_ind_x) X(AND_ind_x_2) X(AND_ind_x_3) X(AND_ind_x_4) X(AND_ind_x_5) \
+    X(AND_ind_y) X(AND_ind_y_2) X(AND_ind_y_3) X(AND_ind_y_4) X(AND_ind_y_5) \
+    \
+    X(ASL_acc) \
+    X(ASL_zpg)   X(ASL_zpg_2)   X(ASL_zpg_3)   X(ASL_zpg_4) \
+    X(ASL_zpg_x) X(ASL_zpg_x_2) X(ASL_zpg_x_3) X(ASL_zpg_x_4) X(ASL_zpg_x_5) \
+    X(ASL_abs)   X(ASL_abs_2)   X(ASL_abs_3)   X(ASL_abs_4)   X(ASL_abs_5) \
+    X(ASL_abs_x) X(ASL_abs_x_2) X(ASL_abs_x_3) X(ASL_abs_x_4) X(ASL_abs_x_5) X(ASL_abs_x_6) \
+    X(ASL_ind_x) X(ASL_ind_x_2) X(ASL_ind_x_3) X(ASL_ind_x_4) X(ASL_ind_x_5) X(ASL_ind_x_6) X(ASL_ind_x_7) \
+    \
+    X(branch_3_underflow) X(branch_3_overflow) \
+    X(BCC_rel) X(BCC_rel_2) \
+    X(BCS_rel) X(BCS_rel_2) \
+    X(BEQ_rel) X(BEQ_rel_2) \
+    \
+    X(BIT_zpg) X(BIT_zpg_2) \
+    X(BIT_abs) X(BIT_abs_2) X(BIT_abs_3) \
+    \
+    X(BMI_rel) X(BMI_rel_2) \
+    X(BNE_rel) X(BNE_rel_2) \
+    X(BPL_rel) X(BPL_rel_2) \
+    \
+    X(BRK) X(BRK_2) X(BRK_3) X(BRK_4) X(BRK_5) X(BRK_6) \
+    X(BRK_nmi_4) X(BRK_nmi_5) X(BRK_nmi_6) \
+    \
+    X(BVC_rel) X(BVC_rel_2) \
+    X(BVS_rel) X(BVS_rel_2) \
+    X(CLC) \
+    X(CLD) \
+    X(CLI) \
+    X(CLV) \
+    \
+    X(CMP_imm) \
+    X(CMP_zpg)   X(CMP_zpg_2) \
+    X(CMP_zpg_x) X(CMP_zpg_x_2) X(CMP_zpg_x_3) \
+    X(CMP_abs)   X(CMP_abs_2)   X(CMP_abs_3) \
+    X(CMP_abs_x) X(CMP_abs_x_2) X(CMP_abs_x_3) X(CMP_abs_x_4) \
+    X(CMP_abs_y) X(CMP_abs_y_2) X(CMP_abs_y_3) X(CMP_abs_y_4) \
+    X(CMP_ind_x) X(CMP_ind_x_2) X(CMP_ind_x_3) X(CMP_ind_x_4) X(CMP_ind_x_5) \
+    X(CMP_ind_y) X(CMP_ind_y_2) X(CMP_ind_y_3) X(CMP_ind_y_4) X(CMP_ind_y_5) \
+    \
+    X(CPX_imm) \
+    X(CPX_zpg) X(CPX_zpg_2) \
+    X(CPX_abs) X(CPX_abs_2) X(CPX_abs_3) \
+    \
+    X(CPY_imm) \
+    X(CPY_zpg) X(CPY_zpg_2) \
+    X(CPY_abs) X(CPY_abs_2) X(CPY_abs_3) \
+    \
+    X(DEC_zpg)   X(DEC_zpg_2)   X(DEC_zpg_3)   X(DEC_zpg_4) \
+    X(DEC_zpg_x) X(DEC_zpg_x_2) X(DEC_zpg_x_3) X(DEC_zpg_x_4) X(DEC_zpg_x_5) \
+    X(DEC_abs)   X(DEC_abs_2)   X(DEC_abs_3)   X(DEC_abs_4)   X(DEC_abs_5) \
+    X(DEC_abs_x) X(DEC_abs_x_2) X(DEC_abs_x_3) X(DEC_abs_x_4) X(DEC_abs_x_5) X(DEC_abs_x_6) \
+    X(DEC_ind_x) X(DEC_ind_x_2) X(DEC_ind_x_3) X(DEC_ind_x_4) X(DEC_ind_x_5) X(DEC_ind_x_6) X(DEC_ind_x_7) \
+    \
+    X(DEX) \
+    X(DEY) \
+    \
+    X(EOR_imm) \
+    X(EOR_zpg)   X(EOR_zpg_2) \
+    X(EOR_zpg_x) X(EOR_zpg_x_2) X(EOR_zpg_x_3) \
+    X(EOR_abs)   X(EOR_abs_2)   X(EOR_abs_3) \
+    X(EOR_abs_x) X(EOR_abs_x_2) X(EOR_abs_x_3) X(EOR_abs_x_4) \
+    X(EOR_abs_y) X(EOR_abs_y_2) X(EOR_abs_y_3) X(EOR_abs_y_4) \
+    X(EOR_ind_x) X(EOR_ind_x_2) X(EOR_ind_x_3) X(EOR_ind_x_4) X(EOR_ind_x_5) \
+    X(EOR_ind_y) X(EOR_ind_y_2) X(EOR_ind_y_3) X(EOR_ind_y_4) X(EOR_ind_y_5) \
+    \
+    X(INC_zpg)   X(INC_zpg_2)   X(INC_zpg_3)   X(INC_zpg_4) \
+    X(INC_zpg_x) X(INC_zpg_x_2) X(INC_zpg_x_3) X(INC_zpg_x_4) X(INC_zpg_x_5) \
+    X(INC_abs)   X(INC_abs_2)   X(INC_abs_3)   X(INC_abs_4)   X(INC_abs_5) \
+    X(INC_abs_x) X(INC_abs_x_2) X(INC_abs_x_3) X(INC_abs_x_4) X(INC_abs_x_5) X(INC_abs_x_6) \
+    X(INC_ind_x) X(INC_ind_x_2) X(INC_ind_x_3) X(INC_ind_x_4) X(INC_ind_x_5) X(INC_ind_x_6) X(INC_ind_x_7) \
+    \
+    X(INX) \
+    X(INY) \
+    \
+    X(JMP_abs) X(JMP_abs_2) \
+    X(JMP_abs_ind) X(JMP_abs_ind_2) X(JMP_abs_ind_3) X(JMP_abs_ind_4) \
+    \
+    X(JSR) X(JSR_2) X(JSR_3) X(JSR_4) X(JSR_5) \
+    \
+    X(LDA_imm) \
+    X(LDA_zpg)   X(LDA_zpg_2) \
+    X(LDA_zpg_x) X(LDA_zpg_x_2) X(LDA_zpg_x_3) \
+    X(LDA_abs)   X(LDA_abs_2)   X(LDA_abs_3) \
+    X(LDA_abs_x) X(LDA_abs_x_2) X(LDA_abs_x_3) X(LDA_abs_x_4) \
+    X(LDA_abs_y) X(LDA_abs_y_2) X(LDA_abs_y_3) X(LDA_abs_y_4) \
+    X(LDA_ind_x) X(LDA_ind_x_2) X(LDA_ind_x_3) X(LDA_ind_x_4) X(LDA_ind_x_5) \
+    X(LDA_ind_y) X(LDA_ind_y_2) X(LDA_ind_y_3) X(LDA_ind_y_4) X(LDA_ind_y_5) \
+    \
+    X(LDX_imm) \
+    X(LDX_zpg)   X(LDX_zpg_2) \
+    X(LDX_zpg_y) X(LDX_zpg_y_2) X(LDX_zpg_y_3) \
+    X(LDX_abs)   X(LDX_abs_2)   X(LDX_abs_3) \
+    X(LDX_abs_y) X(LDX_abs_y_2) X(LDX_abs_y_3) X(LDX_abs_y_4) \
+    X(LDX_ind_x) X(LDX_ind_x_2) X(LDX_ind_x_3) X(LDX_ind_x_4) X(LDX_ind_x_5) \
+    X(LDX_ind_y) X(LDX_ind_y_2) X(LDX_ind_y_3) X(LDX_ind_y_4) X(LDX_ind_y_5) \
+    \
+    X(LDY_imm) \
+    X(LDY_zpg)   X(LDY_zpg_2) \
+    X(LDY_zpg_x) X(LDY_zpg_x_2) X(LDY_zpg_x_3) \
+    X(LDY_abs)   X(LDY_abs_2)   X(LDY_abs_3) \
+    X(LDY_abs_x) X(LDY_abs_x_2) X(LDY_abs_x_3) X(LDY_abs_x_4) \
+    X(LDY_ind_x) X(LDY_ind_x_2) X(LDY_ind_x_3) X(LDY_ind_x_4) X(LDY_ind_x_5) \
+    X(LDY_ind_y) X(LDY_ind_y_2) X(LDY_ind_y_3) X(LDY_ind_y_4) X(LDY_ind_y_5) \
+    \
+    X(LSR_acc) \
+    X(LSR_zpg)   X(LSR_zpg_2)   X(LSR_zpg_3)   X(LSR_zpg_4) \
+    X(LSR_zpg_x) X(LSR_zpg_x_2) X(LSR_zpg_x_3) X(LSR_zpg_x_4) X(LSR_zpg_x_5) \
+    X(LSR_abs)   X(LSR_abs_2)   X(LSR_abs_3)   X(LSR_abs_4)   X(LSR_abs_5) \
+    X(LSR_abs_x) X(LSR_abs_x_2) X(LSR_abs_x_3) X(LSR_abs_x_4) X(LSR_abs_x_5) X(LSR_abs_x_6) \
+    X(LSR_abs_y) X(LSR_abs_y_2) X(LSR_abs_y_3) X(LSR_abs_y_4) X(LSR_abs_y_5) X(LSR_abs_y_6) \
+    X(LSR_ind_x) X(LSR_ind_x_2) X(LSR_ind_x_3) X(LSR_ind_x_4) X(LSR_ind_x_5) X(LSR_ind_x_6) X(LSR_ind_x_7) \
+    X(LSR_ind_y) X(LSR_ind_y_2) X(LSR_ind_y_3) X(LSR_ind_y_4) X(LSR_ind_y_5) X(LSR_ind_y_6) X(LSR_ind_y_7) \
+    \
+    X(NOP) \
+    X(NOP_imm) \
+    X(NOP_zpg)   X(NOP_zpg_2) \
+    X(NOP_zpg_x) X(NOP_zpg_x_2) X(NOP_zpg_x_3) \
+    X(NOP_abs)   X(NOP_abs_2)   X(NOP_abs_3) \
+    X(NOP_abs_x) X(NOP_abs_x_2) X(NOP_abs_x_3) X(NOP_abs_x_4) \
+    \
+    X(ORA_imm) \
+    X(ORA_zpg)   X(ORA_zpg_2) \
+    X(ORA_zpg_x) X(ORA_zpg_x_2) X(ORA_zpg_x_3) \
+    X(ORA_abs)   X(ORA_abs_2)   X(ORA_abs_3) \
+    X(ORA_abs_x) X(ORA_abs_x_2) X(ORA_abs_x_3) X(ORA_abs_x_4) \
+    X(ORA_abs_y) X(ORA_abs_y_2) X(ORA_abs_y_3) X(ORA_abs_y_4) \
+    X(ORA_ind_x) X(ORA_ind_x_2) X(ORA_ind_x_3) X(ORA_ind_x_4) X(ORA_ind_x_5) \
+    X(ORA_ind_y) X(ORA_ind_y_2) X(ORA_ind_y_3) X(ORA_ind_y_4) X(ORA_ind_y_5) \
+    \
+    X(PHA) X(PHA_2) \
+    X(PHP) X(PHP_2) \
+    X(PLA) X(PLA_2) X(PLA_3) \
+    X(PLP) X(PLP_2) X(PLP_3) \
+    \
+    X(ROL_acc) \
+    X(ROL_zpg)   X(ROL_zpg_2)   X(ROL_zpg_3)   X(ROL_zpg_4) \
+    X(ROL_zpg_x) X(ROL_zpg_x_2) X(ROL_zpg_x_3) X(ROL_zpg_x_4) X(ROL_zpg_x_5) \
+    X(ROL_abs)   X(ROL_abs_2)   X(ROL_abs_3)   X(ROL_abs_4)   X(ROL_abs_5) \
+    X(ROL_abs_x) X(ROL_abs_x_2) X(ROL_abs_x_3) X(ROL_abs_x_4) X(ROL_abs_x_5) X(ROL_abs_x_6) \
+    X(ROL_ind_x) X(ROL_ind_x_2) X(ROL_ind_x_3) X(ROL_ind_x_4) X(ROL_ind_x_5) X(ROL_ind_x_6) X(ROL_ind_x_7) \
+    \
+    X(ROR_acc) \
+    X(ROR_zpg)   X(ROR_zpg_2)   X(ROR_zpg_3)   X(ROR_zpg_4) \
+    X(ROR_zpg_x) X(ROR_zpg_x_2) X(ROR_zpg_x_3) X(ROR_zpg_x_4) X(ROR_zpg_x_5) \
+    X(ROR_abs)   X(ROR_abs_2)   X(ROR_abs_3)   X(ROR_abs_4)   X(ROR_abs_5) \
+    X(ROR_abs_x) X(ROR_abs_x_2) X(ROR_abs_x_3) X(ROR_abs_x_4) X(ROR_abs_x_5) X(ROR_abs_x_6) \
+    X(ROR_ind_x) X(ROR_ind_x_2) X(ROR_ind_x_3) X(ROR_ind_x_4) X(ROR_ind_x_5) X(ROR_ind_x_6) X(ROR_ind_x_7) \
+    \
+    X(RTI) X(RTI_2) X(RTI_3) X(RTI_4) X(RTI_5) \
+    X(RTS) X(RTS_2) X(RTS_3) X(RTS_4) X(RTS_5) \
+    \
+    X(SBC_imm) \
+    X(SBC_zpg)   X(SBC_zpg_2) \
+    X(SBC_zpg_x) X(SBC_zpg_x_2) X(SBC_zpg_x_3) \
+    X(SBC_abs)   X(SBC_abs_2)   X(SBC_abs_3) \
+    X(SBC_abs_x) X(SBC_abs_x_2) X(SBC_abs_x_3) X(SBC_abs_x_4) \
+    X(SBC_abs_y) X(SBC_abs_y_2) X(SBC_abs_y_3) X(SBC_abs_y_4) \
+    X(SBC_ind_x) X(SBC_ind_x_2) X(SBC_ind_x_3) X(SBC_ind_x_4) X(SBC_ind_x_5) \
+    X(SBC_ind_y) X(SBC_ind_y_2) X(SBC_ind_y_3) X(SBC_ind_y_4) X(SBC_ind_y_5) \
+    \
+    X(SEC) \
+    X(SED) \
+    X(SEI) X(SEI_cont) \
+    \
+    X(STA_zpg)   X(STA_zpg_2) \
+    X(STA_zpg_x) X(STA_zpg_x_2) X(STA_zpg_x_3) \
+    X(STA_abs)   X(STA_abs_2)   X(STA_abs_3) \
+    X(STA_abs_x) X(STA_abs_x_2) X(STA_abs_x_3) X(STA_abs_x_4) \
+    X(STA_abs_y) X(STA_abs_y_2) X(STA_abs_y_3) X(STA_abs_y_4) \
+    X(STA_ind_x) X(STA_ind_x_2) X(STA_ind_x_3) X(STA_ind_x_4) X(STA_ind_x_5) \
+    X(STA_ind_y) X(STA_ind_y_2) X(STA_ind_y_3) X(STA_ind_y_4) X(STA_ind_y_5) \
+    \
+    X(STX_zpg)   X(STX_zpg_2) \
+    X(STX_zpg_y) X(STX_zpg_y_2) X(STX_zpg_y_3) \
+    X(STX_abs)   X(STX_abs_2)   X(STX_abs_3) \
+    \
+    X(STY_zpg)   X(STY_zpg_2) \
+    X(STY_zpg_x) X(STY_zpg_x_2) X(STY_zpg_x_3) \
+    X(STY_abs)   X(STY_abs_2)   X(STY_abs_3) \
+    \
+    X(TAX) \
+    X(TAY) \
+    X(TSX) \
+    X(TXA) \
+    X(TXS) \
+    X(TYA) \
+    \
+    /* Illegal instructions */ \
+    \
+    X(ALR_imm) \
+    X(ANC_imm) \
+    X(ANE_imm) \
+    X(ARR_imm) \
+    X(AXS_imm) \
+    \
+    X(DCP_zpg)   X(DCP_zpg_2)   X(DCP_zpg_3)   X(DCP_zpg_4) \
+    X(DCP_zpg_x) X(DCP_zpg_x_2) X(DCP_zpg_x_3) X(DCP_zpg_x_4) X(DCP_zpg_x_5) \
+    X(DCP_abs)   X(DCP_abs_2)   X(DCP_abs_3)   X(DCP_abs_4)   X(DCP_abs_5) \
+    X(DCP_abs_x) X(DCP_abs_x_2) X(DCP_abs_x_3) X(DCP_abs_x_4) X(DCP_abs_x_5) X(DCP_abs_x_6) \
+    X(DCP_abs_y) X(DCP_abs_y_2) X(DCP_abs_y_3) X(DCP_abs_y_4) X(DCP_abs_y_5) X(DCP_abs_y_6) \
+    X(DCP_ind_x) X(DCP_ind_x_2) X(DCP_ind_x_3) X(DCP_ind_x_4) X(DCP_ind_x_5) X(DCP_ind_x_6) X(DCP_ind_x_7) \
+    X(DCP_ind_y) X(DCP_ind_y_2) X(DCP_ind_y_3) X(DCP_ind_y_4) X(DCP_ind_y_5) X(DCP_ind_y_6) X(DCP_ind_y_7) \
+    \
+    X(ISC_zpg)   X(ISC_zpg_2)   X(ISC_zpg_3)   X(ISC_zpg_4) \
+    X(ISC_zpg_x) X(ISC_zpg_x_2) X(ISC_zpg_x_3) X(ISC_zpg_x_4) X(ISC_zpg_x_5) \
+    X(ISC_abs)   X(ISC_abs_2)   X(ISC_abs_3)   X(ISC_abs_4)   X(ISC_abs_5) \
+    X(ISC_abs_x) X(ISC_abs_x_2) X(ISC_abs_x_3) X(ISC_abs_x_4) X(ISC_abs_x_5) X(ISC_abs_x_6) \
+    X(ISC_abs_y) X(ISC_abs_y_2) X(ISC_abs_y_3) X(ISC_abs_y_4) X(ISC_abs_y_5) X(ISC_abs_y_6) \
+    X(ISC_ind_x) X(ISC_ind_x_2) X(ISC_ind_x_3) X(ISC_ind_x_4) X(ISC_ind_x_5) X(ISC_ind_x_6) X(ISC_ind_x_7) \
+    X(ISC_ind_y) X(ISC_ind_y_2) X(ISC_ind_y_3) X(ISC_ind_y_4) X(ISC_ind_y_5) X(ISC_ind_y_6) X(ISC_ind_y_7) \
+    \
+    X(LAS_abs_y) X(LAS_abs_y_2) X(LAS_abs_y_3) X(LAS_abs_y_4) \
+    \
+    X(LAX_zpg)   X(LAX_zpg_2) \
+    X(LAX_zpg_y) X(LAX_zpg_y_2) X(LAX_zpg_y_3) \
+    X(LAX_abs)   X(LAX_abs_2)   X(LAX_abs_3) \
+    X(LAX_abs_y) X(LAX_abs_y_2) X(LAX_abs_y_3) X(LAX_abs_y_4) \
+    X(LAX_ind_x) X(LAX_ind_x_2) X(LAX_ind_x_3) X(LAX_ind_x_4) X(LAX_ind_x_5) \
+    X(LAX_ind_y) X(LAX_ind_y_2) X(LAX_ind_y_3) X(LAX_ind_y_4) X(LAX_ind_y_5) \
+    \
+    X(LXA_imm) \
+    \
+    X(RLA_zpg)   X(RLA_zpg_2)   X(RLA_zpg_3)   X(RLA_zpg_4) \
+    X(RLA_zpg_x) X(RLA_zpg_x_2) X(RLA_zpg_x_3) X(RLA_zpg_x_4) X(RLA_zpg_x_5) \
+    X(RLA_abs)   X(RLA_abs_2)   X(RLA_abs_3)   X(RLA_abs_4)   X(RLA_abs_5) \
+    X(RLA_abs_x) X(RLA_abs_x_2) X(RLA_abs_x_3) X(RLA_abs_x_4) X(RLA_abs_x_5) X(RLA_abs_x_6) \
+    X(RLA_abs_y) X(RLA_abs_y_2) X(RLA_abs_y_3) X(RLA_abs_y_4) X(RLA_abs_y_5) X(RLA_abs_y_6) \
+    X(RLA_ind_x) X(RLA_ind_x_2) X(RLA_ind_x_3) X(RLA_ind_x_4) X(RLA_ind_x_5) X(RLA_ind_x_6) X(RLA_ind_x_7) \
+    X(RLA_ind_y) X(RLA_ind_y_2) X(RLA_ind_y_3) X(RLA_ind_y_4) X(RLA_ind_y_5) X(RLA_ind_y_6) X(RLA_ind_y_7) \
+    \
+    X(RRA_zpg)   X(RRA_zpg_2)   X(RRA_zpg_3)   X(RRA_zpg_4) \
+    X(RRA_zpg_x) X(RRA_zpg_x_2) X(RRA_zpg_x_3) X(RRA_zpg_x_4) X(RRA_zpg_x_5) \
+    X(RRA_abs)   X(RRA_abs_2)   X(RRA_abs_3)   X(RRA_abs_4)   X(RRA_abs_5) \
+    X(RRA_abs_x) X(RRA_abs_x_2) X(RRA_abs_x_3) X(RRA_abs_x_4) X(RRA_abs_x_5) X(RRA_abs_x_6) \
+    X(RRA_abs_y) X(RRA_abs_y_2) X(RRA_abs_y_3) X(RRA_abs_y_4) X(RRA_abs_y_5) X(RRA_abs_y_6) \
+    X(RRA_ind_x) X(RRA_ind_x_2) X(RRA_ind_x_3) X(RRA_ind_x_4) X(RRA_ind_x_5) X(RRA_ind_x_6) X(RRA_ind_x_7) \
+    X(RRA_ind_y) X(RRA_ind_y_2) X(RRA_ind_y_3) X(RRA_ind_y_4) X(RRA_ind_y_5) X(RRA_ind_y_6) X(RRA_ind_y_7) \
+    \
+    X(SAX_zpg)   X(SAX_zpg_2) \
+    X(SAX_zpg_y) X(SAX_zpg_y_2) X(SAX_zpg_y_3) \
+    X(SAX_abs)   X(SAX_abs_2)   X(SAX_abs_3) \
+    X(SAX_ind_x) X(SAX_ind_x_2) X(SAX_ind_x_3) X(SAX_ind_x_4) X(SAX_ind_x_5) \
+    \
+    X(SHA_ind_y) X(SHA_ind_y_2) X(SHA_ind_y_3) X(SHA_ind_y_4) X(SHA_ind_y_5) \
+    X(SHA_abs_y) X(SHA_abs_y_2) X(SHA_abs_y_3) X(SHA_abs_y_4) \
+    \
+    X(SHX_abs_y) X(SHX_abs_y_2) X(SHX_abs_y_3) X(SHX_abs_y_4) \
+    X(SHY_abs_x) X(SHY_abs_x_2) X(SHY_abs_x_3) X(SHY_abs_x_4) \
+    \
+    X(SLO_zpg)   X(SLO_zpg_2)   X(SLO_zpg_3)   X(SLO_zpg_4) \
+    X(SLO_zpg_x) X(SLO_zpg_x_2) X(SLO_zpg_x_3) X(SLO_zpg_x_4) X(SLO_zpg_x_5) \
+    X(SLO_abs)   X(SLO_abs_2)   X(SLO_abs_3)   X(SLO_abs_4)   X(SLO_abs_5) \
+    X(SLO_abs_x) X(SLO_abs_x_2) X(SLO_abs_x_3) X(SLO_abs_x_4) X(SLO_abs_x_5) X(SLO_abs_x_6) \
+    X(SLO_abs_y) X(SLO_abs_y_2) X(SLO_abs_y_3) X(SLO_abs_y_4) X(SLO_abs_y_5) X(SLO_abs_y_6) \
+    X(SLO_ind_x) X(SLO_ind_x_2) X(SLO_ind_x_3) X(SLO_ind_x_4) X(SLO_ind_x_5) X(SLO_ind_x_6) X(SLO_ind_x_7) \
+    X(SLO_ind_y) X(SLO_ind_y_2) X(SLO_ind_y_3) X(SLO_ind_y_4) X(SLO_ind_y_5) X(SLO_ind_y_6) X(SLO_ind_y_7) \
+    \
+    X(SRE_zpg)   X(SRE_zpg_2)   X(SRE_zpg_3)   X(SRE_zpg_4) \
+    X(SRE_zpg_x) X(SRE_zpg_x_2) X(SRE_zpg_x_3) X(SRE_zpg_x_4) X(SRE_zpg_x_5) \
+    X(SRE_abs)   X(SRE_abs_2)   X(SRE_abs_3)   X(SRE_abs_4)   X(SRE_abs_5) \
+    X(SRE_abs_x) X(SRE_abs_x_2) X(SRE_abs_x_3) X(SRE_abs_x_4) X(SRE_abs_x_5) X(SRE_abs_x_6) \
+    X(SRE_abs_y) X(SRE_abs_y_2) X(SRE_abs_y_3) X(SRE_abs_y_4) X(SRE_abs_y_5) X(SRE_abs_y_6) \
+    X(SRE_ind_x) X(SRE_ind_x_2) X(SRE_ind_x_3) X(SRE_ind_x_4) X(SRE_ind_x_5) X(SRE_ind_x_6) X(SRE_ind_x_7) \
+    X(SRE_ind_y) X(SRE_ind_y_2) X(SRE_ind_y_3) X(SRE_ind_y_4) X(SRE_ind_y_5) X(SRE_ind_y_6) X(SRE_ind_y_7) \
+    \
+    X(TAS_abs_y) X(TAS_abs_y_2) X(TAS_abs_y_3) X(TAS_abs_y_4)
+
 // Microinstructions
+#define MICRO_INSTRUCTION_NAME(x) x,
 typedef enum {
     
-    fetch,
-    
-    JAM, JAM_2,
-    
-    irq_2, irq_3, irq_4, irq_5, irq_6, irq_7,
-    nmi_2, nmi_3, nmi_4, nmi_5, nmi_6, nmi_7,
-    
-    ADC_imm,
-    ADC_zpg,   ADC_zpg_2,
-    ADC_zpg_x, ADC_zpg_x_2, ADC_zpg_x_3,
-    ADC_abs,   ADC_abs_2,   ADC_abs_3,
-    ADC_abs_x, ADC_abs_x_2, ADC_abs_x_3, ADC_abs_x_4,
-    ADC_abs_y, ADC_abs_y_2, ADC_abs_y_3, ADC_abs_y_4,
-    ADC_ind_x, ADC_ind_x_2, ADC_ind_x_3, ADC_ind_x_4, ADC_ind_x_5,
-    ADC_ind_y, ADC_ind_y_2, ADC_ind_y_3, ADC_ind_y_4, ADC_ind_y_5,
-    
-    AND_imm,
-    AND_zpg,   AND_zpg_2,
-    AND_zpg_x, AND_zpg_x_2, AND_zpg_x_3,
-    AND_abs,   AND_abs_2,   AND_abs_3,
-    AND_abs_x, AND_abs_x_2, AND_abs_x_3, AND_abs_x_4,
-    AND_abs_y, AND_abs_y_2, AND_abs_y_3, AND_abs_y_4,
-    AND_ind_x, AND_ind_x_2, AND_ind_x_3, AND_ind_x_4, AND_ind_x_5,
-    AND_ind_y, AND_ind_y_2, AND_ind_y_3, AND_ind_y_4, AND_ind_y_5,
-    
-    ASL_acc,
-    ASL_zpg,   ASL_zpg_2,   ASL_zpg_3,   ASL_zpg_4,
-    ASL_zpg_x, ASL_zpg_x_2, ASL_zpg_x_3, ASL_zpg_x_4, ASL_zpg_x_5,
-    ASL_abs,   ASL_abs_2,   ASL_abs_3,   ASL_abs_4,   ASL_abs_5,
-    ASL_abs_x, ASL_abs_x_2, ASL_abs_x_3, ASL_abs_x_4, ASL_abs_x_5, ASL_abs_x_6,
-    ASL_ind_x, ASL_ind_x_2, ASL_ind_x_3, ASL_ind_x_4, ASL_ind_x_5, ASL_ind_x_6, ASL_ind_x_7,
-    
-    branch_3_underflow, branch_3_overflow,
-    BCC_rel, BCC_rel_2,
-    BCS_rel, BCS_rel_2,
-    BEQ_rel, BEQ_rel_2,
-    
-    BIT_zpg, BIT_zpg_2,
-    BIT_abs, BIT_abs_2, BIT_abs_3,
-    
-    BMI_rel, BMI_rel_2,
-    BNE_rel, BNE_rel_2,
-    BPL_rel, BPL_rel_2,
-    
-    BRK, BRK_2, BRK_3, BRK_4, BRK_5, BRK_6,
-    BRK_nmi_4, BRK_nmi_5, BRK_nmi_6,
-    
-    BVC_rel, BVC_rel_2,
-    BVS_rel, BVS_rel_2,
-    CLC,
-    CLD,
-    CLI,
-    CLV,
-    
-    CMP_imm,
-    CMP_zpg,   CMP_zpg_2,
-    CMP_zpg_x, CMP_zpg_x_2, CMP_zpg_x_3,
-    CMP_abs,   CMP_abs_2,   CMP_abs_3,
-    CMP_abs_x, CMP_abs_x_2, CMP_abs_x_3, CMP_abs_x_4,
-    CMP_abs_y, CMP_abs_y_2, CMP_abs_y_3, CMP_abs_y_4,
-    CMP_ind_x, CMP_ind_x_2, CMP_ind_x_3, CMP_ind_x_4, CMP_ind_x_5,
-    CMP_ind_y, CMP_ind_y_2, CMP_ind_y_3, CMP_ind_y_4, CMP_ind_y_5,
-    
-    CPX_imm,
-    CPX_zpg, CPX_zpg_2,
-    CPX_abs, CPX_abs_2, CPX_abs_3,
-    
-    CPY_imm,
-    CPY_zpg, CPY_zpg_2,
-    CPY_abs, CPY_abs_2, CPY_abs_3,
-    
-    DEC_zpg,   DEC_zpg_2,   DEC_zpg_3,   DEC_zpg_4,
-    DEC_zpg_x, DEC_zpg_x_2, DEC_zpg_x_3, DEC_zpg_x_4, DEC_zpg_x_5,
-    DEC_abs,   DEC_abs_2,   DEC_abs_3,   DEC_abs_4,   DEC_abs_5,
-    DEC_abs_x, DEC_abs_x_2, DEC_abs_x_3, DEC_abs_x_4, DEC_abs_x_5, DEC_abs_x_6,
-    DEC_ind_x, DEC_ind_x_2, DEC_ind_x_3, DEC_ind_x_4, DEC_ind_x_5, DEC_ind_x_6, DEC_ind_x_7,
-    
-    DEX,
-    DEY,
-    
-    EOR_imm,
-    EOR_zpg,   EOR_zpg_2,
-    EOR_zpg_x, EOR_zpg_x_2, EOR_zpg_x_3,
-    EOR_abs,   EOR_abs_2,   EOR_abs_3,
-    EOR_abs_x, EOR_abs_x_2, EOR_abs_x_3, EOR_abs_x_4,
-    EOR_abs_y, EOR_abs_y_2, EOR_abs_y_3, EOR_abs_y_4,
-    EOR_ind_x, EOR_ind_x_2, EOR_ind_x_3, EOR_ind_x_4, EOR_ind_x_5,
-    EOR_ind_y, EOR_ind_y_2, EOR_ind_y_3, EOR_ind_y_4, EOR_ind_y_5,
-    
-    INC_zpg,   INC_zpg_2,   INC_zpg_3,   INC_zpg_4,
-    INC_zpg_x, INC_zpg_x_2, INC_zpg_x_3, INC_zpg_x_4, INC_zpg_x_5,
-    INC_abs,   INC_abs_2,   INC_abs_3,   INC_abs_4,   INC_abs_5,
-    INC_abs_x, INC_abs_x_2, INC_abs_x_3, INC_abs_x_4, INC_abs_x_5, INC_abs_x_6,
-    INC_ind_x, INC_ind_x_2, INC_ind_x_3, INC_ind_x_4, INC_ind_x_5, INC_ind_x_6, INC_ind_x_7,
-    
-    INX,
-    INY,
-    
-    JMP_abs, JMP_abs_2,
-    JMP_abs_ind, JMP_abs_ind_2, JMP_abs_ind_3, JMP_abs_ind_4,
-    
-    JSR, JSR_2, JSR_3, JSR_4, JSR_5,
-    
-    LDA_imm,
-    LDA_zpg,   LDA_zpg_2,
-    LDA_zpg_x, LDA_zpg_x_2, LDA_zpg_x_3,
-    LDA_abs,   LDA_abs_2,   LDA_abs_3,
-    LDA_abs_x, LDA_abs_x_2, LDA_abs_x_3, LDA_abs_x_4,
-    LDA_abs_y, LDA_abs_y_2, LDA_abs_y_3, LDA_abs_y_4,
-    LDA_ind_x, LDA_ind_x_2, LDA_ind_x_3, LDA_ind_x_4, LDA_ind_x_5,
-    LDA_ind_y, LDA_ind_y_2, LDA_ind_y_3, LDA_ind_y_4, LDA_ind_y_5,
-    
-    LDX_imm,
-    LDX_zpg,   LDX_zpg_2,
-    LDX_zpg_y, LDX_zpg_y_2, LDX_zpg_y_3,
-    LDX_abs,   LDX_abs_2,   LDX_abs_3,
-    LDX_abs_y, LDX_abs_y_2, LDX_abs_y_3, LDX_abs_y_4,
-    LDX_ind_x, LDX_ind_x_2, LDX_ind_x_3, LDX_ind_x_4, LDX_ind_x_5,
-    LDX_ind_y, LDX_ind_y_2, LDX_ind_y_3, LDX_ind_y_4, LDX_ind_y_5,
-    
-    LDY_imm,
-    LDY_zpg,   LDY_zpg_2,
-    LDY_zpg_x, LDY_zpg_x_2, LDY_zpg_x_3,
-    LDY_abs,   LDY_abs_2,   LDY_abs_3,
-    LDY_abs_x, LDY_abs_x_2, LDY_abs_x_3, LDY_abs_x_4,
-    LDY_ind_x, LDY_ind_x_2, LDY_ind_x_3, LDY_ind_x_4, LDY_ind_x_5,
-    LDY_ind_y, LDY_ind_y_2, LDY_ind_y_3, LDY_ind_y_4, LDY_ind_y_5,
-    
-    LSR_acc,
-    LSR_zpg,   LSR_zpg_2,   LSR_zpg_3,   LSR_zpg_4,
-    LSR_zpg_x, LSR_zpg_x_2, LSR_zpg_x_3, LSR_zpg_x_4, LSR_zpg_x_5,
-    LSR_abs,   LSR_abs_2,   LSR_abs_3,   LSR_abs_4,   LSR_abs_5,
-    LSR_abs_x, LSR_abs_x_2, LSR_abs_x_3, LSR_abs_x_4, LSR_abs_x_5, LSR_abs_x_6,
-    LSR_abs_y, LSR_abs_y_2, LSR_abs_y_3, LSR_abs_y_4, LSR_abs_y_5, LSR_abs_y_6,
-    LSR_ind_x, LSR_ind_x_2, LSR_ind_x_3, LSR_ind_x_4, LSR_ind_x_5, LSR_ind_x_6, LSR_ind_x_7,
-    LSR_ind_y, LSR_ind_y_2, LSR_ind_y_3, LSR_ind_y_4, LSR_ind_y_5, LSR_ind_y_6, LSR_ind_y_7,
-    
-    NOP,
-    NOP_imm,
-    NOP_zpg,   NOP_zpg_2,
-    NOP_zpg_x, NOP_zpg_x_2, NOP_zpg_x_3,
-    NOP_abs,   NOP_abs_2,   NOP_abs_3,
-    NOP_abs_x, NOP_abs_x_2, NOP_abs_x_3, NOP_abs_x_4,
-    
-    ORA_imm,
-    ORA_zpg,   ORA_zpg_2,
-    ORA_zpg_x, ORA_zpg_x_2, ORA_zpg_x_3,
-    ORA_abs,   ORA_abs_2,   ORA_abs_3,
-    ORA_abs_x, ORA_abs_x_2, ORA_abs_x_3, ORA_abs_x_4,
-    ORA_abs_y, ORA_abs_y_2, ORA_abs_y_3, ORA_abs_y_4,
-    ORA_ind_x, ORA_ind_x_2, ORA_ind_x_3, ORA_ind_x_4, ORA_ind_x_5,
-    ORA_ind_y, ORA_ind_y_2, ORA_ind_y_3, ORA_ind_y_4, ORA_ind_y_5,
-    
-    PHA, PHA_2,
-    PHP, PHP_2,
-    PLA, PLA_2, PLA_3,
-    PLP, PLP_2, PLP_3,
-    
-    ROL_acc,
-    ROL_zpg,   ROL_zpg_2,   ROL_zpg_3,   ROL_zpg_4,
-    ROL_zpg_x, ROL_zpg_x_2, ROL_zpg_x_3, ROL_zpg_x_4, ROL_zpg_x_5,
-    ROL_abs,   ROL_abs_2,   ROL_abs_3,   ROL_abs_4,   ROL_abs_5,
-    ROL_abs_x, ROL_abs_x_2, ROL_abs_x_3, ROL_abs_x_4, ROL_abs_x_5, ROL_abs_x_6,
-    ROL_ind_x, ROL_ind_x_2, ROL_ind_x_3, ROL_ind_x_4, ROL_ind_x_5, ROL_ind_x_6, ROL_ind_x_7,
-    
-    ROR_acc,
-    ROR_zpg,   ROR_zpg_2,   ROR_zpg_3,   ROR_zpg_4,
-    ROR_zpg_x, ROR_zpg_x_2, ROR_zpg_x_3, ROR_zpg_x_4, ROR_zpg_x_5,
-    ROR_abs,   ROR_abs_2,   ROR_abs_3,   ROR_abs_4,   ROR_abs_5,
-    ROR_abs_x, ROR_abs_x_2, ROR_abs_x_3, ROR_abs_x_4, ROR_abs_x_5, ROR_abs_x_6,
-    ROR_ind_x, ROR_ind_x_2, ROR_ind_x_3, ROR_ind_x_4, ROR_ind_x_5, ROR_ind_x_6, ROR_ind_x_7,
-    
-    RTI, RTI_2, RTI_3, RTI_4, RTI_5,
-    RTS, RTS_2, RTS_3, RTS_4, RTS_5,
-    
-    SBC_imm,
-    SBC_zpg,   SBC_zpg_2,
-    SBC_zpg_x, SBC_zpg_x_2, SBC_zpg_x_3,
-    SBC_abs,   SBC_abs_2,   SBC_abs_3,
-    SBC_abs_x, SBC_abs_x_2, SBC_abs_x_3, SBC_abs_x_4,
-    SBC_abs_y, SBC_abs_y_2, SBC_abs_y_3, SBC_abs_y_4,
-    SBC_ind_x, SBC_ind_x_2, SBC_ind_x_3, SBC_ind_x_4, SBC_ind_x_5,
-    SBC_ind_y, SBC_ind_y_2, SBC_ind_y_3, SBC_ind_y_4, SBC_ind_y_5,
-    
-    SEC,
-    SED,
-    SEI, SEI_cont,
-    
-    STA_zpg,   STA_zpg_2,
-    STA_zpg_x, STA_zpg_x_2, STA_zpg_x_3,
-    STA_abs,   STA_abs_2,   STA_abs_3,
-    STA_abs_x, STA_abs_x_2, STA_abs_x_3, STA_abs_x_4,
-    STA_abs_y, STA_abs_y_2, STA_abs_y_3, STA_abs_y_4,
-    STA_ind_x, STA_ind_x_2, STA_ind_x_3, STA_ind_x_4, STA_ind_x_5,
-    STA_ind_y, STA_ind_y_2, STA_ind_y_3, STA_ind_y_4, STA_ind_y_5,
-    
-    STX_zpg,   STX_zpg_2,
-    STX_zpg_y, STX_zpg_y_2, STX_zpg_y_3,
-    STX_abs,   STX_abs_2,   STX_abs_3,
-    
-    STY_zpg,   STY_zpg_2,
-    STY_zpg_x, STY_zpg_x_2, STY_zpg_x_3,
-    STY_abs,   STY_abs_2,   STY_abs_3,
-    
-    TAX,
-    TAY,
-    TSX,
-    TXA,
-    TXS,
-    TYA,
-    
-    // Illegal instructions
-    
-    ALR_imm,
-    ANC_imm,
-    ANE_imm,
-    ARR_imm,
-    AXS_imm,
-    
-    DCP_zpg,   DCP_zpg_2,   DCP_zpg_3,   DCP_zpg_4,
-    DCP_zpg_x, DCP_zpg_x_2, DCP_zpg_x_3, DCP_zpg_x_4, DCP_zpg_x_5,
-    DCP_abs,   DCP_abs_2,   DCP_abs_3,   DCP_abs_4,   DCP_abs_5,
-    DCP_abs_x, DCP_abs_x_2, DCP_abs_x_3, DCP_abs_x_4, DCP_abs_x_5, DCP_abs_x_6,
-    DCP_abs_y, DCP_abs_y_2, DCP_abs_y_3, DCP_abs_y_4, DCP_abs_y_5, DCP_abs_y_6,
-    DCP_ind_x, DCP_ind_x_2, DCP_ind_x_3, DCP_ind_x_4, DCP_ind_x_5, DCP_ind_x_6, DCP_ind_x_7,
-    DCP_ind_y, DCP_ind_y_2, DCP_ind_y_3, DCP_ind_y_4, DCP_ind_y_5, DCP_ind_y_6, DCP_ind_y_7,
-    
-    ISC_zpg,   ISC_zpg_2,   ISC_zpg_3,   ISC_zpg_4,
-    ISC_zpg_x, ISC_zpg_x_2, ISC_zpg_x_3, ISC_zpg_x_4, ISC_zpg_x_5,
-    ISC_abs,   ISC_abs_2,   ISC_abs_3,   ISC_abs_4,   ISC_abs_5,
-    ISC_abs_x, ISC_abs_x_2, ISC_abs_x_3, ISC_abs_x_4, ISC_abs_x_5, ISC_abs_x_6,
-    ISC_abs_y, ISC_abs_y_2, ISC_abs_y_3, ISC_abs_y_4, ISC_abs_y_5, ISC_abs_y_6,
-    ISC_ind_x, ISC_ind_x_2, ISC_ind_x_3, ISC_ind_x_4, ISC_ind_x_5, ISC_ind_x_6, ISC_ind_x_7,
-    ISC_ind_y, ISC_ind_y_2, ISC_ind_y_3, ISC_ind_y_4, ISC_ind_y_5, ISC_ind_y_6, ISC_ind_y_7,
-    
-    LAS_abs_y, LAS_abs_y_2, LAS_abs_y_3, LAS_abs_y_4,
-    
-    LAX_zpg,   LAX_zpg_2,
-    LAX_zpg_y, LAX_zpg_y_2, LAX_zpg_y_3,
-    LAX_abs,   LAX_abs_2,   LAX_abs_3,
-    LAX_abs_y, LAX_abs_y_2, LAX_abs_y_3, LAX_abs_y_4,
-    LAX_ind_x, LAX_ind_x_2, LAX_ind_x_3, LAX_ind_x_4, LAX_ind_x_5,
-    LAX_ind_y, LAX_ind_y_2, LAX_ind_y_3, LAX_ind_y_4, LAX_ind_y_5,
-    
-    LXA_imm,
-    
-    RLA_zpg,   RLA_zpg_2,   RLA_zpg_3,   RLA_zpg_4,
-    RLA_zpg_x, RLA_zpg_x_2, RLA_zpg_x_3, RLA_zpg_x_4, RLA_zpg_x_5,
-    RLA_abs,   RLA_abs_2,   RLA_abs_3,   RLA_abs_4,   RLA_abs_5,
-    RLA_abs_x, RLA_abs_x_2, RLA_abs_x_3, RLA_abs_x_4, RLA_abs_x_5, RLA_abs_x_6,
-    RLA_abs_y, RLA_abs_y_2, RLA_abs_y_3, RLA_abs_y_4, RLA_abs_y_5, RLA_abs_y_6,
-    RLA_ind_x, RLA_ind_x_2, RLA_ind_x_3, RLA_ind_x_4, RLA_ind_x_5, RLA_ind_x_6, RLA_ind_x_7,
-    RLA_ind_y, RLA_ind_y_2, RLA_ind_y_3, RLA_ind_y_4, RLA_ind_y_5, RLA_ind_y_6, RLA_ind_y_7,
-    
-    RRA_zpg,   RRA_zpg_2,   RRA_zpg_3,   RRA_zpg_4,
-    RRA_zpg_x, RRA_zpg_x_2, RRA_zpg_x_3, RRA_zpg_x_4, RRA_zpg_x_5,
-    RRA_abs,   RRA_abs_2,   RRA_abs_3,   RRA_abs_4,   RRA_abs_5,
-    RRA_abs_x, RRA_abs_x_2, RRA_abs_x_3, RRA_abs_x_4, RRA_abs_x_5, RRA_abs_x_6,
-    RRA_abs_y, RRA_abs_y_2, RRA_abs_y_3, RRA_abs_y_4, RRA_abs_y_5, RRA_abs_y_6,
-    RRA_ind_x, RRA_ind_x_2, RRA_ind_x_3, RRA_ind_x_4, RRA_ind_x_5, RRA_ind_x_6, RRA_ind_x_7,
-    RRA_ind_y, RRA_ind_y_2, RRA_ind_y_3, RRA_ind_y_4, RRA_ind_y_5, RRA_ind_y_6, RRA_ind_y_7,
-    
-    SAX_zpg,   SAX_zpg_2,
-    SAX_zpg_y, SAX_zpg_y_2, SAX_zpg_y_3,
-    SAX_abs,   SAX_abs_2,   SAX_abs_3,
-    SAX_ind_x, SAX_ind_x_2, SAX_ind_x_3, SAX_ind_x_4, SAX_ind_x_5,
-    
-    SHA_ind_y, SHA_ind_y_2, SHA_ind_y_3, SHA_ind_y_4, SHA_ind_y_5,
-    SHA_abs_y, SHA_abs_y_2, SHA_abs_y_3, SHA_abs_y_4,
-    
-    SHX_abs_y, SHX_abs_y_2, SHX_abs_y_3, SHX_abs_y_4,
-    SHY_abs_x, SHY_abs_x_2, SHY_abs_x_3, SHY_abs_x_4,
-    
-    SLO_zpg,   SLO_zpg_2,   SLO_zpg_3,   SLO_zpg_4,
-    SLO_zpg_x, SLO_zpg_x_2, SLO_zpg_x_3, SLO_zpg_x_4, SLO_zpg_x_5,
-    SLO_abs,   SLO_abs_2,   SLO_abs_3,   SLO_abs_4,   SLO_abs_5,
-    SLO_abs_x, SLO_abs_x_2, SLO_abs_x_3, SLO_abs_x_4, SLO_abs_x_5, SLO_abs_x_6,
-    SLO_abs_y, SLO_abs_y_2, SLO_abs_y_3, SLO_abs_y_4, SLO_abs_y_5, SLO_abs_y_6,
-    SLO_ind_x, SLO_ind_x_2, SLO_ind_x_3, SLO_ind_x_4, SLO_ind_x_5, SLO_ind_x_6, SLO_ind_x_7,
-    SLO_ind_y, SLO_ind_y_2, SLO_ind_y_3, SLO_ind_y_4, SLO_ind_y_5, SLO_ind_y_6, SLO_ind_y_7,
-    
-    SRE_zpg,   SRE_zpg_2,   SRE_zpg_3,   SRE_zpg_4,
-    SRE_zpg_x, SRE_zpg_x_2, SRE_zpg_x_3, SRE_zpg_x_4, SRE_zpg_x_5,
-    SRE_abs,   SRE_abs_2,   SRE_abs_3,   SRE_abs_4,   SRE_abs_5,
-    SRE_abs_x, SRE_abs_x_2, SRE_abs_x_3, SRE_abs_x_4, SRE_abs_x_5, SRE_abs_x_6,
-    SRE_abs_y, SRE_abs_y_2, SRE_abs_y_3, SRE_abs_y_4, SRE_abs_y_5, SRE_abs_y_6,
-    SRE_ind_x, SRE_ind_x_2, SRE_ind_x_3, SRE_ind_x_4, SRE_ind_x_5, SRE_ind_x_6, SRE_ind_x_7,
-    SRE_ind_y, SRE_ind_y_2, SRE_ind_y_3, SRE_ind_y_4, SRE_ind_y_5, SRE_ind_y_6, SRE_ind_y_7,
-    
-    TAS_abs_y, TAS_abs_y_2, TAS_abs_y_3, TAS_abs_y_4
+    MICRO_INSTRUCTIONS(MICRO_INSTRUCTION_NAME)
     
 } MicroInstruction;
 
+/* Micro instructions are dispatched via computed goto (labels as values) if
+ * the compiler supports this GNU extension. Jumping through a table of label
+ * addresses saves the range check of the switch statement. To fall back to
+ * the portable switch statement, define CPU_SWITCH_DISPATCH.
+ */
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(CPU_SWITCH_DISPATCH)
+#define CPU_THREADED_DISPATCH
+#define MICRO_CASE(x) mi_##x:
+#define MICRO_DEFAULT
+#else
+#define MICRO_CASE(x) case x:
+#define MICRO_DEFAULT default:
+#endif
+
+//! @brief Jump targets of the threaded dispatcher in CPU::executeOneCycle()
+#define MICRO_INSTRUCTION_LABEL(x) &&mi_##x,
+#define MICRO_INSTRUCTION_LABELS MICRO_INSTRUCTIONS(MICRO_INSTRUCTION_LABEL)
+
 // Atomic CPU tasks
 #define FETCH_OPCODE \
     if (likely(rdyLine)) instr = mem->peek(regPC++); else return true;
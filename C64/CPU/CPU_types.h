@@ -30,6 +30,12 @@ typedef enum {
     MOS_6502 = 1
 } CPUModel;
 
+/*! @brief    Maximum number of cycles of a single instruction
+ *  @details  Reached by the read-modify-write instructions with indexed
+ *            indirect addressing, e.g., SLO ($nn,X).
+ */
+static const unsigned MAX_INSTRUCTION_CYCLES = 8;
+
 //! @brief    Addressing mode
 typedef enum {
     ADDR_IMPLIED,
@@ -55,17 +61,25 @@ typedef enum {
  *            following breakpoint types:
  *            HARD_BREAKPOINT : Execution is halted.
  *            SOFT_BREAKPOINT : Execution is halted and the tag is deleted.
+ *            TRAP            : A high-level emulation routine is invoked.
+ *            CONDITIONAL_BREAKPOINT : Execution is halted if the condition
+ *                              attached to the memory cell holds.
  */
 typedef enum {
     NO_BREAKPOINT   = 0x00,
     HARD_BREAKPOINT = 0x01,
-    SOFT_BREAKPOINT = 0x02
+    SOFT_BREAKPOINT = 0x02,
+    TRAP            = 0x04,
+    CONDITIONAL_BREAKPOINT = 0x08
 } Breakpoint;
 
 
 /*! @brief    Error state of the virtual CPU
  *  @details  CPU_OK indicates normal operation. When a (soft or hard)
  *            breakpoint is reached, state CPU_BREAKPOINT_REACHED is entered.
+ *            Conditional breakpoints enter CPU_HARD_BREAKPOINT_REACHED, too.
+ *            CPU_WATCHPOINT_REACHED is entered after an instruction has
+ *            accessed a watched memory location.
  *            CPU_ILLEGAL_INSTRUCTION is set when an opcode is not understood
  *            by the CPU. Once the CPU enters a different state than CPU_OK,
  *            the execution thread is terminated.
@@ -74,6 +88,7 @@ typedef enum {
     CPU_OK = 0,
     CPU_SOFT_BREAKPOINT_REACHED,
     CPU_HARD_BREAKPOINT_REACHED,
+    CPU_WATCHPOINT_REACHED,
     CPU_ILLEGAL_INSTRUCTION
 } ErrorState;
 
@@ -0,0 +1,316 @@
+/*!
+ * @file        Condition.cpp
+ * @author      Dirk W. Hoffmann, www.dirkwhoffmann.de
+ * @copyright   Dirk W. Hoffmann. All rights reserved.
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "C64.h"
+
+//! @brief    Instructions of the condition stack machine
+typedef enum : uint8_t {
+    
+    OP_CONST,   // Pushes the 16 bit constant stored in the next two bytes
+    OP_A,
+    OP_X,
+    OP_Y,
+    OP_SP,
+    OP_PC,
+    OP_P,
+    OP_FLAG,    // Pushes 1 if the flag stored in the next byte is set
+    OP_PEEK,
+    OP_NOT,
+    OP_CPL,
+    OP_NEG,
+    OP_ADD,
+    OP_SUB,
+    OP_AND,
+    OP_XOR,
+    OP_OR,
+    OP_EQ,
+    OP_NE,
+    OP_LT,
+    OP_LE,
+    OP_GT,
+    OP_GE,
+    OP_LAND,
+    OP_LOR
+    
+} ConditionOp;
+
+Condition::Condition()
+{
+    source[0] = 0;
+    codeSize = 0;
+    pos = source;
+    depth = 0;
+    error = false;
+}
+
+bool
+Condition::compile(const char *expression)
+{
+    Condition result;
+
+    if (strlen(expression) >= maxSourceSize) return false;
+    strcpy(result.source, expression);
+    
+    result.pos = result.source;
+    result.parseOr();
+    
+    // The whole expression must have been consumed
+    while (isspace(*result.pos)) result.pos++;
+    if (result.error || *result.pos || result.depth != 1) return false;
+    
+    *this = result;
+    return true;
+}
+
+bool
+Condition::eval(CPU *cpu, Memory *mem)
+{
+    int32_t stack[maxStackDepth];
+    unsigned sp = 0;
+    
+    for (unsigned i = 0; i < codeSize;) {
+        
+        switch ((ConditionOp)code[i++]) {
+                
+            case OP_CONST: stack[sp++] = LO_HI(code[i], code[i + 1]); i += 2; break;
+            case OP_A:     stack[sp++] = cpu->regA; break;
+            case OP_X:     stack[sp++] = cpu->regX; break;
+            case OP_Y:     stack[sp++] = cpu->regY; break;
+            case OP_SP:    stack[sp++] = cpu->regSP; break;
+            case OP_PC:    stack[sp++] = cpu->getPC(); break;
+            case OP_P:     stack[sp++] = cpu->getP(); break;
+            case OP_FLAG:  stack[sp++] = (cpu->getP() & code[i++]) != 0; break;
+            case OP_PEEK:  stack[sp - 1] = mem->spypeek((uint16_t)stack[sp - 1]); break;
+            case OP_NOT:   stack[sp - 1] = !stack[sp - 1]; break;
+            case OP_CPL:   stack[sp - 1] = ~stack[sp - 1]; break;
+            case OP_NEG:   stack[sp - 1] = -stack[sp - 1]; break;
+            case OP_ADD:   sp--; stack[sp - 1] += stack[sp]; break;
+            case OP_SUB:   sp--; stack[sp - 1] -= stack[sp]; break;
+            case OP_AND:   sp--; stack[sp - 1] &= stack[sp]; break;
+            case OP_XOR:   sp--; stack[sp - 1] ^= stack[sp]; break;
+            case OP_OR:    sp--; stack[sp - 1] |= stack[sp]; break;
+            case OP_EQ:    sp--; stack[sp - 1] = stack[sp - 1] == stack[sp]; break;
+            case OP_NE:    sp--; stack[sp - 1] = stack[sp - 1] != stack[sp]; break;
+            case OP_LT:    sp--; stack[sp - 1] = stack[sp - 1] < stack[sp]; break;
+            case OP_LE:    sp--; stack[sp - 1] = stack[sp - 1] <= stack[sp]; break;
+            case OP_GT:    sp--; stack[sp - 1] = stack[sp - 1] > stack[sp]; break;
+            case OP_GE:    sp--; stack[sp - 1] = stack[sp - 1] >= stack[sp]; break;
+            case OP_LAND:  sp--; stack[sp - 1] = stack[sp - 1] && stack[sp]; break;
+            case OP_LOR:   sp--; stack[sp - 1] = stack[sp - 1] || stack[sp]; break;
+                
+            default:
+                assert(false);
+                return false;
+        }
+    }
+    
+    assert(sp == 1);
+    return stack[0] != 0;
+}
+
+void
+Condition::emit(uint8_t op, int stackEffect)
+{
+    if (codeSize == maxCodeSize || (int)depth + stackEffect > (int)maxStackDepth) {
+        error = true;
+        return;
+    }
+    code[codeSize++] = op;
+    depth += stackEffect;
+}
+
+void
+Condition::emitConstant(uint16_t value)
+{
+    emit(OP_CONST, 1);
+    emit(LO_BYTE(value), 0);
+    emit(HI_BYTE(value), 0);
+}
+
+bool
+Condition::accept(const char *token)
+{
+    size_t length = strlen(token);
+    
+    while (isspace(*pos)) pos++;
+    if (strncmp(pos, token, length)) return false;
+    
+    // Don't mistake a logical operator for a bitwise one
+    if (length == 1 && (*token == '&' || *token == '|') && pos[1] == *token) {
+        return false;
+    }
+    
+    pos += length;
+    return true;
+}
+
+void
+Condition::parseOr()
+{
+    parseAnd();
+    while (!error && accept("||")) { parseAnd(); emit(OP_LOR, -1); }
+}
+
+void
+Condition::parseAnd()
+{
+    parseBitOr();
+    while (!error && accept("&&")) { parseBitOr(); emit(OP_LAND, -1); }
+}
+
+void
+Condition::parseBitOr()
+{
+    parseBitXor();
+    while (!error && accept("|")) { parseBitXor(); emit(OP_OR, -1); }
+}
+
+void
+Condition::parseBitXor()
+{
+    parseBitAnd();
+    while (!error && accept("^")) { parseBitAnd(); emit(OP_XOR, -1); }
+}
+
+void
+Condition::parseBitAnd()
+{
+    parseEquality();
+    while (!error && accept("&")) { parseEquality(); emit(OP_AND, -1); }
+}
+
+void
+Condition::parseEquality()
+{
+    parseRelation();
+    while (!error) {
+        if (accept("==")) { parseRelation(); emit(OP_EQ, -1); }
+        else if (accept("!=")) { parseRelation(); emit(OP_NE, -1); }
+        else return;
+    }
+}
+
+void
+Condition::parseRelation()
+{
+    parseSum();
+    while (!error) {
+        if (accept("<=")) { parseSum(); emit(OP_LE, -1); }
+        else if (accept(">=")) { parseSum(); emit(OP_GE, -1); }
+        else if (accept("<")) { parseSum(); emit(OP_LT, -1); }
+        else if (accept(">")) { parseSum(); emit(OP_GT, -1); }
+        else return;
+    }
+}
+
+void
+Condition::parseSum()
+{
+    parseUnary();
+    while (!error) {
+        if (accept("+")) { parseUnary(); emit(OP_ADD, -1); }
+        else if (accept("-")) { parseUnary(); emit(OP_SUB, -1); }
+        else return;
+    }
+}
+
+void
+Condition::parseUnary()
+{
+    if (accept("!")) { parseUnary(); emit(OP_NOT, 0); }
+    else if (accept("~")) { parseUnary(); emit(OP_CPL, 0); }
+    else if (accept("-")) { parseUnary(); emit(OP_NEG, 0); }
+    else parsePrimary();
+}
+
+void
+Condition::parsePrimary()
+{
+    static const struct { const char *name; uint8_t op; uint8_t flag; } names[] = {
+        
+        { "A", OP_A, 0 }, { "X", OP_X, 0 }, { "Y", OP_Y, 0 },
+        { "SP", OP_SP, 0 }, { "PC", OP_PC, 0 }, { "P", OP_P, 0 },
+        { "N", OP_FLAG, CPU::N_FLAG }, { "V", OP_FLAG, CPU::V_FLAG },
+        { "B", OP_FLAG, CPU::B_FLAG }, { "D", OP_FLAG, CPU::D_FLAG },
+        { "I", OP_FLAG, CPU::I_FLAG }, { "Z", OP_FLAG, CPU::Z_FLAG },
+        { "C", OP_FLAG, CPU::C_FLAG }
+    };
+    
+    if (error) return;
+    
+    if (accept("(")) {
+        parseOr();
+        if (!accept(")")) error = true;
+        return;
+    }
+    
+    if (accept("[")) {
+        parseOr();
+        emit(OP_PEEK, 0);
+        if (!accept("]")) error = true;
+        return;
+    }
+    
+    while (isspace(*pos)) pos++;
+    
+    if (isalpha(*pos)) {
+        
+        const char *start = pos;
+        while (isalnum(*pos)) pos++;
+        size_t length = pos - start;
+        
+        for (unsigned i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+            
+            if (length == strlen(names[i].name) &&
+                !strncasecmp(start, names[i].name, length)) {
+                
+                emit(names[i].op, 1);
+                if (names[i].op == OP_FLAG) emit(names[i].flag, 0);
+                return;
+            }
+        }
+        error = true;
+        return;
+    }
+    
+    parseNumber();
+}
+
+void
+Condition::parseNumber()
+{
+    unsigned base = 10;
+    
+    if (*pos == '$') { base = 16; pos++; }
+    else if (*pos == '%') { base = 2; pos++; }
+    else if (pos[0] == '0' && (pos[1] == 'x' || pos[1] == 'X')) { base = 16; pos += 2; }
+    
+    char *end;
+    unsigned long value = strtoul(pos, &end, base);
+    
+    // Reject missing digits, signs, and values exceeding 16 bit
+    if (end == pos || !isxdigit(*pos) || value > 0xFFFF) {
+        error = true;
+        return;
+    }
+    pos = end;
+    emitConstant((uint16_t)value);
+}
@@ -0,0 +1,118 @@
+/*!
+ * @header      Condition.h
+ * @author      Dirk W. Hoffmann, www.dirkwhoffmann.de
+ * @copyright   Dirk W. Hoffmann. All rights reserved.
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _CONDITION_INC
+#define _CONDITION_INC
+
+#include "basic.h"
+
+class CPU;
+class Memory;
+
+/*! @class    Breakpoint condition
+ *  @details  A condition is a boolean expression over the CPU registers and
+ *            the memory contents. It is compiled once into a compact stack
+ *            machine program which makes evaluating it in the fetch phase
+ *            cheap. The syntax follows C:
+ *
+ *            Operands:   A, X, Y, SP, PC, P, flags N, V, B, D, I, Z, C,
+ *                        numbers ($hex, 0xhex, %binary, decimal), and
+ *                        [expr] which reads a byte from memory.
+ *            Operators:  ! ~ - (unary), + -, & ^ |, == != < <= > >=,
+ *                        && || and parentheses, with the usual precedence.
+ *
+ *            Example:    "X == $10 && [$D012] >= 200 || !C"
+ *
+ *            Memory is read with spypeek(). Hence, evaluating a condition
+ *            has no side effects.
+ */
+class Condition {
+    
+    //! @brief    Maximum length of the source expression
+    static const unsigned maxSourceSize = 128;
+    
+    //! @brief    Maximum size of the compiled program in bytes
+    static const unsigned maxCodeSize = 128;
+    
+    //! @brief    Maximum number of stack elements the program may use
+    static const unsigned maxStackDepth = 16;
+    
+    //! @brief    Source expression
+    char source[maxSourceSize];
+    
+    //! @brief    Compiled program
+    uint8_t code[maxCodeSize];
+    
+    //! @brief    Size of the compiled program
+    unsigned codeSize;
+    
+    //! @brief    Parser position
+    const char *pos;
+    
+    //! @brief    Current stack depth while compiling
+    unsigned depth;
+    
+    //! @brief    Set by the parser when the expression is malformed
+    bool error;
+    
+    public:
+    
+    //! @brief    Constructor
+    Condition();
+    
+    /*! @brief    Compiles an expression.
+     *  @return   false, if the expression is malformed or too complex. In
+     *            that case, the condition keeps its old value.
+     */
+    bool compile(const char *expression);
+    
+    //! @brief    Returns the expression the condition has been compiled from.
+    const char *getSource() { return source; }
+    
+    //! @brief    Evaluates the condition.
+    bool eval(CPU *cpu, Memory *mem);
+    
+    private:
+    
+    //! @brief    Appends an instruction to the program.
+    void emit(uint8_t op, int stackEffect);
+    
+    //! @brief    Appends a push instruction for a constant.
+    void emitConstant(uint16_t value);
+    
+    //! @brief    Skips white space and consumes the token if it comes next.
+    bool accept(const char *token);
+    
+    // Recursive descent parser, one function per precedence level
+    void parseOr();
+    void parseAnd();
+    void parseBitOr();
+    void parseBitXor();
+    void parseBitAnd();
+    void parseEquality();
+    void parseRelation();
+    void parseSum();
+    void parseUnary();
+    void parsePrimary();
+    void parseNumber();
+};
+
+#endif
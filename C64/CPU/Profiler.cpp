@@ -0,0 +1,297 @@
+/*!
+ * @file        Profiler.cpp
+ * @author      Dirk W. Hoffmann, www.dirkwhoffmann.de
+ * @copyright   Dirk W. Hoffmann. All rights reserved.
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Profiler.h"
+#include <algorithm>
+#include <ctype.h>
+
+Profiler::Profiler()
+{
+    instructions = new uint64_t[65536];
+    cycles = new uint64_t[65536];
+    clear();
+}
+
+Profiler::~Profiler()
+{
+    delete[] instructions;
+    delete[] cycles;
+}
+
+void
+Profiler::clear()
+{
+    memset(instructions, 0, 65536 * sizeof(uint64_t));
+    memset(cycles, 0, 65536 * sizeof(uint64_t));
+
+    Node root = { 0, false, 0, 0, 0, 0, 0 };
+    nodes.clear();
+    nodes.push_back(root);
+    current = 0;
+    depth = 0;
+    overflow = 0;
+
+    prevPC = noInstruction;
+    prevOpcode = 0;
+    prevCycle = 0;
+    total = 0;
+    interruptPending = false;
+}
+
+void
+Profiler::call(uint16_t addr, bool interrupt)
+{
+    if (depth == maxDepth) {
+        overflow++;
+        return;
+    }
+
+    // Look up the callee
+    uint32_t node = nodes[current].child;
+    while (node && (nodes[node].addr != addr || nodes[node].interrupt != interrupt)) {
+        node = nodes[node].sibling;
+    }
+
+    // Create a new node if this call stack hasn't been seen before
+    if (!node) {
+        if (nodes.size() == maxNodes) {
+            overflow++;
+            return;
+        }
+        node = (uint32_t)nodes.size();
+        Node callee = { addr, interrupt, current, 0, nodes[current].child, 0, 0 };
+        nodes.push_back(callee);
+        nodes[current].child = node;
+    }
+
+    nodes[node].calls++;
+    current = node;
+    depth++;
+}
+
+void
+Profiler::ret()
+{
+    if (overflow) {
+        overflow--;
+    } else if (depth) {
+        current = nodes[current].parent;
+        depth--;
+    }
+}
+
+int
+Profiler::loadLabels(const char *path)
+{
+    FILE *file = fopen(path, "r");
+    if (!file) return -1;
+
+    char line[256], name[256];
+    unsigned addr;
+    int count = 0;
+
+    while (fgets(line, sizeof(line), file)) {
+
+        char *p = line;
+        while (isspace(*p)) p++;
+        if (strncmp(p, "al ", 3)) continue;
+        p += 3;
+        while (isspace(*p)) p++;
+
+        // Skip the optional memory space prefix (C:, 8:, ...)
+        if (p[0] && p[1] == ':') p += 2;
+
+        if (sscanf(p, "%x %255s", &addr, name) != 2 || addr > 0xFFFF) continue;
+        setLabel((uint16_t)addr, name[0] == '.' ? name + 1 : name);
+        count++;
+    }
+
+    fclose(file);
+    return count;
+}
+
+std::string
+Profiler::label(uint16_t addr)
+{
+    std::map<uint16_t, std::string>::iterator it = labels.upper_bound(addr);
+    if (it == labels.begin()) return "";
+
+    --it;
+    unsigned offset = addr - it->first;
+    if (offset == 0) return it->second;
+    if (offset >= 256) return "";
+
+    char buf[8];
+    snprintf(buf, sizeof(buf), "+%u", offset);
+    return it->second + buf;
+}
+
+std::string
+Profiler::symbolize(uint16_t addr)
+{
+    std::string result = label(addr);
+    if (result.empty()) {
+        char buf[8];
+        snprintf(buf, sizeof(buf), "%04X", addr);
+        result = buf;
+    }
+    return result;
+}
+
+std::vector<uint64_t>
+Profiler::inclusiveCycles()
+{
+    std::vector<uint64_t> result(nodes.size());
+
+    // Callees are always created after their callers
+    for (size_t i = nodes.size(); i-- > 0;) {
+        result[i] += nodes[i].cycles;
+        if (i) result[nodes[i].parent] += result[i];
+    }
+    return result;
+}
+
+std::string
+Profiler::nodeName(uint32_t node)
+{
+    if (node == 0) return "[root]";
+    std::string name = symbolize(nodes[node].addr);
+    return nodes[node].interrupt ? "[irq] " + name : name;
+}
+
+void
+Profiler::writeReport(FILE *file, unsigned limit)
+{
+    uint64_t total = totalCycles();
+    double scale = total ? 100.0 / (double)total : 0.0;
+    std::vector<uint64_t> inclusive = inclusiveCycles();
+
+    //
+    // Hot spots
+    //
+
+    std::vector<uint16_t> pcs;
+    for (unsigned pc = 0; pc < 65536; pc++) {
+        if (cycles[pc]) pcs.push_back((uint16_t)pc);
+    }
+    std::sort(pcs.begin(), pcs.end(), [this](uint16_t a, uint16_t b) {
+        return cycles[a] > cycles[b] || (cycles[a] == cycles[b] && a < b);
+    });
+
+    fprintf(file, "Total cycles: %llu\n\n", (unsigned long long)total);
+    fprintf(file, "%-24s %14s %7s %14s %6s\n",
+            "PC", "Cycles", "%", "Instructions", "CPI");
+    for (size_t i = 0; i < pcs.size() && i < limit; i++) {
+        uint16_t pc = pcs[i];
+        fprintf(file, "%04X %-19s %14llu %6.2f%% %14llu %6.2f\n",
+                pc, label(pc).c_str(),
+                (unsigned long long)cycles[pc], cycles[pc] * scale,
+                (unsigned long long)instructions[pc],
+                instructions[pc] ? (double)cycles[pc] / instructions[pc] : 0.0);
+    }
+
+    //
+    // Routines (all call stacks ending in the same routine are merged)
+    //
+
+    typedef struct { uint64_t self; uint64_t total; uint64_t calls; } Summary;
+    std::map<std::pair<bool, uint16_t>, Summary> routines;
+
+    for (uint32_t i = 1; i < nodes.size(); i++) {
+
+        // Don't count recursive calls twice in the total cycles
+        bool recursive = false;
+        for (uint32_t p = nodes[i].parent; p && !recursive; p = nodes[p].parent) {
+            recursive = nodes[p].addr == nodes[i].addr &&
+            nodes[p].interrupt == nodes[i].interrupt;
+        }
+        Summary &s = routines[std::make_pair(nodes[i].interrupt, nodes[i].addr)];
+        s.self += nodes[i].cycles;
+        s.total += recursive ? 0 : inclusive[i];
+        s.calls += nodes[i].calls;
+    }
+
+    std::vector<std::pair<bool, uint16_t>> keys;
+    for (auto &r : routines) keys.push_back(r.first);
+    std::sort(keys.begin(), keys.end(), [&routines](std::pair<bool, uint16_t> a,
+                                                    std::pair<bool, uint16_t> b) {
+        return routines[a].total > routines[b].total;
+    });
+
+    fprintf(file, "\n%-24s %14s %7s %14s %7s %10s\n",
+            "Routine", "Total", "%", "Self", "%", "Calls");
+    fprintf(file, "%-24s %14llu %6.2f%% %14llu %6.2f%% %10s\n", "[root]",
+            (unsigned long long)inclusive[0], inclusive[0] * scale,
+            (unsigned long long)nodes[0].cycles, nodes[0].cycles * scale, "-");
+    for (size_t i = 0; i < keys.size() && i < limit; i++) {
+        Summary &s = routines[keys[i]];
+        std::string name = symbolize(keys[i].second);
+        if (keys[i].first) name = "[irq] " + name;
+        fprintf(file, "%-24s %14llu %6.2f%% %14llu %6.2f%% %10llu\n",
+                name.c_str(),
+                (unsigned long long)s.total, s.total * scale,
+                (unsigned long long)s.self, s.self * scale,
+                (unsigned long long)s.calls);
+    }
+
+    //
+    // Call graph edges
+    //
+
+    std::map<std::pair<std::string, std::string>, Summary> edges;
+    for (uint32_t i = 1; i < nodes.size(); i++) {
+        Summary &e = edges[std::make_pair(nodeName(nodes[i].parent), nodeName(i))];
+        e.total += inclusive[i];
+        e.calls += nodes[i].calls;
+    }
+
+    std::vector<std::pair<std::string, std::string>> links;
+    for (auto &e : edges) links.push_back(e.first);
+    std::sort(links.begin(), links.end(), [&edges](const std::pair<std::string, std::string> &a,
+                                                   const std::pair<std::string, std::string> &b) {
+        return edges[a].total > edges[b].total;
+    });
+
+    fprintf(file, "\n%-24s %-24s %14s %10s\n", "Caller", "Callee", "Cycles", "Calls");
+    for (size_t i = 0; i < links.size() && i < limit; i++) {
+        Summary &e = edges[links[i]];
+        fprintf(file, "%-24s %-24s %14llu %10llu\n",
+                links[i].first.c_str(), links[i].second.c_str(),
+                (unsigned long long)e.total, (unsigned long long)e.calls);
+    }
+}
+
+void
+Profiler::writeFoldedStacks(FILE *file)
+{
+    for (uint32_t i = 0; i < nodes.size(); i++) {
+
+        if (nodes[i].cycles == 0) continue;
+
+        // Collect the call stack from the innermost routine outwards
+        std::string stack = nodeName(i);
+        for (uint32_t p = i; p; ) {
+            p = nodes[p].parent;
+            stack = nodeName(p) + ";" + stack;
+        }
+        fprintf(file, "%s %llu\n", stack.c_str(), (unsigned long long)nodes[i].cycles);
+    }
+}
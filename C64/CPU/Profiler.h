@@ -0,0 +1,274 @@
+/*!
+ * @header      Profiler.h
+ * @author      Dirk W. Hoffmann, www.dirkwhoffmann.de
+ * @copyright   Dirk W. Hoffmann. All rights reserved.
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _PROFILER_INC
+#define _PROFILER_INC
+
+#include "basic.h"
+#include <map>
+#include <string>
+#include <vector>
+
+/*! @class    Guest code profiler
+ *  @details  Counts the executed instructions and the consumed cycles for
+ *            each program counter value. In addition, the profiler keeps
+ *            track of subroutine calls (JSR, BRK) and interrupts (IRQ, NMI)
+ *            and their returns (RTS, RTI). It maintains a call tree whose
+ *            nodes represent call stacks. Each node sums up the cycles that
+ *            were spent in the called routine itself.
+ *
+ *            The cycles of an instruction are charged to the instruction
+ *            and to the call stack it was executed in. The cycles of the
+ *            interrupt sequence are charged to the interrupt handler.
+ *
+ *            The call tree is only an approximation. Code that manipulates
+ *            the return address on the stack or leaves a subroutine with a
+ *            jump confuses the profiler. To keep memory usage bounded, the
+ *            call stack depth and the number of nodes are limited. If a
+ *            limit is hit, the cycles are charged to the deepest node.
+ *  @see      CPU::startProfiling()
+ */
+class Profiler {
+
+    //! @brief    Maximum call stack depth
+    static const unsigned maxDepth = 64;
+
+    //! @brief    Maximum number of call tree nodes
+    static const unsigned maxNodes = 65536;
+
+    //! @brief    Marks the absence of a previous instruction
+    static const int noInstruction = -1;
+
+    //! @brief    Call tree node
+    typedef struct {
+
+        //! @brief    Entry address of the called routine
+        uint16_t addr;
+
+        //! @brief    True if the routine has been entered by an interrupt
+        bool interrupt;
+
+        //! @brief    Index of the caller node
+        uint32_t parent;
+
+        //! @brief    Index of the first callee node (0 = none)
+        uint32_t child;
+
+        //! @brief    Index of the next callee node of the same caller (0 = none)
+        uint32_t sibling;
+
+        //! @brief    Number of times this call stack has been entered
+        uint64_t calls;
+
+        //! @brief    Cycles spent in the routine itself
+        uint64_t cycles;
+
+    } Node;
+
+    //! @brief    Executed instructions per PC
+    uint64_t *instructions;
+
+    //! @brief    Consumed cycles per PC
+    uint64_t *cycles;
+
+    //! @brief    Call tree. Node 0 is the root.
+    std::vector<Node> nodes;
+
+    //! @brief    Node of the currently executed routine
+    uint32_t current;
+
+    //! @brief    Depth of the current node
+    unsigned depth;
+
+    /*! @brief    Returns that have to be ignored
+     *  @details  Counts the calls that have not been pushed, because the
+     *            maximum depth had been reached.
+     */
+    unsigned overflow;
+
+    //! @brief    Address of the previous instruction or noInstruction
+    int prevPC;
+
+    //! @brief    Opcode of the previous instruction
+    uint8_t prevOpcode;
+
+    //! @brief    Cycle of the previous fetch
+    uint64_t prevCycle;
+
+    //! @brief    Total number of profiled cycles
+    uint64_t total;
+
+    //! @brief    True if an interrupt sequence has been started
+    bool interruptPending;
+
+    //! @brief    Symbol names
+    std::map<uint16_t, std::string> labels;
+
+    public:
+
+    Profiler();
+    ~Profiler();
+
+    //! @brief    Deletes all collected data.
+    void clear();
+
+
+    //
+    //! @functiongroup Collecting data
+    //
+
+    //! @brief    Informs the profiler about an instruction fetch.
+    void instruction(uint16_t pc, uint8_t opcode, uint64_t cycle) {
+
+        retire(pc, cycle);
+        instructions[pc]++;
+        prevPC = pc;
+        prevOpcode = opcode;
+    }
+
+    /*! @brief    Informs the profiler about the start of an interrupt sequence.
+     *  @param    pc  Address of the instruction that is interrupted
+     */
+    void interrupt(uint16_t pc, uint64_t cycle) {
+
+        retire(pc, cycle);
+        prevPC = noInstruction;
+        interruptPending = true;
+    }
+
+    private:
+
+    /*! @brief    Completes the previous instruction or interrupt sequence.
+     *  @details  Charges the cycles since the last call and updates the call
+     *            tree.
+     *  @param    next  Address of the next instruction
+     */
+    void retire(uint16_t next, uint64_t cycle) {
+
+        uint64_t elapsed = cycle - prevCycle;
+        prevCycle = cycle;
+
+        if (prevPC != noInstruction) {
+
+            total += elapsed;
+            cycles[prevPC] += elapsed;
+            nodes[current].cycles += elapsed;
+
+            // Follow subroutine calls and returns
+            switch (prevOpcode) {
+                case 0x00: case 0x20: call(next, false); break;
+                case 0x40: case 0x60: ret(); break;
+            }
+
+        } else if (interruptPending) {
+
+            // The interrupt sequence is charged to the interrupt handler
+            call(next, true);
+            total += elapsed;
+            nodes[current].cycles += elapsed;
+            interruptPending = false;
+        }
+    }
+
+    //! @brief    Enters the callee node for the specified address.
+    void call(uint16_t addr, bool interrupt);
+
+    //! @brief    Returns to the caller node.
+    void ret();
+
+    public:
+
+
+    //
+    //! @functiongroup Accessing the collected data
+    //
+
+    //! @brief    Returns the number of instructions executed at a PC.
+    uint64_t instructionsAt(uint16_t pc) { return instructions[pc]; }
+
+    //! @brief    Returns the number of cycles consumed at a PC.
+    uint64_t cyclesAt(uint16_t pc) { return cycles[pc]; }
+
+    /*! @brief    Returns the total number of profiled cycles.
+     *  @details  In contrast to the sum of the cycles per PC, the result
+     *            includes the cycles of the interrupt sequences.
+     */
+    uint64_t totalCycles() { return total; }
+
+
+    //
+    //! @functiongroup Symbols
+    //
+
+    /*! @brief    Reads a VICE label file.
+     *  @details  Each line has the format "al [C:]addr .name" with a
+     *            hexadecimal address, as written by the VICE monitor
+     *            command "save_labels" or by assemblers like ACME or 64tass.
+     *            Other lines are ignored.
+     *  @return   Number of labels read or -1 if the file cannot be opened.
+     */
+    int loadLabels(const char *path);
+
+    //! @brief    Assigns a name to an address.
+    void setLabel(uint16_t addr, const char *name) { labels[addr] = name; }
+
+    /*! @brief    Returns a printable name for an address.
+     *  @details  Uses the nearest preceding label within 256 bytes (as in
+     *            "loop+3") or the hexadecimal address if there is none.
+     */
+    std::string symbolize(uint16_t addr);
+
+    private:
+
+    //! @brief    Returns the label part of symbolize() or an empty string.
+    std::string label(uint16_t addr);
+
+    public:
+
+
+    //
+    //! @functiongroup Exporting
+    //
+
+    /*! @brief    Writes a flat report.
+     *  @details  Lists the hottest PCs, the routines with their self and
+     *            total cycles, and the call graph edges.
+     *  @param    limit   Maximum number of lines per table
+     */
+    void writeReport(FILE *file, unsigned limit);
+
+    /*! @brief    Writes the call stacks in the folded format.
+     *  @details  Each line holds a call stack, with the routines separated
+     *            by semicolons, and the cycles spent in the innermost one.
+     *            This is the input format of flamegraph.pl and speedscope.
+     */
+    void writeFoldedStacks(FILE *file);
+
+    private:
+
+    //! @brief    Returns the cycles of all nodes including their callees.
+    std::vector<uint64_t> inclusiveCycles();
+
+    //! @brief    Returns the name of a call tree node.
+    std::string nodeName(uint32_t node);
+};
+
+#endif
@@ -0,0 +1,259 @@
+/*!
+ * @file        TraceStream.cpp
+ * @author      Dirk W. Hoffmann, www.dirkwhoffmann.de
+ * @copyright   Dirk W. Hoffmann. All rights reserved.
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "C64.h"
+
+//! @brief    Signature at the beginning of each trace file
+static const char signature[8] = { 'V', 'C', '6', '4', 'T', 'R', 'C', '1' };
+
+//! @brief    Header bits of a trace record
+enum {
+    TRACE_LENGTH = 0x03,
+    TRACE_PC = 0x04,
+    TRACE_A = 0x08,
+    TRACE_X = 0x10,
+    TRACE_Y = 0x20,
+    TRACE_SP = 0x40,
+    TRACE_P = 0x80
+};
+
+//! @brief    Maximum size of an encoded record
+static const size_t maxRecordSize = 1 + 10 + 2 + 3 + 5;
+
+TraceWriter::TraceWriter()
+{
+    queue = new Entry[queueSize];
+    head = 0;
+    tail = 0;
+    quit = false;
+    file = NULL;
+    failed = false;
+    records = 0;
+    stalls = 0;
+}
+
+TraceWriter::~TraceWriter()
+{
+    close();
+    delete [] queue;
+}
+
+bool
+TraceWriter::open(const char *path)
+{
+    close();
+    
+    if (!(file = fopen(path, "wb"))) return false;
+    
+    head = 0;
+    tail = 0;
+    quit = false;
+    failed = fwrite(signature, sizeof(signature), 1, file) != 1;
+    memset(&prev, 0, sizeof(prev));
+    prevLength = 0;
+    records = 0;
+    stalls = 0;
+    
+    if (pthread_create(&thread, NULL, threadMain, this) != 0) {
+        fclose(file);
+        file = NULL;
+        return false;
+    }
+    return true;
+}
+
+bool
+TraceWriter::close()
+{
+    if (!file) return true;
+    
+    quit.store(true, std::memory_order_release);
+    pthread_join(thread, NULL);
+    
+    failed |= fclose(file) != 0;
+    file = NULL;
+    return !failed;
+}
+
+void *
+TraceWriter::threadMain(void *writer)
+{
+    ((TraceWriter *)writer)->run();
+    return NULL;
+}
+
+void
+TraceWriter::run()
+{
+    uint8_t buffer[4096];
+    size_t fill = 0;
+    
+    while (true) {
+        
+        // Check for termination before looking at the queue to drain it
+        bool done = quit.load(std::memory_order_acquire);
+        unsigned h = head.load(std::memory_order_relaxed);
+        unsigned t = tail.load(std::memory_order_acquire);
+        
+        if (h == t) {
+            if (done) break;
+            usleep(1000);
+            continue;
+        }
+        
+        for (; h != t; h = (h + 1) & (queueSize - 1)) {
+            
+            if (fill + maxRecordSize > sizeof(buffer)) {
+                failed |= fwrite(buffer, fill, 1, file) != 1;
+                fill = 0;
+            }
+            fill += encode(queue[h], buffer + fill);
+        }
+        head.store(h, std::memory_order_release);
+    }
+    
+    if (fill) failed |= fwrite(buffer, fill, 1, file) != 1;
+}
+
+size_t
+TraceWriter::encode(const Entry &entry, uint8_t *buffer)
+{
+    const RecordedInstruction &i = entry.instr;
+    uint8_t *p = buffer + 1;
+    uint8_t header = entry.length & TRACE_LENGTH;
+    
+    if (i.pc != (uint16_t)(prev.pc + prevLength)) header |= TRACE_PC;
+    if (i.a != prev.a) header |= TRACE_A;
+    if (i.x != prev.x) header |= TRACE_X;
+    if (i.y != prev.y) header |= TRACE_Y;
+    if (i.sp != prev.sp) header |= TRACE_SP;
+    if (i.flags != prev.flags) header |= TRACE_P;
+    
+    // Elapsed cycles
+    uint64_t delta = i.cycle - prev.cycle;
+    do {
+        *p++ = (delta & 0x7F) | (delta > 0x7F ? 0x80 : 0x00);
+        delta >>= 7;
+    } while (delta);
+    
+    if (header & TRACE_PC) { *p++ = LO_BYTE(i.pc); *p++ = HI_BYTE(i.pc); }
+    
+    *p++ = i.byte1;
+    if (entry.length > 1) *p++ = i.byte2;
+    if (entry.length > 2) *p++ = i.byte3;
+    
+    if (header & TRACE_A) *p++ = i.a;
+    if (header & TRACE_X) *p++ = i.x;
+    if (header & TRACE_Y) *p++ = i.y;
+    if (header & TRACE_SP) *p++ = i.sp;
+    if (header & TRACE_P) *p++ = i.flags;
+    
+    buffer[0] = header;
+    prev = i;
+    prevLength = entry.length;
+    return p - buffer;
+}
+
+TraceReader::TraceReader()
+{
+    file = NULL;
+}
+
+TraceReader::~TraceReader()
+{
+    close();
+}
+
+bool
+TraceReader::open(const char *path)
+{
+    char buffer[sizeof(signature)];
+    
+    close();
+    
+    if (!(file = fopen(path, "rb"))) return false;
+    
+    if (fread(buffer, sizeof(buffer), 1, file) != 1 ||
+        memcmp(buffer, signature, sizeof(signature))) {
+        close();
+        return false;
+    }
+    
+    memset(&prev, 0, sizeof(prev));
+    prevLength = 0;
+    return true;
+}
+
+void
+TraceReader::close()
+{
+    if (file) fclose(file);
+    file = NULL;
+}
+
+bool
+TraceReader::read(RecordedInstruction *instr)
+{
+    if (!file) return false;
+    
+    int header = fgetc(file);
+    if (header == EOF) return false;
+    
+    RecordedInstruction i = prev;
+    uint8_t length = header & TRACE_LENGTH;
+    int c;
+    
+    // Elapsed cycles
+    uint64_t delta = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        if ((c = fgetc(file)) == EOF) return false;
+        delta |= (uint64_t)(c & 0x7F) << shift;
+        if (!(c & 0x80)) break;
+    }
+    i.cycle += delta;
+    
+    if (header & TRACE_PC) {
+        int lo = fgetc(file), hi = fgetc(file);
+        if (hi == EOF) return false;
+        i.pc = LO_HI(lo, hi);
+    } else {
+        i.pc = prev.pc + prevLength;
+    }
+    
+    uint8_t bytes[3] = { 0, 0, 0 };
+    if (length == 0 || fread(bytes, length, 1, file) != 1) return false;
+    i.byte1 = bytes[0];
+    i.byte2 = bytes[1];
+    i.byte3 = bytes[2];
+    
+    uint8_t *regs[] = { &i.a, &i.x, &i.y, &i.sp, &i.flags };
+    for (unsigned r = 0; r < 5; r++) {
+        if (header & (TRACE_A << r)) {
+            if ((c = fgetc(file)) == EOF) return false;
+            *regs[r] = (uint8_t)c;
+        }
+    }
+    
+    prev = i;
+    prevLength = length;
+    *instr = i;
+    return true;
+}
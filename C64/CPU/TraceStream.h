@@ -0,0 +1,190 @@
+/*!
+ * @header      TraceStream.h
+ * @author      Dirk W. Hoffmann, www.dirkwhoffmann.de
+ * @copyright   Dirk W. Hoffmann. All rights reserved.
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _TRACESTREAM_INC
+#define _TRACESTREAM_INC
+
+#include "basic.h"
+#include "CPU_types.h"
+#include <atomic>
+#include <pthread.h>
+
+/*! @brief    Trace file format
+ *  @details  A trace file starts with the 8 byte signature "VC64TRC1",
+ *            followed by one record per instruction. Each record is encoded
+ *            relative to its predecessor (initially, all values are 0):
+ *
+ *            1 byte    Bits 0-1: Length of the instruction (1 to 3)
+ *                      Bit 2:    PC does not follow the previous instruction
+ *                      Bit 3-7:  A, X, Y, SP, P have changed
+ *            varint    Elapsed cycles (LEB128, 7 bits per byte, low first)
+ *            2 bytes   PC (little endian, only if bit 2 is set)
+ *            1-3 bytes Instruction bytes
+ *            0-5 bytes Changed registers in the order of the header bits
+ *
+ *            A typical record takes five to six bytes.
+ */
+
+/*! @class    Streaming trace sink
+ *  @details  Writes recorded instructions into a trace file. The emulator
+ *            thread puts the instructions into a lock-free single producer,
+ *            single consumer queue. A background thread encodes them and
+ *            writes them to disk. If the queue runs full, the producer waits
+ *            for the writer. Hence, no instruction is ever lost.
+ *  @see      CPU::startStreaming()
+ */
+class TraceWriter {
+    
+    //! @brief    Queue entry
+    typedef struct {
+        RecordedInstruction instr;
+        uint8_t length;
+    } Entry;
+    
+    //! @brief    Number of queue entries (must be a power of two)
+    static const unsigned queueSize = 1 << 16;
+    
+    //! @brief    Instruction queue
+    Entry *queue;
+    
+    //! @brief    Read position (owned by the writer thread)
+    std::atomic<unsigned> head;
+    
+    //! @brief    Write position (owned by the emulator thread)
+    std::atomic<unsigned> tail;
+    
+    //! @brief    Asks the writer thread to drain the queue and terminate
+    std::atomic<bool> quit;
+    
+    //! @brief    The writer thread
+    pthread_t thread;
+    
+    //! @brief    Output file
+    FILE *file;
+    
+    //! @brief    Indicates that a write access has failed
+    bool failed;
+    
+    //! @brief    Last encoded instruction
+    RecordedInstruction prev;
+    
+    //! @brief    Length of the last encoded instruction
+    uint8_t prevLength;
+    
+    //! @brief    Number of recorded instructions
+    uint64_t records;
+    
+    //! @brief    Number of times the producer had to wait for the writer
+    uint64_t stalls;
+    
+    public:
+    
+    //! @brief    Constructor
+    TraceWriter();
+    
+    //! @brief    Destructor
+    ~TraceWriter();
+    
+    /*! @brief    Creates the trace file and launches the writer thread.
+     *  @return   false, if the file cannot be created.
+     */
+    bool open(const char *path);
+    
+    /*! @brief    Writes out all pending instructions and closes the file.
+     *  @return   false, if a write error has occurred.
+     */
+    bool close();
+    
+    //! @brief    Returns true if the trace file is open.
+    bool isOpen() { return file != NULL; }
+    
+    //! @brief    Returns the number of recorded instructions.
+    uint64_t numRecords() { return records; }
+    
+    //! @brief    Returns how often the emulator thread had to wait.
+    uint64_t numStalls() { return stalls; }
+    
+    //! @brief    Puts an instruction into the queue.
+    void record(const RecordedInstruction &instr, uint8_t length) {
+        
+        unsigned t = tail.load(std::memory_order_relaxed);
+        unsigned next = (t + 1) & (queueSize - 1);
+        
+        while (next == head.load(std::memory_order_acquire)) {
+            stalls++;
+            sched_yield();
+        }
+        queue[t].instr = instr;
+        queue[t].length = length;
+        records++;
+        tail.store(next, std::memory_order_release);
+    }
+    
+    private:
+    
+    //! @brief    Entry point of the writer thread
+    static void *threadMain(void *writer);
+    
+    //! @brief    Main loop of the writer thread
+    void run();
+    
+    //! @brief    Encodes a single instruction into a buffer
+    size_t encode(const Entry &entry, uint8_t *buffer);
+};
+
+/*! @class    Trace file reader
+ *  @details  Decodes the records of a trace file written by TraceWriter.
+ */
+class TraceReader {
+    
+    //! @brief    Input file
+    FILE *file;
+    
+    //! @brief    Last decoded instruction
+    RecordedInstruction prev;
+    
+    //! @brief    Length of the last decoded instruction
+    uint8_t prevLength;
+    
+    public:
+    
+    //! @brief    Constructor
+    TraceReader();
+    
+    //! @brief    Destructor
+    ~TraceReader();
+    
+    /*! @brief    Opens a trace file.
+     *  @return   false, if the file cannot be opened or is no trace file.
+     */
+    bool open(const char *path);
+    
+    //! @brief    Closes the trace file.
+    void close();
+    
+    /*! @brief    Decodes the next instruction.
+     *  @return   false, if the end of the file has been reached or if the
+     *            file is corrupt.
+     */
+    bool read(RecordedInstruction *instr);
+};
+
+#endif
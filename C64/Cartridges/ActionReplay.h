@@ -34,6 +34,7 @@ class ActionReplay3 : public Cartridge {
     using Cartridge::Cartridge;
     CartridgeType getCartridgeType() { return CRT_ACTION_REPLAY3; }
     uint8_t peek(uint16_t addr);
+    uint8_t *romPage(uint16_t addr) { return NULL; }
     uint8_t peekIO1(uint16_t addr);
     uint8_t peekIO2(uint16_t addr);
     void pokeIO1(uint16_t addr, uint8_t value);
@@ -67,6 +68,7 @@ class ActionReplay : public Cartridge {
     void reset();
     void resetCartConfig();
     uint8_t peek(uint16_t addr);
+    uint8_t *romPage(uint16_t addr) { return NULL; }
     uint8_t peekIO1(uint16_t addr);
     uint8_t peekIO2(uint16_t addr);
     void poke(uint16_t addr, uint8_t value);
@@ -368,6 +368,29 @@ Cartridge::peekRomH(uint16_t addr)
     return packet[chipH]->peek(addr + offsetH);
 }
 
+uint8_t *
+Cartridge::romPage(uint16_t addr)
+{
+    assert(isROMLaddr(addr) || isROMHaddr(addr));
+    
+    bool romL = isROMLaddr(addr);
+    uint8_t chip = romL ? chipL : chipH;
+    uint16_t mappedBytes = romL ? mappedBytesL : mappedBytesH;
+    uint16_t offset = romL ? offsetL : offsetH;
+    uint16_t relAddr = addr & 0x1F00;
+    
+    // Unmapped parts of the Rom area show RAM (see peek())
+    if (relAddr >= mappedBytes) {
+        return c64->mem.ram + (addr & 0xFF00);
+    }
+    
+    if (relAddr + 0x100 > mappedBytes || chip >= numPackets || packet[chip] == NULL ||
+        offset + relAddr + 0x100 > packet[chip]->size) {
+        return NULL;
+    }
+    return packet[chip]->pointer(offset + relAddr);
+}
+
 void
 Cartridge::poke(uint16_t addr, uint8_t value)
 {
@@ -387,6 +410,7 @@ Cartridge::poke(uint16_t addr, uint8_t value)
         
     // Question: Is it correct to write to RAM if no ROM is mapped?
      c64->mem.ram[addr] = value;
+     c64->mem.markDirty(addr);
 }
 
 uint32_t
@@ -474,6 +498,8 @@ Cartridge::bankInROML(unsigned nr, uint16_t size, uint16_t offset)
     chipL = nr;
     mappedBytesL = size;
     offsetL = offset;
+    c64->mem.updatePageTables();
+    c64->mem.updateCoverageTables();
 }
 
 void
@@ -482,6 +508,8 @@ Cartridge::bankInROMH(unsigned nr, uint16_t size, uint16_t offset)
     chipH = nr;
     mappedBytesH = size;
     offsetH = offset;
+    c64->mem.updatePageTables();
+    c64->mem.updateCoverageTables();
 }
 
 void
@@ -533,6 +561,8 @@ Cartridge::bankOut(unsigned nr)
         mappedBytesH = 0;
         offsetH = 0;
     }
+    c64->mem.updatePageTables();
+    c64->mem.updateCoverageTables();
 }
 
 void
@@ -545,5 +575,6 @@ Cartridge::pressResetButton()
     memcpy(ram, c64->mem.ram, 0xFFFF);
     c64->reset();
     memcpy(c64->mem.ram, ram, 0xFFFF);
+    c64->mem.markAllModified();
     resume();
 }
@@ -235,6 +235,16 @@ public:
     //! @brief    Same as peek, but without side effects.
     virtual uint8_t spypeek(uint16_t addr) { return peek(addr); }
     
+    /*! @brief    Returns the host memory that peek() reads a page from.
+     *  @details  C64Memory uses the returned pointer to read the page without
+     *            calling peek(). NULL is returned if the page is not backed
+     *            by a single memory block. Cartridges overriding peek(),
+     *            peekRomL(), or peekRomH() have to override this function,
+     *            too, if reading has side effects.
+     *  @param    addr  Start address of the page in the ROML or ROMH range
+     */
+    virtual uint8_t *romPage(uint16_t addr);
+    
     //! @brief    Same as peekRomL, but without side effects
     uint8_t spypeekRomL(uint16_t addr) { return peekRomL(addr); }
     
@@ -74,6 +74,9 @@ class CartridgeRom : public VirtualComponent {
     //! @brief    Reads a ROM cell without side effects
     uint8_t spypeek(uint16_t addr) { return peek(addr); }
     
+    //! @brief    Returns a pointer to a ROM cell
+    uint8_t *pointer(uint16_t addr) { assert(addr < size); return rom + addr; }
+    
     //! @brief    Writes a ROM cell
     void poke(uint16_t addr, uint8_t value) { }
     
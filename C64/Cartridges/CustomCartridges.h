@@ -132,6 +132,8 @@ public:
     CartridgeType getCartridgeType() { return CRT_ZAXXON; }
     uint8_t peekRomL(uint16_t addr);
     uint8_t spypeekRomL(uint16_t addr);
+    uint8_t *romPage(uint16_t addr) {
+        return isROMLaddr(addr) ? NULL : Cartridge::romPage(addr); }
 };
 
 //! @brief    Type 19 cartridges
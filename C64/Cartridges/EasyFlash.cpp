@@ -27,6 +27,7 @@ EasyFlash::EasyFlash(C64 *c64) : Cartridge(c64)
     flashRomH.setDescription("FlashRom_H");
 
     bank = 0;
+    chipBank = 0;
 
     // Allocate 256 bytes on-board RAM
     setRamCapacity(256);
@@ -89,14 +90,12 @@ EasyFlash::saveToBuffer(uint8_t **buffer)
 void
 EasyFlash::loadChip(unsigned nr, CRTFile *c)
 {
-    static int bank;
-    
     uint16_t chipSize = c->chipSize(nr);
     uint16_t chipAddr = c->chipAddr(nr);
     uint8_t *chipData = c->chipData(nr);
 
     if (nr == 0) {
-        bank = 0;
+        chipBank = 0;
     }
     
     if(chipSize != 0x2000) {
@@ -105,26 +104,26 @@ EasyFlash::loadChip(unsigned nr, CRTFile *c)
     }
 
     // Check for missing banks
-    if (bank % 2 == 0 && isROMHaddr(chipAddr)) {
-        debug(1, "Skipping Rom bank %dL ...\n", bank / 2);
-        bank++;
+    if (chipBank % 2 == 0 && isROMHaddr(chipAddr)) {
+        debug(1, "Skipping Rom bank %dL ...\n", chipBank / 2);
+        chipBank++;
     }
-    if (bank % 2 == 1 && isROMLaddr(chipAddr)) {
-        debug(1, "Skipping Rom bank %dH ...\n", bank / 2);
-        bank++;
+    if (chipBank % 2 == 1 && isROMLaddr(chipAddr)) {
+        debug(1, "Skipping Rom bank %dH ...\n", chipBank / 2);
+        chipBank++;
     }
 
     if (isROMLaddr(chipAddr)) {
             
-        debug(1, "Loading Rom bank %dL ...\n", bank / 2);
-        flashRomL.loadBank(bank / 2, chipData);
-        bank++;
+        debug(1, "Loading Rom bank %dL ...\n", chipBank / 2);
+        flashRomL.loadBank(chipBank / 2, chipData);
+        chipBank++;
     
     } else if (isROMHaddr(chipAddr)) {
 
-        debug(1, "Loading Rom bank %dH ...\n", bank / 2);
-        flashRomH.loadBank(bank / 2, chipData);
-        bank++;
+        debug(1, "Loading Rom bank %dH ...\n", chipBank / 2);
+        flashRomH.loadBank(chipBank / 2, chipData);
+        chipBank++;
         
     } else {
         
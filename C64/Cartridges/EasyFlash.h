@@ -33,6 +33,9 @@ class EasyFlash : public Cartridge {
     
     //!@brief    Selected memory bank
     uint8_t bank;
+    
+    //!@brief    Half bank that receives the next chip packet from a CRT file
+    unsigned chipBank;
 
 public:
     
@@ -60,6 +63,7 @@ public:
     
     void loadChip(unsigned nr, CRTFile *c);
     uint8_t peek(uint16_t addr);
+    uint8_t *romPage(uint16_t addr) { return NULL; }
     void poke(uint16_t addr, uint8_t value);
     uint8_t peekIO1(uint16_t addr);
     uint8_t peekIO2(uint16_t addr);
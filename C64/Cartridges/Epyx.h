@@ -56,6 +56,7 @@ class EpyxFastLoad : public Cartridge {
     uint8_t peekRomH(uint16_t addr);
     uint8_t spypeekRomL(uint16_t addr) { return Cartridge::peekRomL(addr); }
     uint8_t spypeekRomH(uint16_t addr) { return Cartridge::peekRomH(addr); }
+    uint8_t *romPage(uint16_t addr) { return NULL; }
     uint8_t peekIO1(uint16_t addr);
     uint8_t readIO1(uint16_t addr);
     uint8_t peekIO2(uint16_t addr);
@@ -62,10 +62,13 @@ ControlPort::loadFromBuffer(uint8_t **buffer)
 {
     VirtualComponent::loadFromBuffer(buffer);
     
-    // Discard any active joystick movements
-    button = false;
-    axisX = 0;
-    axisY = 0;
+    // Discard any active joystick movements (unless we are rolling back after
+    // running ahead, because the joystick is still in use then)
+    if (!c64->isRunningAhead()) {
+        button = false;
+        axisX = 0;
+        axisY = 0;
+    }
 }
 
 void
@@ -83,6 +83,10 @@ ExpansionPort::loadFromBuffer(uint8_t **buffer)
         cartridge->loadFromBuffer(buffer);
     }
     
+    // The memory tables may still point into the deleted cartridge
+    c64->mem.updatePageTables();
+    c64->mem.updateCoverageTables();
+    
     debug(2, "  Expansion port state loaded (%d bytes)\n", *buffer - old);
     assert(*buffer - old == stateSize());
 }
@@ -195,8 +199,10 @@ ExpansionPort::poke(uint16_t addr, uint8_t value)
 {
     if (cartridge != NULL) cartridge->poke(addr, value);
 
-    if (!c64->getUltimax())
+    if (!c64->getUltimax()) {
         c64->mem.ram[addr] = value;
+        c64->mem.markDirty(addr);
+    }
 }
 
 void
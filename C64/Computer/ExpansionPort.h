@@ -164,6 +164,9 @@ public:
     
     //! @brief    Returns true if a cartridge is attached to the expansion port
     bool getCartridgeAttached() { return cartridge != NULL; }
+    
+    //! @brief    Returns the attached cartridge (NULL if none is attached)
+    Cartridge *getCartridge() { return cartridge; }
 
     //! @brief    Attaches a cartridge to the expansion port.
     bool attachCartridge(Cartridge *c);
@@ -162,7 +162,8 @@ IEC::updateIecLines()
 
     if (signals_changed) {
         
-        c64->cia2.updatePA();
+        // In threaded mode, CIA2 fetches the new values by itself
+        if (!c64->driveThread.isActive()) c64->cia2.updatePA();
         
         // ATN signal is connected to CA1 pin of VIA 1
         c64->drive1.via1.CA1action(!atnLine);
@@ -188,30 +189,92 @@ IEC::updateIecLines()
 	}
 }
 
+void
+IEC::setNeedsUpdateC64Side()
+{
+    isDirtyC64Side = true;
+    c64->scheduleEvent(IEC_SLOT, 0);
+}
+
 void
 IEC::updateIecLinesC64Side()
 {
     // Get bus signals from C64 side
     uint8_t ciaBits = c64->cia2.getPA();
-    ciaAtn = !!(ciaBits & 0x08);
-    ciaClock = !!(ciaBits & 0x10);
-    ciaData = !!(ciaBits & 0x20);
     
-    updateIecLines();
+    if (c64->driveThread.isActive()) {
+        
+        // Let the drive thread update the bus when it reaches this cycle
+        c64->driveThread.changeIecLines(c64->cpu.cycle, ciaBits);
+        
+    } else {
+        
+        setCiaBits(ciaBits);
+    }
+    
     isDirtyC64Side = false;
+    c64->cancelEvent(IEC_SLOT);
+}
+
+void
+IEC::setCiaBits(uint8_t ciaBits)
+{
+    bool atn = !!(ciaBits & 0x08);
+    bool clock = !!(ciaBits & 0x10);
+    bool data = !!(ciaBits & 0x20);
+    
+    // Drives skipping an idle loop need to catch up before the bus changes
+    if (atn != ciaAtn || clock != ciaClock || data != ciaData) {
+        
+        if (c64->driveThread.isActive()) {
+            
+            // We are on the drive thread which runs on the drives' own time
+            c64->drive1.wakeUp();
+            c64->drive2.wakeUp();
+            
+        } else {
+            
+            c64->wakeUpDrive(&c64->drive1, c64->cpu.cycle - 1);
+            c64->wakeUpDrive(&c64->drive2, c64->cpu.cycle - 1);
+        }
+    }
+    
+    ciaAtn = atn;
+    ciaClock = clock;
+    ciaData = data;
+    
+    updateIecLines();
 }
 
 void
 IEC::updateIecLinesDriveSide()
 {
-    // Get bus signals from drive 1
-    uint8_t device1Bits = c64->drive1.via1.getPB();
+    // Get bus signals from both drives
+    uint8_t device1Bits = c64->drive1.via1.getPB() & 0x1A;
+    uint8_t device2Bits = c64->drive2.via1.getPB() & 0x1A;
+    
+    // A drive skipping an idle loop needs to catch up before the bus changes.
+    // Note that drive 1 is executed before drive 2 in each cycle.
+    uint8_t oldDevice1Bits = device1Atn << 4 | device1Clock << 3 | device1Data << 1;
+    uint8_t oldDevice2Bits = device2Atn << 4 | device2Clock << 3 | device2Data << 1;
+    if (device1Bits != oldDevice1Bits || device2Bits != oldDevice2Bits) {
+        
+        if (c64->driveThread.isActive()) {
+            
+            // We are on the drive thread which runs on the drives' own time
+            c64->drive1.wakeUp();
+            c64->drive2.wakeUp();
+            
+        } else {
+            
+            c64->wakeUpDrive(&c64->drive1, c64->cpu.cycle);
+            c64->wakeUpDrive(&c64->drive2, c64->cpu.cycle - 1);
+        }
+    }
+    
     device1Atn = !!(device1Bits & 0x10);
     device1Clock = !!(device1Bits & 0x08);
     device1Data = !!(device1Bits & 0x02);
-
-    // Get bus signals from drive 2
-    uint8_t device2Bits = c64->drive2.via1.getPB();
     device2Atn = !!(device2Bits & 0x10);
     device2Clock = !!(device2Bits & 0x08);
     device2Data = !!(device2Bits & 0x02);
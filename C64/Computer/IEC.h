@@ -93,7 +93,7 @@ public:
     
     //! @brief    Requensts an update of the bus lines from the C64 side.
     //! @deprecated
-    void setNeedsUpdateC64Side() { isDirtyC64Side = true; }
+    void setNeedsUpdateC64Side();
 
     //! @brief    Requensts an update of the bus lines from the drive side.
     //! @deprecated
@@ -105,6 +105,13 @@ public:
      */
     void updateIecLinesC64Side();
     void updateIecLinesDriveSide();
+    
+    /*! @brief    Updates the bus lines with new output bits from CIA2.
+     *  @details  In threaded drive mode, this function is called by the
+     *            drive thread when the drives have reached the cycle the
+     *            bits have been written in.
+     */
+    void setCiaBits(uint8_t ciaBits);
 
 	//! @brief    Execution function for observing the bus activity.
     /*! @details  This method is invoked periodically. It's only purpose is to
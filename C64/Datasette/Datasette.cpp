@@ -220,6 +220,8 @@ Datasette::pressPlay()
     if (!hasTape())
         return;
     
+    suspend();
+    
     debug("Datasette::pressPlay\n");
     playKey = true;
 
@@ -227,6 +229,11 @@ Datasette::pressPlay()
     uint64_t length = pulseLength();
     nextRisingEdge = length / 2;
     nextFallingEdge = length;
+    
+    // Let the main loop execute the datasette if the motor is running
+    if (motor) c64->scheduleEvent(DATASETTE_SLOT, 0);
+    
+    resume();
 }
 
 void
@@ -235,6 +242,7 @@ Datasette::pressStop()
     debug("Datasette::pressStop\n");
     setMotor(false);
     playKey = false;
+    c64->cancelEvent(DATASETTE_SLOT);
 }
 
 void
@@ -244,6 +252,12 @@ Datasette::setMotor(bool value)
         return;
     
     motor = value;
+    
+    if (motor && playKey) {
+        c64->scheduleEvent(DATASETTE_SLOT, 0);
+    } else {
+        c64->cancelEvent(DATASETTE_SLOT);
+    }
 }
 
 void
@@ -9,6 +9,7 @@
 #define DISK_TYPES_H
 
 #include <ctype.h>
+#include <stddef.h>
 
 /* Overview:
  *
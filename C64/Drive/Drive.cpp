@@ -59,6 +59,10 @@ VC1541::VC1541(unsigned nr)
         { &writeShiftreg,           sizeof(writeShiftreg),          CLEAR_ON_RESET },
         { &sync,                    sizeof(sync),                   CLEAR_ON_RESET },
         { &byteReady,               sizeof(byteReady),              CLEAR_ON_RESET },
+        { &idle,                    sizeof(idle),                   CLEAR_ON_RESET },
+        { &idleStart,               sizeof(idleStart),              CLEAR_ON_RESET },
+        { &idlePeriod,              sizeof(idlePeriod),             CLEAR_ON_RESET },
+        { &idleEnd,                 sizeof(idleEnd),                CLEAR_ON_RESET },
 
         // Disk properties (will survive reset)
         { &insertionStatus,         sizeof(insertionStatus),        KEEP_ON_RESET },
@@ -68,6 +72,9 @@ VC1541::VC1541(unsigned nr)
     
     insertionStatus = NOT_INSERTED;
     sendSoundMessages = true;
+    skipIdleLoops = false;
+    idle = false;
+    loopRecorded = false;
     resetDisk();
 }
 
@@ -83,6 +90,8 @@ VC1541::reset()
     
     cpu.regPC = 0xEAA0;
     halftrack = 41;
+    
+    loopRecorded = false;
 }
 
 void
@@ -113,6 +122,15 @@ VC1541::setClockFrequency(uint32_t frequency)
     debug("Duration a CPU cycle is %lld 1/10 nsec.\n", durationOfOneCpuCycle);
 }
 
+void
+VC1541::loadFromBuffer(uint8_t **buffer)
+{
+    VirtualComponent::loadFromBuffer(buffer);
+    
+    // An idle loop is continued, but the loop detection starts over
+    loopRecorded = false;
+}
+
 void 
 VC1541::dump()
 {
@@ -145,13 +163,21 @@ VC1541::execute(uint64_t duration)
 
         if (nextClock <= nextCarry) {
             
-            // Execute CPU and VIAs
-            uint64_t cycle = ++cpu.cycle;
-            result = cpu.executeOneCycle();
-            if (cycle >= via1.wakeUpCycle) via1.execute(); else via1.idleCounter++;
-            if (cycle >= via2.wakeUpCycle) via2.execute(); else via2.idleCounter++;
-            updateByteReady();
-            if (c64->iec.isDirtyDriveSide) c64->iec.updateIecLinesDriveSide();
+            if (skipIdleLoops && !idle && cpu.inFetchPhase()) detectIdleLoop();
+            
+            if (idle) {
+                
+                // Skip CPU and VIAs (nothing happens inside the idle loop)
+                uint64_t cycle = ++cpu.cycle;
+                via1.idleCounter++;
+                via2.idleCounter++;
+                if (cycle + 1 >= idleEnd) leaveIdleLoop();
+                
+            } else {
+                
+                // Execute CPU and VIAs
+                result = executeCpuCycle();
+            }
 
             nextClock += 10000;
 
@@ -167,6 +193,19 @@ VC1541::execute(uint64_t duration)
     return result;
 }
 
+bool
+VC1541::executeCpuCycle()
+{
+    uint64_t cycle = ++cpu.cycle;
+    bool result = cpu.executeOneCycle();
+    if (cycle >= via1.wakeUpCycle) via1.execute(); else via1.idleCounter++;
+    if (cycle >= via2.wakeUpCycle) via2.execute(); else via2.idleCounter++;
+    updateByteReady();
+    if (c64->iec.isDirtyDriveSide) c64->iec.updateIecLinesDriveSide();
+    
+    return result;
+}
+
 /*
 bool
 VC1541::execute(uint64_t duration)
@@ -201,6 +240,144 @@ VC1541::execute(uint64_t duration)
 }
 */
 
+void
+VC1541::setSkipIdleLoops(bool b)
+{
+    suspend();
+    
+    wakeUp();
+    skipIdleLoops = b;
+    loopRecorded = false;
+    
+    resume();
+}
+
+void
+VC1541::detectIdleLoop()
+{
+    uint16_t pc = cpu.regPC;
+    
+    if (!loopRecorded) {
+        
+        // Start over with the current instruction
+        loopPC = pc;
+        recordLoopStart();
+        
+    } else if (pc == loopPC) {
+        
+        // Check if the last iteration has changed anything
+        uint64_t period = cpu.cycle - loopCycle;
+        if (period <= 256 &&
+            mem.sideEffects == loopSideEffects &&
+            cpu.getLogicalState() == loopCpuState) {
+            
+            uint64_t via1State[VIA_STATE_WORDS];
+            uint64_t via2State[VIA_STATE_WORDS];
+            via1.getLogicalState(via1State);
+            via2.getLogicalState(via2State);
+            
+            if (memcmp(via1State, loopVia1State, sizeof(via1State)) == 0 &&
+                memcmp(via2State, loopVia2State, sizeof(via2State)) == 0) {
+                
+                enterIdleLoop(period);
+                if (idle) return;
+            }
+        }
+        recordLoopStart();
+        
+    } else if (pc <= lastPC) {
+        
+        // A backward jump marks the beginning of a potential loop
+        loopPC = pc;
+        recordLoopStart();
+    }
+    
+    lastPC = pc;
+}
+
+void
+VC1541::recordLoopStart()
+{
+    loopRecorded = true;
+    loopCycle = cpu.cycle;
+    loopSideEffects = mem.sideEffects;
+    loopCpuState = cpu.getLogicalState();
+    via1.getLogicalState(loopVia1State);
+    via2.getLogicalState(loopVia2State);
+}
+
+void
+VC1541::enterIdleLoop(uint64_t period)
+{
+    // The read/write logic must be inactive
+    if (spinning) return;
+    
+    // Interrupt signals must not be on their way
+    if (!cpu.interruptLinesSettled()) return;
+
+    // Breakpoints inside the loop must stay reachable
+    for (unsigned addr = loopPC; addr <= lastPC; addr++) {
+        if (cpu.hardBreakpoint(addr) || cpu.softBreakpoint(addr) ||
+            cpu.conditionalBreakpoint(addr)) return;
+    }
+    
+    // Skipped iterations would bypass the watchpoints and the profiler
+    if (mem.hasWatchpoints() || cpu.getProfiler()) return;
+    
+    // Both VIAs must be able to sleep
+    VIA6522 *vias[] = { &via1, &via2 };
+    for (unsigned i = 0; i < 2; i++) {
+        
+        VIA6522 *via = vias[i];
+        if (cpu.cycle + 1 < via->wakeUpCycle) continue;
+        if (via->idleCounter != 0 || !via->isStable()) return;
+        via->sleep();
+        via->tiredness = 0;
+    }
+    
+    // Skip until the first VIA timer runs out
+    uint64_t end = MIN(via1.wakeUpCycle, via2.wakeUpCycle);
+    
+    // The light barrier changes state after power up (see getLightBarrier())
+    if (cpu.cycle < powerUpCycles) end = MIN(end, powerUpCycles);
+    
+    // Only skip if a couple of iterations fit in
+    if (end <= cpu.cycle + 2 * period) return;
+    
+    idle = true;
+    idleStart = cpu.cycle;
+    idlePeriod = period;
+    idleEnd = end;
+}
+
+uint64_t
+VC1541::idleCycles(uint64_t duration)
+{
+    if (!idle) return 0;
+    
+    // Stay clear of the end of the idle phase by a few cycles
+    uint64_t remaining = idleEnd - cpu.cycle;
+    return remaining > 4 ? (remaining - 4) * 10000 / duration : 0;
+}
+
+void
+VC1541::leaveIdleLoop()
+{
+    assert(idle);
+    
+    // Rewind to the beginning of the current iteration
+    uint64_t phase = (cpu.cycle - idleStart) % idlePeriod;
+    cpu.cycle -= phase;
+    via1.idleCounter -= phase;
+    via2.idleCounter -= phase;
+    idle = false;
+    
+    // Emulate the current iteration up to the current cycle
+    for (uint64_t i = 0; i < phase; i++) {
+        (void)executeCpuCycle();
+    }
+}
+
 void
 VC1541::executeUF4()
 {
@@ -360,6 +537,7 @@ VC1541::powerOn()
     suspend();
     
     poweredOn = true;
+    c64->scheduleEvent(deviceNr == 1 ? DRIVE1_SLOT : DRIVE2_SLOT, 0);
     if (soundMessagesEnabled())
         c64->putMessage(MSG_VC1541_ATTACHED_SOUND, deviceNr);
     ping();
@@ -377,6 +555,7 @@ VC1541::powerOff()
     reset();
     
     poweredOn = false;
+    c64->cancelEvent(deviceNr == 1 ? DRIVE1_SLOT : DRIVE2_SLOT);
     if (soundMessagesEnabled())
         c64->putMessage(MSG_VC1541_DETACHED_SOUND, deviceNr);
     ping();
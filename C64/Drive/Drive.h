@@ -59,6 +59,11 @@ class VC1541 : public VirtualComponent {
         8125   // Density bits = 11: Carry pulse every 13/16 * 10^4 1/10 nsec
     };
     
+    /*! @brief    Number of CPU cycles the write barrier is blocked after power up
+     *  @see      getLightBarrier()
+     */
+    static const uint64_t powerUpCycles = 1500000;
+    
     
     //
     // Sub components
@@ -222,6 +227,59 @@ public:
      */
     bool byteReady;
     
+    
+    //
+    // Idle loop detection
+    //
+    
+private:
+    
+    /*! @brief    Indicates whether idle loops are fast forwarded.
+     *  @details  Most of the time, the drive CPU waits in a tight loop for
+     *            something to happen. If the motor is off, such a loop is
+     *            detected and skipped until a VIA timer runs out or the IEC
+     *            bus changes. The skipped cycles are replayed on demand, hence
+     *            the emulation stays cycle exact. Disabled by default.
+     */
+    bool skipIdleLoops;
+    
+    //! @brief    Indicates whether the CPU is trapped in an idle loop.
+    bool idle;
+    
+    //! @brief    Drive cycle in which the idle loop has been entered
+    uint64_t idleStart;
+    
+    //! @brief    Number of cycles needed for one iteration of the idle loop
+    uint64_t idlePeriod;
+    
+    //! @brief    Drive cycle in which the idle loop has to be left
+    uint64_t idleEnd;
+    
+    /*! @brief    Indicates whether a loop start has been recorded.
+     *  @details  If false, the next fetch phase records the start of a new
+     *            loop. This is the case after a reset and after restoring a
+     *            snapshot, which may have been taken in the middle of an
+     *            instruction where the logical CPU state is meaningless.
+     */
+    bool loopRecorded;
+    
+    //! @brief    Address of the previously executed instruction
+    uint16_t lastPC;
+    
+    //! @brief    Start address of the most recent backward jump
+    uint16_t loopPC;
+    
+    //! @brief    Drive cycle in which the CPU has been at loopPC
+    uint64_t loopCycle;
+    
+    //! @brief    Value of the memory side effect counter at loopPC
+    uint64_t loopSideEffects;
+    
+    //! @brief    Logical state of the CPU and the VIAs at loopPC
+    uint64_t loopCpuState;
+    uint64_t loopVia1State[VIA_STATE_WORDS];
+    uint64_t loopVia2State[VIA_STATE_WORDS];
+    
     public:
 
     //
@@ -245,6 +303,7 @@ public:
     void ping();
     void dump();
     void setClockFrequency(uint32_t frequency);
+    void loadFromBuffer(uint8_t **buffer);
 
     /*! @brief    Resets all disk related properties
      *  @note     This method is needed, because reset() keeps the disk alive.
@@ -262,6 +321,12 @@ public:
     //! @brief    Enables or disables sending of sound messages.
     void setSendSoundMessages(bool b) { sendSoundMessages = b; }
 
+    //! @brief    Returns true if idle loops are fast forwarded.
+    bool getSkipIdleLoops() { return skipIdleLoops; }
+    
+    //! @brief    Enables or disables fast forwarding of idle loops.
+    void setSkipIdleLoops(bool b);
+
     
     //
     //! @functiongroup Working with the drive
@@ -347,7 +412,7 @@ public:
      */
     bool getLightBarrier() {
         return
-        (cpu.cycle < 1500000)
+        (cpu.cycle < powerUpCycles)
         || hasPartiallyInsertedDisk()
         || disk.isWriteProtected();
     }
@@ -386,11 +451,51 @@ public:
      */
     bool execute(uint64_t duration);
 
+    //! @brief    Returns true if the CPU is trapped in an idle loop.
+    bool isIdle() { return idle; }
+    
+    /*! @brief    Leaves the idle loop.
+     *  @details  Needs to be called before anything is changed the drive
+     *            could observe, e.g., the IEC bus lines. The function replays
+     *            the last iteration up to the current cycle.
+     */
+    void wakeUp() { if (idle) leaveIdleLoop(); }
+    
+    /*! @brief    Returns the number of C64 cycles the drive can be left alone.
+     *  @details  If the CPU is trapped in an idle loop, the drive does not
+     *            need to be executed in each cycle. The skipped time can be
+     *            made up for by a single call to execute() later.
+     *  @param    duration is the duration of a C64 cycle in 1/10 nano seconds.
+     */
+    uint64_t idleCycles(uint64_t duration);
+    
 private:
     
+    //! @brief   Emulates a single cycle of the CPU and the VIAs.
+    bool executeCpuCycle();
+    
     //! @brief   Emulates a trigger event on the carry output pin of UE7.
     void executeUF4();
     
+    /*! @brief   Checks if the CPU has completed an idle loop iteration.
+     *  @details Called at the beginning of each instruction. A loop is
+     *           considered idle if the CPU and both VIAs are in the same
+     *           logical state as in the previous iteration and nothing has
+     *           been written to memory in the meantime.
+     */
+    void detectIdleLoop();
+    
+    //! @brief   Records the current state as the start of a loop iteration.
+    void recordLoopStart();
+    
+    /*! @brief   Starts to skip the idle loop if possible.
+     *  @param   period Number of cycles needed for a single iteration
+     */
+    void enterIdleLoop(uint64_t period);
+    
+    //! @brief   Work horse for wakeUp()
+    void leaveIdleLoop();
+    
 public:
 
     /*! @brief    Returns true iff drive is in read mode
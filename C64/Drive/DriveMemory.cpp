@@ -31,6 +31,7 @@ VC1541Memory::VC1541Memory(VC1541 *drive)
     
     memset(rom, 0, sizeof(rom));
     stack = &ram[0x0100];
+    sideEffects = 0;
     
     // Register snapshot items
     SnapshotItem items[] = {
@@ -56,6 +57,16 @@ VC1541Memory::reset()
     for (unsigned i = 0; i < sizeof(ram); i++) {
         ram[i] = (i & 64) ? 0xFF : 0x00;
     }
+    markAllModified();
+    markAllDirty();
+}
+
+void
+VC1541Memory::loadFromBuffer(uint8_t **buffer)
+{
+    VirtualComponent::loadFromBuffer(buffer);
+    markAllModified();
+    markAllDirty();
 }
 
 void 
@@ -70,6 +81,8 @@ VC1541Memory::dump()
 uint8_t 
 VC1541Memory::peek(uint16_t addr)
 {
+    watchRead(addr);
+    
     if (addr >= 0x8000) {
         
         // 0xC000 - 0xFFFF : ROM
@@ -86,11 +99,15 @@ VC1541Memory::peek(uint16_t addr)
         // 0x0800 - 0x17FF : unmapped
         // 0x1800 - 0x1BFF : VIA 1 (repeats every 16 bytes)
         // 0x1C00 - 0x1FFF : VIA 2 (repeats every 16 bytes)
+        if (addr < 0x0800) return ram[addr];
+        if (addr < 0x1800) return addr >> 8;
+        
+        // Reading a timer makes the program depend on the elapsed time
+        uint8_t reg = addr & 0xF;
+        if (reg == 0x4 || reg == 0x5 || reg == 0x8 || reg == 0x9) sideEffects++;
+        
         return
-        (addr < 0x0800) ? ram[addr] :
-        (addr < 0x1800) ? addr >> 8 :
-        (addr < 0x1C00) ? drive->via1.peek(addr & 0xF) :
-        drive->via2.peek(addr & 0xF);
+        (addr < 0x1C00) ? drive->via1.peek(reg) : drive->via2.peek(reg);
     }
 }
 
@@ -112,6 +129,8 @@ VC1541Memory::spypeek(uint16_t addr)
 void 
 VC1541Memory::poke(uint16_t addr, uint8_t value)
 {
+    watchWrite(addr, value);
+    
     if (addr >= 0x8000) { // ROM
         return;
     }
@@ -120,10 +139,19 @@ VC1541Memory::poke(uint16_t addr, uint8_t value)
     addr &= 0x1FFF;
     
     if (addr < 0x0800) { // RAM
-        ram[addr] = value;
+        if (ram[addr] != value) {
+            ram[addr] = value;
+            sideEffects++;
+            markModified(addr);
+            markDirty(addr);
+        }
         return;
     }
     
+    if (addr >= 0x1800) { // VIA 1 or VIA 2
+        sideEffects++;
+    }
+    
     if (addr >= 0x1C00) { // VIA 2
         drive->via2.poke(addr & 0xF, value);
         return;
@@ -135,3 +163,39 @@ VC1541Memory::poke(uint16_t addr, uint8_t value)
     }
 }
 
+void
+VC1541Memory::addCoverageRegions()
+{
+    coverage->addRegion("DRIVE_RAM", 0x0800);
+    coverage->addRegion("DRIVE_ROM", 0x4000);
+    coverage->addRegion("DRIVE_VIA", 0x0800);
+}
+
+void
+VC1541Memory::mapCoverage()
+{
+    // The mapping is fixed and repeats every 8KB (Rom: 16KB)
+    for (unsigned page = 0; page < 256; page++) {
+        
+        uint16_t addr = page << 8;
+        uint16_t mirrored = addr & 0x1FFF;
+        
+        if (addr >= 0x8000) {
+            mapCoveragePage(COVER_EXEC, page, COVER_ROM, addr & 0x3FFF);
+            mapCoveragePage(COVER_READ, page, COVER_ROM, addr & 0x3FFF);
+            mapCoveragePage(COVER_WRITE, page, -1, 0);
+        } else if (mirrored < 0x0800) {
+            mapCoveragePage(COVER_EXEC, page, COVER_RAM, mirrored);
+            mapCoveragePage(COVER_READ, page, COVER_RAM, mirrored);
+            mapCoveragePage(COVER_WRITE, page, COVER_RAM, mirrored);
+        } else if (mirrored >= 0x1800) {
+            mapCoveragePage(COVER_EXEC, page, COVER_VIA, mirrored - 0x1800);
+            mapCoveragePage(COVER_READ, page, COVER_VIA, mirrored - 0x1800);
+            mapCoveragePage(COVER_WRITE, page, COVER_VIA, mirrored - 0x1800);
+        } else {
+            mapCoveragePage(COVER_EXEC, page, -1, 0);
+            mapCoveragePage(COVER_READ, page, -1, 0);
+            mapCoveragePage(COVER_WRITE, page, -1, 0);
+        }
+    }
+}
@@ -43,6 +43,13 @@ class VC1541Memory : public Memory {
     //! @brief    Read Only Memory
     uint8_t rom[0x4000];
     
+    /*! @brief    Counts all memory accesses with side effects
+     *  @details  The counter is increased whenever the CPU modifies RAM,
+     *            writes into a VIA register, or reads a VIA timer. It is
+     *            used by the drive to detect idle loops.
+     */
+    uint64_t sideEffects;
+    
     
     //
     //! @functiongroup Creating and destructing
@@ -61,6 +68,17 @@ class VC1541Memory : public Memory {
 
 	void reset();
 	void dump();
+    void loadFromBuffer(uint8_t **buffer);
+
+    
+    //
+    //! @functiongroup Methods from Memory
+    //
+    
+    /*! @details  The drive has 2KB of RAM. Hence, only the first eight bits
+     *            of the dirty page bitmap are used.
+     */
+    void markAllDirty() { markDirty(0x0000, sizeof(ram) - 1); }
 
     
     //
@@ -77,14 +95,37 @@ class VC1541Memory : public Memory {
 
     // Reading from memory
     uint8_t peek(uint16_t addr);
-    uint8_t peekZP(uint8_t addr) { return ram[addr]; }
+    uint8_t peekZP(uint8_t addr) { watchRead(addr); return ram[addr]; }
 
     // Reading from memory without side effects
     uint8_t spypeek(uint16_t addr);
     
+    // Caching memory contents
+    bool isCacheable(uint16_t addr) { return addr < 0x0800 || addr >= 0x8000; }
+    
+    private:
+    
+    //! @brief    Coverage regions (RAM, Rom, and the VIA registers $1800 - $1FFF)
+    enum { COVER_RAM, COVER_ROM, COVER_VIA };
+    
+    //! @brief    Method from Memory
+    void addCoverageRegions();
+    
+    //! @brief    Method from Memory
+    void mapCoverage();
+    
+    public:
+    
     // Writing into memory
     void poke(uint16_t addr, uint8_t value);
-    void pokeZP(uint8_t addr, uint8_t value) { ram[addr] = value; }
+    void pokeZP(uint8_t addr, uint8_t value) {
+        watchWrite(addr, value);
+        if (ram[addr] != value) {
+            ram[addr] = value; sideEffects++; pageVersion[0]++; markDirty(0x0000); } }
+    void pokeStack(uint8_t sp, uint8_t value) {
+        watchWrite(0x100 | sp, value);
+        if (stack[sp] != value) {
+            stack[sp] = value; sideEffects++; pageVersion[1]++; markDirty(0x100); } }
 };
 
 #endif
@@ -0,0 +1,248 @@
+/*!
+ * @file        DriveThread.cpp
+ * @author      Dirk W. Hoffmann, www.dirkwhoffmann.de
+ * @copyright   Dirk W. Hoffmann. All rights reserved.
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "C64.h"
+#include <sched.h>
+
+DriveThread::DriveThread(C64 *c64)
+{
+    setDescription("DriveThread");
+
+    this->c64 = c64;
+    active = false;
+    base = 0;
+    granted = 0;
+    completed = 0;
+    stopped = false;
+    quit = false;
+    sleeping = false;
+    head = 0;
+    tail = 0;
+    lastBits = -1;
+
+    pthread_mutex_init(&lock, NULL);
+    pthread_cond_init(&wakeupCond, NULL);
+}
+
+DriveThread::~DriveThread()
+{
+    terminate();
+
+    pthread_cond_destroy(&wakeupCond);
+    pthread_mutex_destroy(&lock);
+}
+
+void
+DriveThread::launch()
+{
+    if (active) return;
+
+    debug(2, "Launching drive thread\n");
+
+    granted = 0;
+    completed = 0;
+    stopped = false;
+    quit = false;
+    head = 0;
+    tail = 0;
+    rebase(c64->cpu.cycle);
+
+    active = true;
+    pthread_create(&thread, NULL, threadMain, this);
+}
+
+void
+DriveThread::terminate()
+{
+    if (!active) return;
+
+    debug(2, "Terminating drive thread\n");
+
+    synchronize(c64->cpu.cycle);
+
+    quit = true;
+    wakeup();
+    pthread_join(thread, NULL);
+    active = false;
+}
+
+void
+DriveThread::rebase(uint64_t cycle)
+{
+    assert(completed == granted);
+    assert(head == tail);
+
+    base = cycle - granted.load();
+    lastBits = -1;
+}
+
+bool
+DriveThread::synchronize(uint64_t cycle)
+{
+    if (!active) return true;
+    
+    // Cycle counts are compared by their difference, because the time base
+    // wraps around if the C64 has jumped back in time (run-ahead mode).
+    uint64_t target = cycle - base;
+    
+    if ((int64_t)(target - granted.load(std::memory_order_relaxed)) > 0) {
+        granted.store(target, std::memory_order_release);
+    }
+
+    for (unsigned spins = 0; ; spins++) {
+
+        if ((int64_t)(completed.load(std::memory_order_acquire) - target) >= 0 &&
+            head.load(std::memory_order_acquire) == tail.load(std::memory_order_relaxed)) {
+            return !stopped.load(std::memory_order_relaxed);
+        }
+
+        if (spins == 0) wakeup();
+
+        // Don't steal the time slice from the drive thread on small machines
+        if (spins >= 64) sched_yield();
+    }
+}
+
+void
+DriveThread::changeIecLines(uint64_t cycle, uint8_t bits)
+{
+    bits &= 0x38;
+    if (bits == lastBits) return;
+    lastBits = bits;
+
+    unsigned t = tail.load(std::memory_order_relaxed);
+    unsigned next = (t + 1) % queueSize;
+
+    // Wait until there is space in the queue
+    if (next == head.load(std::memory_order_acquire)) {
+        synchronize(cycle - 1);
+    }
+
+    queue[t].cycle = cycle - base;
+    queue[t].bits = bits;
+    tail.store(next, std::memory_order_release);
+}
+
+void
+DriveThread::clearStop()
+{
+    stopped = false;
+}
+
+void
+DriveThread::wakeup()
+{
+    pthread_mutex_lock(&lock);
+    if (sleeping) {
+        sleeping = false;
+        pthread_cond_signal(&wakeupCond);
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+bool
+DriveThread::hasWork()
+{
+    if (quit) return true;
+
+    uint64_t cycle = completed.load(std::memory_order_relaxed);
+    if (cycle < granted.load(std::memory_order_acquire)) return true;
+
+    // Check for a bus change that is due before the next cycle
+    unsigned h = head.load(std::memory_order_relaxed);
+    return h != tail.load(std::memory_order_acquire) && queue[h].cycle <= cycle + 1;
+}
+
+void *
+DriveThread::threadMain(void *driveThread)
+{
+    ((DriveThread *)driveThread)->run();
+    return NULL;
+}
+
+void
+DriveThread::run()
+{
+    unsigned idle = 0;
+
+    while (!quit) {
+
+        uint64_t cycle = completed.load(std::memory_order_relaxed);
+        uint64_t limit = granted.load(std::memory_order_acquire);
+
+        // Apply the C64's bus changes that are due before the next cycle
+        applyIecChanges(cycle + 1);
+
+        if (cycle >= limit) {
+
+            // Nothing to do. Spin for a while and go to sleep afterwards.
+            if (++idle < 1024) continue;
+            if (idle < 4096) { sched_yield(); continue; }
+
+            pthread_mutex_lock(&lock);
+            sleeping = true;
+            while (sleeping && !hasWork()) {
+                pthread_cond_wait(&wakeupCond, &lock);
+            }
+            sleeping = false;
+            pthread_mutex_unlock(&lock);
+            idle = 0;
+            continue;
+        }
+        idle = 0;
+
+        // Skip all granted cycles if no drive is connected
+        if (c64->drive1.isPoweredOff() && c64->drive2.isPoweredOff()) {
+            applyIecChanges(limit);
+            completed.store(limit, std::memory_order_release);
+            continue;
+        }
+
+        // Emulate all granted cycles
+        while (cycle < limit) {
+
+            bool result = true;
+
+            applyIecChanges(++cycle);
+            if (c64->drive1.isPoweredOn()) result &= c64->drive1.execute(c64->durationOfOneCycle);
+            if (c64->drive2.isPoweredOn()) result &= c64->drive2.execute(c64->durationOfOneCycle);
+            completed.store(cycle, std::memory_order_release);
+
+            // Breakpoints are reported to the C64 thread in grant(). As the
+            // C64 notices them with a delay, the drives keep on running until
+            // all granted cycles have been emulated.
+            if (!result) stopped = true;
+        }
+    }
+}
+
+void
+DriveThread::applyIecChanges(uint64_t cycle)
+{
+    unsigned h = head.load(std::memory_order_relaxed);
+
+    while (h != tail.load(std::memory_order_acquire) && queue[h].cycle <= cycle) {
+
+        c64->iec.setCiaBits(queue[h].bits);
+        h = (h + 1) % queueSize;
+        head.store(h, std::memory_order_release);
+    }
+}
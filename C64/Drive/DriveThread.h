@@ -0,0 +1,189 @@
+/*!
+ * @header      DriveThread.h
+ * @author      Dirk W. Hoffmann, www.dirkwhoffmann.de
+ * @copyright   Dirk W. Hoffmann. All rights reserved.
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _DRIVETHREAD_INC
+#define _DRIVETHREAD_INC
+
+#include "VC64Object.h"
+#include <atomic>
+#include <pthread.h>
+
+class C64;
+
+/*! @class    DriveThread
+ *  @brief    Emulates the VC1541 drives on a separate host thread.
+ *  @details  In threaded mode, the C64 thread stops calling VC1541::execute()
+ *            itself. Instead, it grants the drive thread the permission to
+ *            emulate all cycles up to the current C64 cycle. The drives are
+ *            allowed to lag behind the C64, but they never run ahead.
+ *
+ *            Both sides only interact via the IEC bus:
+ *
+ *            C64 -> Drive: Whenever the C64 changes its bus outputs, the new
+ *            CIA2 bits are stored in a time-stamped queue. The drive thread
+ *            applies them exactly in the cycle they were written in.
+ *
+ *            Drive -> C64: The C64 can only observe the drives by reading the
+ *            bus lines via CIA2. Before doing so, the C64 thread waits until
+ *            the drives have caught up (synchronize()).
+ *
+ *            Because the drives never run ahead, no rollback is needed and
+ *            the emulation stays cycle-exact. Outside the main loop, e.g.,
+ *            at the end of each frame, both sides are fully synchronized.
+ *            Hence, the rest of the emulator can access the drives as usual.
+ */
+class DriveThread : public VC64Object {
+
+    //! @brief    Reference to the virtual C64
+    C64 *c64;
+
+    //! @brief    The host thread
+    pthread_t thread;
+
+    //! @brief    Indicates if the host thread has been launched
+    bool active;
+
+    /*! @brief    Offset between C64 cycles and drive thread cycles
+     *  @details  The drive thread counts cycles from its own time base. This
+     *            allows the C64 to jump in time (reset, snapshots) without
+     *            modifying any variables the drive thread is looking at.
+     *            Only accessed by the C64 thread.
+     */
+    uint64_t base;
+
+    //! @brief    Number of cycles the drive thread is allowed to emulate
+    std::atomic<uint64_t> granted;
+
+    //! @brief    Number of cycles the drive thread has emulated
+    std::atomic<uint64_t> completed;
+
+    //! @brief    Set if a drive has hit a breakpoint or a jam
+    std::atomic<bool> stopped;
+
+    //! @brief    Asks the drive thread to terminate
+    std::atomic<bool> quit;
+
+    //! @brief    Set while the drive thread is waiting for work
+    std::atomic<bool> sleeping;
+
+    //! @brief    Used to put the idle drive thread to sleep
+    pthread_mutex_t lock;
+    pthread_cond_t wakeupCond;
+
+
+    //
+    // IEC queue (C64 -> Drive)
+    //
+
+    //! @brief    A change of the C64's bus outputs
+    typedef struct {
+        uint64_t cycle;
+        uint8_t bits;
+    } IecChange;
+
+    static const unsigned queueSize = 256;
+    IecChange queue[queueSize];
+
+    //! @brief    Read position (owned by the drive thread)
+    std::atomic<unsigned> head;
+
+    //! @brief    Write position (owned by the C64 thread)
+    std::atomic<unsigned> tail;
+
+    /*! @brief    Last bits put into the queue
+     *  @details  Used to filter out redundant updates. A negative value
+     *            forces the next update to be recorded.
+     */
+    int lastBits;
+
+public:
+
+    //! @brief    Constructor
+    DriveThread(C64 *c64);
+
+    //! @brief    Destructor
+    ~DriveThread();
+
+    //! @brief    Returns true if the drives are emulated on the drive thread.
+    bool isActive() { return active; }
+
+    /*! @brief    Launches the drive thread.
+     *  @note     The emulator needs to be suspended.
+     */
+    void launch();
+
+    /*! @brief    Terminates the drive thread.
+     *  @note     The emulator needs to be suspended.
+     */
+    void terminate();
+
+    /*! @brief    Aligns the time base with the current C64 cycle.
+     *  @details  Needs to be called whenever the C64 cycle counter is changed
+     *            from outside the main loop. Both sides must be synchronized.
+     */
+    void rebase(uint64_t cycle);
+
+
+    //
+    //! @functiongroup Interface for the C64 thread
+    //
+
+    /*! @brief    Allows the drives to emulate all cycles up to the specified
+     *            C64 cycle.
+     *  @return   false, if a drive has hit a breakpoint or a jam.
+     */
+    bool grant(uint64_t cycle) {
+        granted.store(cycle - base, std::memory_order_release);
+        if (sleeping.load(std::memory_order_relaxed)) wakeup();
+        return !stopped.load(std::memory_order_relaxed);
+    }
+
+    /*! @brief    Waits until the drives have emulated all cycles up to the
+     *            specified C64 cycle and all bus changes have been processed.
+     *  @return   false, if a drive has hit a breakpoint or a jam.
+     */
+    bool synchronize(uint64_t cycle);
+
+    //! @brief    Records a change of the C64's bus outputs.
+    void changeIecLines(uint64_t cycle, uint8_t bits);
+
+    //! @brief    Resumes emulation after a drive has stopped.
+    void clearStop();
+
+private:
+
+    //! @brief    Wakes up the drive thread if it is sleeping.
+    void wakeup();
+
+    //! @brief    Checks if there is something to do for the drive thread.
+    bool hasWork();
+
+    //! @brief    Entry point of the drive thread
+    static void *threadMain(void *driveThread);
+
+    //! @brief    Main loop of the drive thread
+    void run();
+
+    //! @brief    Applies all bus changes that are due in the specified cycle.
+    void applyIecChanges(uint64_t cycle);
+};
+
+#endif
@@ -854,6 +854,10 @@ VIA6522::sleep()
     if (!(delay & VIACountA1)) sleepA = UINT64_MAX;
     if (!(delay & VIACountB1)) sleepB = UINT64_MAX;
     
+    // The same holds for timers that can't trigger an interrupt any more
+    if (sleepA && silentTimer1()) sleepA = UINT64_MAX;
+    if (sleepB && silentTimer2()) sleepB = UINT64_MAX;
+    
     wakeUpCycle = MIN(sleepA, sleepB);
 }
 
@@ -867,8 +871,11 @@ VIA6522::wakeUp()
         if (delay & VIACountA1) {
             assert((delay & (VIACountA0)) != 0);
             assert((feed & (VIACountA0)) != 0);
-            assert(t1 > idleCycles);
-            t1 -= idleCycles;
+            if (t1 > idleCycles) {
+                t1 -= idleCycles;
+            } else {
+                wrapTimer1(idleCycles);
+            }
         } else {
             assert((delay & (VIACountA0)) == 0);
             assert((feed & (VIACountA0)) == 0);
@@ -876,7 +883,7 @@ VIA6522::wakeUp()
         if (delay & VIACountB1) {
             assert((delay & (VIACountB0)) != 0);
             assert((feed & (VIACountB0)) != 0);
-            assert(t2 > idleCycles);
+            assert(t2 > idleCycles || silentTimer2());
             t2 -= idleCycles;
         } else {
             assert((delay & (VIACountB0)) == 0);
@@ -887,6 +894,62 @@ VIA6522::wakeUp()
     wakeUpCycle = 0;
 }
 
+void
+VIA6522::wrapTimer1(uint64_t cycles)
+{
+    assert(silentTimer1());
+    assert(t1 <= cycles);
+    
+    // In each period, the counter runs down to 0, wraps around to 0xFFFF,
+    // and is reloaded with the latch value afterwards.
+    uint16_t latch = HI_LO(t1_latch_hi, t1_latch_lo);
+    uint64_t phase = (cycles - t1) % (latch + 2);
+    
+    delay &= ~(VIAReloadA1 | VIAReloadA2);
+    
+    switch (phase) {
+            
+        case 0:
+            t1 = 0;
+            delay |= VIAReloadA1;
+            break;
+            
+        case 1:
+            t1 = 0xFFFF;
+            delay |= VIAReloadA2;
+            break;
+            
+        default:
+            t1 = latch - (phase - 2);
+    }
+}
+
+bool
+VIA6522::isStable()
+{
+    // Timers must not be close to an underflow
+    if ((delay & VIACountA1) ? t1 <= 2 : t1 == 0) return false;
+    if ((delay & VIACountB1) && t2 <= 2) return false;
+    
+    // Pending events must not change the event triggering queue
+    return delay == (((delay << 1) & VIAClearBits) | feed);
+}
+
+void
+VIA6522::getLogicalState(uint64_t *state)
+{
+    state[0] =
+    (uint64_t)pa | (uint64_t)pb << 8 | (uint64_t)ddra << 16 | (uint64_t)ddrb << 24 |
+    (uint64_t)ora << 32 | (uint64_t)orb << 40 | (uint64_t)ira << 48 | (uint64_t)irb << 56;
+    state[1] =
+    (uint64_t)pcr | (uint64_t)acr << 8 | (uint64_t)ier << 16 | (uint64_t)ifr << 24 |
+    (uint64_t)sr << 32 | (uint64_t)t1_latch_lo << 40 | (uint64_t)t1_latch_hi << 48 |
+    (uint64_t)t2_latch_lo << 56;
+    state[2] = ca1 | ca2 << 1 | cb1 << 2 | cb2 << 3;
+    state[3] = delay;
+    state[4] = feed;
+}
+
 
 //
 // VIA 1
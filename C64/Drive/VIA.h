@@ -66,6 +66,9 @@ class VC1541;
 
 #define VIAClearBits ~((1ULL << 29) | VIACountA0 | VIACountB0 | VIAReloadA0 | VIAReloadB0 | VIAPostOneShotA0 | VIAPostOneShotB0 | VIAInterrupt0 | VIASetCA1out0 | VIAClearCA1out0 | VIASetCA2out0 | VIAClearCA2out0 | VIASetCB2out0 | VIAClearCB2out0 | VIAPB7out0 | VIAClrInterrupt0)
 
+//! @brief    Size of the logical VIA state in 64 bit words
+#define VIA_STATE_WORDS 5
+
 /*! @brief    Virtual VIA6522 controller
     @details  The VC1541 drive contains two VIAs on its logic board.
  */
@@ -523,6 +526,40 @@ public:
     
     //! @brief    Emulates all previously skipped cycles.
     void wakeUp();
+    
+    /*! @brief    Returns true if timer 1 can run out without any side effect.
+     *  @details  This is the case if the timer has already fired in one shot
+     *            mode. Such a timer is reloaded silently from then on.
+     */
+    bool silentTimer1() {
+        return !freeRun() && (feed & VIAPostOneShotA0) &&
+        HI_LO(t1_latch_hi, t1_latch_lo) != 0; }
+    
+    /*! @brief    Returns true if timer 2 can run out without any side effect.
+     *  @details  This is the case if the timer has already fired. From then
+     *            on, it keeps on counting down and wraps around silently.
+     */
+    bool silentTimer2() { return (delay & VIAPostOneShotB0) != 0; }
+    
+    /*! @brief    Makes up for skipped cycles in which timer 1 has run out.
+     *  @param    cycles Number of skipped cycles
+     */
+    void wrapTimer1(uint64_t cycles);
+    
+    /*! @brief    Returns true if the VIA can be put into idle state right now.
+     *  @details  This is the case if executing the next cycle would not
+     *            change anything but the timer counters.
+     */
+    bool isStable();
+    
+    /*! @brief    Records the logical state of the VIA.
+     *  @details  The logical state comprises all state variables except the
+     *            timer counters and the variables of the sleep logic. Two
+     *            equal recordings mean that the VIA behaves the same way, as
+     *            long as no timer runs out.
+     *  @param    state must point to an array of VIA_STATE_WORDS elements.
+     */
+    void getLogicalState(uint64_t *state);
 };
 
 
@@ -0,0 +1,480 @@
+/*!
+ * @file        VirtualDrive.cpp
+ * @author      Dirk W. Hoffmann, www.dirkwhoffmann.de
+ * @copyright   Dirk W. Hoffmann. All rights reserved.
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "C64.h"
+
+// Kernal error codes
+#define KERNAL_FILE_NOT_FOUND 4
+#define KERNAL_MISSING_FILENAME 8
+
+// Size of the buffer holding a synthesized directory listing
+#define DIRECTORY_BUFFER_SIZE 0x2000
+
+VirtualDrive::VirtualDrive()
+{
+    setDescription("VirtualDrive");
+    debug(3, "  Creating virtual drive at address %p...\n", this);
+
+    archive = NULL;
+    deviceNr = 8;
+    numSavedFiles = 0;
+}
+
+VirtualDrive::~VirtualDrive()
+{
+    clearSavedFiles();
+}
+
+void
+VirtualDrive::dump()
+{
+    msg("VirtualDrive\n");
+    msg("------------\n\n");
+    msg("       Device : %d\n", deviceNr);
+    msg("      Archive : %s\n", archive ? archive->getName() : "none");
+    msg("  Saved files : %d\n", numSavedFiles);
+    for (unsigned i = 0; i < numSavedFiles; i++) {
+        msg("                %s (%zu bytes)\n", savedName[i], savedFile[i]->getSize());
+    }
+    msg("\n");
+}
+
+void
+VirtualDrive::mount(AnyArchive *a)
+{
+    assert(a != NULL);
+
+    c64->suspend();
+    archive = a;
+    setTraps(true);
+    c64->resume();
+}
+
+void
+VirtualDrive::unmount()
+{
+    c64->suspend();
+    archive = NULL;
+    setTraps(false);
+    c64->resume();
+}
+
+void
+VirtualDrive::setTraps(bool value)
+{
+    if (value) {
+        c64->cpu.setTrap(KERNAL_LOAD_TRAP);
+        c64->cpu.setTrap(KERNAL_SAVE_TRAP);
+    } else {
+        c64->cpu.deleteTrap(KERNAL_LOAD_TRAP);
+        c64->cpu.deleteTrap(KERNAL_SAVE_TRAP);
+    }
+}
+
+const char *
+VirtualDrive::getNameOfSavedFile(unsigned nr)
+{
+    return nr < numSavedFiles ? savedName[nr] : NULL;
+}
+
+PRGFile *
+VirtualDrive::getSavedFile(unsigned nr)
+{
+    return nr < numSavedFiles ? savedFile[nr] : NULL;
+}
+
+void
+VirtualDrive::clearSavedFiles()
+{
+    for (unsigned i = 0; i < numSavedFiles; i++) {
+        delete savedFile[i];
+    }
+    numSavedFiles = 0;
+}
+
+bool
+VirtualDrive::executeTrap(uint16_t addr)
+{
+    uint8_t *ram = c64->mem.ram;
+    uint8_t *rom = c64->mem.rom;
+
+    // Only serve requests for our device
+    if (!archive || ram[0xBA] != deviceNr) return false;
+
+    // The original Kernal routine must be visible
+    if (c64->mem.getPeekSource(addr) != M_KERNAL) return false;
+
+    switch (addr) {
+
+        case KERNAL_LOAD_TRAP:
+
+            // F4A5: STA $93
+            if (rom[addr] != 0x85 || rom[addr + 1] != 0x93) return false;
+            load();
+            return true;
+
+        case KERNAL_SAVE_TRAP:
+
+            // F5ED: LDA $BA
+            if (rom[addr] != 0xA5 || rom[addr + 1] != 0xBA) return false;
+            if (numSavedFiles == MAX_SAVED_FILES) return false;
+            save();
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+void
+VirtualDrive::load()
+{
+    uint8_t *ram = c64->mem.ram;
+    char name[17];
+
+    // Register A contains the verify flag
+    bool verify = c64->cpu.regA != 0;
+    ram[0x93] = c64->cpu.regA;
+    ram[0x90] = 0;
+    c64->mem.markDirty(0x0000);
+
+    if (readFilename(name, 16) == 0) {
+        returnWithError(KERNAL_MISSING_FILENAME);
+        return;
+    }
+
+    // A secondary address of 0 makes the file load to the address in $C3/$C4
+    bool relocate = ram[0xB9] == 0;
+    uint16_t addr = LO_HI(ram[0xC3], ram[0xC4]);
+
+    if (name[0] == '$' && name[1] == 0) {
+        loadDirectory(relocate ? addr : 0x0401, verify);
+        return;
+    }
+
+    size_t length;
+    uint16_t loadAddr;
+    uint8_t *data = findFile(name, &length, &loadAddr);
+    if (data == NULL) {
+        returnWithError(KERNAL_FILE_NOT_FOUND);
+        return;
+    }
+
+    debug(2, "Loading %s (%zu bytes)\n", name, length);
+    uint16_t end = copyToMemory(data, length, relocate ? addr : loadAddr, verify);
+    delete[] data;
+
+    // Return the end address in X and Y
+    ram[0xAE] = LO_BYTE(end);
+    ram[0xAF] = HI_BYTE(end);
+    c64->cpu.regX = LO_BYTE(end);
+    c64->cpu.regY = HI_BYTE(end);
+    ram[0x90] |= 0x40; // EOF
+    returnWithSuccess();
+}
+
+void
+VirtualDrive::save()
+{
+    uint8_t *ram = c64->mem.ram;
+    char name[17];
+
+    ram[0x90] = 0;
+    c64->mem.markDirty(0x0000);
+
+    if (readFilename(name, 16) == 0) {
+        returnWithError(KERNAL_MISSING_FILENAME);
+        return;
+    }
+
+    // The memory range is stored in $C1/$C2 (start) and $AE/$AF (end)
+    uint16_t start = LO_HI(ram[0xC1], ram[0xC2]);
+    uint16_t end = LO_HI(ram[0xAE], ram[0xAF]);
+    size_t length = end > start ? end - start : 0;
+
+    // Saved files are not part of the rolled back state. The file gets saved
+    // when the real frame reaches this point.
+    if (c64->isRunningAhead()) {
+        debug(2, "Skipping %s in run-ahead mode\n", name);
+        returnWithSuccess();
+        return;
+    }
+
+    uint8_t *buffer = new uint8_t[length + 2];
+    buffer[0] = LO_BYTE(start);
+    buffer[1] = HI_BYTE(start);
+    for (size_t i = 0; i < length; i++) {
+        buffer[i + 2] = c64->mem.spypeek(start + i);
+    }
+    PRGFile *file = PRGFile::makeWithBuffer(buffer, length + 2);
+    delete[] buffer;
+
+    // Replace a previously saved file with the same name
+    unsigned nr;
+    for (nr = 0; nr < numSavedFiles; nr++) {
+        if (strcmp(savedName[nr], name) == 0) break;
+    }
+    if (nr < numSavedFiles) {
+        delete savedFile[nr];
+    } else {
+        numSavedFiles++;
+    }
+    savedFile[nr] = file;
+    strcpy(savedName[nr], name);
+
+    debug(2, "Saved %s (%zu bytes)\n", name, length);
+    returnWithSuccess();
+}
+
+// Appends a single line to a directory listing in BASIC format
+static size_t
+appendLine(uint8_t *buffer, size_t pos, uint16_t addr, uint16_t number,
+           const uint8_t *text, size_t length)
+{
+    size_t start = pos;
+
+    pos += 2; // Link pointer (written below)
+    buffer[pos++] = LO_BYTE(number);
+    buffer[pos++] = HI_BYTE(number);
+    memcpy(buffer + pos, text, length);
+    pos += length;
+    buffer[pos++] = 0;
+
+    // Link to the next line
+    uint16_t next = addr + pos;
+    buffer[start] = LO_BYTE(next);
+    buffer[start + 1] = HI_BYTE(next);
+
+    return pos;
+}
+
+void
+VirtualDrive::loadDirectory(uint16_t addr, bool verify)
+{
+    uint8_t *ram = c64->mem.ram;
+    uint8_t buffer[DIRECTORY_BUFFER_SIZE];
+    uint8_t text[40];
+    size_t pos = 0;
+    size_t len;
+
+    // Header line: 0 "DISK NAME       " ID 2A
+    uint8_t id1 = '0', id2 = '0';
+    const char *diskName = archive->getName();
+    if (archive->type() == D64_FILE) {
+        id1 = ((D64File *)archive)->diskId1();
+        id2 = ((D64File *)archive)->diskId2();
+    }
+    size_t nameLen = strlen(diskName);
+    len = 0;
+    text[len++] = 0x12; // RVS ON
+    text[len++] = '"';
+    for (unsigned i = 0; i < 16; i++) {
+        uint8_t c = i < nameLen ? diskName[i] : ' ';
+        text[len++] = (archive->type() == D64_FILE) ? c : ascii2pet(c);
+    }
+    text[len++] = '"';
+    text[len++] = ' ';
+    text[len++] = id1;
+    text[len++] = id2;
+    text[len++] = ' ';
+    text[len++] = '2';
+    text[len++] = 'A';
+    pos = appendLine(buffer, pos, addr, 0, text, len);
+
+    // One line per file
+    unsigned usedBlocks = 0;
+    for (unsigned i = 0; i < numSavedFiles + archive->numberOfItems(); i++) {
+
+        const char *name;
+        const char *type;
+        size_t blocks;
+
+        if (i < numSavedFiles) {
+            name = savedName[i];
+            type = "PRG";
+            blocks = (savedFile[i]->getSize() + 253) / 254;
+        } else {
+            archive->selectItem(i - numSavedFiles);
+            name = archive->getNameOfItem();
+            type = archive->getTypeOfItemAsString();
+            blocks = archive->getSizeOfItemInBlocks();
+        }
+        if (name == NULL) continue;
+        usedBlocks += blocks;
+
+        // Align the file names
+        len = 0;
+        text[len++] = ' ';
+        if (blocks < 100) text[len++] = ' ';
+        if (blocks < 10) text[len++] = ' ';
+
+        // "NAME"   PRG
+        size_t nameLen = MIN(strlen(name), 16);
+        text[len++] = '"';
+        memcpy(text + len, name, nameLen);
+        len += nameLen;
+        text[len++] = '"';
+        for (size_t j = nameLen; j < 16; j++) {
+            text[len++] = ' ';
+        }
+        text[len++] = ' ';
+        memcpy(text + len, type, MIN(strlen(type), 3));
+        len += MIN(strlen(type), 3);
+
+        if (pos + len + 8 > DIRECTORY_BUFFER_SIZE) break;
+        pos = appendLine(buffer, pos, addr, blocks, text, len);
+    }
+
+    // Trailer line: BLOCKS FREE.
+    const char *trailer = "BLOCKS FREE.             ";
+    len = strlen(trailer);
+    memcpy(text, trailer, len);
+    pos = appendLine(buffer, pos, addr, usedBlocks < 664 ? 664 - usedBlocks : 0, text, len);
+
+    // End of program
+    buffer[pos++] = 0;
+    buffer[pos++] = 0;
+
+    uint16_t end = copyToMemory(buffer, pos, addr, verify);
+    ram[0xAE] = LO_BYTE(end);
+    ram[0xAF] = HI_BYTE(end);
+    c64->cpu.regX = LO_BYTE(end);
+    c64->cpu.regY = HI_BYTE(end);
+    ram[0x90] |= 0x40; // EOF
+    returnWithSuccess();
+}
+
+uint16_t
+VirtualDrive::copyToMemory(const uint8_t *data, size_t length, uint16_t addr, bool verify)
+{
+    uint32_t end = addr;
+
+    for (size_t i = 0; i < length && end <= 0xFFFF; i++, end++) {
+
+        if (verify) {
+            if (c64->mem.spypeek(end) != data[i]) c64->mem.ram[0x90] |= 0x10;
+        } else {
+            c64->mem.poke(end, data[i]);
+        }
+    }
+
+    return (uint16_t)end;
+}
+
+unsigned
+VirtualDrive::readFilename(char *name, unsigned maxLength)
+{
+    uint8_t *ram = c64->mem.ram;
+    uint16_t ptr = LO_HI(ram[0xBB], ram[0xBC]);
+    unsigned length = MIN(ram[0xB7], maxLength);
+
+    for (unsigned i = 0; i < length; i++) {
+        name[i] = c64->mem.spypeek(ptr + i);
+    }
+    name[length] = 0;
+
+    // Strip off the drive number prefix (e.g., "0:NAME")
+    char *colon = strchr(name, ':');
+    if (colon && colon - name <= 2 && name[0] != '$') {
+        memmove(name, colon + 1, strlen(colon));
+    }
+
+    return (unsigned)strlen(name);
+}
+
+bool
+VirtualDrive::matches(const char *pattern, const char *name)
+{
+    for (;; pattern++, name++) {
+
+        if (*pattern == '*') return true;
+        if (*pattern == 0 || *name == 0) return *pattern == *name;
+        if (*pattern != '?' && *pattern != *name) return false;
+    }
+}
+
+// Copies the selected item of an archive into a newly allocated buffer
+static uint8_t *
+readSelectedItem(AnyArchive *archive, size_t *length, uint16_t *loadAddr)
+{
+    *loadAddr = archive->getDestinationAddrOfItem();
+    *length = archive->getSizeOfItem();
+
+    uint8_t *data = new uint8_t[*length];
+    archive->seekItem(0);
+    for (size_t i = 0; i < *length; i++) {
+        data[i] = (uint8_t)archive->readItem();
+    }
+    return data;
+}
+
+uint8_t *
+VirtualDrive::findFile(const char *pattern, size_t *length, uint16_t *loadAddr)
+{
+    // Search the saved files first (newest first)
+    for (unsigned i = numSavedFiles; i-- > 0;) {
+
+        if (!matches(pattern, savedName[i])) continue;
+
+        savedFile[i]->selectItem(0);
+        return readSelectedItem(savedFile[i], length, loadAddr);
+    }
+
+    // Search the archive
+    for (int i = 0; i < archive->numberOfItems(); i++) {
+
+        archive->selectItem(i);
+
+        // Plain PRG files don't store a name
+        const char *name = archive->getNameOfItem();
+        if (archive->type() != PRG_FILE && (!name || !matches(pattern, name))) continue;
+
+        return readSelectedItem(archive, length, loadAddr);
+    }
+
+    return NULL;
+}
+
+void
+VirtualDrive::returnWithSuccess()
+{
+    c64->cpu.setC(0);
+    returnFromSubroutine();
+}
+
+void
+VirtualDrive::returnWithError(uint8_t code)
+{
+    c64->cpu.regA = code;
+    c64->cpu.setC(1);
+    returnFromSubroutine();
+}
+
+void
+VirtualDrive::returnFromSubroutine()
+{
+    uint8_t *stack = c64->mem.ram + 0x100;
+    uint8_t lo = stack[(uint8_t)(c64->cpu.regSP + 1)];
+    uint8_t hi = stack[(uint8_t)(c64->cpu.regSP + 2)];
+
+    c64->cpu.regSP += 2;
+    c64->cpu.regPC = LO_HI(lo, hi) + 1;
+}
@@ -0,0 +1,193 @@
+/*!
+ * @header      VirtualDrive.h
+ * @author      Dirk W. Hoffmann, www.dirkwhoffmann.de
+ * @copyright   Dirk W. Hoffmann. All rights reserved.
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _VIRTUALDRIVE_INC
+#define _VIRTUALDRIVE_INC
+
+#include "VirtualComponent.h"
+#include "AnyArchive.h"
+#include "PRGFile.h"
+
+//! @brief    Entry point of the Kernal LOAD routine (behind vector $0330)
+#define KERNAL_LOAD_TRAP 0xF4A5
+
+//! @brief    Entry point of the Kernal SAVE routine (behind vector $0332)
+#define KERNAL_SAVE_TRAP 0xF5ED
+
+//! @brief    Maximum number of files that can be saved to the virtual drive
+#define MAX_SAVED_FILES 144
+
+/*! @class    VirtualDrive
+ *  @brief    High-level emulation of a floppy drive
+ *  @details  The virtual drive intercepts the Kernal LOAD and SAVE routines
+ *            and serves the request directly from a mounted archive. Hence,
+ *            standard loaders finish instantly, without emulating the VC1541
+ *            CPU or the bit-level GCR logic.
+ *
+ *            The routines are intercepted via trap tags in the breakpoint
+ *            table of the C64 CPU. The CPU checks this table in each fetch
+ *            cycle anyway, so the traps come without any extra cost. Only
+ *            the entry points behind the default vectors are trapped. Programs
+ *            bending the vectors to their own fast loader keep on talking to
+ *            the true drive emulation.
+ *
+ *            Saved files are not written back into the mounted archive. They
+ *            are kept in a separate list which shadows the archive for
+ *            subsequent loads and which can be queried by the GUI.
+ */
+class VirtualDrive : public VirtualComponent {
+
+    //! @brief    Mounted archive (not owned by the virtual drive)
+    AnyArchive *archive;
+
+    //! @brief    Device number the virtual drive responds to
+    uint8_t deviceNr;
+
+    //! @brief    Files saved to the virtual drive
+    PRGFile *savedFile[MAX_SAVED_FILES];
+
+    //! @brief    PETSCII names of the saved files
+    char savedName[MAX_SAVED_FILES][17];
+
+    //! @brief    Number of saved files
+    unsigned numSavedFiles;
+
+public:
+
+    //
+    //! @functiongroup Constructing and destructing
+    //
+
+    //! @brief    Constructor
+    VirtualDrive();
+
+    //! @brief    Destructor
+    ~VirtualDrive();
+
+
+    //
+    //! @functiongroup Methods from VirtualComponent
+    //
+
+    void dump();
+
+
+    //
+    //! @functiongroup Configuring the device
+    //
+
+    //! @brief    Returns true if an archive is mounted.
+    bool isMounted() { return archive != NULL; }
+
+    /*! @brief    Mounts an archive and installs the Kernal traps.
+     *  @details  The archive is not copied. It has to stay alive until it is
+     *            unmounted. If a true drive with the same device number is
+     *            powered on, it is bypassed by all standard LOAD and SAVE
+     *            requests. To get rid of its emulation cost, power it off.
+     */
+    void mount(AnyArchive *archive);
+
+    //! @brief    Removes the traps and forgets about the mounted archive.
+    void unmount();
+
+    //! @brief    Returns the device number the virtual drive responds to.
+    uint8_t getDeviceNr() { return deviceNr; }
+
+    //! @brief    Sets the device number the virtual drive responds to.
+    void setDeviceNr(uint8_t nr) { deviceNr = nr; }
+
+
+    //
+    //! @functiongroup Accessing saved files
+    //
+
+    //! @brief    Returns the number of files saved to the virtual drive.
+    unsigned numberOfSavedFiles() { return numSavedFiles; }
+
+    //! @brief    Returns the PETSCII name of a saved file.
+    const char *getNameOfSavedFile(unsigned nr);
+
+    //! @brief    Returns a saved file (owned by the virtual drive).
+    PRGFile *getSavedFile(unsigned nr);
+
+    //! @brief    Deletes all saved files.
+    void clearSavedFiles();
+
+
+    //
+    //! @functiongroup Executing traps
+    //
+
+    /*! @brief    Executes a Kernal routine in high-level emulation.
+     *  @details  Called by the C64 CPU when it fetches an opcode from a cell
+     *            that is tagged as a trap. If the request is served, the CPU
+     *            registers are set up as if the routine has returned via RTS.
+     *  @return   false, if the request is not meant for the virtual drive.
+     *            In this case, the CPU executes the original Kernal code.
+     */
+    bool executeTrap(uint16_t addr);
+
+private:
+
+    //! @brief    Installs or removes the trap tags in the CPU.
+    void setTraps(bool value);
+
+    //! @brief    Emulates the Kernal LOAD routine.
+    void load();
+
+    //! @brief    Emulates the Kernal SAVE routine.
+    void save();
+
+    //! @brief    Loads a synthesized directory listing (LOAD"$",8).
+    void loadDirectory(uint16_t addr, bool verify);
+
+    /*! @brief    Copies a file into memory, starting at the specified address.
+     *  @details  If verify is true, memory is compared with the file instead.
+     *  @return   The end address (last written address plus one)
+     */
+    uint16_t copyToMemory(const uint8_t *data, size_t length, uint16_t addr, bool verify);
+
+    //! @brief    Reads the name of the requested file from memory.
+    unsigned readFilename(char *name, unsigned maxLength);
+
+    /*! @brief    Checks if a file name matches a pattern.
+     *  @details  The pattern may contain the wildcards '?' and '*'.
+     */
+    bool matches(const char *pattern, const char *name);
+
+    /*! @brief    Returns the file data (without load address) of a matching file.
+     *  @details  Saved files are searched first. The returned buffer has to be
+     *            deleted by the caller.
+     *  @return   NULL, if no file matches.
+     */
+    uint8_t *findFile(const char *pattern, size_t *length, uint16_t *loadAddr);
+
+    //! @brief    Leaves the trapped routine with the carry flag cleared.
+    void returnWithSuccess();
+
+    //! @brief    Leaves the trapped routine with an error code and carry set.
+    void returnWithError(uint8_t code);
+
+    //! @brief    Emulates an RTS instruction.
+    void returnFromSubroutine();
+};
+
+#endif
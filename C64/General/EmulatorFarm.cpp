@@ -0,0 +1,320 @@
+/*!
+ * @file        EmulatorFarm.cpp
+ * @author      Dirk W. Hoffmann, www.dirkwhoffmann.de
+ * @copyright   Dirk W. Hoffmann. All rights reserved.
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "C64.h"
+#include "EmulatorFarm.h"
+#include <sched.h>
+
+EmulatorFarm::EmulatorFarm(unsigned numWorkers)
+{
+    if (numWorkers == 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        numWorkers = cores > 0 ? (unsigned)cores : 1;
+    }
+
+    sliceFrames = 10;
+    generation = 0;
+    pending = 0;
+    active = 0;
+    quit = false;
+    lastRunTime = 0.0;
+
+    pthread_mutex_init(&lock, NULL);
+    pthread_cond_init(&wakeup, NULL);
+    pthread_cond_init(&done, NULL);
+
+    // Launch the thread pool
+    for (unsigned i = 0; i < numWorkers; i++) {
+
+        Worker *w = new Worker();
+        w->farm = this;
+        w->nr = i;
+        w->steals = 0;
+        pthread_mutex_init(&w->lock, NULL);
+        workers.push_back(w);
+    }
+    for (unsigned i = 0; i < numWorkers; i++) {
+        pthread_create(&workers[i]->thread, NULL, workerMain, workers[i]);
+    }
+}
+
+EmulatorFarm::~EmulatorFarm()
+{
+    pthread_mutex_lock(&lock);
+    quit = true;
+    pthread_cond_broadcast(&wakeup);
+    pthread_mutex_unlock(&lock);
+
+    for (unsigned i = 0; i < workers.size(); i++) {
+        pthread_join(workers[i]->thread, NULL);
+        pthread_mutex_destroy(&workers[i]->lock);
+        delete workers[i];
+    }
+
+    pthread_cond_destroy(&done);
+    pthread_cond_destroy(&wakeup);
+    pthread_mutex_destroy(&lock);
+}
+
+unsigned
+EmulatorFarm::addInstance(C64 *c64)
+{
+    assert(c64 != NULL);
+    assert(pending == 0);
+
+    Instance instance;
+    memset(&instance, 0, sizeof(instance));
+    instance.c64 = c64;
+    instance.worker = -1;
+    instances.push_back(instance);
+
+    return (unsigned)(instances.size() - 1);
+}
+
+bool
+EmulatorFarm::run(uint64_t frames)
+{
+    bool success = true;
+    uint64_t start = clock.now();
+
+    pthread_mutex_lock(&lock);
+
+    // Distribute all instances round robin
+    pending = 0;
+    for (unsigned i = 0; i < instances.size(); i++) {
+
+        assert(!instances[i].c64->isRunning());
+
+        instances[i].remaining = frames;
+        if (frames) {
+            workers[i % workers.size()]->queue.push_back(i);
+            pending++;
+        }
+    }
+
+    // Start the workers and wait for them to finish
+    active = (unsigned)workers.size();
+    generation++;
+    pthread_cond_broadcast(&wakeup);
+    while (pending > 0 || active > 0) {
+        pthread_cond_wait(&done, &lock);
+    }
+
+    pthread_mutex_unlock(&lock);
+
+    lastRunTime = (clock.now() - start) / 1000000000.0;
+
+    for (unsigned i = 0; i < instances.size(); i++) {
+        if (instances[i].info.stopped) success = false;
+    }
+    return success;
+}
+
+FarmInstanceInfo
+EmulatorFarm::getInstanceInfo(unsigned nr)
+{
+    Instance *instance = &instances.at(nr);
+    FarmInstanceInfo result = instance->info;
+
+    if (result.busyTime > 0.0) {
+        result.fps = result.frames / result.busyTime;
+        result.mhz = result.cycles / result.busyTime / 1000000.0;
+    }
+    return result;
+}
+
+uint64_t
+EmulatorFarm::getSteals()
+{
+    uint64_t result = 0;
+
+    for (unsigned i = 0; i < workers.size(); i++) {
+        result += workers[i]->steals;
+    }
+    return result;
+}
+
+void
+EmulatorFarm::resetInfo()
+{
+    assert(pending == 0);
+
+    for (unsigned i = 0; i < instances.size(); i++) {
+        memset(&instances[i].info, 0, sizeof(FarmInstanceInfo));
+        instances[i].worker = -1;
+    }
+    for (unsigned i = 0; i < workers.size(); i++) {
+        workers[i]->steals = 0;
+    }
+    lastRunTime = 0.0;
+}
+
+void *
+EmulatorFarm::workerMain(void *worker)
+{
+    Worker *w = (Worker *)worker;
+    EmulatorFarm *farm = w->farm;
+    uint64_t seen = 0;
+
+    pthread_mutex_lock(&farm->lock);
+
+    while (1) {
+
+        // Wait for a new run
+        while (!farm->quit && farm->generation == seen) {
+            pthread_cond_wait(&farm->wakeup, &farm->lock);
+        }
+        if (farm->quit) break;
+        seen = farm->generation;
+
+        pthread_mutex_unlock(&farm->lock);
+        farm->work(w);
+        pthread_mutex_lock(&farm->lock);
+
+        if (--farm->active == 0) {
+            pthread_cond_signal(&farm->done);
+        }
+    }
+
+    pthread_mutex_unlock(&farm->lock);
+    return NULL;
+}
+
+void
+EmulatorFarm::work(Worker *w)
+{
+    unsigned nr;
+
+    while (1) {
+
+        if (pop(w, &nr) || steal(w, &nr)) {
+
+            if (executeSlice(w, nr)) {
+
+                // Reschedule the instance
+                push(w, nr);
+
+            } else {
+
+                // The instance has finished the current run
+                pthread_mutex_lock(&lock);
+                if (--pending == 0) {
+                    pthread_cond_signal(&done);
+                }
+                pthread_mutex_unlock(&lock);
+            }
+            continue;
+        }
+
+        // There is nothing to do right now. All remaining instances are
+        // currently executed by other workers. Check if we are done.
+        pthread_mutex_lock(&lock);
+        bool finished = (pending == 0);
+        pthread_mutex_unlock(&lock);
+
+        if (finished) return;
+        sched_yield();
+    }
+}
+
+bool
+EmulatorFarm::pop(Worker *w, unsigned *nr)
+{
+    bool result = false;
+
+    pthread_mutex_lock(&w->lock);
+    if (!w->queue.empty()) {
+        *nr = w->queue.front();
+        w->queue.pop_front();
+        result = true;
+    }
+    pthread_mutex_unlock(&w->lock);
+
+    return result;
+}
+
+bool
+EmulatorFarm::steal(Worker *w, unsigned *nr)
+{
+    unsigned count = (unsigned)workers.size();
+
+    // Start with the right neighbour to spread the victims evenly
+    for (unsigned i = 1; i < count; i++) {
+
+        Worker *victim = workers[(w->nr + i) % count];
+        bool success = false;
+
+        pthread_mutex_lock(&victim->lock);
+        if (!victim->queue.empty()) {
+            *nr = victim->queue.back();
+            victim->queue.pop_back();
+            success = true;
+        }
+        pthread_mutex_unlock(&victim->lock);
+
+        if (success) {
+            w->steals++;
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+EmulatorFarm::push(Worker *w, unsigned nr)
+{
+    pthread_mutex_lock(&w->lock);
+    w->queue.push_back(nr);
+    pthread_mutex_unlock(&w->lock);
+}
+
+bool
+EmulatorFarm::executeSlice(Worker *w, unsigned nr)
+{
+    Instance *instance = &instances[nr];
+    C64 *c64 = instance->c64;
+
+    uint64_t frames = MIN(instance->remaining, (uint64_t)sliceFrames);
+    uint64_t frame = c64->frame;
+    uint64_t cycle = c64->cpu.cycle;
+    uint64_t start = clock.now();
+
+    bool success = c64->executeFrames(frames);
+
+    // Update statistics
+    if (instance->worker != -1 && instance->worker != (int)w->nr) {
+        instance->info.migrations++;
+    }
+    instance->worker = (int)w->nr;
+    instance->info.busyTime += (clock.now() - start) / 1000000000.0;
+    instance->info.frames += c64->frame - frame;
+    instance->info.cycles += c64->cpu.cycle - cycle;
+    instance->info.slices++;
+
+    if (!success) {
+        instance->info.stopped = true;
+        instance->remaining = 0;
+        return false;
+    }
+
+    instance->remaining -= frames;
+    return instance->remaining > 0;
+}
@@ -0,0 +1,244 @@
+/*!
+ * @header      EmulatorFarm.h
+ * @author      Dirk W. Hoffmann, www.dirkwhoffmann.de
+ * @copyright   Dirk W. Hoffmann. All rights reserved.
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _EMULATORFARM_INC
+#define _EMULATORFARM_INC
+
+#include "HostClock.h"
+#include <pthread.h>
+#include <vector>
+#include <deque>
+
+class C64;
+
+//! @brief    Throughput statistics of a single farm instance
+typedef struct {
+
+    //! @brief    Number of emulated frames
+    uint64_t frames;
+
+    //! @brief    Number of emulated CPU cycles
+    uint64_t cycles;
+
+    //! @brief    Number of executed frame slices
+    uint64_t slices;
+
+    //! @brief    Number of times the instance moved to another worker
+    uint64_t migrations;
+
+    //! @brief    Time spent in emulation (seconds)
+    double busyTime;
+
+    //! @brief    Emulated frames per second of busy time
+    double fps;
+
+    //! @brief    Emulated CPU frequency in MHz
+    double mhz;
+
+    //! @brief    Indicates if the instance has hit a breakpoint or a jam
+    bool stopped;
+
+} FarmInstanceInfo;
+
+
+/*! @class    EmulatorFarm
+ *  @brief    Runs many independent C64 instances on a pool of worker threads.
+ *  @details  The farm is meant for batch workloads such as regression tests
+ *            or search algorithms that need lots of emulated machines. Each
+ *            instance is emulated in frame slices with the batch API of
+ *            class C64, i.e., without frame pacing and without messages.
+ *            An instance is owned by exactly one worker during a slice.
+ *            Afterwards, it is appended to the worker's queue again. A worker
+ *            running out of work steals instances from the back of other
+ *            queues. Hence, the load stays balanced even if some instances
+ *            are much more expensive to emulate than others.
+ *
+ *            Instances are owned by the caller. They must not be running in
+ *            their own emulator thread while the farm is in use.
+ */
+class EmulatorFarm {
+
+    //! @brief    Bookkeeping information about a single instance
+    typedef struct {
+
+        C64 *c64;
+
+        //! @brief    Number of frames still to be emulated in the current run
+        uint64_t remaining;
+
+        //! @brief    Worker that has executed the last slice
+        int worker;
+
+        FarmInstanceInfo info;
+
+    } Instance;
+
+    //! @brief    A worker thread together with its task queue
+    typedef struct {
+
+        EmulatorFarm *farm;
+        unsigned nr;
+        pthread_t thread;
+
+        //! @brief    Protects the task queue
+        pthread_mutex_t lock;
+
+        //! @brief    Indices of the instances assigned to this worker
+        std::deque<unsigned> queue;
+
+        //! @brief    Number of instances stolen from other workers
+        uint64_t steals;
+
+    } Worker;
+
+    //! @brief    All registered instances
+    std::vector<Instance> instances;
+
+    //! @brief    The worker pool
+    std::vector<Worker *> workers;
+
+    //! @brief    Number of frames an instance runs before it is rescheduled
+    unsigned sliceFrames;
+
+    //! @brief    Protects all farm wide variables below
+    pthread_mutex_t lock;
+
+    //! @brief    Signals the workers that a new run has started
+    pthread_cond_t wakeup;
+
+    //! @brief    Signals the controlling thread that a run has finished
+    pthread_cond_t done;
+
+    //! @brief    Incremented whenever a new run starts
+    uint64_t generation;
+
+    //! @brief    Number of instances that haven't finished the current run
+    unsigned pending;
+
+    //! @brief    Number of workers that are still busy in the current run
+    unsigned active;
+
+    //! @brief    Asks all worker threads to terminate
+    bool quit;
+
+    //! @brief    Time base for measuring throughput
+    SystemClock clock;
+
+    //! @brief    Duration of the most recent run (seconds)
+    double lastRunTime;
+
+public:
+
+    //
+    //! @functiongroup Creating and destructing
+    //
+
+    /*! @brief    Constructor
+     *  @param    numWorkers  Size of the thread pool. If 0 is passed in, one
+     *                        worker is created per online CPU core.
+     */
+    EmulatorFarm(unsigned numWorkers = 0);
+
+    //! @brief    Destructor
+    /*! @details  Terminates all worker threads. Registered instances are
+     *            left untouched.
+     */
+    ~EmulatorFarm();
+
+
+    //
+    //! @functiongroup Configuring the farm
+    //
+
+    //! @brief    Adds an instance and returns its index.
+    unsigned addInstance(C64 *c64);
+
+    //! @brief    Returns the number of registered instances.
+    unsigned numInstances() { return (unsigned)instances.size(); }
+
+    //! @brief    Returns the instance with the specified index.
+    C64 *getInstance(unsigned nr) { return instances.at(nr).c64; }
+
+    //! @brief    Returns the size of the thread pool.
+    unsigned numWorkers() { return (unsigned)workers.size(); }
+
+    //! @brief    Returns the number of frames per slice.
+    unsigned getSliceFrames() { return sliceFrames; }
+
+    /*! @brief    Sets the number of frames per slice.
+     *  @details  Small slices improve load balancing, large slices reduce
+     *            the scheduling overhead.
+     */
+    void setSliceFrames(unsigned frames) { sliceFrames = frames ? frames : 1; }
+
+
+    //
+    //! @functiongroup Running the farm
+    //
+
+    /*! @brief    Runs all instances for the specified number of frames.
+     *  @details  The function blocks until all instances have finished.
+     *            Instances that hit a breakpoint or jam drop out early.
+     *  @return   false, if at least one instance has stopped early.
+     */
+    bool run(uint64_t frames);
+
+    //! @brief    Returns the duration of the most recent run in seconds.
+    double getLastRunTime() { return lastRunTime; }
+
+
+    //
+    //! @functiongroup Gathering statistics
+    //
+
+    //! @brief    Returns the accumulated statistics of an instance.
+    FarmInstanceInfo getInstanceInfo(unsigned nr);
+
+    //! @brief    Returns the number of stolen tasks summed up over all workers.
+    uint64_t getSteals();
+
+    //! @brief    Clears all statistics.
+    void resetInfo();
+
+private:
+
+    //! @brief    Entry point of the worker threads
+    static void *workerMain(void *worker);
+
+    //! @brief    Executes tasks until the current run has finished.
+    void work(Worker *w);
+
+    //! @brief    Fetches a task from the worker's own queue.
+    bool pop(Worker *w, unsigned *nr);
+
+    //! @brief    Fetches a task from the queue of another worker.
+    bool steal(Worker *w, unsigned *nr);
+
+    //! @brief    Appends a task to the worker's own queue.
+    void push(Worker *w, unsigned nr);
+
+    //! @brief    Emulates a single slice of an instance.
+    /*! @return   true, if the instance has more frames to emulate.
+     */
+    bool executeSlice(Worker *w, unsigned nr);
+};
+
+#endif
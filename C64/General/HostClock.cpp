@@ -0,0 +1,94 @@
+/*!
+ * @file        HostClock.cpp
+ * @author      Dirk W. Hoffmann, www.dirkwhoffmann.de
+ * @copyright   Dirk W. Hoffmann. All rights reserved.
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "HostClock.h"
+
+SystemClock::SystemClock(uint64_t earlyWakeup)
+{
+    this->earlyWakeup = earlyWakeup;
+    
+#ifdef __APPLE__
+    mach_timebase_info(&timebase);
+#endif
+}
+
+#ifdef __APPLE__
+
+uint64_t
+SystemClock::now()
+{
+    return mach_absolute_time() * timebase.numer / timebase.denom;
+}
+
+int64_t
+SystemClock::sleepUntil(uint64_t target)
+{
+    uint64_t time = now();
+    
+    if (time >= target)
+        return (int64_t)(time - target);
+    
+    // Sleep
+    if (target - time > earlyWakeup) {
+        uint64_t wakeup = target - earlyWakeup;
+        mach_wait_until(wakeup * timebase.denom / timebase.numer);
+    }
+    
+    // Count some sheep to increase precision
+    while ((time = now()) < target) { }
+    
+    return (int64_t)(time - target);
+}
+
+#else
+
+uint64_t
+SystemClock::now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+int64_t
+SystemClock::sleepUntil(uint64_t target)
+{
+    uint64_t time = now();
+    
+    if (time >= target)
+        return (int64_t)(time - target);
+    
+    // Sleep
+    if (target - time > earlyWakeup) {
+        uint64_t wakeup = target - earlyWakeup;
+        struct timespec ts;
+        ts.tv_sec = (time_t)(wakeup / 1000000000ULL);
+        ts.tv_nsec = (long)(wakeup % 1000000000ULL);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) { }
+    }
+    
+    // Count some sheep to increase precision
+    while ((time = now()) < target) { }
+    
+    return (int64_t)(time - target);
+}
+
+#endif
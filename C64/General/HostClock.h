@@ -0,0 +1,97 @@
+/*!
+ * @header      HostClock.h
+ * @author      Dirk W. Hoffmann, www.dirkwhoffmann.de
+ * @copyright   Dirk W. Hoffmann. All rights reserved.
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _HOSTCLOCK_INC
+#define _HOSTCLOCK_INC
+
+#include "basic.h"
+
+#ifdef __APPLE__
+#include <mach/mach.h>
+#include <mach/mach_time.h>
+#endif
+
+/*! @class    HostClock
+ *  @brief    Abstract interface to the real-time clock of the host computer.
+ *  @details  The emulator thread uses this clock to synchronize the emulated
+ *            frame rate with the real time. All values are measured in
+ *            nanoseconds. A custom clock can be plugged in via
+ *            C64::setHostClock().
+ */
+class HostClock {
+    
+public:
+    
+    virtual ~HostClock() { };
+    
+    //! @brief    Returns the current time in nanoseconds.
+    virtual uint64_t now() = 0;
+    
+    /*! @brief    Puts the calling thread to sleep until the target time has
+     *            been reached.
+     *  @return   Time between the target time and the actual wakeup time
+     *            (jitter). If the target time was already in the past when
+     *            the function got called, the missed time is returned.
+     */
+    virtual int64_t sleepUntil(uint64_t target) = 0;
+};
+
+
+/*! @class    SystemClock
+ *  @brief    Default clock of the host operating system.
+ *  @details  On macOS, the clock is based on mach_absolute_time() and
+ *            mach_wait_until(). On all other platforms, it uses the POSIX
+ *            functions clock_gettime() and clock_nanosleep() with a monotonic
+ *            time base. To increase precision, the thread wakes up a little
+ *            earlier than requested and waits actively in a busy loop until
+ *            the deadline is reached.
+ */
+class SystemClock : public HostClock {
+    
+private:
+    
+    //! @brief    Duration of the busy waiting phase in nanoseconds
+    uint64_t earlyWakeup;
+    
+#ifdef __APPLE__
+    //! @brief    Conversion factors between kernel time and nanoseconds
+    mach_timebase_info_data_t timebase;
+#endif
+    
+public:
+    
+    //! @brief    Constructor
+    SystemClock(uint64_t earlyWakeup = 1500000 /* 1.5 milliseconds */);
+    
+    //! @brief    Returns the duration of the busy waiting phase.
+    uint64_t getEarlyWakeup() { return earlyWakeup; }
+    
+    //! @brief    Sets the duration of the busy waiting phase.
+    /*! @details  A value of 0 disables busy waiting. This lowers the CPU load,
+     *            but makes the wakeup time dependent on the scheduler.
+     */
+    void setEarlyWakeup(uint64_t nanos) { earlyWakeup = nanos; }
+    
+    uint64_t now();
+    int64_t sleepUntil(uint64_t target);
+};
+
+#endif
@@ -33,8 +33,6 @@
 #include <sys/stat.h>
 #include <sys/param.h>
 #include <time.h>
-#include <mach/mach.h>
-#include <mach/mach_time.h>
 #include <unistd.h>
 #include <pthread.h>
 #include <errno.h>
@@ -126,6 +124,15 @@ inline bool is_uint5_t(uint5_t value) { return value < 32; }
 //! @brief    Returns true if bit n is falling when switching from x to y
 #define FALLING_EDGE_BIT(x,y,n) (((x) & (1 << (n))) && !((y) & (1 << (n))))
 
+/*! @brief    Returns a pseudo random number (32 bit xorshift generator)
+ *  @details  Unlike rand(), the generator state is passed in explicitly. This
+ *            keeps multiple emulator instances independent of each other.
+ */
+inline uint32_t xorshift32(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+    return *state = x; }
+
 
 //
 //! @functiongroup Handling buffers
@@ -325,14 +332,5 @@ uint8_t localTimeHour();
 //! @brief    Put the current thread to sleep for a certain amount of time.
 void sleepMicrosec(unsigned usec);
 
-/*! @brief    Sleeps until kernel timer reaches kernelTargetTime
- *  @param    kernelEarlyWakeup: To increase timing precision, the function
- *            wakes up the thread earlier by this amount and waits actively in
- *            a delay loop until the deadline is reached.
- *  @return   Overshoot time (jitter), measured in kernel time. Smaller values
- *            are better, 0 is best.
- */
-int64_t sleepUntil(uint64_t kernelTargetTime, uint64_t kernelEarlyWakeup);
-
 #endif
 
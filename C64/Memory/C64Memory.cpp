@@ -27,6 +27,10 @@ C64Memory::C64Memory()
 	debug (3, "  Creating main memory at address %p...\n", this);
 		
     memset(rom, 0, sizeof(rom));
+    memset(readPage, 0, sizeof(readPage));
+    memset(writePage, 0, sizeof(writePage));
+    dirtyColorPages = 0;
+    freezeLine = 0;
     stack = &ram[0x0100];
     
     // Register snapshot items
@@ -45,6 +49,7 @@ C64Memory::C64Memory()
     registerSnapshotItems(items, sizeof(items));
     
     ramInitPattern = INIT_PATTERN_C64; 
+    randomState = 1000;
 }
 
 C64Memory::~C64Memory()
@@ -61,9 +66,9 @@ C64Memory::reset()
     eraseWithPattern(ramInitPattern);
         
     // Initialize color RAM with random numbers
-    srand(1000);
+    randomState = 1000;
     for (unsigned i = 0; i < sizeof(colorRam); i++) {
-        colorRam[i] = (rand() & 0xFF);
+        colorRam[i] = (xorshift32(&randomState) & 0xFF);
     }
     
     // Initialize peek source lookup table
@@ -77,6 +82,10 @@ C64Memory::reset()
         pokeTarget[i] = M_RAM;
     }
     pokeTarget[0x0] = M_PP;
+    
+    updatePageTables();
+    markAllModified();
+    markAllDirty();
 }
 
 void 
@@ -107,6 +116,15 @@ C64Memory::dump()
     */
 }
 
+void
+C64Memory::loadFromBuffer(uint8_t **buffer)
+{
+    VirtualComponent::loadFromBuffer(buffer);
+    updatePageTables();
+    markAllModified();
+    markAllDirty();
+}
+
 
 //
 // Accessing the memory
@@ -137,6 +155,9 @@ C64Memory::updatePeekPokeLookupTables()
 {
     MemoryType source;
     // MemoryType target;
+    MemoryType oldSrc[16];
+    
+    memcpy(oldSrc, peekSrc, sizeof(peekSrc));
     
     uint8_t exrom = c64->expansionport.getExromLinePhi2() ? 0x10 : 0x00;
     uint8_t game  = c64->expansionport.getGameLinePhi2() ? 0x08 : 0x00;
@@ -183,6 +204,193 @@ C64Memory::updatePeekPokeLookupTables()
     // An attached cartridge may influence the settings. Let's give it a chance
     // to adjust the tables ...
     c64->expansionport.updatePeekPokeLookupTables();
+    
+    // Invalidate cached contents of all banks that have been remapped
+    for (unsigned i = 0; i < 16; i++) {
+        if (peekSrc[i] != oldSrc[i]) markModified(i << 12, (i << 12) | 0xFFF);
+    }
+    
+    updatePageTables();
+    updateCoverageTables();
+}
+
+void
+C64Memory::updatePageTables()
+{
+    Cartridge *cartridge = c64->expansionport.getCartridge();
+    
+    for (unsigned page = 0; page < 256; page++) {
+        
+        uint16_t addr = page << 8;
+        
+        // Page 0 contains the processor port registers
+        switch (peekSrc[page >> 4]) {
+                
+            case M_RAM:
+                readPage[page] = ram + addr;
+                break;
+                
+            case M_ROM:
+                readPage[page] = rom + addr;
+                break;
+                
+            case M_PP:
+                readPage[page] = page ? ram + addr : NULL;
+                break;
+                
+            case M_CRTLO:
+            case M_CRTHI:
+                readPage[page] = cartridge ? cartridge->romPage(addr) : NULL;
+                break;
+                
+            default:
+                readPage[page] = NULL;
+        }
+        
+        switch (pokeTarget[page >> 4]) {
+                
+            case M_RAM:
+                writePage[page] = ram + addr;
+                break;
+                
+            case M_PP:
+                writePage[page] = page ? ram + addr : NULL;
+                break;
+                
+            default:
+                writePage[page] = NULL;
+        }
+    }
+}
+
+void
+C64Memory::addCoverageRegions()
+{
+    coverage->addRegion("RAM", 0x10000);
+    coverage->addRegion("BASIC", 0x2000);
+    coverage->addRegion("CHAR", 0x1000);
+    coverage->addRegion("KERNAL", 0x2000);
+    coverage->addRegion("IO", 0x1000);
+    
+    Cartridge *cartridge = c64->expansionport.getCartridge();
+    coveredPackets = cartridge ? cartridge->numPackets : 0;
+    
+    for (unsigned i = 0; i < coveredPackets; i++) {
+        char name[16];
+        snprintf(name, sizeof(name), "CRT%02X", i);
+        coverage->addRegion(name, cartridge->packet[i] ? cartridge->packet[i]->size : 0);
+    }
+}
+
+int
+C64Memory::cartridgeCoverage(unsigned packet, uint32_t offset, uint32_t *result)
+{
+    int region = COVER_CRT + packet;
+    
+    if (packet >= coveredPackets || offset >= coverage->regionSize(region)) return -1;
+    
+    *result = offset;
+    return region;
+}
+
+void
+C64Memory::mapCoverage()
+{
+    Cartridge *cartridge = c64->expansionport.getCartridge();
+    
+    for (unsigned page = 0; page < 256; page++) {
+        
+        uint16_t addr = page << 8;
+        uint32_t offset = addr;
+        int region;
+        
+        // Reads and opcode fetches
+        switch (peekSrc[page >> 4]) {
+                
+            case M_RAM:
+            case M_PP:
+                region = COVER_RAM;
+                break;
+                
+            case M_ROM:
+                if (addr >= 0xE000) {
+                    region = COVER_KERNAL; offset = addr - 0xE000;
+                } else if (addr >= 0xD000) {
+                    region = COVER_CHAR; offset = addr - 0xD000;
+                } else if (addr >= 0xA000 && addr < 0xC000) {
+                    region = COVER_BASIC; offset = addr - 0xA000;
+                } else {
+                    region = -1;
+                }
+                break;
+                
+            case M_IO:
+                region = COVER_IO; offset = addr - 0xD000;
+                break;
+                
+            case M_CRTLO:
+                region = !cartridge ? -1 :
+                cartridgeCoverage(cartridge->chipL, cartridge->offsetL + (addr & 0x1FFF), &offset);
+                break;
+                
+            case M_CRTHI:
+                region = !cartridge ? -1 :
+                cartridgeCoverage(cartridge->chipH, cartridge->offsetH + (addr & 0x1FFF), &offset);
+                break;
+                
+            default:
+                region = -1;
+        }
+        mapCoveragePage(COVER_EXEC, page, region, offset);
+        mapCoveragePage(COVER_READ, page, region, offset);
+        
+        // Writes (which end up in RAM if they don't hit I/O space)
+        switch (pokeTarget[page >> 4]) {
+                
+            case M_RAM:
+            case M_PP:
+            case M_ROM:
+                mapCoveragePage(COVER_WRITE, page, COVER_RAM, addr);
+                break;
+                
+            case M_IO:
+                mapCoveragePage(COVER_WRITE, page, COVER_IO, addr - 0xD000);
+                break;
+                
+            case M_CRTLO:
+            case M_CRTHI:
+                mapCoveragePage(COVER_WRITE, page, c64->getUltimax() ? -1 : COVER_RAM, addr);
+                break;
+                
+            default:
+                mapCoveragePage(COVER_WRITE, page, -1, 0);
+        }
+    }
+}
+
+bool
+C64Memory::isPlainMemory(uint16_t banks)
+{
+    for (unsigned i = 0; banks; i++, banks >>= 1) {
+        
+        if (!(banks & 1)) continue;
+        
+        MemoryType source = peekSrc[i];
+        MemoryType target = pokeTarget[i];
+        if (source != M_RAM && source != M_ROM && source != M_PP) return false;
+        if (target != M_RAM && target != M_ROM && target != M_PP) return false;
+    }
+    return true;
+}
+
+bool
+C64Memory::isCacheable(uint16_t addr)
+{
+    MemoryType source = peekSrc[addr >> 12];
+    
+    // Page 0 is excluded, because the processor port is not plain memory
+    return
+    source == M_RAM || source == M_ROM || (source == M_PP && addr >= 0x0100);
 }
 
 uint8_t
@@ -224,6 +432,8 @@ C64Memory::peek(uint16_t addr, MemoryType source)
 uint8_t
 C64Memory::peekZP(uint8_t addr)
 {
+    watchRead(addr);
+    
     if (likely(addr >= 0x02)) {
         return ram[addr];
     } else if (addr == 0x00) {
@@ -369,8 +579,16 @@ void C64Memory::poke(uint16_t addr, uint8_t value, MemoryType target)
     switch(target) {
             
         case M_RAM:
+            ram[addr] = value;
+            markModified(addr);
+            markDirty(addr);
+            return;
+            
         case M_ROM:
+            
+            // The Rom stays visible. Hence, no cached line is affected
             ram[addr] = value;
+            markDirty(addr);
             return;
             
         case M_IO:
@@ -385,6 +603,8 @@ void C64Memory::poke(uint16_t addr, uint8_t value, MemoryType target)
         case M_PP:
             if (likely(addr >= 0x02)) {
                 ram[addr] = value;
+                markModified(addr);
+                markDirty(addr);
             } else if (addr == 0x00) {
                 c64->processorPort.writeDirection(value);
             } else {
@@ -403,8 +623,11 @@ void C64Memory::poke(uint16_t addr, uint8_t value, MemoryType target)
 
 void C64Memory::pokeZP(uint8_t addr, uint8_t value)
 {
+    watchWrite(addr, value);
+    
     if (likely(addr >= 0x02)) {
         ram[addr] = value;
+        markDirty(0x0000);
     } else if (addr == 0x00) {
         c64->processorPort.writeDirection(value);
     } else {
@@ -443,7 +666,8 @@ void C64Memory::pokeIO(uint16_t addr, uint8_t value)
         case 0xA: // Color RAM
         case 0xB: // Color RAM
             
-            colorRam[addr - 0xD800] = (value & 0x0F) | (rand() & 0xF0);
+            colorRam[addr - 0xD800] = (value & 0x0F) | (xorshift32(&randomState) & 0xF0);
+            dirtyColorPages |= 1 << ((addr >> 8) & 3);
             return;
             
         case 0xC: // CIA 1
@@ -471,3 +695,79 @@ void C64Memory::pokeIO(uint16_t addr, uint8_t value)
     
     assert(false);
 }
+
+
+//
+// Freezing memory cells
+//
+
+unsigned
+C64Memory::addFreeze(uint16_t addr, uint8_t value)
+{
+    Freeze entry = { addr, value, false, 0, 0 };
+    
+    suspend();
+    unsigned nr = 0;
+    while (nr < freezes.size() &&
+           (freezes[nr].addr != addr || freezes[nr].conditional)) nr++;
+    if (nr == freezes.size()) freezes.push_back(entry); else freezes[nr] = entry;
+    resume();
+    
+    return nr;
+}
+
+unsigned
+C64Memory::addFreeze(uint16_t addr, uint8_t value, uint16_t condAddr, uint8_t condValue)
+{
+    Freeze entry = { addr, value, true, condAddr, condValue };
+    
+    suspend();
+    unsigned nr = 0;
+    while (nr < freezes.size() &&
+           (freezes[nr].addr != addr || !freezes[nr].conditional ||
+            freezes[nr].condAddr != condAddr || freezes[nr].condValue != condValue)) nr++;
+    if (nr == freezes.size()) freezes.push_back(entry); else freezes[nr] = entry;
+    resume();
+    
+    return nr;
+}
+
+void
+C64Memory::removeFreeze(unsigned nr)
+{
+    if (nr >= freezes.size()) return;
+    
+    suspend();
+    freezes.erase(freezes.begin() + nr);
+    resume();
+}
+
+void
+C64Memory::clearFreezes()
+{
+    suspend();
+    freezes.clear();
+    resume();
+}
+
+void
+C64Memory::setFreezeLine(uint16_t line)
+{
+    suspend();
+    freezeLine = line;
+    resume();
+}
+
+void
+C64Memory::writeFreezes()
+{
+    for (const Freeze &entry : freezes) {
+        
+        if (entry.conditional && ram[entry.condAddr] != entry.condValue) continue;
+        if (ram[entry.addr] == entry.value) continue;
+        
+        ram[entry.addr] = entry.value;
+        markModified(entry.addr);
+        markDirty(entry.addr);
+    }
+}
@@ -22,6 +22,7 @@
 #define _C64MEMORY_INC
 
 #include "Memory.h"
+#include <vector>
 
 /*! @brief    This class represents RAM and ROM of the virtual C64
  *  @details  Due to the limited address space, RAM, ROM, and I/O memory are
@@ -92,6 +93,13 @@ public:
      */
     uint8_t colorRam[1024];
 
+    /*! @brief    Dirty page bitmap of the color RAM
+     *  @details  Bit n is set whenever the n-th 256 byte page of the color
+     *            RAM is written to.
+     *  @see      Memory::dirtyPages
+     */
+    uint8_t dirtyColorPages;
+
     //! @brief    Read Only Memory
 	/*! @details  Only specific memory cells are valid ROM locations. In total, the C64
      *            has three ROMs that are located at different addresses.
@@ -103,6 +111,12 @@ public:
     //! @brief    RAM init pattern type
     RamInitPattern ramInitPattern;
     
+    /*! @brief    State of the random number generator
+     *  @details  Used to fill the open upper bits of color RAM. Each instance
+     *            owns its own generator to avoid sharing the global rand() state.
+     */
+    uint32_t randomState;
+    
 public:
     
     //! @brief    Peek source lookup table
@@ -111,6 +125,33 @@ public:
     //! @brief    Poke target lookup table
     MemoryType pokeTarget[16];
     
+private:
+    
+    /*! @brief    Read pointers for each 256 byte page
+     *  @details  If a page is mapped to RAM, Rom, or side-effect free
+     *            cartridge Rom, the entry points to the host memory holding
+     *            the page contents. Otherwise, the entry is NULL and the
+     *            access is handled according to the peek source lookup table.
+     */
+    uint8_t *readPage[256];
+    
+    /*! @brief    Write pointers for each 256 byte page
+     *  @details  Only pages whose writes end up in plain RAM get an entry.
+     *            Writes to all other pages are handled according to the poke
+     *            target lookup table.
+     */
+    uint8_t *writePage[256];
+    
+    /*! @brief    Freeze list
+     *  @details  The entries are applied in order. Hence, if two entries
+     *            write the same cell, the latter one wins.
+     *  @see      applyFreezes()
+     */
+    std::vector<Freeze> freezes;
+    
+    //! @brief    Rasterline before which the freeze list is applied
+    uint16_t freezeLine;
+    
 public:
     
 	//! @brief    Constructor
@@ -127,6 +168,9 @@ public:
 
 	//! @brief    Method from VirtualComponent
 	void dump();
+    
+    //! @brief    Method from VirtualComponent
+    void loadFromBuffer(uint8_t **buffer);
 
 	//! @brief    Returns true, iff the Basic ROM is alrady loaded
 	bool basicRomIsLoaded() { return rom[0xA000] != 0x00; }
@@ -154,28 +198,155 @@ public:
      */
     void updatePeekPokeLookupTables();
     
+    /*! @brief    Updates the read and write page tables.
+     *  @details  Is called by updatePeekPokeLookupTables() and needs to be
+     *            called whenever a cartridge changes the visible Rom bank.
+     */
+    void updatePageTables();
+    
     //! @brief    Returns the current peek source of the specified memory address
     MemoryType getPeekSource(uint16_t addr) { return peekSrc[addr >> 12]; }
     
     //! @brief    Returns the current poke target of the specified memory address
     MemoryType getPokeTarget(uint16_t addr) { return pokeTarget[addr >> 12]; }
+    
+    /*! @brief    Checks if accessing certain memory banks has side effects.
+     *  @param    banks   Bit n represents the 4KB bank starting at n * $1000.
+     *  @return   true, if all banks are mapped to RAM, a ROM, or the processor
+     *            port. I.e., no I/O chip and no cartridge is accessed.
+     */
+    bool isPlainMemory(uint16_t banks);
+    
+    //! @brief    Method from Memory
+    bool isCacheable(uint16_t addr);
+    
+    //! @brief    Method from Memory
+    void markAllDirty() { Memory::markAllDirty(); dirtyColorPages = 0x0F; }
+    
+    //! @brief    Method from Memory
+    void clearDirtyPages() { Memory::clearDirtyPages(); dirtyColorPages = 0; }
+    
+    //! @brief    Returns the dirty page bitmap of the color RAM.
+    uint8_t getDirtyColorPages() { return dirtyColorPages; }
+    
+    //! @brief    Replaces the dirty page bitmap of the color RAM.
+    void setDirtyColorPages(uint8_t bitmap) { dirtyColorPages = bitmap; }
+    
+    //! @brief    Returns and clears the dirty page bitmap of the color RAM.
+    uint8_t takeDirtyColorPages() {
+        uint8_t result = dirtyColorPages; dirtyColorPages = 0; return result; }
+    
+private:
+    
+    /*! @brief    Coverage regions
+     *  @details  RAM, Basic, Character, and Kernal Rom, I/O space ($D000 -
+     *            $DFFF), followed by one region for each cartridge packet.
+     */
+    enum { COVER_RAM, COVER_BASIC, COVER_CHAR, COVER_KERNAL, COVER_IO, COVER_CRT };
+    
+    //! @brief    Number of cartridge packets with a coverage region
+    unsigned coveredPackets;
+    
+    //! @brief    Method from Memory
+    void addCoverageRegions();
+    
+    //! @brief    Method from Memory
+    void mapCoverage();
+    
+    //! @brief    Returns the coverage region and offset of a cartridge byte.
+    int cartridgeCoverage(unsigned packet, uint32_t offset, uint32_t *result);
+    
+public:
+    
 
     // Reading from memory
     uint8_t peek(uint16_t addr, MemoryType source);
-    uint8_t peek(uint16_t addr) { return peek(addr, peekSrc[addr >> 12]); }
+    uint8_t peek(uint16_t addr) {
+        watchRead(addr);
+        uint8_t *page = readPage[addr >> 8];
+        return page ? page[addr & 0xFF] : peek(addr, peekSrc[addr >> 12]); }
     uint8_t peekZP(uint8_t addr);
     uint8_t peekIO(uint16_t addr);
     
     // Reading from memory without side effects
     uint8_t spypeek(uint16_t addr, MemoryType source);
-    uint8_t spypeek(uint16_t addr) { return spypeek(addr, peekSrc[addr >> 12]); }
+    uint8_t spypeek(uint16_t addr) {
+        uint8_t *page = readPage[addr >> 8];
+        return page ? page[addr & 0xFF] : spypeek(addr, peekSrc[addr >> 12]); }
     uint8_t spypeekIO(uint16_t addr);
     
     // Writing into memory
     void poke(uint16_t addr, uint8_t value, MemoryType target);
-    void poke(uint16_t addr, uint8_t value) { poke(addr, value, pokeTarget[addr >> 12]); }
+    void poke(uint16_t addr, uint8_t value) {
+        watchWrite(addr, value);
+        uint8_t *page = writePage[addr >> 8];
+        if (page) {
+            page[addr & 0xFF] = value; markModified(addr); markDirty(addr);
+        } else {
+            poke(addr, value, pokeTarget[addr >> 12]);
+        } }
     void pokeZP(uint8_t addr, uint8_t value);
     void pokeIO(uint16_t addr, uint8_t value);
+    
+    
+    //
+    //! @functiongroup Freezing memory cells
+    //
+    
+    /*! @brief    Adds an entry to the freeze list.
+     *  @details  The value is written into RAM once per frame, like the
+     *            trainers of freezer cartridges do. Hence, the program may
+     *            change the cell in between, but every frame starts with
+     *            the frozen value. An existing entry for the same address
+     *            and condition is replaced.
+     *  @return   The number of the entry.
+     */
+    unsigned addFreeze(uint16_t addr, uint8_t value);
+    
+    /*! @brief    Adds a conditional entry to the freeze list.
+     *  @details  The value is only written if the RAM cell at condAddr holds
+     *            condValue, e.g., to patch a routine only after it has been
+     *            unpacked.
+     */
+    unsigned addFreeze(uint16_t addr, uint8_t value, uint16_t condAddr, uint8_t condValue);
+    
+    //! @brief    Removes an entry from the freeze list.
+    void removeFreeze(unsigned nr);
+    
+    //! @brief    Removes all entries from the freeze list.
+    void clearFreezes();
+    
+    //! @brief    Returns the number of entries in the freeze list.
+    unsigned numFreezes() { return (unsigned)freezes.size(); }
+    
+    //! @brief    Returns an entry of the freeze list.
+    Freeze getFreeze(unsigned nr) { assert(nr < freezes.size()); return freezes[nr]; }
+    
+    //! @brief    Returns the rasterline before which the list is applied.
+    uint16_t getFreezeLine() { return freezeLine; }
+    
+    /*! @brief    Selects the rasterline before which the list is applied.
+     *  @details  By default, the list is applied at the beginning of each
+     *            frame (line 0). Choosing another line allows to patch values
+     *            that a game reinitializes in its frame interrupt. If the
+     *            line does not exist in the selected VICII model, the list is
+     *            applied at the beginning of the frame. Lines are numbered
+     *            like C64::rasterLine. On NTSC machines, this numbering
+     *            differs from the one in register $D012.
+     */
+    void setFreezeLine(uint16_t line);
+    
+    /*! @brief    Writes the freeze list into RAM.
+     *  @details  Is called by the C64 once per frame. The values are written
+     *            directly into RAM, even if the cell is hidden by a Rom or
+     *            the I/O space.
+     */
+    void applyFreezes() { if (!freezes.empty()) writeFreezes(); }
+    
+private:
+    
+    //! @brief    Implements applyFreezes().
+    void writeFreezes();
 };
 
 #endif
@@ -0,0 +1,118 @@
+/*!
+ * @file        Coverage.cpp
+ * @author      Dirk W. Hoffmann, www.dirkwhoffmann.de
+ * @copyright   Dirk W. Hoffmann. All rights reserved.
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Coverage.h"
+#include <algorithm>
+
+static const char *typeName[3] = { "exec", "read", "write" };
+
+unsigned
+Coverage::addRegion(const char *name, uint32_t size)
+{
+    Region region;
+    
+    region.name = name;
+    region.size = (size + 0xFF) & ~0xFF;
+    for (unsigned t = 0; t < 3; t++) region.bits[t].assign(region.size / 64, 0);
+    
+    regions.push_back(region);
+    return (unsigned)regions.size() - 1;
+}
+
+uint32_t
+Coverage::count(unsigned nr, CoverageType type)
+{
+    uint32_t result = 0;
+    for (uint64_t word : regions[nr].bits[type]) result += __builtin_popcountll(word);
+    return result;
+}
+
+void
+Coverage::clear()
+{
+    for (Region &region : regions) {
+        for (unsigned t = 0; t < 3; t++) {
+            std::fill(region.bits[t].begin(), region.bits[t].end(), 0);
+        }
+    }
+}
+
+void
+Coverage::subtract(const Coverage &other)
+{
+    for (Region &region : regions) {
+        for (const Region &old : other.regions) {
+            
+            if (old.name != region.name || old.size != region.size) continue;
+            
+            for (unsigned t = 0; t < 3; t++) {
+                for (size_t i = 0; i < region.bits[t].size(); i++) {
+                    region.bits[t][i] &= ~old.bits[t][i];
+                }
+            }
+            break;
+        }
+    }
+}
+
+void
+Coverage::write(FILE *file)
+{
+    for (unsigned nr = 0; nr < regions.size(); nr++) {
+        
+        Region &region = regions[nr];
+        fprintf(file, "# %s: %u bytes, %u executed, %u read, %u written\n",
+                region.name.c_str(), region.size,
+                count(nr, COVER_EXEC), count(nr, COVER_READ), count(nr, COVER_WRITE));
+        
+        for (unsigned t = 0; t < 3; t++) {
+            
+            uint32_t first = 0;
+            bool inRange = false;
+            
+            for (uint32_t offset = 0; offset <= region.size; offset++) {
+                
+                bool covered =
+                offset < region.size && isCovered(nr, (CoverageType)t, offset);
+                
+                if (covered && !inRange) {
+                    first = offset;
+                } else if (!covered && inRange) {
+                    fprintf(file, "%s %s %04X-%04X\n", region.name.c_str(),
+                            typeName[t], first, offset - 1);
+                }
+                inRange = covered;
+            }
+        }
+    }
+}
+
+void
+Coverage::writeBinary(FILE *file)
+{
+    for (Region &region : regions) {
+        for (unsigned t = 0; t < 3; t++) {
+            for (uint64_t word : region.bits[t]) {
+                for (unsigned i = 0; i < 8; i++) fputc((int)(word >> (8 * i)) & 0xFF, file);
+            }
+        }
+    }
+}
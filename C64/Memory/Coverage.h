@@ -0,0 +1,115 @@
+/*!
+ * @header      Coverage.h
+ * @author      Dirk W. Hoffmann, www.dirkwhoffmann.de
+ * @copyright   Dirk W. Hoffmann. All rights reserved.
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _COVERAGE_INC
+#define _COVERAGE_INC
+
+#include "basic.h"
+#include "Memory_types.h"
+#include <string>
+#include <vector>
+
+/*! @class    Code coverage maps
+ *  @details  A coverage object consists of regions, one for each physical
+ *            memory chip, e.g., RAM, Kernal Rom, or a cartridge chip packet.
+ *            For each byte of a region, three bits record if the byte has
+ *            been executed as an opcode, read, or written by the CPU.
+ *
+ *            The object is a plain value. Copying it takes a snapshot which
+ *            can later be compared with the live maps by subtract().
+ *  @see      Memory::startCoverage()
+ */
+class Coverage {
+    
+    //! @brief    Coverage region
+    typedef struct {
+        
+        //! @brief    Name used in reports, e.g., "RAM"
+        std::string name;
+        
+        //! @brief    Size in bytes (a multiple of 256)
+        uint32_t size;
+        
+        //! @brief    One bit per byte for each access type
+        std::vector<uint64_t> bits[3];
+        
+    } Region;
+    
+    //! @brief    All regions
+    std::vector<Region> regions;
+    
+    public:
+    
+    /*! @brief    Adds a region.
+     *  @details  The size is rounded up to a multiple of 256.
+     *  @return   The number of the new region.
+     */
+    unsigned addRegion(const char *name, uint32_t size);
+    
+    //! @brief    Returns the number of regions.
+    unsigned numRegions() { return (unsigned)regions.size(); }
+    
+    //! @brief    Returns the name of a region.
+    const char *regionName(unsigned nr) { return regions[nr].name.c_str(); }
+    
+    //! @brief    Returns the size of a region in bytes.
+    uint32_t regionSize(unsigned nr) { return regions[nr].size; }
+    
+    /*! @brief    Returns the bitset words of a 256 byte block.
+     *  @details  Used by the memory to set up its coverage page table.
+     */
+    uint64_t *block(unsigned nr, CoverageType type, uint32_t offset) {
+        assert(offset < regions[nr].size);
+        return &regions[nr].bits[type][offset >> 6]; }
+    
+    //! @brief    Checks if a byte has been accessed in the specified way.
+    bool isCovered(unsigned nr, CoverageType type, uint32_t offset) {
+        return (regions[nr].bits[type][offset >> 6] >> (offset & 63)) & 1; }
+    
+    //! @brief    Returns the number of bytes accessed in the specified way.
+    uint32_t count(unsigned nr, CoverageType type);
+    
+    //! @brief    Erases all recorded accesses.
+    void clear();
+    
+    /*! @brief    Computes the difference to a snapshot.
+     *  @details  Deletes all bits that are also set in the other object.
+     *            Afterwards, the maps show the accesses that have happened
+     *            since the snapshot was taken. Regions are matched by name.
+     */
+    void subtract(const Coverage &other);
+    
+    /*! @brief    Exports the maps as text.
+     *  @details  Each line lists a range of consecutive bytes in a region
+     *            that have been accessed in the same way, e.g.
+     *            "RAM exec 0801-081F". Offsets are hexadecimal and relative
+     *            to the region start. For the RAM, they equal the address.
+     */
+    void write(FILE *file);
+    
+    /*! @brief    Exports the maps as binary data.
+     *  @details  For each region and access type, the bitset is written
+     *            in little endian byte order (bit 0 of byte 0 = offset 0).
+     */
+    void writeBinary(FILE *file);
+};
+
+#endif
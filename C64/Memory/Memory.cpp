@@ -0,0 +1,156 @@
+/*!
+ * @file        Memory.cpp
+ * @author      Dirk W. Hoffmann, www.dirkwhoffmann.de
+ * @copyright   Dirk W. Hoffmann. All rights reserved.
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "C64.h"
+
+Memory::Memory()
+{
+    for (unsigned i = 0; i < 256; i++) pageVersion[i] = 1;
+    
+    numWatchpoints = 0;
+    watchpointReached = false;
+    memset(&hit, 0, sizeof(hit));
+    updateWatchedPages();
+    
+    coverage = NULL;
+    memset(coverageSink, 0, sizeof(coverageSink));
+    for (unsigned t = 0; t < 3; t++) {
+        for (unsigned page = 0; page < 256; page++) coveragePage[t][page] = coverageSink;
+    }
+    
+    memset(dirtyPages, 0, sizeof(dirtyPages));
+}
+
+Memory::~Memory()
+{
+    delete coverage;
+}
+
+unsigned
+Memory::numDirtyPages()
+{
+    unsigned result = 0;
+    for (unsigned i = 0; i < 4; i++) result += __builtin_popcountll(dirtyPages[i]);
+    return result;
+}
+
+int
+Memory::addWatchpoint(uint16_t first, uint16_t last, WatchType type)
+{
+    if (numWatchpoints == maxWatchpoints || first > last) return -1;
+    
+    watchpoints[numWatchpoints++] = { first, last, type };
+    updateWatchedPages();
+    
+    return numWatchpoints - 1;
+}
+
+void
+Memory::deleteWatchpoint(unsigned nr)
+{
+    if (nr >= numWatchpoints) return;
+    
+    for (unsigned i = nr; i + 1 < numWatchpoints; i++) {
+        watchpoints[i] = watchpoints[i + 1];
+    }
+    numWatchpoints--;
+    updateWatchedPages();
+}
+
+void
+Memory::deleteAllWatchpoints()
+{
+    numWatchpoints = 0;
+    updateWatchedPages();
+}
+
+void
+Memory::updateWatchedPages()
+{
+    memset(watchedPage, 0, sizeof(watchedPage));
+    
+    for (unsigned i = 0; i < numWatchpoints; i++) {
+        for (unsigned page = watchpoints[i].first >> 8;
+             page <= (unsigned)(watchpoints[i].last >> 8); page++) {
+            watchedPage[page] |= watchpoints[i].type;
+        }
+    }
+    watching = numWatchpoints > 0;
+}
+
+void
+Memory::checkWatchpoints(uint16_t addr, WatchType access, uint8_t value)
+{
+    if (!(watchedPage[addr >> 8] & access)) return;
+    
+    for (unsigned i = 0; i < numWatchpoints; i++) {
+        
+        Watchpoint *wp = &watchpoints[i];
+        if ((wp->type & access) && addr >= wp->first && addr <= wp->last) {
+            
+            // Reads are reported before they happen
+            hit.nr = i;
+            hit.addr = addr;
+            hit.value = (access == WATCH_READ) ? spypeek(addr) : value;
+            hit.access = access;
+            watchpointReached = true;
+            return;
+        }
+    }
+}
+
+void
+Memory::startCoverage()
+{
+    suspend();
+    if (coverage) {
+        coverage->clear();
+    } else {
+        coverage = new Coverage();
+        addCoverageRegions();
+        mapCoverage();
+    }
+    resume();
+}
+
+void
+Memory::stopCoverage()
+{
+    suspend();
+    delete coverage;
+    coverage = NULL;
+    for (unsigned t = 0; t < 3; t++) {
+        for (unsigned page = 0; page < 256; page++) coveragePage[t][page] = coverageSink;
+    }
+    resume();
+}
+
+Coverage *
+Memory::snapshotCoverage()
+{
+    if (!coverage) return NULL;
+    
+    suspend();
+    Coverage *result = new Coverage(*coverage);
+    resume();
+    
+    return result;
+}
@@ -24,6 +24,7 @@
 #include "basic.h"
 #include "VirtualComponent.h"
 #include "Memory_types.h"
+#include "Coverage.h"
 
 
 //! @brief    Common interface for C64 memory and VC1541 memory
@@ -34,12 +35,260 @@ class Memory : public VirtualComponent {
 protected:
     
     /*! @brief    Pointer to the first byte of the stack memory
-     *  @details  This value is used by peekStack and pokeStack, only.
+     *  @details  This value is used by peekStack and pokeStack, only. In
+     *            both the C64 and the VC1541, the stack is located in page 1.
      */
     uint8_t *stack = NULL;
     
+    /*! @brief    Modification counter of each 256 byte page
+     *  @details  A counter is increased whenever the contents of the
+     *            corresponding page, as seen by the CPU, may have changed.
+     *            The CPU compares the counters with the values it has
+     *            recorded when caching disassembled lines from that page.
+     *  @see      CPU::disassemble(uint16_t, unsigned, bool, DisassembledInstruction *)
+     */
+    uint32_t pageVersion[256];
+    
+    //! @brief    Maximum number of watchpoints
+    static const unsigned maxWatchpoints = 16;
+    
+    //! @brief    Armed watchpoints
+    Watchpoint watchpoints[maxWatchpoints];
+    
+    //! @brief    Number of armed watchpoints
+    unsigned numWatchpoints;
+    
+    /*! @brief    Watched access types of each 256 byte page
+     *  @details  Each entry is the bitwise or of the access types of all
+     *            watchpoints overlapping the page.
+     */
+    uint8_t watchedPage[256];
+    
+    /*! @brief    Indicates if at least one watchpoint is armed
+     *  @details  The memory access functions consult the watchpoints only if
+     *            this flag is set. Hence, unused watchpoints cost a single
+     *            predictable branch per access.
+     */
+    bool watching;
+    
+    /*! @brief    Indicates if a watchpoint has been hit
+     *  @details  The CPU checks this flag in the fetch phase of the next
+     *            instruction and halts if it is set.
+     */
+    bool watchpointReached;
+    
+    //! @brief    Most recent watchpoint hit
+    WatchpointHit hit;
+    
+    /*! @brief    Coverage maps
+     *  @details  NULL, if coverage recording is switched off. The memory
+     *            access functions consult the maps only if this pointer is
+     *            set.
+     */
+    Coverage *coverage;
+    
+    /*! @brief    Coverage page table
+     *  @details  For each access type and each 256 byte page, the table
+     *            points to the bitset words of the coverage region that is
+     *            currently mapped to this page. Hence, recording an access
+     *            takes a single or operation.
+     *  @see      updateCoverageTables()
+     */
+    uint64_t *coveragePage[3][256];
+    
+    //! @brief    Target for pages that are not mapped to any region
+    uint64_t coverageSink[4];
+    
+    /*! @brief    Dirty page bitmap
+     *  @details  Bit n % 64 of word n / 64 is set whenever the n-th 256 byte
+     *            page of the RAM is written to. In contrast to the page
+     *            versions, the bits refer to the RAM itself and not to the
+     *            address space seen by the CPU. The bits are only cleared on
+     *            request. Hence, a consumer can find out which pages have
+     *            changed since it has looked the last time.
+     *  @see      takeDirtyPages()
+     */
+    uint64_t dirtyPages[4];
+    
+public:
+    
+    //! @brief    Constructor
+    Memory();
+    
+    //! @brief    Destructor
+    ~Memory();
+    
+    //! @brief    Marks the page containing the specified address as modified
+    void markModified(uint16_t addr) { pageVersion[addr >> 8]++; }
+    
+    //! @brief    Marks all pages in the specified address range as modified
+    void markModified(uint16_t first, uint16_t last) {
+        for (unsigned i = first >> 8; i <= (unsigned)(last >> 8); i++) pageVersion[i]++; }
+    
+    /*! @brief    Marks all pages as modified
+     *  @details  Needs to be called whenever memory is altered by other means
+     *            than poke(), e.g., when a Rom is flashed or a snapshot is
+     *            restored.
+     */
+    void markAllModified() { markModified(0x0000, 0xFFFF); }
+    
+    
+    //
+    //! @functiongroup Tracking RAM modifications
+    //
+    
+    //! @brief    Marks the RAM page containing the specified RAM offset as dirty
+    void markDirty(uint16_t offset) {
+        dirtyPages[offset >> 14] |= 1ULL << ((offset >> 8) & 63); }
+    
+    //! @brief    Marks all RAM pages in the specified range as dirty
+    void markDirty(uint16_t first, uint16_t last) {
+        for (unsigned i = first >> 8; i <= (unsigned)(last >> 8); i++) markDirty(i << 8); }
+    
+    /*! @brief    Marks all RAM pages as dirty
+     *  @details  Needs to be called whenever RAM is altered as a whole, e.g.,
+     *            on reset or when a snapshot is restored.
+     */
+    virtual void markAllDirty() { memset(dirtyPages, 0xFF, sizeof(dirtyPages)); }
+    
+    //! @brief    Returns true if the specified RAM page has been written to.
+    bool isDirty(uint8_t page) { return (dirtyPages[page >> 6] >> (page & 63)) & 1; }
+    
+    //! @brief    Returns the number of dirty RAM pages.
+    unsigned numDirtyPages();
+    
+    //! @brief    Copies the dirty page bitmap into the provided buffer.
+    void getDirtyPages(uint64_t bitmap[4]) { memcpy(bitmap, dirtyPages, sizeof(dirtyPages)); }
+    
+    /*! @brief    Replaces the dirty page bitmap.
+     *  @details  Used to put back a bitmap that has been saved together with
+     *            the RAM contents it refers to.
+     */
+    void setDirtyPages(const uint64_t bitmap[4]) {
+        memcpy(dirtyPages, bitmap, sizeof(dirtyPages)); }
+    
+    //! @brief    Clears the dirty page bitmaps.
+    virtual void clearDirtyPages() { memset(dirtyPages, 0, sizeof(dirtyPages)); }
+    
+    /*! @brief    Copies and clears the dirty page bitmap.
+     *  @details  Use this function to process the modifications incrementally.
+     *            Each write ends up in exactly one of the returned bitmaps.
+     */
+    void takeDirtyPages(uint64_t bitmap[4]) {
+        getDirtyPages(bitmap); memset(dirtyPages, 0, sizeof(dirtyPages)); }
+    
+    
+    //
+    //! @functiongroup Handling watchpoints
+    //
+    
+    /*! @brief    Arms a watchpoint for the address range first ... last.
+     *  @details  The CPU halts after the instruction that has accessed a
+     *            watched address in the specified way. If the access is an
+     *            opcode fetch, the CPU halts right after the fetch. Accesses
+     *            of other components, e.g., the VICII, are not watched.
+     *  @return   The number of the new watchpoint or -1 if all watchpoints
+     *            are in use.
+     */
+    int addWatchpoint(uint16_t first, uint16_t last, WatchType type);
+    
+    //! @brief    Deletes the watchpoint with the specified number.
+    void deleteWatchpoint(unsigned nr);
+    
+    //! @brief    Deletes all watchpoints.
+    void deleteAllWatchpoints();
+    
+    //! @brief    Returns the number of armed watchpoints.
+    unsigned numberOfWatchpoints() { return numWatchpoints; }
+    
+    //! @brief    Returns true if at least one watchpoint is armed.
+    bool hasWatchpoints() { return watching; }
+    
+    //! @brief    Returns the watchpoint with the specified number.
+    Watchpoint getWatchpoint(unsigned nr) {
+        assert(nr < numWatchpoints); return watchpoints[nr]; }
+    
+    /*! @brief    Returns the most recent watchpoint hit.
+     *  @details  The result is valid after the CPU has entered error state
+     *            CPU_WATCHPOINT_REACHED.
+     */
+    WatchpointHit getWatchpointHit() { return hit; }
+    
+    
+    //
+    //! @functiongroup Recording code coverage
+    //
+    
+    /*! @brief    Starts recording code coverage.
+     *  @details  Creates coverage maps for all memory chips that can be seen
+     *            by the CPU and records all opcode fetches, reads, and writes
+     *            of the CPU from now on. If coverage is recorded already, the
+     *            maps are cleared. Cartridges have to be attached before.
+     */
+    void startCoverage();
+    
+    //! @brief    Stops recording and deletes the coverage maps.
+    void stopCoverage();
+    
+    /*! @brief    Returns the coverage maps.
+     *  @return   NULL, if coverage is not recorded.
+     */
+    Coverage *getCoverage() { return coverage; }
+    
+    /*! @brief    Takes a snapshot of the coverage maps.
+     *  @details  The caller is responsible for deleting the returned object.
+     *  @return   NULL, if coverage is not recorded.
+     */
+    Coverage *snapshotCoverage();
+    
+    /*! @brief    Updates the coverage page table.
+     *  @details  Needs to be called whenever the memory mapping changes.
+     */
+    void updateCoverageTables() { if (coverage) mapCoverage(); }
+    
+    //! @brief    Records an opcode fetch (which counts as a read, too).
+    void coverExec(uint16_t addr) {
+        if (coverage) {
+            cover(COVER_EXEC, addr); cover(COVER_READ, addr); } }
+    
+protected:
+    
+    //! @brief    Sets the coverage bit of an address.
+    void cover(CoverageType type, uint16_t addr) {
+        coveragePage[type][addr >> 8][(addr >> 6) & 3] |= 1ULL << (addr & 63); }
+    
+    //! @brief    Reports a read access to the watchpoint and coverage logic.
+    void watchRead(uint16_t addr) {
+        if (coverage) cover(COVER_READ, addr);
+        if (watching) checkWatchpoints(addr, WATCH_READ, 0); }
+    
+    //! @brief    Reports a write access to the watchpoint and coverage logic.
+    void watchWrite(uint16_t addr, uint8_t value) {
+        if (coverage) cover(COVER_WRITE, addr);
+        if (watching) checkWatchpoints(addr, WATCH_WRITE, value); }
+    
+    /*! @brief    Maps a page to a coverage region.
+     *  @param    region  Region number or -1 to discard the accesses
+     *  @param    offset  Offset of the page in the region
+     */
+    void mapCoveragePage(CoverageType type, unsigned page, int region, uint32_t offset) {
+        coveragePage[type][page] = region < 0 ?
+        coverageSink : coverage->block(region, type, offset); }
+    
+    //! @brief    Adds the coverage regions of this memory.
+    virtual void addCoverageRegions() = 0;
+    
+    //! @brief    Sets up the coverage page table for the current mapping.
+    virtual void mapCoverage() = 0;
+    
 private:
     
+    //! @brief    Recomputes watchedPage and watching.
+    void updateWatchedPages();
+    
+    //! @brief    Checks a memory access against all watchpoints.
+    void checkWatchpoints(uint16_t addr, WatchType access, uint8_t value);
+    
     /*! @brief    Peeks a byte from memory.
      *  @details  Emulates a native read access including side effects.
      *            The value is read is from the currently visible memory.
@@ -51,7 +300,16 @@ private:
     virtual uint8_t peekZP(uint8_t addr) = 0;
 
     //! @brief    Peeks a byte from the stack.
-    virtual uint8_t peekStack(uint8_t sp) { return stack[sp]; }
+    virtual uint8_t peekStack(uint8_t sp) {
+        watchRead(0x100 | sp); return stack[sp]; }
+    
+    /*! @brief    Checks if the contents of an address can be cached.
+     *  @details  Returns true if a read access has no side effects and the
+     *            value only changes together with the page version. This is
+     *            the case for RAM and Rom, but not for I/O space, cartridge
+     *            memory, or unmapped areas.
+     */
+    virtual bool isCacheable(uint16_t addr) { return false; }
     
 public:
     
@@ -69,7 +327,8 @@ public:
     virtual void pokeZP(uint8_t addr, uint8_t value) = 0;
 
     //! @brief    Pokes a byte onto the stack.
-    virtual void pokeStack(uint8_t sp, uint8_t value) { stack[sp] = value; }
+    virtual void pokeStack(uint8_t sp, uint8_t value) {
+        watchWrite(0x100 | sp, value); stack[sp] = value; pageVersion[1]++; markDirty(0x100); }
 };
 
 #endif
@@ -0,0 +1,237 @@
+/*!
+ * @file        MemorySearch.cpp
+ * @author      Dirk W. Hoffmann, www.dirkwhoffmann.de
+ * @copyright   Dirk W. Hoffmann. All rights reserved.
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "MemorySearch.h"
+#include <algorithm>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/*! @brief    Compares 64 bytes with 64 reference bytes.
+ *  @details  Sets bit i of eq if a[i] equals b[i] and bit i of gt if a[i] is
+ *            greater than b[i] (unsigned).
+ */
+static inline void
+compare64(const uint8_t *a, const uint8_t *b, uint64_t *eq, uint64_t *gt)
+{
+    uint64_t e = 0, le = 0;
+
+#if defined(__AVX2__)
+
+    for (unsigned i = 0; i < 64; i += 32) {
+        __m256i x = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i y = _mm256_loadu_si256((const __m256i *)(b + i));
+        e |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)) << i;
+
+        // There is no unsigned compare. x <= y holds iff max(x,y) == y.
+        __m256i m = _mm256_cmpeq_epi8(_mm256_max_epu8(x, y), y);
+        le |= (uint64_t)(uint32_t)_mm256_movemask_epi8(m) << i;
+    }
+
+#elif defined(__SSE2__)
+
+    for (unsigned i = 0; i < 64; i += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i y = _mm_loadu_si128((const __m128i *)(b + i));
+        e |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) << i;
+
+        // There is no unsigned compare. x <= y holds iff max(x,y) == y.
+        __m128i m = _mm_cmpeq_epi8(_mm_max_epu8(x, y), y);
+        le |= (uint64_t)(uint16_t)_mm_movemask_epi8(m) << i;
+    }
+
+#else
+
+    for (unsigned i = 0; i < 64; i++) {
+        e |= (uint64_t)(a[i] == b[i]) << i;
+        le |= (uint64_t)(a[i] <= b[i]) << i;
+    }
+
+#endif
+
+    *eq = e;
+    *gt = ~le;
+}
+
+//! @brief    Selects the bits satisfying a relation from the compare masks.
+static inline uint64_t
+matching(SearchRelation relation, uint64_t eq, uint64_t gt)
+{
+    switch (relation) {
+        case SEARCH_EQUAL:     return eq;
+        case SEARCH_CHANGED:   return ~eq;
+        case SEARCH_INCREASED: return gt;
+        case SEARCH_DECREASED: return ~(eq | gt);
+    }
+    assert(false);
+    return 0;
+}
+
+MemorySearch::MemorySearch(const uint8_t *memory, uint32_t size)
+{
+    assert(memory != NULL);
+    assert(size % 64 == 0);
+
+    this->memory = memory;
+    this->size = size;
+    candidates.resize(size / 64);
+    previous.resize(size);
+    restart();
+}
+
+void
+MemorySearch::restart(unsigned width)
+{
+    assert(width == 1 || width == 2);
+
+    this->width = width;
+    std::fill(candidates.begin(), candidates.end(), ~0ULL);
+
+    // A word must not extend beyond the memory end
+    if (width == 2) candidates.back() &= ~(1ULL << 63);
+
+    record();
+}
+
+void
+MemorySearch::record()
+{
+    memcpy(previous.data(), memory, size);
+}
+
+uint32_t
+MemorySearch::filter(SearchRelation relation, const uint8_t *lo, const uint8_t *hi,
+                     unsigned step)
+{
+    size_t blocks = candidates.size();
+
+    for (size_t i = 0; i < blocks; i++) {
+
+        if (candidates[i] == 0) continue;
+
+        const uint8_t *mem = memory + 64 * i;
+        uint64_t eq, gt;
+        compare64(mem, lo + step * i, &eq, &gt);
+
+        if (width == 2) {
+
+            // Compare the high bytes, located one address above
+            uint64_t eqHi, gtHi;
+            if (hi != lo) compare64(mem, hi + step * i, &eqHi, &gtHi);
+            else { eqHi = eq; gtHi = gt; }
+
+            eqHi >>= 1;
+            gtHi >>= 1;
+            if (i + 1 < blocks) {
+                uint8_t next = mem[64], ref = hi[step * (i + 1)];
+                eqHi |= (uint64_t)(next == ref) << 63;
+                gtHi |= (uint64_t)(next > ref) << 63;
+            }
+
+            // The high byte decides unless it is equal
+            gt = gtHi | (eqHi & gt);
+            eq = eqHi & eq;
+        }
+
+        candidates[i] &= matching(relation, eq, gt);
+    }
+
+    record();
+    return count();
+}
+
+uint32_t
+MemorySearch::find(SearchRelation relation, uint16_t value)
+{
+    uint8_t lo[64], hi[64];
+    memset(lo, width == 1 ? value : LO_BYTE(value), sizeof(lo));
+    memset(hi, HI_BYTE(value), sizeof(hi));
+
+    return filter(relation, lo, hi, 0);
+}
+
+uint32_t
+MemorySearch::narrow(SearchRelation relation)
+{
+    return filter(relation, previous.data(), previous.data(), 64);
+}
+
+uint32_t
+MemorySearch::findSequence(const uint8_t *pattern, uint32_t length)
+{
+    assert(pattern != NULL);
+
+    if (length == 0 || length > size) {
+        std::fill(candidates.begin(), candidates.end(), 0);
+        record();
+        return 0;
+    }
+
+    uint8_t first[64];
+    memset(first, pattern[0], sizeof(first));
+
+    for (size_t i = 0; i < candidates.size(); i++) {
+
+        if (candidates[i] == 0) continue;
+
+        // Find the matches of the first byte, then verify the remaining ones
+        uint64_t eq, gt;
+        compare64(memory + 64 * i, first, &eq, &gt);
+        eq &= candidates[i];
+
+        for (uint64_t bits = eq; bits; bits &= bits - 1) {
+            uint32_t addr = (uint32_t)(64 * i) + __builtin_ctzll(bits);
+            if (addr + length > size || memcmp(memory + addr, pattern, length)) {
+                eq &= ~(1ULL << (addr & 63));
+            }
+        }
+        candidates[i] = eq;
+    }
+
+    record();
+    return count();
+}
+
+uint32_t
+MemorySearch::count()
+{
+    uint32_t result = 0;
+    for (uint64_t word : candidates) result += __builtin_popcountll(word);
+    return result;
+}
+
+int32_t
+MemorySearch::next(uint32_t addr)
+{
+    if (addr >= size) return -1;
+
+    size_t i = addr >> 6;
+    uint64_t bits = candidates[i] & (~0ULL << (addr & 63));
+
+    while (bits == 0) {
+        if (++i == candidates.size()) return -1;
+        bits = candidates[i];
+    }
+    return (int32_t)(64 * i) + __builtin_ctzll(bits);
+}
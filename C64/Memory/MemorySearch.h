@@ -0,0 +1,153 @@
+/*!
+ * @header      MemorySearch.h
+ * @author      Dirk W. Hoffmann, www.dirkwhoffmann.de
+ * @copyright   Dirk W. Hoffmann. All rights reserved.
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _MEMORYSEARCH_INC
+#define _MEMORYSEARCH_INC
+
+#include "basic.h"
+#include "Memory_types.h"
+#include <vector>
+
+/*! @class    Memory search
+ *  @details  Implements the classic cheat finder workflow. A search starts
+ *            with all addresses of a memory array being candidates. Each
+ *            search pass compares the candidates with a constant or with
+ *            the values they had in the previous pass and drops all
+ *            candidates that don't satisfy the requested relation. E.g., to
+ *            find the lives counter of a game, search for the current number
+ *            of lives, lose a life, and narrow the candidates down to those
+ *            that have decreased.
+ *
+ *            Values are either bytes or little endian words. A word value
+ *            is located at the address of its low byte. The candidates are
+ *            stored as a bitset and the memory is compared 64 bytes at a
+ *            time with SSE2 or AVX2 instructions if available. Blocks
+ *            without candidates are skipped.
+ *
+ *            The object only reads the memory array, e.g., C64Memory::ram
+ *            or VC1541Memory::ram. Searching does not interfere with
+ *            emulation, but it should not run while the emulator thread is
+ *            writing the array.
+ */
+class MemorySearch {
+
+    //! @brief    Searched memory
+    const uint8_t *memory;
+
+    //! @brief    Size of the searched memory in bytes (a multiple of 64)
+    uint32_t size;
+
+    //! @brief    Value size in bytes (1 or 2)
+    unsigned width;
+
+    //! @brief    One bit per address, set for all remaining candidates
+    std::vector<uint64_t> candidates;
+
+    //! @brief    Memory contents at the time of the previous pass
+    std::vector<uint8_t> previous;
+
+    public:
+
+    /*! @brief    Constructor
+     *  @details  Starts a byte search.
+     */
+    MemorySearch(const uint8_t *memory, uint32_t size);
+
+    /*! @brief    Starts a new search.
+     *  @details  Makes all addresses candidates and records the current
+     *            memory contents as the reference for the next narrow() call.
+     *  @param    width   1 for byte values, 2 for word values
+     */
+    void restart(unsigned width = 1);
+
+    //! @brief    Returns the value size in bytes.
+    unsigned getWidth() { return width; }
+
+
+    //
+    //! @functiongroup Searching
+    //
+
+    /*! @brief    Keeps the candidates whose value relates to a constant.
+     *  @details  E.g., find(SEARCH_EQUAL, 3) keeps all candidates holding 3.
+     *  @return   The number of remaining candidates.
+     */
+    uint32_t find(SearchRelation relation, uint16_t value);
+
+    /*! @brief    Keeps the candidates whose value relates to the previous pass.
+     *  @details  E.g., narrow(SEARCH_DECREASED) keeps all candidates whose
+     *            value is smaller than it has been in the previous pass.
+     *  @return   The number of remaining candidates.
+     */
+    uint32_t narrow(SearchRelation relation);
+
+    /*! @brief    Keeps the candidates where a byte sequence starts.
+     *  @details  The sequence must not extend beyond the memory end. The
+     *            value size is ignored.
+     *  @return   The number of remaining candidates.
+     */
+    uint32_t findSequence(const uint8_t *pattern, uint32_t length);
+
+
+    //
+    //! @functiongroup Accessing the candidates
+    //
+
+    //! @brief    Returns the number of remaining candidates.
+    uint32_t count();
+
+    //! @brief    Checks if an address is still a candidate.
+    bool isCandidate(uint32_t addr) {
+        return addr < size && ((candidates[addr >> 6] >> (addr & 63)) & 1); }
+
+    /*! @brief    Returns the first candidate at or above an address.
+     *  @return   The address or -1 if there is none.
+     */
+    int32_t next(uint32_t addr);
+
+    //! @brief    Returns the current value of an address.
+    uint16_t value(uint32_t addr) { return read(memory, addr); }
+
+    //! @brief    Returns the value of an address in the previous pass.
+    uint16_t previousValue(uint32_t addr) { return read(previous.data(), addr); }
+
+    private:
+
+    //! @brief    Reads a value of the current size.
+    uint16_t read(const uint8_t *mem, uint32_t addr) {
+        return width == 1 || addr + 1 >= size ?
+        mem[addr] : LO_HI(mem[addr], mem[addr + 1]); }
+
+    /*! @brief    Drops all candidates that don't satisfy a relation.
+     *  @param    lo     Reference values for the (low) byte at each address
+     *  @param    hi     Reference values for the high byte of a word value,
+     *                   which is located at the next address
+     *  @param    step   64 if lo and hi cover the whole memory, 0 if they hold
+     *                   64 bytes that are used for all blocks
+     */
+    uint32_t filter(SearchRelation relation, const uint8_t *lo, const uint8_t *hi,
+                    unsigned step);
+
+    //! @brief    Records the current memory contents for the next pass.
+    void record();
+};
+
+#endif
@@ -48,4 +48,62 @@ inline bool isRamInitPattern(RamInitPattern pattern) {
     return (pattern == INIT_PATTERN_C64) || (pattern == INIT_PATTERN_C64C);
 }
 
+//! @brief    Access types a watchpoint reacts to
+typedef enum {
+    WATCH_READ = 0x01,
+    WATCH_WRITE = 0x02,
+    WATCH_ACCESS = 0x03
+} WatchType;
+
+//! @brief    Watchpoint covering the address range first ... last
+typedef struct {
+    uint16_t first;
+    uint16_t last;
+    WatchType type;
+} Watchpoint;
+
+/*! @brief    Watchpoint hit
+ *  @details  Describes the memory access that has triggered a watchpoint.
+ *            For read accesses, value is the value seen by the CPU. For
+ *            write accesses, it is the value written.
+ */
+typedef struct {
+    unsigned nr;
+    uint16_t addr;
+    uint8_t value;
+    WatchType access;
+} WatchpointHit;
+
+//! @brief    Access types recorded in coverage maps
+typedef enum {
+    COVER_EXEC = 0,
+    COVER_READ = 1,
+    COVER_WRITE = 2
+} CoverageType;
+
+/*! @brief    Freeze list entry
+ *  @details  Makes the C64 write value into RAM at addr once per frame. If
+ *            conditional is set, the value is only written if the RAM cell
+ *            at condAddr holds condValue.
+ */
+typedef struct {
+    uint16_t addr;
+    uint8_t value;
+    bool conditional;
+    uint16_t condAddr;
+    uint8_t condValue;
+} Freeze;
+
+/*! @brief    Relations used to narrow down a memory search
+ *  @details  The current value of a candidate is compared with a reference
+ *            value, which is either a constant or the value of the previous
+ *            search pass. Values are compared as unsigned numbers.
+ */
+typedef enum {
+    SEARCH_EQUAL,
+    SEARCH_CHANGED,
+    SEARCH_INCREASED,
+    SEARCH_DECREASED
+} SearchRelation;
+
 #endif
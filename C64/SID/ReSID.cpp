@@ -27,7 +27,12 @@ ReSID::ReSID()
     emulateFilter = true;
     sampleRate = 44100;
 
+    // reSID computes its static lookup tables when the first SID is created.
+    // The initialization is not thread-safe, so creation is serialized.
+    static pthread_mutex_t tableLock = PTHREAD_MUTEX_INITIALIZER;
+    pthread_mutex_lock(&tableLock);
     sid = new reSID::SID();
+    pthread_mutex_unlock(&tableLock);
     sid->set_chip_model(reSID::MOS6581);
     sid->set_sampling_parameters((double)PAL_CLOCK_FREQUENCY,
                                  reSID::SAMPLE_FAST,
@@ -75,7 +75,11 @@ void
 SIDBridge::loadFromBuffer(uint8_t **buffer)
 {
     VirtualComponent::loadFromBuffer(buffer);
-    clearRingbuffer();
+    
+    // Keep the audio stream alive when rolling back after running ahead
+    if (!c64->isRunningAhead()) {
+        clearRingbuffer();
+    }
 }
 
 void 
@@ -415,6 +419,11 @@ SIDBridge::readStereoSamplesInterleaved(float *target, size_t n)
 void
 SIDBridge::writeData(short *data, size_t count)
 {
+    // Frames emulated ahead or in batch mode are not heard
+    if (c64->isRunningAhead() || c64->isRunningBatch()) {
+        return;
+    }
+    
     // Check for buffer overflow
     if (bufferCapacity() < count) {
         handleBufferOverflow();
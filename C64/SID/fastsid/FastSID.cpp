@@ -54,8 +54,9 @@ FastSID::FastSID()
         { NULL,              0,                        0 }};
     registerSnapshotItems(items, sizeof(items));
     
-    // Initialize wave and noise tables
-    FastVoice::initWaveTables();
+    // Initialize wave and noise tables (shared by all instances)
+    static pthread_once_t initWaveTablesOnce = PTHREAD_ONCE_INIT;
+    pthread_once(&initWaveTablesOnce, FastVoice::initWaveTables);
     
     // Initialize voices
     voice[0].init(this, 0, &voice[3]);
@@ -83,6 +84,7 @@ FastSID::reset()
     cpuFrequency = PAL_CLOCK_FREQUENCY; 
     sampleRate = 44100;
     emulateFilter = true;
+    randomState = 1000;
     
     init(sampleRate, cpuFrequency);
 }
@@ -217,14 +219,14 @@ FastSID::peek(uint16_t addr)
             // upper 8 output bits of oscillator 3.
             // debug("doosc = %d\n", voice[2].doosc());
             // return (uint8_t)(voice[2].doosc() >> 7);
-            return (uint8_t)rand();
+            return (uint8_t)xorshift32(&randomState);
 
         case 0x1C:
             
             // This register allows the microprocessor to read the
             // output of the voice 3 envelope generator.
             // return (uint8_t)(voice[2].adsr >> 23);
-            return (uint8_t)rand();
+            return (uint8_t)xorshift32(&randomState);
             
         default:
             
@@ -79,6 +79,9 @@ private:
     //! @brief   Last value on the data bus
     uint8_t latchedDataBus;
     
+    //! @brief   State of the random number generator (OSC 3 and ENV 3 stubs)
+    uint32_t randomState;
+    
 public:
     
     //! @brief   ADSR counter step lookup table
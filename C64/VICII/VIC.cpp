@@ -39,6 +39,9 @@ VIC::VIC()
     
 	markIRQLines = false;
 	markDMALines = false;
+    discardFrame = false;
+    fastCanvas = true;
+    stableLine = false;
     emulateGrayDotBug = true;
     palette = COLOR_PALETTE;
     
@@ -166,6 +169,7 @@ VIC::reset()
     // Screen buffer
     currentScreenBuffer = screenBuffer1;
     pixelBuffer = currentScreenBuffer;
+    stableLine = false;
 }
 
 void
@@ -258,6 +262,7 @@ VIC::loadFromBuffer(uint8_t **buffer)
 
     baLine.loadFromBuffer(buffer);
     gAccessResult.loadFromBuffer(buffer);
+    stableLine = false;
     
     if (*buffer - old != stateSize()) {
         assert(false);
@@ -294,7 +299,7 @@ VIC::setModel(VICModel m)
     model = m;
     updatePalette();
     resetScreenBuffers();
-    c64->updateVicFunctionTable();
+    c64->updateExecutors();
     
     switch(model) {
             
@@ -797,8 +802,10 @@ void
 VIC::endFrame()
 {
     // Switch active screen buffer
-    bool first = (currentScreenBuffer == screenBuffer1);
-    currentScreenBuffer = first ? screenBuffer2 : screenBuffer1;
+    if (!discardFrame) {
+        bool first = (currentScreenBuffer == screenBuffer1);
+        currentScreenBuffer = first ? screenBuffer2 : screenBuffer1;
+    }
     pixelBuffer = currentScreenBuffer;
 }
 
@@ -823,6 +830,13 @@ VIC::beginRasterline(uint16_t line)
         delay |= VICSetDisplayState;
     }
     
+    // Check if the canvas can be drawn by the fast renderer.
+    // Note: The value is cleared if one of the involved registers is written.
+    stableLine = fastCanvas &&
+    reg.delayed.ctrl1 == reg.current.ctrl1 &&
+    reg.delayed.ctrl2 == reg.current.ctrl2 &&
+    !memcmp(reg.delayed.colors + COLREG_BG0, reg.current.colors + COLREG_BG0, 4);
+    
     // We adjust the position of the first pixel in the pixel buffer to make
     // sure that the screen always appears centered.
     if (c64->vic.isPAL()) {
@@ -419,6 +419,14 @@ private:
     //! @brief    True if the current rasterline belongs to the VBLANK area.
     bool vblank;
     
+    /*! @brief    True if the canvas can be drawn by drawCanvasFast()
+     *  @details  The flag is set at the beginning of a rasterline if the
+     *            control registers and the background color registers hold
+     *            settled values. It is cleared as soon as one of these
+     *            registers is written to.
+     */
+    bool stableLine;
+    
 public: // REMOVE 
     //! @brief    Indicates if the current rasterline is a DMA line (bad line).
     bool badLine;
@@ -650,6 +658,19 @@ public:
      *            partial DMA lines may not appear. 
      */
 	bool markDMALines;
+    
+    /*! @brief    Indicates whether the current frame is discarded.
+     *  @details  If set to true, the screen buffers are not switched at the
+     *            end of the frame. Hence, the frame never appears on the
+     *            screen and the next frame is drawn into the same buffer.
+     *  @see      C64::setRunAheadFrames()
+     */
+    bool discardFrame;
+    
+    /*! @brief    Enables the fast canvas renderer
+     *  @see      setFastCanvas()
+     */
+    bool fastCanvas;
 
     
 private:
@@ -1393,6 +1414,14 @@ private:
                          bool loadShiftReg,
                          bool updateColors);
     
+    /*! @brief    Draws 8 canvas pixels in a single pass
+     *  @details  Produces the same result as drawCanvas(), but may only be
+     *            called if the rasterline is stable. In this case, the display
+     *            mode and the colors can't change while the pixels are drawn.
+     *  @seealso  stableLine
+     */
+    void drawCanvasFast();
+    
     /*! @brief    Draws 8 sprite pixels
      *  @seealso  draw()
      */
@@ -1590,6 +1619,15 @@ public:
 
 	//! @brief    Hides or shows sprites.
     void setHideSprites(bool hide);
+    
+    /*! @brief    Enables or disables the fast canvas renderer.
+     *  @details  If enabled, the canvas pixels of rasterlines without any
+     *            writes to the control registers or the background color
+     *            registers are drawn by drawCanvasFast(). Both renderers
+     *            produce the same emulation result. The option is meant for
+     *            benchmarking (see vc64canvasbench).
+     */
+    void setFastCanvas(bool b);
 	
 	//! @brief    Enables or disables sprite-sprite collision detection.
     void setSpriteSpriteCollisionFlag(bool b);
@@ -117,6 +117,7 @@ VIC::setDisplayMode(DisplayMode m)
     reg.current.ctrl1 = (reg.current.ctrl1 & ~0x60) | (m & 0x60);
     reg.current.ctrl2 = (reg.current.ctrl2 & ~0x10) | (m & 0x10);
     delay |= VICUpdateRegisters;
+    stableLine = false;
     resume();
 }
 
@@ -174,6 +175,7 @@ VIC::setVerticalRasterScroll(uint8_t offset)
     suspend();
     reg.current.ctrl1 = (reg.current.ctrl1 & 0xF8) | (offset & 0x07);
     delay |= VICUpdateRegisters;
+    stableLine = false;
     resume();
 }
 
@@ -185,6 +187,7 @@ VIC::setHorizontalRasterScroll(uint8_t offset)
     suspend();
     reg.current.ctrl2 = (reg.current.ctrl2 & 0xF8) | (offset & 0x07);
     delay |= VICUpdateRegisters;
+    stableLine = false;
     resume();
 }
 
@@ -414,6 +417,15 @@ VIC::setHideSprites(bool hide)
     resume();
 }
 
+void
+VIC::setFastCanvas(bool b)
+{
+    suspend();
+    fastCanvas = b;
+    stableLine = false;
+    resume();
+}
+
 void
 VIC::setSpriteSpriteCollisionFlag(bool b)
 {
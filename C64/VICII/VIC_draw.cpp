@@ -20,24 +20,28 @@
 
 #include "C64.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 void
 VIC::draw()
 {
-    drawCanvas();
+    stableLine ? drawCanvasFast() : drawCanvas();
     drawBorder();
 }
 
 void
 VIC::draw17()
 {
-    drawCanvas();
+    stableLine ? drawCanvasFast() : drawCanvas();
     drawBorder17();
 }
 
 void
 VIC::draw55()
 {
-    drawCanvas();
+    stableLine ? drawCanvasFast() : drawCanvas();
     drawBorder55();
 }
 
@@ -251,6 +255,90 @@ VIC::drawCanvasPixel(uint8_t pixel,
     sr.remainingBits -= 1;
 }
 
+void
+VIC::drawCanvasFast()
+{
+    if (flipflops.delayed.vertical) {
+        drawCanvas();
+        return;
+    }
+    
+    // In a stable rasterline, D011, D016, and the background colors are the
+    // same in all pixels. Hence, the colors only need to be reloaded when the
+    // shift register loads and the multicolor flipflop is never reset.
+    uint8_t d016 = reg.delayed.ctrl2;
+    uint8_t mode = (reg.delayed.ctrl1 & 0x60) | (d016 & 0x10);
+    unsigned load = sr.canLoad ? (d016 & 0x07) : 8;
+    uint8_t color[8];
+    unsigned foreground = 0;
+    
+    loadColors(mode);
+    
+    for (unsigned pixel = 0; pixel < 8; pixel++) {
+        
+        if (pixel == load) {
+            
+            uint32_t result = gAccessResult.delayed();
+            sr.data = BYTE0(result);
+            sr.latchedCharacter = BYTE2(result);
+            sr.latchedColor = BYTE1(result);
+            sr.mcFlop = true;
+            sr.remainingBits = 8;
+            loadColors(mode);
+        }
+        
+        if (!sr.remainingBits) {
+            sr.colorbits = 0;
+        }
+        
+        if ((mode & 0x10) && ((mode & 0x20) || (sr.latchedColor & 0x8))) {
+            
+            // Multi-color pixel
+            if (sr.mcFlop) sr.colorbits = sr.data >> 6;
+            foreground |= (sr.colorbits >> 1) << pixel;
+
+        } else {
+            
+            // Single-color pixel
+            sr.colorbits = sr.data >> 7;
+            foreground |= sr.colorbits << pixel;
+        }
+        color[pixel] = col[sr.colorbits];
+        
+        sr.data <<= 1;
+        sr.mcFlop = !sr.mcFlop;
+        sr.remainingBits -= 1;
+    }
+    
+    for (unsigned pixel = 0; pixel < 8; pixel++) {
+        COLORIZE(pixel, color[pixel]);
+    }
+    
+#if defined(__SSE2__)
+    
+    // Expand the foreground bits to 16 bit masks
+    __m128i bits = _mm_setr_epi16(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80);
+    __m128i mask = _mm_set1_epi16((short)foreground);
+    mask = _mm_cmpeq_epi16(_mm_and_si128(mask, bits), bits);
+    
+    __m128i source = _mm_and_si128(mask, _mm_set1_epi16(0x100));
+    __m128i depth = _mm_or_si128(_mm_and_si128(mask, _mm_set1_epi16(FOREGROUND_LAYER_DEPTH)),
+                                 _mm_andnot_si128(mask, _mm_set1_epi16(BACKGROUD_LAYER_DEPTH)));
+    _mm_storeu_si128((__m128i *)pixelSource, source);
+    _mm_storel_epi64((__m128i *)zBuffer, _mm_packus_epi16(depth, depth));
+
+#else
+    
+    for (unsigned pixel = 0; pixel < 8; pixel++) {
+        bool fg = (foreground >> pixel) & 1;
+        zBuffer[pixel] = fg ? FOREGROUND_LAYER_DEPTH : BACKGROUD_LAYER_DEPTH;
+        pixelSource[pixel] = fg ? 0x100 : 0x00;
+    }
+    
+#endif
+}
+
+
 void
 VIC::drawSprites()
 {
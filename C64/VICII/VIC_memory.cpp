@@ -467,6 +467,7 @@ VIC::poke(uint16_t addr, uint8_t value)
             }
             upperComparisonVal = upperComparisonValue();
             lowerComparisonVal = lowerComparisonValue();
+            stableLine = false;
             break;
             
         case 0x12: // RASTER_COUNTER
@@ -496,6 +497,7 @@ VIC::poke(uint16_t addr, uint8_t value)
             reg.current.ctrl2 = value;
             leftComparisonVal = leftComparisonValue();
             rightComparisonVal = rightComparisonValue();
+            stableLine = false;
             break;
             
         case 0x17: // SPRITE Y EXPANSION
@@ -592,6 +594,11 @@ VIC::poke(uint16_t addr, uint8_t value)
             if (emulateGrayDotBug) {
                 reg.delayed.colors[addr - 0x20] = 0xF;
             }
+            
+            // Background color changes show up in the canvas
+            if (addr >= 0x21 && addr <= 0x24) {
+                stableLine = false;
+            }
             break;
     }
     
@@ -0,0 +1,268 @@
+/*!
+ * @file        canvasbench.cpp
+ * @author      Dirk W. Hoffmann, www.dirkwhoffmann.de
+ * @copyright   Dirk W. Hoffmann. All rights reserved.
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* Canvas renderer benchmark
+ *
+ * Compares the fast canvas renderer with the exact one (see
+ * VIC::setFastCanvas()) for each VICII model family and each display mode.
+ * Both renderers run the same workload on fresh emulator instances.
+ * Afterwards, the program reports the time per rasterline and checks that
+ * both renderers ended up in the same machine state.
+ *
+ * The C64 executes a small built-in program that fills the screen with
+ * random data and shows eight multicolor sprites. Once per frame, a raster
+ * interrupt records the collision registers and changes the scroll offsets.
+ */
+
+#include "C64.h"
+
+//! @brief    Main program (placed at $E000)
+static uint8_t program[] = {
+
+    0x78,                   // SEI
+    0xA9, 0x1B,             // LDA #$1B     Display mode (patched)
+    0x8D, 0x11, 0xD0,       // STA $D011
+    0xA9, 0x08,             // LDA #$08     Display mode (patched)
+    0x8D, 0x16, 0xD0,       // STA $D016
+    0xA9, 0x18,             // LDA #$18
+    0x8D, 0x18, 0xD0,       // STA $D018    Screen at $0400, data at $2000
+    0xA9, 0xFF,             // LDA #$FF
+    0x8D, 0x15, 0xD0,       // STA $D015    Enable all sprites
+    0x8D, 0x1C, 0xD0,       // STA $D01C    Multicolor sprites
+    0xA9, 0x0F,             // LDA #$0F
+    0x8D, 0x1D, 0xD0,       // STA $D01D    Stretch four sprites
+    0xA9, 0x01,             // LDA #$01
+    0x8D, 0x1A, 0xD0,       // STA $D01A    Enable raster interrupts
+    0xA9, 0x80,             // LDA #$80
+    0x8D, 0x12, 0xD0,       // STA $D012
+    0xA2, 0x10,             // LDX #$10
+    0xBD, 0x40, 0x03,       // LDA $0340,X  Sprite coordinates
+    0x9D, 0x00, 0xD0,       // STA $D000,X
+    0xCA,                   // DEX
+    0x10, 0xF7,             // BPL $E029
+    0x58,                   // CLI
+    0xEE, 0x00, 0x07,       // INC $0700    Main loop
+    0x4C, 0x33, 0xE0        // JMP $E033
+};
+
+//! @brief    Interrupt handler of the built-in program (placed at $E100)
+static const uint8_t handler[] = {
+
+    0x48,                   // PHA
+    0xAD, 0x1E, 0xD0,       // LDA $D01E    Sprite-sprite collisions
+    0x8D, 0x01, 0x07,       // STA $0701
+    0xAD, 0x1F, 0xD0,       // LDA $D01F    Sprite-background collisions
+    0x8D, 0x02, 0x07,       // STA $0702
+    0xAD, 0x16, 0xD0,       // LDA $D016
+    0x49, 0x05,             // EOR #$05     Change the horizontal scroll offset
+    0x8D, 0x16, 0xD0,       // STA $D016
+    0xAD, 0x11, 0xD0,       // LDA $D011
+    0x29, 0x7F,             // AND #$7F     Keep the raster compare line
+    0x49, 0x02,             // EOR #$02     Change the vertical scroll offset
+    0x8D, 0x11, 0xD0,       // STA $D011
+    0xA9, 0xFF,             // LDA #$FF
+    0x8D, 0x19, 0xD0,       // STA $D019    Acknowledge VICII interrupt
+    0x68,                   // PLA
+    0x40                    // RTI
+};
+
+static void
+usage(const char *name)
+{
+    fprintf(stderr, "Usage: %s [options]\n\n", name);
+    fprintf(stderr, "  -f, --frames <n>      Number of frames per run (default: 300)\n");
+    fprintf(stderr, "  -n, --runs <n>        Number of runs per renderer (default: 3)\n");
+    fprintf(stderr, "  -h, --help            Prints this message\n");
+}
+
+//! @brief    Computes a 64 bit FNV-1a hash
+static uint64_t
+fnv64(const void *data, size_t length, uint64_t hash)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+
+    for (size_t i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+//! @brief    Fingerprints the parts of the machine state that matter here
+static uint64_t
+fingerprint(C64 *c64)
+{
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    uint64_t cycle = c64->cpu.cycle;
+
+    hash = fnv64(&cycle, sizeof(cycle), hash);
+    hash = fnv64(c64->mem.ram, sizeof(c64->mem.ram), hash);
+    hash = fnv64(c64->mem.colorRam, sizeof(c64->mem.colorRam), hash);
+    hash = fnv64(c64->vic.screenBuffer(), PAL_RASTERLINES * NTSC_PIXELS * 4, hash);
+    return hash;
+}
+
+//! @brief    Result of a single benchmark run
+typedef struct {
+
+    uint64_t nanos;
+    uint64_t lines;
+    uint64_t hash;
+    bool success;
+
+} RunInfo;
+
+static RunInfo
+run(VICModel model, uint8_t d011, uint8_t d016, bool fast, uint64_t frames)
+{
+    RunInfo info = { 0, 0, 0, false };
+    SystemClock clock;
+    C64 *c64 = new C64();
+
+    program[2] = d011;
+    program[7] = d016;
+    memcpy(c64->mem.rom + 0xE000, program, sizeof(program));
+    memcpy(c64->mem.rom + 0xE100, handler, sizeof(handler));
+    c64->mem.rom[0xFFFC] = 0x00; c64->mem.rom[0xFFFD] = 0xE0;
+    c64->mem.rom[0xFFFE] = 0x00; c64->mem.rom[0xFFFF] = 0xE1;
+
+    // C64::reset() enters the Kernal at $FCE2 if the reset vector is in Rom
+    c64->mem.rom[0xFCE2] = 0x4C; c64->mem.rom[0xFCE3] = 0x00; c64->mem.rom[0xFCE4] = 0xE0;
+
+    c64->vic.setModel(model);
+    c64->reset();
+    c64->vic.setFastCanvas(fast);
+
+    // Fill the screen, the graphics data, and the sprites with random data
+    uint32_t seed = 12345;
+    for (unsigned i = 0x0400; i < 0x4000; i++) {
+        seed = seed * 1103515245 + 12345;
+        c64->mem.ram[i] = (uint8_t)(seed >> 16);
+    }
+    for (unsigned i = 0; i < sizeof(c64->mem.colorRam); i++) {
+        seed = seed * 1103515245 + 12345;
+        c64->mem.colorRam[i] = (uint8_t)(seed >> 20);
+    }
+
+    // Spread the sprites over the visible area
+    for (unsigned i = 0; i < 16; i += 2) {
+        seed = seed * 1103515245 + 12345;
+        c64->mem.ram[0x340 + i] = (uint8_t)(0x18 + (seed >> 24) % 0x140);
+        c64->mem.ram[0x341 + i] = (uint8_t)(0x40 + (seed >> 28) * 12);
+    }
+    c64->mem.ram[0x350] = 0x80;
+
+    uint64_t start = clock.now();
+    info.success = c64->executeFrames(frames);
+    info.nanos = clock.now() - start;
+
+    info.lines = c64->cpu.cycle / c64->vic.getCyclesPerRasterline();
+    info.hash = fingerprint(c64);
+
+    delete c64;
+    return info;
+}
+
+int
+main(int argc, char *argv[])
+{
+    uint64_t frames = 300;
+    unsigned runs = 3;
+
+    // Parse command line
+    for (int i = 1; i < argc; i++) {
+
+        const char *arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if ((!strcmp(arg, "-f") || !strcmp(arg, "--frames")) && hasValue) {
+            frames = strtoull(argv[++i], NULL, 10);
+        } else if ((!strcmp(arg, "-n") || !strcmp(arg, "--runs")) && hasValue) {
+            runs = (unsigned)strtoul(argv[++i], NULL, 10);
+        } else {
+            usage(argv[0]);
+            return strcmp(arg, "-h") && strcmp(arg, "--help") ? 1 : 0;
+        }
+    }
+    if (runs == 0) runs = 1;
+
+    // One representative per VICII model family
+    const struct { VICModel model; const char *name; } families[] = {
+
+        { PAL_8565, "PAL (63 cycles)" },
+        { NTSC_6567_R56A, "NTSC old (64 cycles)" },
+        { NTSC_8562, "NTSC (65 cycles)" }
+    };
+
+    // Display modes as set up in $D011 and $D016
+    const struct { uint8_t d011; uint8_t d016; const char *name; } modes[] = {
+
+        { 0x1B, 0x08, "Text" },
+        { 0x1B, 0x18, "Multicolor text" },
+        { 0x5B, 0x08, "Extended color" },
+        { 0x3B, 0x08, "Bitmap" },
+        { 0x3B, 0x18, "Multicolor bitmap" },
+        { 0x7B, 0x18, "Invalid" }
+    };
+
+    bool success = true;
+    printf("%-22s %-18s %13s %13s %9s  %s\n",
+           "Family", "Mode", "Exact ns/line", "Fast ns/line", "Speedup", "State");
+
+    for (unsigned f = 0; f < sizeof(families) / sizeof(families[0]); f++) {
+        for (unsigned m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+
+            // Keep the fastest of all runs to filter out scheduling noise
+            RunInfo best[2];
+            bool match = true;
+
+            for (unsigned r = 0; r < runs; r++) {
+
+                // Alternate the renderers to distribute frequency scaling effects
+                for (unsigned fast = 0; fast < 2; fast++) {
+
+                    RunInfo info = run(families[f].model,
+                                       modes[m].d011, modes[m].d016,
+                                       fast, frames);
+                    if (!info.success) {
+                        fprintf(stderr, "Emulation stopped in run %u\n", r);
+                        return 2;
+                    }
+                    if (r == 0 || info.nanos < best[fast].nanos) {
+                        best[fast] = info;
+                    }
+                    match &= info.hash == best[0].hash;
+                }
+            }
+
+            double exact = (double)best[0].nanos / (double)best[0].lines;
+            double fast = (double)best[1].nanos / (double)best[1].lines;
+
+            printf("%-22s %-18s %13.1f %13.1f %8.2fx  %s\n",
+                   families[f].name, modes[m].name, exact, fast,
+                   fast > 0 ? exact / fast : 0.0,
+                   match ? "identical" : "MISMATCH");
+            success &= match;
+        }
+    }
+
+    return success ? 0 : 3;
+}
@@ -0,0 +1,166 @@
+/*!
+ * @file        cpubench.cpp
+ * @author      Dirk W. Hoffmann, www.dirkwhoffmann.de
+ * @copyright   Dirk W. Hoffmann. All rights reserved.
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* CPU dispatch benchmark
+ *
+ * Executes a tight instruction mix on the C64 CPU and on the CPU of the
+ * first VC1541 and reports the achieved number of CPU cycles per second.
+ * The CPUs are clocked directly, i.e., no other component is emulated in
+ * the meantime. Hence, the result is dominated by the micro instruction
+ * dispatcher in CPU::executeOneCycle() and by the memory access functions.
+ *
+ * The program prints the dispatch backend it was compiled with. To compare
+ * the computed goto dispatcher with the switch statement, run the benchmark
+ * in two build trees, one of them configured with -DVC64_SWITCH_DISPATCH=ON.
+ */
+
+#include "C64.h"
+
+/*! @brief    Assembles the benchmark loop
+ *  @details  The loop mixes immediate, zero page, absolute indexed, and
+ *            indirect indexed addressing with a read-modify-write access, a
+ *            subroutine call, stack operations, and a taken branch.
+ *  @param    base   Start address of the program
+ *  @param    data   Start address of a 512 byte scratch area
+ *  @return   Size of the program in bytes
+ */
+static size_t
+assemble(uint8_t *mem, uint16_t base, uint16_t data)
+{
+    const uint16_t sub = base + 0x1E;
+    const uint8_t code[] = {
+
+        0xA2, 0x00,                                 // LDX #$00
+        0xBD, LO_BYTE(data), HI_BYTE(data),         // LDA data,X
+        0x69, 0x01,                                 // ADC #$01
+        0x9D, LO_BYTE(data + 0x100), HI_BYTE(data + 0x100), // STA data+256,X
+        0xB1, 0xFB,                                 // LDA ($FB),Y
+        0x45, 0x02,                                 // EOR $02
+        0x85, 0x02,                                 // STA $02
+        0x0A,                                       // ASL
+        0x66, 0x03,                                 // ROR $03
+        0x20, LO_BYTE(sub), HI_BYTE(sub),           // JSR sub
+        0xE8,                                       // INX
+        0xD0, 0xE9,                                 // BNE base+2
+        0xE6, 0x04,                                 // INC $04
+        0x4C, LO_BYTE(base), HI_BYTE(base),         // JMP base
+        0x18,                                       // sub: CLC
+        0x48,                                       // PHA
+        0x68,                                       // PLA
+        0x60                                        // RTS
+    };
+
+    memcpy(mem + base, code, sizeof(code));
+    mem[0xFB] = LO_BYTE(data);
+    mem[0xFC] = HI_BYTE(data);
+    return sizeof(code);
+}
+
+//! @brief    Clocks a CPU for the specified number of cycles
+static double
+measure(CPU *cpu, uint16_t base, uint64_t cycles)
+{
+    SystemClock clock;
+
+    cpu->jumpToAddress(base);
+    cpu->setI(1);
+
+    uint64_t start = clock.now();
+    for (uint64_t i = 0; i < cycles; i++) {
+        if (!cpu->executeOneCycle()) {
+            fprintf(stderr, "CPU halted at %04X\n", cpu->getPC());
+            return 0.0;
+        }
+    }
+    uint64_t elapsed = clock.now() - start;
+
+    return elapsed ? (double)cycles * 1000000000.0 / (double)elapsed : 0.0;
+}
+
+static void
+usage(const char *name)
+{
+    fprintf(stderr, "Usage: %s [options]\n\n", name);
+    fprintf(stderr, "  -c, --cycles <n>      Million cycles per run (default: 50)\n");
+    fprintf(stderr, "  -n, --runs <n>        Number of runs per CPU (default: 3)\n");
+    fprintf(stderr, "  -h, --help            Prints this message\n");
+}
+
+int
+main(int argc, char *argv[])
+{
+    uint64_t cycles = 50;
+    unsigned runs = 3;
+
+    // Parse command line
+    for (int i = 1; i < argc; i++) {
+
+        const char *arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if ((!strcmp(arg, "-c") || !strcmp(arg, "--cycles")) && hasValue) {
+            cycles = strtoull(argv[++i], NULL, 10);
+        } else if ((!strcmp(arg, "-n") || !strcmp(arg, "--runs")) && hasValue) {
+            runs = (unsigned)strtoul(argv[++i], NULL, 10);
+        } else {
+            usage(argv[0]);
+            return strcmp(arg, "-h") && strcmp(arg, "--help") ? 1 : 0;
+        }
+    }
+    if (cycles == 0) cycles = 1;
+    if (runs == 0) runs = 1;
+    cycles *= 1000000;
+
+    C64 *c64 = new C64();
+    c64->reset();
+
+    // The C64 program runs in RAM, the drive program in the drive's RAM
+    assemble(c64->mem.ram, 0x1000, 0x2000);
+    assemble(c64->drive1.mem.ram, 0x0300, 0x0400);
+
+    const struct { CPU *cpu; uint16_t base; const char *name; } cpus[] = {
+
+        { &c64->cpu, 0x1000, "C64 (6510)" },
+        { &c64->drive1.cpu, 0x0300, "VC1541 (6502)" }
+    };
+
+#ifdef CPU_THREADED_DISPATCH
+    printf("Dispatch backend: computed goto\n");
+#else
+    printf("Dispatch backend: switch\n");
+#endif
+    printf("%-16s %14s\n", "CPU", "MCycles/sec");
+
+    bool success = true;
+    for (unsigned c = 0; c < sizeof(cpus) / sizeof(cpus[0]); c++) {
+
+        // Keep the fastest run to filter out scheduling noise
+        double best = 0.0;
+        for (unsigned r = 0; r < runs; r++) {
+            best = MAX(best, measure(cpus[c].cpu, cpus[c].base, cycles));
+        }
+        printf("%-16s %14.2f\n", cpus[c].name, best / 1000000.0);
+        success &= best > 0.0;
+    }
+
+    delete c64;
+    return success ? 0 : 2;
+}
@@ -0,0 +1,1020 @@
+/*!
+ * @file        cpusuite.cpp
+ * @author      Dirk W. Hoffmann, www.dirkwhoffmann.de
+ * @copyright   Dirk W. Hoffmann. All rights reserved.
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* CPU conformance suite
+ *
+ * Runs CPU test programs without any pacing and reports the result of each
+ * test together with the achieved emulation speed in MHz.
+ *
+ * The program first executes a set of built-in checks that clock the C64
+ * CPU directly:
+ *
+ *   - ADC and SBC for all operands and carry values, in binary and in
+ *     decimal mode. The decimal results are compared with the NMOS 6502
+ *     behaviour as described in Bruce Clark's "Decimal Mode" tutorial,
+ *     including the flags and the results of invalid BCD operands.
+ *   - All undocumented opcodes with random register and memory contents.
+ *     The stable opcodes are compared with their reference semantics. The
+ *     unstable ones (ANE, LXA, SHA, SHX, SHY, TAS) are checked under the
+ *     conditions that give a well defined result. The JAM opcodes must halt
+ *     the CPU.
+ *   - The cycle count of all opcodes, including branches and page crossings.
+ *
+ * Afterwards, all program files given on the command line are executed as
+ * Wolfgang Lorenz style test programs. Each test runs on a fresh C64 with a
+ * minimal Kernal replacement. Output sent to CHROUT ($FFD2) is collected,
+ * the test passes when it loads the next test ($E16F) or returns to BASIC
+ * ($8000, $A474) and fails when it waits for a key ($FFE4) or executes BRK.
+ */
+
+#include "C64.h"
+#include <string>
+
+//! @brief    Result of a single test
+typedef struct {
+
+    bool passed;
+    uint64_t cycles;
+    uint64_t nanos;
+    std::string details;
+
+} TestResult;
+
+static unsigned failed = 0;
+static bool verbose = false;
+
+static void
+report(const char *name, TestResult &result)
+{
+    double mhz = result.nanos ? (double)result.cycles * 1000.0 / (double)result.nanos : 0.0;
+
+    printf("%-24s %-6s %14llu %10.2f\n", name, result.passed ? "ok" : "FAILED",
+           (unsigned long long)result.cycles, mhz);
+
+    if ((!result.passed || verbose) && !result.details.empty()) {
+        printf("%s\n", result.details.c_str());
+    }
+    if (!result.passed) failed++;
+}
+
+
+//
+// Built-in checks
+//
+
+//! @brief    Register contents before or after an instruction
+typedef struct {
+
+    uint8_t a, x, y, sp, p;
+
+} Registers;
+
+static const uint16_t codeAddr = 0x1000;
+static const uint8_t zpgAddr = 0x80;
+static const uint16_t absAddr = 0x2080;
+
+//! @brief    Returns the flags of the C64 CPU (B and bit 5 are masked out)
+static uint8_t
+getFlags(CPU *cpu)
+{
+    return cpu->getN() | cpu->getV() | cpu->getD() | cpu->getI() | cpu->getZ() | cpu->getC();
+}
+
+static void
+setFlags(CPU *cpu, uint8_t p)
+{
+    cpu->setN(p & CPU::N_FLAG);
+    cpu->setV(p & CPU::V_FLAG);
+    cpu->setD(p & CPU::D_FLAG);
+    cpu->setI(p & CPU::I_FLAG);
+    cpu->setZ(p & CPU::Z_FLAG);
+    cpu->setC(p & CPU::C_FLAG);
+}
+
+/*! @brief    Places a single instruction at codeAddr
+ *  @details  The operand refers to zpgAddr or absAddr.
+ *  @param    pointer   Location of the zero page pointer to absAddr that is
+ *                      used by the indirect addressing modes
+ */
+static void
+setup(C64 *c64, uint8_t opcode, uint8_t operand, const Registers &regs,
+      uint8_t pointer = zpgAddr)
+{
+    CPU *cpu = &c64->cpu;
+
+    c64->mem.poke(codeAddr, opcode);
+    c64->mem.poke(codeAddr + 1, operand);
+    c64->mem.poke(codeAddr + 2, HI_BYTE(absAddr));
+    c64->mem.poke(pointer, LO_BYTE(absAddr));
+    c64->mem.poke((pointer + 1) & 0xFF, HI_BYTE(absAddr));
+
+    cpu->regA = regs.a;
+    cpu->regX = regs.x;
+    cpu->regY = regs.y;
+    cpu->regSP = regs.sp;
+    setFlags(cpu, regs.p);
+    cpu->jumpToAddress(codeAddr);
+}
+
+/*! @brief    Executes a single instruction and returns the consumed cycles
+ *  @details  The cycle counter is advanced like in C64::executeOneCycle(),
+ *            because some instructions compare it with the time of the last
+ *            RDY line change.
+ */
+static unsigned
+step(CPU *cpu)
+{
+    unsigned cycles = 0;
+
+    do {
+        cpu->cycle++;
+        cpu->executeOneCycle();
+        cycles++;
+    } while (!cpu->inFetchPhase() && cycles < 16);
+
+    return cycles;
+}
+
+static Registers
+registers(CPU *cpu)
+{
+    Registers regs = { cpu->regA, cpu->regX, cpu->regY, cpu->regSP, getFlags(cpu) };
+    return regs;
+}
+
+static void
+setNZ(Registers &r, uint8_t value)
+{
+    r.p = (r.p & ~(CPU::N_FLAG | CPU::Z_FLAG)) | (value & 0x80) | (value ? 0 : CPU::Z_FLAG);
+}
+
+static void
+setFlag(Registers &r, uint8_t flag, bool value)
+{
+    r.p = value ? (r.p | flag) : (r.p & ~flag);
+}
+
+/*! @brief    Reference implementation of ADC
+ *  @details  The decimal mode follows sequences 1 and 2 of Bruce Clark's
+ *            "Decimal Mode" tutorial (NMOS 6502). Z is always computed as in
+ *            binary mode.
+ */
+static void
+adc(Registers &r, uint8_t m)
+{
+    int c = r.p & CPU::C_FLAG;
+    int sum = r.a + m + c;
+
+    if (!(r.p & CPU::D_FLAG)) {
+        setFlag(r, CPU::V_FLAG, ~(r.a ^ m) & (r.a ^ sum) & 0x80);
+        setFlag(r, CPU::C_FLAG, sum > 0xFF);
+        r.a = (uint8_t)sum;
+        setNZ(r, r.a);
+        return;
+    }
+
+    int al = (r.a & 0x0F) + (m & 0x0F) + c;
+    if (al >= 0x0A) al = ((al + 0x06) & 0x0F) + 0x10;
+
+    int seq1 = (r.a & 0xF0) + (m & 0xF0) + al;
+    if (seq1 >= 0xA0) seq1 += 0x60;
+
+    int seq2 = (int8_t)(r.a & 0xF0) + (int8_t)(m & 0xF0) + al;
+
+    setNZ(r, (uint8_t)sum);
+    setFlag(r, CPU::N_FLAG, seq2 & 0x80);
+    setFlag(r, CPU::V_FLAG, seq2 < -128 || seq2 > 127);
+    setFlag(r, CPU::C_FLAG, seq1 >= 0x100);
+    r.a = (uint8_t)seq1;
+}
+
+/*! @brief    Reference implementation of SBC
+ *  @details  The decimal mode follows sequence 3 of Bruce Clark's "Decimal
+ *            Mode" tutorial (NMOS 6502). All flags are computed as in
+ *            binary mode.
+ */
+static void
+sbc(Registers &r, uint8_t m)
+{
+    int c = r.p & CPU::C_FLAG;
+    int diff = r.a - m - (1 - c);
+
+    int al = (r.a & 0x0F) - (m & 0x0F) + c - 1;
+    if (al < 0) al = ((al - 0x06) & 0x0F) - 0x10;
+
+    int seq3 = (r.a & 0xF0) - (m & 0xF0) + al;
+    if (seq3 < 0) seq3 -= 0x60;
+
+    setFlag(r, CPU::V_FLAG, (r.a ^ m) & (r.a ^ diff) & 0x80);
+    setFlag(r, CPU::C_FLAG, diff >= 0);
+    setNZ(r, (uint8_t)diff);
+    r.a = (uint8_t)((r.p & CPU::D_FLAG) ? seq3 : diff);
+}
+
+static void
+cmp(Registers &r, uint8_t reg, uint8_t m)
+{
+    setFlag(r, CPU::C_FLAG, reg >= m);
+    setNZ(r, (uint8_t)(reg - m));
+}
+
+static std::string
+describe(uint8_t opcode, uint8_t m, const Registers &in,
+         const Registers &expected, uint8_t expectedM,
+         const Registers &actual, uint8_t actualM)
+{
+    char buf[256];
+    snprintf(buf, sizeof(buf),
+             "  %02X: A=%02X X=%02X Y=%02X SP=%02X P=%02X M=%02X\n"
+             "      expected A=%02X X=%02X Y=%02X SP=%02X P=%02X M=%02X\n"
+             "      got      A=%02X X=%02X Y=%02X SP=%02X P=%02X M=%02X\n",
+             opcode, in.a, in.x, in.y, in.sp, in.p, m,
+             expected.a, expected.x, expected.y, expected.sp, expected.p, expectedM,
+             actual.a, actual.x, actual.y, actual.sp, actual.p, actualM);
+    return buf;
+}
+
+//! @brief    Runs ADC or SBC immediate for all operands, carries, and accumulators
+static TestResult
+checkArithmetic(C64 *c64, uint8_t opcode, bool decimal)
+{
+    TestResult result = { true, 0, 0, "" };
+    SystemClock clock;
+    CPU *cpu = &c64->cpu;
+    unsigned mismatches = 0;
+
+    uint64_t start = clock.now();
+    for (unsigned carry = 0; carry < 2; carry++) {
+        for (unsigned a = 0; a < 256; a++) {
+            for (unsigned m = 0; m < 256; m++) {
+
+                uint8_t p = (decimal ? CPU::D_FLAG : 0) | CPU::I_FLAG | carry;
+                Registers in = { (uint8_t)a, 0, 0, 0xFD, p };
+                Registers expected = in;
+                opcode == 0x69 ? adc(expected, (uint8_t)m) : sbc(expected, (uint8_t)m);
+
+                setup(c64, opcode, (uint8_t)m, in);
+                result.cycles += step(cpu);
+                Registers actual = registers(cpu);
+
+                if (memcmp(&expected, &actual, sizeof(Registers))) {
+                    if (mismatches++ < 8) {
+                        result.details += describe(opcode, (uint8_t)m, in, expected, 0, actual, 0);
+                    }
+                }
+            }
+        }
+    }
+    result.nanos = clock.now() - start;
+
+    if (mismatches) {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "  %u mismatches", mismatches);
+        result.details += buf;
+        result.passed = false;
+    }
+    return result;
+}
+
+//! @brief    Undocumented operations
+typedef enum {
+
+    OP_SLO, OP_RLA, OP_SRE, OP_RRA, OP_SAX, OP_LAX, OP_DCP, OP_ISC,
+    OP_ANC, OP_ALR, OP_ARR, OP_SBX, OP_USBC, OP_ANE, OP_LXA, OP_LAS,
+    OP_TAS, OP_SHA, OP_SHX, OP_SHY, OP_NOP, OP_JAM
+
+} Operation;
+
+//! @brief    The undocumented opcodes registered by CPU::registerIllegalInstructions()
+static const struct { uint8_t opcode; Operation op; AddressingMode mode; } illegals[] = {
+
+    { 0x07, OP_SLO, ADDR_ZERO_PAGE }, { 0x17, OP_SLO, ADDR_ZERO_PAGE_X },
+    { 0x03, OP_SLO, ADDR_INDIRECT_X }, { 0x13, OP_SLO, ADDR_INDIRECT_Y },
+    { 0x0F, OP_SLO, ADDR_ABSOLUTE }, { 0x1F, OP_SLO, ADDR_ABSOLUTE_X },
+    { 0x1B, OP_SLO, ADDR_ABSOLUTE_Y },
+
+    { 0x27, OP_RLA, ADDR_ZERO_PAGE }, { 0x37, OP_RLA, ADDR_ZERO_PAGE_X },
+    { 0x23, OP_RLA, ADDR_INDIRECT_X }, { 0x33, OP_RLA, ADDR_INDIRECT_Y },
+    { 0x2F, OP_RLA, ADDR_ABSOLUTE }, { 0x3F, OP_RLA, ADDR_ABSOLUTE_X },
+    { 0x3B, OP_RLA, ADDR_ABSOLUTE_Y },
+
+    { 0x47, OP_SRE, ADDR_ZERO_PAGE }, { 0x57, OP_SRE, ADDR_ZERO_PAGE_X },
+    { 0x43, OP_SRE, ADDR_INDIRECT_X }, { 0x53, OP_SRE, ADDR_INDIRECT_Y },
+    { 0x4F, OP_SRE, ADDR_ABSOLUTE }, { 0x5F, OP_SRE, ADDR_ABSOLUTE_X },
+    { 0x5B, OP_SRE, ADDR_ABSOLUTE_Y },
+
+    { 0x67, OP_RRA, ADDR_ZERO_PAGE }, { 0x77, OP_RRA, ADDR_ZERO_PAGE_X },
+    { 0x63, OP_RRA, ADDR_INDIRECT_X }, { 0x73, OP_RRA, ADDR_INDIRECT_Y },
+    { 0x6F, OP_RRA, ADDR_ABSOLUTE }, { 0x7F, OP_RRA, ADDR_ABSOLUTE_X },
+    { 0x7B, OP_RRA, ADDR_ABSOLUTE_Y },
+
+    { 0x87, OP_SAX, ADDR_ZERO_PAGE }, { 0x97, OP_SAX, ADDR_ZERO_PAGE_Y },
+    { 0x83, OP_SAX, ADDR_INDIRECT_X }, { 0x8F, OP_SAX, ADDR_ABSOLUTE },
+
+    { 0xA7, OP_LAX, ADDR_ZERO_PAGE }, { 0xB7, OP_LAX, ADDR_ZERO_PAGE_Y },
+    { 0xA3, OP_LAX, ADDR_INDIRECT_X }, { 0xB3, OP_LAX, ADDR_INDIRECT_Y },
+    { 0xAF, OP_LAX, ADDR_ABSOLUTE }, { 0xBF, OP_LAX, ADDR_ABSOLUTE_Y },
+
+    { 0xC7, OP_DCP, ADDR_ZERO_PAGE }, { 0xD7, OP_DCP, ADDR_ZERO_PAGE_X },
+    { 0xC3, OP_DCP, ADDR_INDIRECT_X }, { 0xD3, OP_DCP, ADDR_INDIRECT_Y },
+    { 0xCF, OP_DCP, ADDR_ABSOLUTE }, { 0xDF, OP_DCP, ADDR_ABSOLUTE_X },
+    { 0xDB, OP_DCP, ADDR_ABSOLUTE_Y },
+
+    { 0xE7, OP_ISC, ADDR_ZERO_PAGE }, { 0xF7, OP_ISC, ADDR_ZERO_PAGE_X },
+    { 0xE3, OP_ISC, ADDR_INDIRECT_X }, { 0xF3, OP_ISC, ADDR_INDIRECT_Y },
+    { 0xEF, OP_ISC, ADDR_ABSOLUTE }, { 0xFF, OP_ISC, ADDR_ABSOLUTE_X },
+    { 0xFB, OP_ISC, ADDR_ABSOLUTE_Y },
+
+    { 0x0B, OP_ANC, ADDR_IMMEDIATE }, { 0x2B, OP_ANC, ADDR_IMMEDIATE },
+    { 0x4B, OP_ALR, ADDR_IMMEDIATE }, { 0x6B, OP_ARR, ADDR_IMMEDIATE },
+    { 0xCB, OP_SBX, ADDR_IMMEDIATE }, { 0xEB, OP_USBC, ADDR_IMMEDIATE },
+    { 0x8B, OP_ANE, ADDR_IMMEDIATE }, { 0xAB, OP_LXA, ADDR_IMMEDIATE },
+
+    { 0xBB, OP_LAS, ADDR_ABSOLUTE_Y }, { 0x9B, OP_TAS, ADDR_ABSOLUTE_Y },
+    { 0x93, OP_SHA, ADDR_INDIRECT_Y }, { 0x9F, OP_SHA, ADDR_ABSOLUTE_Y },
+    { 0x9E, OP_SHX, ADDR_ABSOLUTE_Y }, { 0x9C, OP_SHY, ADDR_ABSOLUTE_X },
+
+    { 0x1A, OP_NOP, ADDR_IMPLIED }, { 0x3A, OP_NOP, ADDR_IMPLIED },
+    { 0x5A, OP_NOP, ADDR_IMPLIED }, { 0x7A, OP_NOP, ADDR_IMPLIED },
+    { 0xDA, OP_NOP, ADDR_IMPLIED }, { 0xFA, OP_NOP, ADDR_IMPLIED },
+    { 0x80, OP_NOP, ADDR_IMMEDIATE }, { 0x82, OP_NOP, ADDR_IMMEDIATE },
+    { 0x89, OP_NOP, ADDR_IMMEDIATE }, { 0xC2, OP_NOP, ADDR_IMMEDIATE },
+    { 0xE2, OP_NOP, ADDR_IMMEDIATE },
+    { 0x04, OP_NOP, ADDR_ZERO_PAGE }, { 0x44, OP_NOP, ADDR_ZERO_PAGE },
+    { 0x64, OP_NOP, ADDR_ZERO_PAGE },
+    { 0x14, OP_NOP, ADDR_ZERO_PAGE_X }, { 0x34, OP_NOP, ADDR_ZERO_PAGE_X },
+    { 0x54, OP_NOP, ADDR_ZERO_PAGE_X }, { 0x74, OP_NOP, ADDR_ZERO_PAGE_X },
+    { 0xD4, OP_NOP, ADDR_ZERO_PAGE_X }, { 0xF4, OP_NOP, ADDR_ZERO_PAGE_X },
+    { 0x0C, OP_NOP, ADDR_ABSOLUTE },
+    { 0x1C, OP_NOP, ADDR_ABSOLUTE_X }, { 0x3C, OP_NOP, ADDR_ABSOLUTE_X },
+    { 0x5C, OP_NOP, ADDR_ABSOLUTE_X }, { 0x7C, OP_NOP, ADDR_ABSOLUTE_X },
+    { 0xDC, OP_NOP, ADDR_ABSOLUTE_X }, { 0xFC, OP_NOP, ADDR_ABSOLUTE_X },
+
+    { 0x02, OP_JAM, ADDR_IMPLIED }, { 0x12, OP_JAM, ADDR_IMPLIED },
+    { 0x22, OP_JAM, ADDR_IMPLIED }, { 0x32, OP_JAM, ADDR_IMPLIED },
+    { 0x42, OP_JAM, ADDR_IMPLIED }, { 0x52, OP_JAM, ADDR_IMPLIED },
+    { 0x62, OP_JAM, ADDR_IMPLIED }, { 0x72, OP_JAM, ADDR_IMPLIED },
+    { 0x92, OP_JAM, ADDR_IMPLIED }, { 0xB2, OP_JAM, ADDR_IMPLIED },
+    { 0xD2, OP_JAM, ADDR_IMPLIED }, { 0xF2, OP_JAM, ADDR_IMPLIED }
+};
+
+//! @brief    Returns the address an instruction with operand zpgAddr accesses
+static uint16_t
+effectiveAddress(AddressingMode mode, const Registers &r)
+{
+    switch (mode) {
+        case ADDR_ZERO_PAGE:   return zpgAddr;
+        case ADDR_ZERO_PAGE_X: return (zpgAddr + r.x) & 0xFF;
+        case ADDR_ZERO_PAGE_Y: return (zpgAddr + r.y) & 0xFF;
+        case ADDR_ABSOLUTE:    return absAddr;
+        case ADDR_ABSOLUTE_X:  return absAddr + r.x;
+        case ADDR_ABSOLUTE_Y:  return absAddr + r.y;
+        case ADDR_INDIRECT_X:  return absAddr;
+        case ADDR_INDIRECT_Y:  return absAddr + r.y;
+        default:               return codeAddr + 1;
+    }
+}
+
+//! @brief    Applies the reference semantics of an undocumented operation
+static void
+execute(Operation op, Registers &r, uint8_t &m, uint16_t addr)
+{
+    uint8_t c = r.p & CPU::C_FLAG;
+    uint8_t h = HI_BYTE(addr - r.y) + 1;
+
+    switch (op) {
+
+        case OP_SLO:
+            setFlag(r, CPU::C_FLAG, m & 0x80);
+            m <<= 1; r.a |= m; setNZ(r, r.a);
+            break;
+
+        case OP_RLA:
+            setFlag(r, CPU::C_FLAG, m & 0x80);
+            m = (uint8_t)(m << 1) | c; r.a &= m; setNZ(r, r.a);
+            break;
+
+        case OP_SRE:
+            setFlag(r, CPU::C_FLAG, m & 0x01);
+            m >>= 1; r.a ^= m; setNZ(r, r.a);
+            break;
+
+        case OP_RRA:
+            setFlag(r, CPU::C_FLAG, m & 0x01);
+            m = (m >> 1) | (c << 7); adc(r, m);
+            break;
+
+        case OP_SAX:
+            m = r.a & r.x;
+            break;
+
+        case OP_LAX:
+            r.a = r.x = m; setNZ(r, m);
+            break;
+
+        case OP_DCP:
+            m--; cmp(r, r.a, m);
+            break;
+
+        case OP_ISC:
+            m++; sbc(r, m);
+            break;
+
+        case OP_ANC:
+            r.a &= m; setNZ(r, r.a); setFlag(r, CPU::C_FLAG, r.a & 0x80);
+            break;
+
+        case OP_ALR:
+            r.a &= m; setFlag(r, CPU::C_FLAG, r.a & 0x01);
+            r.a >>= 1; setNZ(r, r.a);
+            break;
+
+        case OP_ARR:
+        {
+            uint8_t t = r.a & m;
+            r.a = (t >> 1) | (c << 7);
+            if (!(r.p & CPU::D_FLAG)) {
+                setNZ(r, r.a);
+                setFlag(r, CPU::C_FLAG, r.a & 0x40);
+                setFlag(r, CPU::V_FLAG, ((r.a >> 6) ^ (r.a >> 5)) & 1);
+            } else {
+                setNZ(r, r.a);
+                setFlag(r, CPU::N_FLAG, c);
+                setFlag(r, CPU::V_FLAG, (t ^ r.a) & 0x40);
+                if ((t & 0x0F) + (t & 0x01) > 5) r.a = (r.a & 0xF0) | ((r.a + 6) & 0x0F);
+                bool carry = (t & 0xF0) + (t & 0x10) > 0x50;
+                if (carry) r.a += 0x60;
+                setFlag(r, CPU::C_FLAG, carry);
+            }
+            break;
+        }
+        case OP_SBX:
+            cmp(r, r.a & r.x, m); r.x = (r.a & r.x) - m;
+            break;
+
+        case OP_USBC:
+            sbc(r, m);
+            break;
+
+        case OP_ANE: // Stable for A = $FF
+            r.a = r.x & m; setNZ(r, r.a);
+            break;
+
+        case OP_LXA: // Stable for A = $FF
+            r.a = r.x = m; setNZ(r, m);
+            break;
+
+        case OP_LAS:
+            r.a = r.x = r.sp = m & r.sp; setNZ(r, r.a);
+            break;
+
+        case OP_TAS:
+            r.sp = r.a & r.x; m = r.a & r.x & h;
+            break;
+
+        case OP_SHA:
+            m = r.a & r.x & h;
+            break;
+
+        case OP_SHX:
+            m = r.x & h;
+            break;
+
+        case OP_SHY:
+            m = r.y & (HI_BYTE(addr - r.x) + 1);
+            break;
+
+        default:
+            break;
+    }
+}
+
+/*! @brief    Executes all undocumented opcodes with random inputs
+ *  @details  The index register of the addressing mode is kept small to
+ *            avoid page crossings, which make SHA, SHX, SHY, and TAS store
+ *            to unpredictable addresses.
+ */
+static TestResult
+checkIllegals(C64 *c64, unsigned trials)
+{
+    TestResult result = { true, 0, 0, "" };
+    SystemClock clock;
+    CPU *cpu = &c64->cpu;
+    unsigned mismatches = 0;
+    bool covered[256] = { false };
+
+    srand(6510);
+    uint64_t start = clock.now();
+    for (auto &entry : illegals) {
+
+        covered[entry.opcode] = true;
+
+        if (entry.op == OP_JAM) {
+
+            Registers in = { 0, 0, 0, 0xFD, CPU::I_FLAG };
+            setup(c64, entry.opcode, 0, in);
+            result.cycles += step(cpu);
+            if (cpu->getErrorState() != CPU_ILLEGAL_INSTRUCTION) {
+                char buf[64];
+                snprintf(buf, sizeof(buf), "  %02X: CPU did not jam\n", entry.opcode);
+                result.details += buf;
+                mismatches++;
+            }
+            cpu->clearErrorState();
+            continue;
+        }
+
+        unsigned errors = 0;
+        for (unsigned i = 0; i < trials; i++) {
+
+            Registers in;
+            in.a = rand() & 0xFF;
+            in.x = rand() & 0xFF;
+            in.y = rand() & 0xFF;
+            in.sp = rand() & 0xFF;
+            in.p = rand() & ~(CPU::B_FLAG | 0x20);
+            uint8_t m = rand() & 0xFF;
+
+            switch (entry.mode) {
+                case ADDR_ZERO_PAGE_X: case ADDR_ABSOLUTE_X: case ADDR_INDIRECT_X:
+                    in.x &= 0x3F; break;
+                case ADDR_ZERO_PAGE_Y: case ADDR_ABSOLUTE_Y: case ADDR_INDIRECT_Y:
+                    in.y &= 0x3F; break;
+                default:
+                    break;
+            }
+            if (entry.op == OP_ANE || entry.op == OP_LXA) in.a = 0xFF;
+
+            uint16_t addr = effectiveAddress(entry.mode, in);
+            uint8_t operand = entry.mode == ADDR_IMMEDIATE ? m : zpgAddr;
+            uint8_t pointer = entry.mode == ADDR_INDIRECT_X ? zpgAddr + in.x : zpgAddr;
+            setup(c64, entry.opcode, operand, in, pointer);
+            if (entry.mode != ADDR_IMMEDIATE) c64->mem.poke(addr, m);
+
+            Registers expected = in;
+            uint8_t expectedM = m;
+            execute(entry.op, expected, expectedM, addr);
+
+            result.cycles += step(cpu);
+            Registers actual = registers(cpu);
+            uint8_t actualM = entry.mode == ADDR_IMMEDIATE ? expectedM : c64->mem.spypeek(addr);
+
+            // Report the first mismatch of each opcode
+            if (memcmp(&expected, &actual, sizeof(Registers)) || expectedM != actualM) {
+                if (errors++ == 0) {
+                    result.details += describe(entry.opcode, m, in, expected, expectedM,
+                                               actual, actualM);
+                }
+            }
+        }
+        mismatches += errors;
+    }
+    result.nanos = clock.now() - start;
+
+    // Every opcode the disassembler marks as undocumented must be covered
+    for (unsigned opcode = 0; opcode < 256; opcode++) {
+
+        c64->mem.poke(codeAddr, (uint8_t)opcode);
+        DisassembledInstruction instr = cpu->disassemble(codeAddr, true);
+        bool illegal = strchr(instr.command, '*') || !strncmp(instr.command, "???", 3);
+
+        if (illegal && !covered[opcode]) {
+            char buf[64];
+            snprintf(buf, sizeof(buf), "  %02X: not covered\n", opcode);
+            result.details += buf;
+            mismatches++;
+        }
+    }
+
+    if (mismatches) {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "  %u mismatches", mismatches);
+        result.details += buf;
+        result.passed = false;
+    }
+    return result;
+}
+
+/*! @brief    Cycles per opcode without page crossings (NMOS 6510)
+ *  @details  Branches are not taken. 0 marks the JAM opcodes.
+ */
+static const uint8_t cyclesPerOpcode[256] = {
+
+    7, 6, 0, 8, 3, 3, 5, 5, 3, 2, 2, 2, 4, 4, 6, 6,
+    2, 5, 0, 8, 4, 4, 6, 6, 2, 4, 2, 7, 4, 4, 7, 7,
+    6, 6, 0, 8, 3, 3, 5, 5, 4, 2, 2, 2, 4, 4, 6, 6,
+    2, 5, 0, 8, 4, 4, 6, 6, 2, 4, 2, 7, 4, 4, 7, 7,
+    6, 6, 0, 8, 3, 3, 5, 5, 3, 2, 2, 2, 3, 4, 6, 6,
+    2, 5, 0, 8, 4, 4, 6, 6, 2, 4, 2, 7, 4, 4, 7, 7,
+    6, 6, 0, 8, 3, 3, 5, 5, 4, 2, 2, 2, 5, 4, 6, 6,
+    2, 5, 0, 8, 4, 4, 6, 6, 2, 4, 2, 7, 4, 4, 7, 7,
+    2, 6, 2, 6, 3, 3, 3, 3, 2, 2, 2, 2, 4, 4, 4, 4,
+    2, 6, 0, 6, 4, 4, 4, 4, 2, 5, 2, 5, 5, 5, 5, 5,
+    2, 6, 2, 6, 3, 3, 3, 3, 2, 2, 2, 2, 4, 4, 4, 4,
+    2, 5, 0, 5, 4, 4, 4, 4, 2, 4, 2, 4, 4, 4, 4, 4,
+    2, 6, 2, 8, 3, 3, 5, 5, 2, 2, 2, 2, 4, 4, 6, 6,
+    2, 5, 0, 8, 4, 4, 6, 6, 2, 4, 2, 7, 4, 4, 7, 7,
+    2, 6, 2, 8, 3, 3, 5, 5, 2, 2, 2, 2, 4, 4, 6, 6,
+    2, 5, 0, 8, 4, 4, 6, 6, 2, 4, 2, 7, 4, 4, 7, 7
+};
+
+//! @brief    Read instructions that take an extra cycle on page crossings
+static const uint8_t pageCrossers[] = {
+
+    0x11, 0x19, 0x1D, 0x31, 0x39, 0x3D, 0x51, 0x59, 0x5D, 0x71, 0x79, 0x7D,
+    0xB1, 0xB3, 0xB9, 0xBB, 0xBC, 0xBD, 0xBE, 0xBF, 0xD1, 0xD9, 0xDD, 0xF1,
+    0xF9, 0xFD, 0x1C, 0x3C, 0x5C, 0x7C, 0xDC, 0xFC
+};
+
+static void
+checkCycles(C64 *c64, uint8_t opcode, uint8_t operand, const Registers &in,
+            unsigned expected, const char *what, TestResult &result, unsigned &mismatches)
+{
+    setup(c64, opcode, operand, in);
+    unsigned cycles = step(&c64->cpu);
+    result.cycles += cycles;
+
+    if (cycles != expected) {
+        if (mismatches++ < 16) {
+            char buf[96];
+            snprintf(buf, sizeof(buf), "  %02X%s: %u cycles instead of %u\n",
+                     opcode, what, cycles, expected);
+            result.details += buf;
+        }
+    }
+}
+
+//! @brief    Measures the cycle count of all opcodes
+static TestResult
+checkTiming(C64 *c64)
+{
+    TestResult result = { true, 0, 0, "" };
+    SystemClock clock;
+    unsigned mismatches = 0;
+
+    // Flags tested by BPL/BMI, BVC/BVS, BCC/BCS, and BNE/BEQ
+    const uint8_t branchFlags[4] = { CPU::N_FLAG, CPU::V_FLAG, CPU::C_FLAG, CPU::Z_FLAG };
+
+    uint64_t start = clock.now();
+    for (unsigned opcode = 0; opcode < 256; opcode++) {
+
+        if (cyclesPerOpcode[opcode] == 0) continue;
+
+        Registers in = { 0, 0, 0, 0xFD, CPU::I_FLAG };
+
+        if ((opcode & 0x1F) == 0x10) {
+
+            uint8_t flag = branchFlags[opcode >> 6];
+            bool ifSet = (opcode & 0x20) != 0;
+
+            in.p = CPU::I_FLAG | (ifSet ? 0 : flag);
+            checkCycles(c64, (uint8_t)opcode, 0x10, in, 2, " (not taken)", result, mismatches);
+            in.p = CPU::I_FLAG | (ifSet ? flag : 0);
+            checkCycles(c64, (uint8_t)opcode, 0x10, in, 3, " (taken)", result, mismatches);
+            checkCycles(c64, (uint8_t)opcode, 0x80, in, 4, " (page crossed)", result, mismatches);
+            continue;
+        }
+
+        checkCycles(c64, (uint8_t)opcode, zpgAddr, in, cyclesPerOpcode[opcode], "",
+                    result, mismatches);
+    }
+
+    // Indexed reads that cross a page boundary take an extra cycle
+    for (unsigned i = 0; i < sizeof(pageCrossers); i++) {
+
+        Registers in = { 0, 0xFF, 0xFF, 0xFD, CPU::I_FLAG };
+        uint8_t opcode = pageCrossers[i];
+        checkCycles(c64, opcode, zpgAddr, in, cyclesPerOpcode[opcode] + 1, " (page crossed)",
+                    result, mismatches);
+    }
+    result.nanos = clock.now() - start;
+
+    if (mismatches) {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "  %u mismatches", mismatches);
+        result.details += buf;
+        result.passed = false;
+    }
+    return result;
+}
+
+static void
+runBuiltinChecks(unsigned trials)
+{
+    C64 *c64 = new C64();
+    c64->reset();
+
+    TestResult result;
+
+    result = checkArithmetic(c64, 0x69, false);
+    report("ADC (binary)", result);
+    result = checkArithmetic(c64, 0xE9, false);
+    report("SBC (binary)", result);
+    result = checkArithmetic(c64, 0x69, true);
+    report("ADC (decimal)", result);
+    result = checkArithmetic(c64, 0xE9, true);
+    report("SBC (decimal)", result);
+    result = checkIllegals(c64, trials);
+    report("Undocumented opcodes", result);
+    result = checkTiming(c64);
+    report("Cycle counts", result);
+
+    delete c64;
+}
+
+
+//
+// Lorenz test programs
+//
+
+/*! @brief    Interrupt entry of the Kernal (placed at $FF48)
+ *  @details  Dispatches via the RAM vectors at $0314 (IRQ) and $0316 (BRK).
+ */
+static const uint8_t irqEntry[] = {
+
+    0x48,                   // PHA
+    0x8A,                   // TXA
+    0x48,                   // PHA
+    0x98,                   // TYA
+    0x48,                   // PHA
+    0xBA,                   // TSX
+    0xBD, 0x04, 0x01,       // LDA $0104,X
+    0x29, 0x10,             // AND #$10
+    0xF0, 0x03,             // BEQ $FF58
+    0x6C, 0x16, 0x03,       // JMP ($0316)
+    0x6C, 0x14, 0x03        // JMP ($0314)
+};
+
+//! @brief    Default IRQ handler (placed at $EA31)
+static const uint8_t irqHandler[] = {
+
+    0x4C, 0x7E, 0xEA        // JMP $EA7E
+};
+
+//! @brief    Interrupt exit of the Kernal (placed at $EA7E)
+static const uint8_t irqExit[] = {
+
+    0xAD, 0x0D, 0xDC,       // LDA $DC0D    Acknowledge CIA interrupt
+    0x68,                   // PLA
+    0xA8,                   // TAY
+    0x68,                   // PLA
+    0xAA,                   // TAX
+    0x68,                   // PLA
+    0x40                    // RTI
+};
+
+//! @brief    NMI entry of the Kernal (placed at $FE43)
+static const uint8_t nmiEntry[] = {
+
+    0x78,                   // SEI
+    0x6C, 0x18, 0x03,       // JMP ($0318)
+    0x48,                   // PHA          Default NMI handler
+    0xAD, 0x0D, 0xDD,       // LDA $DD0D    Acknowledge CIA interrupt
+    0x68,                   // PLA
+    0x40                    // RTI
+};
+
+//! @brief    Addresses that end a test
+static const uint16_t passTraps[] = { 0xE16F, 0x8000, 0xA474 };
+static const uint16_t chrout = 0xFFD2, getin = 0xFFE4, brkHandler = 0xFE66;
+
+//! @brief    Writes a 16 bit value to both Ram and Rom
+static void
+pokeVector(C64 *c64, uint16_t addr, uint16_t value)
+{
+    c64->mem.ram[addr] = c64->mem.rom[addr] = LO_BYTE(value);
+    c64->mem.ram[addr + 1] = c64->mem.rom[addr + 1] = HI_BYTE(value);
+}
+
+/*! @brief    Installs a minimal Kernal replacement
+ *  @details  The interrupt code is copied to Ram, too, because some tests
+ *            bank out the Kernal. All Kernal jump table entries return
+ *            immediately.
+ */
+static void
+installKernal(C64 *c64)
+{
+    uint8_t *rom = c64->mem.rom;
+    uint8_t *ram = c64->mem.ram;
+
+    for (unsigned addr = 0xFF81; addr <= 0xFFF3; addr += 3) rom[addr] = 0x60;
+    rom[brkHandler] = 0x60;
+    for (unsigned i = 0; i < sizeof(passTraps) / sizeof(passTraps[0]); i++) {
+        rom[passTraps[i]] = 0x60;
+    }
+
+    memcpy(rom + 0xFF48, irqEntry, sizeof(irqEntry));
+    memcpy(ram + 0xFF48, irqEntry, sizeof(irqEntry));
+    memcpy(rom + 0xEA31, irqHandler, sizeof(irqHandler));
+    memcpy(rom + 0xEA7E, irqExit, sizeof(irqExit));
+    memcpy(rom + 0xFE43, nmiEntry, sizeof(nmiEntry));
+
+    pokeVector(c64, 0xFFFA, 0xFE43);
+    pokeVector(c64, 0xFFFC, 0xFCE2);
+    pokeVector(c64, 0xFFFE, 0xFF48);
+    pokeVector(c64, 0xA002, 0x8000);
+
+    ram[0x0314] = 0x31; ram[0x0315] = 0xEA;
+    ram[0x0316] = LO_BYTE(brkHandler); ram[0x0317] = HI_BYTE(brkHandler);
+    ram[0x0318] = 0x47; ram[0x0319] = 0xFE;
+    ram[0x0002] = 0x00;
+
+    // Return address of the SYS command ($8000)
+    ram[0x01FE] = 0xFF;
+    ram[0x01FF] = 0x7F;
+}
+
+//! @brief    Determines the start address from the SYS command of a Basic stub
+static uint16_t
+startAddress(C64 *c64, uint16_t load)
+{
+    uint8_t *ram = c64->mem.ram;
+
+    if (load == 0x0801) {
+        for (unsigned addr = 0x0805; addr < 0x0900 && ram[addr]; addr++) {
+            if (ram[addr] != 0x9E) continue;
+
+            unsigned value = 0;
+            for (addr++; ram[addr] == ' '; addr++) { }
+            for (; ram[addr] >= '0' && ram[addr] <= '9'; addr++) {
+                value = value * 10 + (ram[addr] - '0');
+            }
+            if (value && value <= 0xFFFF) return (uint16_t)value;
+            break;
+        }
+    }
+    return load;
+}
+
+//! @brief    Translates a character printed via CHROUT
+static void
+appendPetscii(std::string &output, uint8_t c)
+{
+    if (c == 0x0D) {
+        output += '\n';
+    } else if (c >= 0x20 && c <= 0x5F) {
+        output += (char)c;
+    } else if (c >= 0xC1 && c <= 0xDA) {
+        output += (char)(c - 0x80);
+    }
+}
+
+static TestResult
+runProgram(const char *path, uint64_t limit)
+{
+    TestResult result = { false, 0, 0, "" };
+    SystemClock clock;
+
+    PRGFile *prg = PRGFile::makeWithFile(path);
+    if (!prg) {
+        result.details = "  Cannot read file";
+        return result;
+    }
+
+    C64 *c64 = new C64();
+    c64->reset();
+
+    prg->selectItem(0);
+    uint16_t load = prg->getDestinationAddrOfItem();
+    c64->flash(prg, 0);
+    installKernal(c64);
+    c64->mem.markAllModified();
+    delete prg;
+
+    CPU *cpu = &c64->cpu;
+    for (unsigned i = 0; i < sizeof(passTraps) / sizeof(passTraps[0]); i++) {
+        cpu->setHardBreakpoint(passTraps[i]);
+    }
+    cpu->setHardBreakpoint(chrout);
+    cpu->setHardBreakpoint(getin);
+    cpu->setHardBreakpoint(brkHandler);
+
+    cpu->jumpToAddress(startAddress(c64, load));
+    cpu->regSP = 0xFD;
+    cpu->setI(1);
+
+    std::string output;
+    const char *reason = "timeout";
+    uint64_t start = clock.now();
+    uint64_t first = cpu->cycle;
+
+    while (cpu->cycle - first < limit) {
+
+        uint64_t chunk = std::min(limit - (cpu->cycle - first), (uint64_t)1000000);
+        if (c64->executeCycles(chunk)) continue;
+
+        if (cpu->getErrorState() == CPU_ILLEGAL_INSTRUCTION) {
+            reason = "CPU jammed";
+            break;
+        }
+
+        uint16_t pc = cpu->getPC();
+        if (pc == chrout) {
+            appendPetscii(output, cpu->regA);
+            continue;
+        }
+        if (pc == getin) {
+            reason = "waiting for a key";
+        } else if (pc == brkHandler) {
+            reason = "BRK";
+        } else {
+            result.passed = true;
+        }
+        break;
+    }
+    result.nanos = clock.now() - start;
+    result.cycles = cpu->cycle - first;
+
+    if (!result.passed) {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "  %s at %04X\n", reason, cpu->getPC());
+        result.details = buf;
+    }
+    result.details += output;
+    while (!result.details.empty() && result.details.back() == '\n') {
+        result.details.pop_back();
+    }
+
+    delete c64;
+    return result;
+}
+
+static void
+usage(const char *name)
+{
+    fprintf(stderr, "Usage: %s [options] [test.prg ...]\n\n", name);
+    fprintf(stderr, "  -c, --cycles <n>      Cycle limit per test program in millions (default: 500)\n");
+    fprintf(stderr, "  -t, --trials <n>      Random inputs per undocumented opcode (default: 5000)\n");
+    fprintf(stderr, "  -s, --skip-builtin    Skips the built-in checks\n");
+    fprintf(stderr, "  -v, --verbose         Prints the output of all test programs\n");
+    fprintf(stderr, "  -h, --help            Prints this message\n");
+}
+
+int
+main(int argc, char *argv[])
+{
+    uint64_t limit = 500;
+    unsigned trials = 5000;
+    bool builtin = true;
+    std::vector<const char *> programs;
+
+    // Parse command line
+    for (int i = 1; i < argc; i++) {
+
+        const char *arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if ((!strcmp(arg, "-c") || !strcmp(arg, "--cycles")) && hasValue) {
+            limit = strtoull(argv[++i], NULL, 10);
+        } else if ((!strcmp(arg, "-t") || !strcmp(arg, "--trials")) && hasValue) {
+            trials = (unsigned)strtoul(argv[++i], NULL, 10);
+        } else if (!strcmp(arg, "-s") || !strcmp(arg, "--skip-builtin")) {
+            builtin = false;
+        } else if (!strcmp(arg, "-v") || !strcmp(arg, "--verbose")) {
+            verbose = true;
+        } else if (arg[0] != '-') {
+            programs.push_back(arg);
+        } else {
+            usage(argv[0]);
+            return strcmp(arg, "-h") && strcmp(arg, "--help") ? 1 : 0;
+        }
+    }
+    if (limit == 0) limit = 1;
+    limit *= 1000000;
+
+    printf("%-24s %-6s %14s %10s\n", "Test", "Result", "Cycles", "MHz");
+
+    if (builtin) {
+        runBuiltinChecks(trials);
+    }
+    for (size_t i = 0; i < programs.size(); i++) {
+
+        const char *name = strrchr(programs[i], '/');
+        name = name ? name + 1 : programs[i];
+
+        TestResult result = runProgram(programs[i], limit);
+        report(name, result);
+    }
+
+    unsigned total = (builtin ? 6 : 0) + (unsigned)programs.size();
+    printf("\n%u of %u tests passed\n", total - failed, total);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,262 @@
+/*!
+ * @file        freezecheck.cpp
+ * @author      Dirk W. Hoffmann, www.dirkwhoffmann.de
+ * @copyright   Dirk W. Hoffmann. All rights reserved.
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* Freeze list check
+ *
+ * Checks that the freeze list (see C64Memory::addFreeze()) is applied once
+ * per frame on the selected rasterline (see C64Memory::setFreezeLine()).
+ * The check is run with the loop executor, the fast CPU executor, threaded
+ * drives, and single stepping, for several freeze lines and both PAL and
+ * NTSC machines.
+ *
+ * The C64 executes a small built-in program that polls a frozen cell. Once
+ * the frozen value shows up, the program records the current rasterline
+ * and the values of two cells that are frozen conditionally. Afterwards, it
+ * clears all three cells and continues polling. The screen is switched off
+ * to get rid of bad lines, so that the program sees the value within the
+ * rasterline it has been written in.
+ *
+ * The freeze list contains three entries:
+ *
+ *   $0400 := $A5
+ *   $0401 := $5A   if $0402 = $01
+ *   $0403 := $33   if $0402 = $02
+ *
+ * Halfway through, the check changes $0402 from $01 to $02, which switches
+ * from the first conditional entry to the second one.
+ */
+
+#include "C64.h"
+
+//! @brief    Main program (placed at $E000)
+static const uint8_t program[] = {
+
+    0x78,                   // SEI
+    0xA9, 0x0B,             // LDA #$0B
+    0x8D, 0x11, 0xD0,       // STA $D011    Switch off the screen
+    0xA2, 0x00,             // LDX #$00
+    0xAD, 0x00, 0x04,       // LDA $0400    Main loop
+    0xC9, 0xA5,             // CMP #$A5
+    0xD0, 0xF9,             // BNE $E008
+    0xAD, 0x12, 0xD0,       // LDA $D012    Record the rasterline
+    0x9D, 0x00, 0x08,       // STA $0800,X
+    0xAD, 0x11, 0xD0,       // LDA $D011
+    0x9D, 0x00, 0x09,       // STA $0900,X
+    0xAD, 0x01, 0x04,       // LDA $0401    Record the conditional cells
+    0x9D, 0x00, 0x0A,       // STA $0A00,X
+    0xAD, 0x03, 0x04,       // LDA $0403
+    0x9D, 0x00, 0x0B,       // STA $0B00,X
+    0xE8,                   // INX
+    0x86, 0x02,             // STX $02      Number of records
+    0xA9, 0x00,             // LDA #$00
+    0x8D, 0x00, 0x04,       // STA $0400
+    0x8D, 0x01, 0x04,       // STA $0401
+    0x8D, 0x03, 0x04,       // STA $0403
+    0x4C, 0x08, 0xE0        // JMP $E008
+};
+
+static void
+usage(const char *name)
+{
+    fprintf(stderr, "Usage: %s [options]\n\n", name);
+    fprintf(stderr, "  -f, --frames <n>      Number of frames per phase (default: 50)\n");
+    fprintf(stderr, "  -h, --help            Prints this message\n");
+}
+
+//! @brief    Execution modes
+typedef enum {
+
+    MODE_LOOP,
+    MODE_FAST_CPU,
+    MODE_THREADED,
+    MODE_STEP
+
+} ExecutionMode;
+
+//! @brief    Executes a certain number of frames
+static bool
+execute(C64 *c64, ExecutionMode mode, uint64_t frames)
+{
+    if (mode != MODE_STEP) {
+        return c64->executeFrames(frames);
+    }
+
+    uint64_t end = c64->frame + frames;
+    while (c64->frame < end) c64->step();
+    return true;
+}
+
+//! @brief    Result of a single check
+typedef struct {
+
+    unsigned records;
+    unsigned errors;
+
+} CheckInfo;
+
+/*! @brief    Runs a single check
+ *  @param    line   The selected freeze line
+ */
+static CheckInfo
+check(VICModel model, ExecutionMode mode, uint16_t line, uint64_t frames)
+{
+    CheckInfo info = { 0, 0 };
+    C64 *c64 = new C64();
+
+    memcpy(c64->mem.rom + 0xE000, program, sizeof(program));
+    c64->mem.rom[0xFFFC] = 0x00; c64->mem.rom[0xFFFD] = 0xE0;
+
+    // C64::reset() enters the Kernal at $FCE2 if the reset vector is in Rom
+    c64->mem.rom[0xFCE2] = 0x4C; c64->mem.rom[0xFCE3] = 0x00; c64->mem.rom[0xFCE4] = 0xE0;
+
+    c64->vic.setModel(model);
+    c64->reset();
+    c64->setFastCpu(mode == MODE_FAST_CPU);
+    c64->setThreadedDrives(mode == MODE_THREADED);
+
+    // Run a frame first, as the yCounter starts off beyond the last line
+    execute(c64, mode, 1);
+
+    c64->mem.ram[0x02] = 0;
+    memset(c64->mem.ram + 0x0400, 0, 4);
+    c64->mem.ram[0x0402] = 0x01;
+    c64->mem.addFreeze(0x0400, 0xA5);
+    c64->mem.addFreeze(0x0401, 0x5A, 0x0402, 0x01);
+    c64->mem.addFreeze(0x0403, 0x33, 0x0402, 0x02);
+    c64->mem.setFreezeLine(line);
+
+    // Lines beyond the last one fall back to the beginning of the frame
+    unsigned lines = c64->vic.getRasterlinesPerFrame();
+    unsigned expected = line < lines ? line : 0;
+
+    // NTSC models reset the yCounter in line 238 (see VIC::yCounterOverflow())
+    if (!c64->vic.isPAL()) {
+        expected = expected >= 238 ? expected - 238 : expected + lines - 238;
+    }
+
+    // Run both phases
+    bool success = execute(c64, mode, frames);
+    unsigned switched = c64->mem.ram[0x02];
+    c64->mem.ram[0x0402] = 0x02;
+    success &= execute(c64, mode, frames);
+    info.records = c64->mem.ram[0x02];
+
+    if (!success) {
+        fprintf(stderr, "Emulation stopped\n");
+        info.errors++;
+    }
+
+    // The first phase may miss a record, all other frames must produce one
+    if (info.records + 1 < 2 * frames) {
+        fprintf(stderr, "Line %u: %u records in %llu frames\n",
+                line, info.records, (unsigned long long)(2 * frames));
+        info.errors++;
+    }
+
+    for (unsigned i = 0; i < info.records; i++) {
+
+        unsigned recorded =
+        c64->mem.ram[0x0800 + i] | (c64->mem.ram[0x0900 + i] & 0x80) << 1;
+        uint8_t cell1 = c64->mem.ram[0x0A00 + i];
+        uint8_t cell3 = c64->mem.ram[0x0B00 + i];
+
+        if (recorded != expected) {
+            if (info.errors++ < 4) {
+                fprintf(stderr, "Line %u: Record %u on line %u\n", line, i, recorded);
+            }
+        }
+
+        // The record at the phase change may see either condition
+        if (i == switched) continue;
+
+        bool first = i < switched;
+        if (cell1 != (first ? 0x5A : 0x00) || cell3 != (first ? 0x00 : 0x33)) {
+            if (info.errors++ < 4) {
+                fprintf(stderr, "Line %u: Record %u holds %02X %02X\n",
+                        line, i, cell1, cell3);
+            }
+        }
+    }
+
+    delete c64;
+    return info;
+}
+
+int
+main(int argc, char *argv[])
+{
+    uint64_t frames = 50;
+
+    // Parse command line
+    for (int i = 1; i < argc; i++) {
+
+        const char *arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if ((!strcmp(arg, "-f") || !strcmp(arg, "--frames")) && hasValue) {
+            frames = strtoull(argv[++i], NULL, 10);
+        } else {
+            usage(argv[0]);
+            return strcmp(arg, "-h") && strcmp(arg, "--help") ? 1 : 0;
+        }
+    }
+
+    // The program records up to 256 frames
+    if (frames < 2) frames = 2;
+    if (frames > 127) frames = 127;
+
+    const struct { VICModel model; const char *name; } models[] = {
+
+        { PAL_8565, "PAL" },
+        { NTSC_8562, "NTSC" }
+    };
+
+    const struct { ExecutionMode mode; const char *name; } modes[] = {
+
+        { MODE_LOOP, "Loop" },
+        { MODE_FAST_CPU, "Fast CPU" },
+        { MODE_THREADED, "Threaded drives" },
+        { MODE_STEP, "Single step" }
+    };
+
+    // The first and last lines of both models and a line beyond them
+    const uint16_t lines[] = { 0, 1, 100, 262, 311, 400 };
+
+    bool success = true;
+    printf("%-6s %-16s %6s %8s  %s\n", "Model", "Mode", "Line", "Records", "Result");
+
+    for (unsigned m = 0; m < sizeof(models) / sizeof(models[0]); m++) {
+        for (unsigned e = 0; e < sizeof(modes) / sizeof(modes[0]); e++) {
+            for (unsigned l = 0; l < sizeof(lines) / sizeof(lines[0]); l++) {
+
+                // Single stepping is slow, hence it gets fewer frames
+                uint64_t f = modes[e].mode == MODE_STEP ? 3 : frames;
+                CheckInfo info = check(models[m].model, modes[e].mode, lines[l], f);
+
+                printf("%-6s %-16s %6u %8u  %s\n", models[m].name, modes[e].name,
+                       lines[l], info.records, info.errors ? "MISMATCH" : "ok");
+                success &= info.errors == 0;
+            }
+        }
+    }
+
+    return success ? 0 : 3;
+}
@@ -0,0 +1,475 @@
+/*!
+ * @file        main.cpp
+ * @author      Dirk W. Hoffmann, www.dirkwhoffmann.de
+ * @copyright   Dirk W. Hoffmann. All rights reserved.
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* Headless runner
+ *
+ * Runs the core emulator without a graphical user interface. The emulator
+ * is executed in the calling thread for a fixed number of frames, either
+ * synchronized with the host clock or as fast as possible (warp mode).
+ * When the program terminates, it reports the achieved speed and the
+ * measured frame pacing jitter.
+ *
+ * With option --instances, the runner creates multiple emulator instances
+ * and executes them in warp mode on the thread pool of an EmulatorFarm.
+ * Afterwards, it reports the throughput of each instance.
+ */
+
+#include "C64.h"
+#include "EmulatorFarm.h"
+
+#define MAX_ROMS 8
+
+static void
+usage(const char *name)
+{
+    fprintf(stderr, "Usage: %s [options]\n\n", name);
+    fprintf(stderr, "  -r, --rom <file>      Loads a Basic, Character, Kernal, or VC1541 Rom\n");
+    fprintf(stderr, "  -a, --attach <file>   Flashes the first item of an archive into memory\n");
+    fprintf(stderr, "  -b, --boot <frames>   Frames to run before flashing (default: 150)\n");
+    fprintf(stderr, "  -f, --frames <n>      Number of frames to emulate (default: 500)\n");
+    fprintf(stderr, "  -s, --spin <usec>     Duration of the busy waiting phase (default: 1500)\n");
+    fprintf(stderr, "  -R, --runahead <n>    Number of frames to emulate ahead (default: 0)\n");
+    fprintf(stderr, "  -w, --warp            Runs as fast as possible\n");
+    fprintf(stderr, "  -d, --drive-thread    Emulates the drives on a separate thread\n");
+    fprintf(stderr, "  -c, --fast-cpu        Executes whole CPU instructions at once\n");
+    fprintf(stderr, "  -I, --skip-idle       Fast forwards idle loops of the drive CPUs\n");
+    fprintf(stderr, "  -v, --virtual-drive   Mounts the archive in the virtual drive instead of\n");
+    fprintf(stderr, "                        flashing it and switches off the true drive\n");
+    fprintf(stderr, "  -i, --instances <n>   Runs n instances on a thread pool (implies -w)\n");
+    fprintf(stderr, "  -t, --threads <n>     Size of the thread pool (default: number of cores)\n");
+    fprintf(stderr, "  -S, --slice <frames>  Frames per scheduling slice (default: 10)\n");
+    fprintf(stderr, "  -B, --break <spec>    Halts at a C64 breakpoint given as addr[:condition],\n");
+    fprintf(stderr, "                        e.g., E5CD:A==$0D&&[$C6]>0 (addresses in hex)\n");
+    fprintf(stderr, "  -W, --watch <spec>    Halts when the C64 CPU accesses memory given as\n");
+    fprintf(stderr, "                        first[-last][:r|w|rw] (default access: w)\n");
+    fprintf(stderr, "  -T, --trace <file>    Streams the C64 CPU trace into a file\n");
+    fprintf(stderr, "  -P, --profile <file>  Writes a hotspot and call graph report of the\n");
+    fprintf(stderr, "                        C64 CPU (profiling starts after flashing)\n");
+    fprintf(stderr, "  -F, --flamegraph <file>\n");
+    fprintf(stderr, "                        Writes the profiled call stacks in the folded\n");
+    fprintf(stderr, "                        format of flamegraph.pl\n");
+    fprintf(stderr, "  -L, --labels <file>   Reads symbol names from a VICE label file\n");
+    fprintf(stderr, "  -p, --profile-drive   Profiles the CPU of the first drive instead\n");
+    fprintf(stderr, "  -C, --coverage <file> Writes the code coverage maps of the C64 and the\n");
+    fprintf(stderr, "                        first drive (recording starts after flashing)\n");
+    fprintf(stderr, "  -h, --help            Prints this message\n");
+}
+
+static bool
+runFrames(C64 *c64, uint64_t count, bool warp)
+{
+    bool success = true;
+    
+    if (warp) {
+        
+        // Execute all frames back to back
+        success = c64->executeFrames(count);
+        
+    } else {
+        
+        // Execute frame by frame in sync with the host clock
+        for (uint64_t i = 0; i < count && success; i++) {
+            success = c64->executeOneFrame();
+        }
+    }
+    
+    if (!success) {
+        fprintf(stderr, "Emulation stopped in frame %llu\n", (unsigned long long)c64->frame);
+    }
+    return success;
+}
+
+//! @brief    Sets a breakpoint specified as addr[:condition]
+static bool
+setBreakpoint(C64 *c64, const char *spec)
+{
+    char *end;
+    uint16_t addr = (uint16_t)strtoul(spec, &end, 16);
+    
+    if (end == spec) return false;
+    if (*end == 0) { c64->cpu.setHardBreakpoint(addr); return true; }
+    return *end == ':' && c64->cpu.setConditionalBreakpoint(addr, end + 1);
+}
+
+//! @brief    Arms a watchpoint specified as first[-last][:r|w|rw]
+static bool
+setWatchpoint(C64 *c64, const char *spec)
+{
+    char *end;
+    uint16_t first = (uint16_t)strtoul(spec, &end, 16);
+    uint16_t last = first;
+    WatchType type = WATCH_WRITE;
+    
+    if (end == spec) return false;
+    if (*end == '-') last = (uint16_t)strtoul(end + 1, &end, 16);
+    if (*end == ':') {
+        end++;
+        if (!strcmp(end, "r")) type = WATCH_READ;
+        else if (!strcmp(end, "rw")) type = WATCH_ACCESS;
+        else if (strcmp(end, "w")) return false;
+    } else if (*end) {
+        return false;
+    }
+    return c64->mem.addWatchpoint(first, last, type) >= 0;
+}
+
+static C64 *
+createInstance(const char **roms, unsigned numRoms)
+{
+    C64 *c64 = new C64();
+    
+    for (unsigned i = 0; i < numRoms; i++) {
+        if (!c64->loadRom(roms[i])) {
+            fprintf(stderr, "Cannot load Rom %s\n", roms[i]);
+            delete c64;
+            return NULL;
+        }
+    }
+    return c64;
+}
+
+static int
+runFarm(const char **roms, unsigned numRoms, AnyArchive *archive,
+        uint64_t bootFrames, uint64_t frames,
+        unsigned numInstances, unsigned numThreads, unsigned slice)
+{
+    EmulatorFarm farm(numThreads);
+    farm.setSliceFrames(slice);
+    
+    // Create instances
+    for (unsigned i = 0; i < numInstances; i++) {
+        
+        C64 *c64 = createInstance(roms, numRoms);
+        if (!c64) return 1;
+        farm.addInstance(c64);
+    }
+    
+    if (!farm.getInstance(0)->isRunnable()) {
+        fprintf(stderr, "WARNING: Not all Roms are installed. ");
+        fprintf(stderr, "The emulator will execute garbage.\n");
+    }
+    
+    // Boot and flash
+    if (archive) {
+        farm.run(bootFrames);
+        for (unsigned i = 0; i < numInstances; i++) {
+            farm.getInstance(i)->flash(archive, 0);
+        }
+        farm.resetInfo();
+    }
+    
+    // Run
+    bool success = farm.run(frames);
+    
+    // Report
+    double elapsed = farm.getLastRunTime();
+    uint64_t totalCycles = 0;
+    
+    printf("Instances:     %u\n", farm.numInstances());
+    printf("Threads:       %u\n", farm.numWorkers());
+    printf("Slice:         %u frames\n", farm.getSliceFrames());
+    printf("Elapsed time:  %.3f sec\n\n", elapsed);
+    printf("  Nr    Frames      Cycles    Busy (s)      fps      MHz  Slices  Moves\n");
+    
+    for (unsigned i = 0; i < farm.numInstances(); i++) {
+        
+        FarmInstanceInfo info = farm.getInstanceInfo(i);
+        totalCycles += info.cycles;
+        
+        printf("%4u %9llu %11llu %11.3f %8.1f %8.3f %7llu %6llu%s\n", i,
+               (unsigned long long)info.frames, (unsigned long long)info.cycles,
+               info.busyTime, info.fps, info.mhz,
+               (unsigned long long)info.slices, (unsigned long long)info.migrations,
+               info.stopped ? "  (stopped)" : "");
+    }
+    
+    double emulated = (double)totalCycles / (double)PAL_CLOCK_FREQUENCY;
+    printf("\nSteals:        %llu\n", (unsigned long long)farm.getSteals());
+    printf("Throughput:    %.3f MHz\n", elapsed > 0 ? totalCycles / elapsed / 1000000.0 : 0.0);
+    printf("Speed:         %.2f x (summed up over all instances)\n",
+           elapsed > 0 ? emulated / elapsed : 0.0);
+    
+    for (unsigned i = 0; i < farm.numInstances(); i++) {
+        delete farm.getInstance(i);
+    }
+    return success ? 0 : 2;
+}
+
+//! @brief    Writes the report and the call stacks of a profiler
+static bool
+writeProfile(Profiler *profiler, const char *reportFile, const char *foldedFile)
+{
+    FILE *file;
+    bool success = true;
+    
+    if (reportFile) {
+        if ((file = fopen(reportFile, "w"))) {
+            profiler->writeReport(file, 50);
+            fclose(file);
+        } else {
+            fprintf(stderr, "Cannot create %s\n", reportFile);
+            success = false;
+        }
+    }
+    if (foldedFile) {
+        if ((file = fopen(foldedFile, "w"))) {
+            profiler->writeFoldedStacks(file);
+            fclose(file);
+        } else {
+            fprintf(stderr, "Cannot create %s\n", foldedFile);
+            success = false;
+        }
+    }
+    return success;
+}
+
+//! @brief    Writes the coverage maps of the C64 and the first drive
+static bool
+writeCoverage(C64 *c64, const char *path)
+{
+    FILE *file = fopen(path, "w");
+    if (!file) {
+        fprintf(stderr, "Cannot create %s\n", path);
+        return false;
+    }
+    c64->mem.getCoverage()->write(file);
+    c64->drive1.mem.getCoverage()->write(file);
+    fclose(file);
+    return true;
+}
+
+int
+main(int argc, char *argv[])
+{
+    const char *roms[MAX_ROMS];
+    unsigned numRoms = 0;
+    const char *attachment = NULL;
+    uint64_t bootFrames = 150;
+    uint64_t frames = 500;
+    uint64_t spin = 1500;
+    unsigned runAhead = 0;
+    unsigned numInstances = 0;
+    unsigned numThreads = 0;
+    unsigned slice = 10;
+    bool warp = false;
+    bool driveThread = false;
+    bool fastCpu = false;
+    bool skipIdle = false;
+    bool virtualDrive = false;
+    const char *breakSpec = NULL;
+    const char *watchSpec = NULL;
+    const char *traceFile = NULL;
+    const char *profileFile = NULL;
+    const char *foldedFile = NULL;
+    const char *labelFile = NULL;
+    bool profileDrive = false;
+    const char *coverageFile = NULL;
+    
+    // Parse command line
+    for (int i = 1; i < argc; i++) {
+        
+        const char *arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        
+        if ((!strcmp(arg, "-r") || !strcmp(arg, "--rom")) && hasValue) {
+            if (numRoms == MAX_ROMS) {
+                fprintf(stderr, "Too many Roms\n");
+                return 1;
+            }
+            roms[numRoms++] = argv[++i];
+        } else if ((!strcmp(arg, "-a") || !strcmp(arg, "--attach")) && hasValue) {
+            attachment = argv[++i];
+        } else if ((!strcmp(arg, "-b") || !strcmp(arg, "--boot")) && hasValue) {
+            bootFrames = strtoull(argv[++i], NULL, 10);
+        } else if ((!strcmp(arg, "-f") || !strcmp(arg, "--frames")) && hasValue) {
+            frames = strtoull(argv[++i], NULL, 10);
+        } else if ((!strcmp(arg, "-s") || !strcmp(arg, "--spin")) && hasValue) {
+            spin = strtoull(argv[++i], NULL, 10);
+        } else if ((!strcmp(arg, "-R") || !strcmp(arg, "--runahead")) && hasValue) {
+            runAhead = (unsigned)strtoul(argv[++i], NULL, 10);
+        } else if (!strcmp(arg, "-w") || !strcmp(arg, "--warp")) {
+            warp = true;
+        } else if (!strcmp(arg, "-d") || !strcmp(arg, "--drive-thread")) {
+            driveThread = true;
+        } else if (!strcmp(arg, "-c") || !strcmp(arg, "--fast-cpu")) {
+            fastCpu = true;
+        } else if (!strcmp(arg, "-I") || !strcmp(arg, "--skip-idle")) {
+            skipIdle = true;
+        } else if (!strcmp(arg, "-v") || !strcmp(arg, "--virtual-drive")) {
+            virtualDrive = true;
+        } else if ((!strcmp(arg, "-i") || !strcmp(arg, "--instances")) && hasValue) {
+            numInstances = (unsigned)strtoul(argv[++i], NULL, 10);
+        } else if ((!strcmp(arg, "-t") || !strcmp(arg, "--threads")) && hasValue) {
+            numThreads = (unsigned)strtoul(argv[++i], NULL, 10);
+        } else if ((!strcmp(arg, "-S") || !strcmp(arg, "--slice")) && hasValue) {
+            slice = (unsigned)strtoul(argv[++i], NULL, 10);
+        } else if ((!strcmp(arg, "-B") || !strcmp(arg, "--break")) && hasValue) {
+            breakSpec = argv[++i];
+        } else if ((!strcmp(arg, "-W") || !strcmp(arg, "--watch")) && hasValue) {
+            watchSpec = argv[++i];
+        } else if ((!strcmp(arg, "-T") || !strcmp(arg, "--trace")) && hasValue) {
+            traceFile = argv[++i];
+        } else if ((!strcmp(arg, "-P") || !strcmp(arg, "--profile")) && hasValue) {
+            profileFile = argv[++i];
+        } else if ((!strcmp(arg, "-F") || !strcmp(arg, "--flamegraph")) && hasValue) {
+            foldedFile = argv[++i];
+        } else if ((!strcmp(arg, "-L") || !strcmp(arg, "--labels")) && hasValue) {
+            labelFile = argv[++i];
+        } else if (!strcmp(arg, "-p") || !strcmp(arg, "--profile-drive")) {
+            profileDrive = true;
+        } else if ((!strcmp(arg, "-C") || !strcmp(arg, "--coverage")) && hasValue) {
+            coverageFile = argv[++i];
+        } else {
+            usage(argv[0]);
+            return strcmp(arg, "-h") && strcmp(arg, "--help") ? 1 : 0;
+        }
+    }
+    
+    AnyArchive *archive = NULL;
+    if (attachment && !(archive = AnyArchive::makeWithFile(attachment))) {
+        fprintf(stderr, "Cannot read %s\n", attachment);
+        return 1;
+    }
+    
+    if (numInstances > 0) {
+        int result = runFarm(roms, numRoms, archive, bootFrames, frames,
+                             numInstances, numThreads, slice);
+        delete archive;
+        return result;
+    }
+    
+    C64 *c64 = createInstance(roms, numRoms);
+    if (!c64) return 1;
+    
+    if (breakSpec && !setBreakpoint(c64, breakSpec)) {
+        fprintf(stderr, "Invalid breakpoint %s\n", breakSpec);
+        delete c64;
+        return 1;
+    }
+    if (watchSpec && !setWatchpoint(c64, watchSpec)) {
+        fprintf(stderr, "Invalid watchpoint %s\n", watchSpec);
+        delete c64;
+        return 1;
+    }
+    if (traceFile && !c64->cpu.startStreaming(traceFile)) {
+        fprintf(stderr, "Cannot create %s\n", traceFile);
+        delete c64;
+        return 1;
+    }
+    
+    if (!c64->isRunnable()) {
+        fprintf(stderr, "WARNING: Not all Roms are installed. ");
+        fprintf(stderr, "The emulator will execute garbage.\n");
+    }
+    
+    // Configure pacing
+    SystemClock clock(spin * 1000);
+    c64->setHostClock(&clock);
+    c64->setRunAheadFrames(runAhead);
+    c64->setThreadedDrives(driveThread);
+    c64->setFastCpu(fastCpu);
+    c64->drive1.setSkipIdleLoops(skipIdle);
+    c64->drive2.setSkipIdleLoops(skipIdle);
+    
+    // Boot and flash
+    bool success = true;
+    c64->restartTimer();
+    uint64_t start = clock.now();
+    
+    if (archive && virtualDrive) {
+        c64->drive1.powerOff();
+        c64->virtualDrive.mount(archive);
+    } else if (archive) {
+        success = runFrames(c64, bootFrames, warp);
+        c64->flash(archive, 0);
+    }
+    
+    // Run
+    CPU *profiled = profileDrive ? &c64->drive1.cpu : &c64->cpu;
+    if (profileFile || foldedFile) {
+        profiled->startProfiling();
+        if (labelFile && profiled->getProfiler()->loadLabels(labelFile) < 0) {
+            fprintf(stderr, "Cannot read %s\n", labelFile);
+        }
+    }
+    if (coverageFile) {
+        c64->mem.startCoverage();
+        c64->drive1.mem.startCoverage();
+    }
+    if (success) {
+        success = runFrames(c64, frames, warp);
+    }
+    if (coverageFile) {
+        success &= writeCoverage(c64, coverageFile);
+        c64->mem.stopCoverage();
+        c64->drive1.mem.stopCoverage();
+    }
+    if (profileFile || foldedFile) {
+        success &= writeProfile(profiled->getProfiler(), profileFile, foldedFile);
+        profiled->stopProfiling();
+    }
+    
+    if (traceFile && !c64->cpu.stopStreaming()) {
+        fprintf(stderr, "Cannot write %s\n", traceFile);
+        success = false;
+    }
+    
+    // Report
+    double elapsed = (clock.now() - start) / 1000000000.0;
+    double emulated = (double)c64->cpu.cycle / (double)c64->frequency;
+    PacingInfo info = c64->getPacingInfo();
+    RunAheadInfo runAheadInfo = c64->getRunAheadInfo();
+    
+    printf("Frames:        %llu\n", (unsigned long long)c64->frame);
+    printf("Cycles:        %llu\n", (unsigned long long)c64->cpu.cycle);
+    printf("Elapsed time:  %.3f sec\n", elapsed);
+    printf("Emulated time: %.3f sec\n", emulated);
+    printf("Speed:         %.2f x\n", elapsed > 0 ? emulated / elapsed : 0.0);
+    
+    if (info.frames) {
+        printf("Paced frames:  %llu\n", (unsigned long long)info.frames);
+        printf("Timer resyncs: %llu\n", (unsigned long long)info.restarts);
+        printf("Jitter (usec): avg %.2f rms %.2f min %.2f max %.2f\n",
+               info.avgJitter / 1000.0, info.rmsJitter / 1000.0,
+               info.minJitter / 1000.0, info.maxJitter / 1000.0);
+    }
+    
+    if (c64->cpu.getErrorState() == CPU_HARD_BREAKPOINT_REACHED) {
+        printf("Breakpoint:    %04X\n", c64->cpu.getPC());
+    }
+    if (c64->cpu.getErrorState() == CPU_WATCHPOINT_REACHED) {
+        WatchpointHit hit = c64->mem.getWatchpointHit();
+        printf("Watchpoint:    %s %04X (value %02X), halted at %04X\n",
+               hit.access == WATCH_READ ? "read" : "write",
+               hit.addr, hit.value, c64->cpu.getPC());
+    }
+    
+    if (runAheadInfo.frames) {
+        printf("Run-ahead:     %u frames\n", c64->getRunAheadFrames());
+        printf("Cost (usec):   avg %.2f max %llu\n",
+               runAheadInfo.avgCost, (unsigned long long)runAheadInfo.maxCost);
+    }
+    
+    c64->setHostClock(NULL);
+    delete c64;
+    delete archive;
+    return success ? 0 : 2;
+}
@@ -0,0 +1,330 @@
+/*!
+ * @file        searchcheck.cpp
+ * @author      Dirk W. Hoffmann, www.dirkwhoffmann.de
+ * @copyright   Dirk W. Hoffmann. All rights reserved.
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* Memory search check
+ *
+ * Compares MemorySearch, which compares 64 bytes at a time (with SSE2 or
+ * AVX2 instructions if the core library has been compiled with them), with
+ * a straightforward scalar search that checks one address at a time.
+ *
+ * The memory is filled with few distinct values, so that many addresses
+ * match. Each check starts with some hand-placed values: Words crossing a
+ * 64 byte block boundary and a word occupying the last two bytes of memory.
+ * Afterwards, the program runs random find(), narrow(), and findSequence()
+ * passes with all four relations, modifying the memory between the passes.
+ * After each pass, both searches must agree on every candidate.
+ */
+
+#include "C64.h"
+#include "MemorySearch.h"
+#include <vector>
+
+static void
+usage(const char *name)
+{
+    fprintf(stderr, "Usage: %s [options]\n\n", name);
+    fprintf(stderr, "  -r, --rounds <n>      Number of random rounds per check (default: 2000)\n");
+    fprintf(stderr, "  -h, --help            Prints this message\n");
+}
+
+//! @brief    Pseudo random number generator
+static uint32_t
+random32(uint32_t *seed)
+{
+    *seed = *seed * 1103515245 + 12345;
+    return *seed >> 8;
+}
+
+/*! @class    Scalar reference search
+ *  @details  Implements the same workflow as MemorySearch, one address at a
+ *            time.
+ */
+class ReferenceSearch {
+
+    const uint8_t *memory;
+    uint32_t size;
+    unsigned width;
+    std::vector<bool> candidates;
+    std::vector<uint8_t> previous;
+
+    public:
+
+    ReferenceSearch(const uint8_t *memory, uint32_t size) :
+    memory(memory), size(size), width(1), candidates(size), previous(size) { }
+
+    void restart(unsigned w) {
+        width = w;
+        for (uint32_t addr = 0; addr < size; addr++) {
+            candidates[addr] = addr + width <= size;
+        }
+        previous.assign(memory, memory + size);
+    }
+
+    uint16_t read(const uint8_t *mem, uint32_t addr) {
+        return width == 1 ? mem[addr] : LO_HI(mem[addr], mem[addr + 1]);
+    }
+
+    bool holds(SearchRelation relation, uint16_t value, uint16_t reference) {
+        switch (relation) {
+            case SEARCH_EQUAL:     return value == reference;
+            case SEARCH_CHANGED:   return value != reference;
+            case SEARCH_INCREASED: return value > reference;
+            case SEARCH_DECREASED: return value < reference;
+        }
+        return false;
+    }
+
+    void find(SearchRelation relation, uint16_t value) {
+        if (width == 1) value &= 0xFF;
+        for (uint32_t addr = 0; addr < size; addr++) {
+            if (candidates[addr] && !holds(relation, read(memory, addr), value)) {
+                candidates[addr] = false;
+            }
+        }
+        previous.assign(memory, memory + size);
+    }
+
+    void narrow(SearchRelation relation) {
+        for (uint32_t addr = 0; addr < size; addr++) {
+            if (candidates[addr] &&
+                !holds(relation, read(memory, addr), read(previous.data(), addr))) {
+                candidates[addr] = false;
+            }
+        }
+        previous.assign(memory, memory + size);
+    }
+
+    void findSequence(const uint8_t *pattern, uint32_t length) {
+        for (uint32_t addr = 0; addr < size; addr++) {
+            if (candidates[addr] &&
+                (length == 0 || addr + length > size ||
+                 memcmp(memory + addr, pattern, length))) {
+                candidates[addr] = false;
+            }
+        }
+        previous.assign(memory, memory + size);
+    }
+
+    bool isCandidate(uint32_t addr) { return candidates[addr]; }
+};
+
+//! @brief    Statistics of a check
+typedef struct {
+
+    uint64_t passes;
+    uint64_t hits;
+    uint64_t errors;
+
+} CheckInfo;
+
+/*! @brief    Compares both searches
+ *  @details  Checks each address, the candidate count, and the candidate
+ *            enumeration via next().
+ */
+static void
+compare(MemorySearch &search, ReferenceSearch &reference, uint32_t size,
+        const char *pass, CheckInfo *info)
+{
+    uint32_t count = 0;
+    int32_t expected = -1;
+    bool success = true;
+
+    for (uint32_t addr = size; addr-- > 0;) {
+
+        if (reference.isCandidate(addr)) {
+            count++;
+            expected = (int32_t)addr;
+        }
+        if (search.isCandidate(addr) != reference.isCandidate(addr) ||
+            search.next(addr) != expected) {
+            if (success) fprintf(stderr, "%s: Address %04X differs\n", pass, addr);
+            success = false;
+        }
+    }
+
+    if (search.count() != count) {
+        if (success) fprintf(stderr, "%s: Count %u instead of %u\n",
+                             pass, search.count(), count);
+        success = false;
+    }
+
+    info->passes++;
+    info->hits += count;
+    info->errors += success ? 0 : 1;
+}
+
+//! @brief    Places a value at an address
+static void
+place(uint8_t *memory, uint32_t addr, uint16_t value, unsigned width)
+{
+    memory[addr] = LO_BYTE(value);
+    if (width == 2) memory[addr + 1] = HI_BYTE(value);
+}
+
+static CheckInfo
+check(uint32_t size, unsigned width, unsigned rounds)
+{
+    const SearchRelation relations[] = {
+        SEARCH_EQUAL, SEARCH_CHANGED, SEARCH_INCREASED, SEARCH_DECREASED };
+    const char *names[] = { "equal", "changed", "increased", "decreased" };
+
+    CheckInfo info = { 0, 0, 0 };
+    std::vector<uint8_t> memory(size);
+    uint32_t seed = 4711 + size + width;
+    char pass[64];
+
+    // Few distinct values make many addresses match
+    for (uint32_t addr = 0; addr < size; addr++) {
+        memory[addr] = (uint8_t)(random32(&seed) % 3);
+    }
+
+    MemorySearch search(memory.data(), size);
+    ReferenceSearch reference(memory.data(), size);
+
+    // Words across block boundaries and the last value in memory
+    const uint16_t marker = width == 1 ? 0x42 : 0x4201;
+    for (uint32_t addr = 64 - width + 1; addr < size; addr += 64) {
+        place(memory.data(), addr, marker, width);
+    }
+    place(memory.data(), size - width, marker, width);
+
+    for (unsigned r = 0; r < 4; r++) {
+
+        search.restart(width);
+        reference.restart(width);
+        search.find(relations[r], marker);
+        reference.find(relations[r], marker);
+        snprintf(pass, sizeof(pass), "find(%s, marker)", names[r]);
+        compare(search, reference, size, pass, &info);
+
+        // Move the markers up by one
+        for (uint32_t addr = 64 - width + 1; addr < size; addr += 64) {
+            memory[addr]++;
+        }
+        memory[size - width]++;
+
+        search.narrow(relations[r]);
+        reference.narrow(relations[r]);
+        snprintf(pass, sizeof(pass), "narrow(%s) of markers", names[r]);
+        compare(search, reference, size, pass, &info);
+    }
+
+    // Random passes
+    search.restart(width);
+    reference.restart(width);
+
+    for (unsigned round = 0; round < rounds; round++) {
+
+        uint32_t rnd = random32(&seed);
+
+        // Start over from time to time, as the candidates run out quickly
+        if (rnd % 8 == 0) {
+            search.restart(width);
+            reference.restart(width);
+        }
+
+        // Modify some bytes, preferably at the block boundaries
+        unsigned changes = random32(&seed) % 32;
+        for (unsigned c = 0; c < changes; c++) {
+            uint32_t addr = random32(&seed) % size;
+            if (c % 2) addr = (addr | 63) - (random32(&seed) % 2) * 63;
+            memory[addr] = (uint8_t)(memory[addr] + random32(&seed) % 5 - 2);
+        }
+
+        SearchRelation relation = relations[(rnd >> 3) % 4];
+        unsigned kind = (rnd >> 5) % 4;
+
+        if (kind == 0) {
+
+            uint16_t value = (uint16_t)(random32(&seed) % 3) |
+            (uint16_t)(random32(&seed) % 3) << 8;
+            search.find(relation, value);
+            reference.find(relation, value);
+            snprintf(pass, sizeof(pass), "Round %u: find(%s, %04X)",
+                     round, names[(rnd >> 3) % 4], value);
+
+        } else if (kind == 1) {
+
+            uint32_t length = 1 + random32(&seed) % 4;
+            uint32_t start = random32(&seed) % (size - length + 1);
+            uint8_t pattern[4];
+            memcpy(pattern, memory.data() + start, length);
+            search.findSequence(pattern, length);
+            reference.findSequence(pattern, length);
+            snprintf(pass, sizeof(pass), "Round %u: findSequence(%u bytes)",
+                     round, length);
+
+        } else {
+
+            search.narrow(relation);
+            reference.narrow(relation);
+            snprintf(pass, sizeof(pass), "Round %u: narrow(%s)",
+                     round, names[(rnd >> 3) % 4]);
+        }
+        compare(search, reference, size, pass, &info);
+    }
+
+    return info;
+}
+
+int
+main(int argc, char *argv[])
+{
+    unsigned rounds = 2000;
+
+    // Parse command line
+    for (int i = 1; i < argc; i++) {
+
+        const char *arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if ((!strcmp(arg, "-r") || !strcmp(arg, "--rounds")) && hasValue) {
+            rounds = (unsigned)strtoul(argv[++i], NULL, 10);
+        } else {
+            usage(argv[0]);
+            return strcmp(arg, "-h") && strcmp(arg, "--help") ? 1 : 0;
+        }
+    }
+
+    // A single block, a few blocks, and the drive and C64 memory sizes
+    const uint32_t sizes[] = { 64, 256, 0x800, 0x10000 };
+    bool success = true;
+
+    printf("%-8s %-6s %8s %12s  %s\n", "Size", "Width", "Passes", "Candidates", "Result");
+
+    for (unsigned s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        for (unsigned width = 1; width <= 2; width++) {
+
+            // Scale down the number of rounds for the large memory
+            unsigned r = sizes[s] > 0x800 ? rounds / 10 : rounds;
+            CheckInfo info = check(sizes[s], width, r);
+
+            printf("%-8u %-6s %8llu %12llu  %s\n", sizes[s],
+                   width == 1 ? "byte" : "word",
+                   (unsigned long long)info.passes,
+                   (unsigned long long)info.hits,
+                   info.errors ? "MISMATCH" : "ok");
+            success &= info.errors == 0;
+        }
+    }
+
+    return success ? 0 : 3;
+}
@@ -0,0 +1,354 @@
+/*!
+ * @file        tracecheck.cpp
+ * @author      Dirk W. Hoffmann, www.dirkwhoffmann.de
+ * @copyright   Dirk W. Hoffmann. All rights reserved.
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/* Trace file round trip check
+ *
+ * Encodes instructions with TraceWriter, decodes them with TraceReader, and
+ * compares the result with the original instructions. The program runs three
+ * checks:
+ *
+ * Synthetic:  Hand-picked corner cases of the delta encoding (PC wrap-around,
+ *             cycle gaps of all sizes, cycles running backwards, all
+ *             instruction lengths) followed by pseudo-random records.
+ * Emulator:   A trace streamed by CPU::startStreaming(). The reference is
+ *             taken from the CPU's trace buffer after each rasterline.
+ * Run-ahead:  The same workload with run-ahead enabled. Because run-ahead
+ *             frames are not traced, both trace files must be identical.
+ */
+
+#include "C64.h"
+#include <vector>
+
+//! @brief    Main program (placed at $E000)
+static const uint8_t program[] = {
+
+    0x78,                   // SEI
+    0xA9, 0x01,             // LDA #$01
+    0x8D, 0x1A, 0xD0,       // STA $D01A    Enable raster interrupts
+    0xA9, 0x30,             // LDA #$30
+    0x8D, 0x12, 0xD0,       // STA $D012
+    0xA9, 0x81,             // LDA #$81
+    0x8D, 0x0D, 0xDC,       // STA $DC0D    Enable timer interrupts
+    0x58,                   // CLI
+    0xEE, 0x20, 0xD0,       // INC $D020    Main loop
+    0xAD, 0x12, 0xD0,       // LDA $D012
+    0x9D, 0x00, 0x04,       // STA $0400,X
+    0xE8,                   // INX
+    0xAD, 0x04, 0xDC,       // LDA $DC04
+    0x9D, 0x00, 0x05,       // STA $0500,X
+    0x4C, 0x11, 0xE0        // JMP $E011
+};
+
+//! @brief    Interrupt handler of the built-in program (placed at $E100)
+static const uint8_t handler[] = {
+
+    0x48,                   // PHA
+    0xEE, 0x21, 0xD0,       // INC $D021
+    0xA9, 0xFF,             // LDA #$FF
+    0x8D, 0x19, 0xD0,       // STA $D019    Acknowledge VICII interrupt
+    0xAD, 0x0D, 0xDC,       // LDA $DC0D    Acknowledge CIA interrupt
+    0x68,                   // PLA
+    0x40                    // RTI
+};
+
+static void
+usage(const char *name)
+{
+    fprintf(stderr, "Usage: %s [options]\n\n", name);
+    fprintf(stderr, "  -f, --frames <n>      Number of emulated frames (default: 50)\n");
+    fprintf(stderr, "  -n, --records <n>     Number of random records (default: 1000000)\n");
+    fprintf(stderr, "  -h, --help            Prints this message\n");
+}
+
+//! @brief    Creates an empty temporary file and returns its name
+static bool
+makeTempFile(char *path)
+{
+    strcpy(path, "/tmp/vc64traceXXXXXX");
+    int fd = mkstemp(path);
+    if (fd < 0) return false;
+    close(fd);
+    return true;
+}
+
+//! @brief    Compares two instructions
+static bool
+equal(const RecordedInstruction &i1, const RecordedInstruction &i2)
+{
+    return
+    i1.cycle == i2.cycle && i1.pc == i2.pc &&
+    i1.byte1 == i2.byte1 && i1.byte2 == i2.byte2 && i1.byte3 == i2.byte3 &&
+    i1.a == i2.a && i1.x == i2.x && i1.y == i2.y &&
+    i1.sp == i2.sp && i1.flags == i2.flags;
+}
+
+/*! @brief    Decodes a trace file and compares it with the reference
+ *  @return   The number of mismatching records, including missing ones.
+ */
+static uint64_t
+compare(const char *path, const std::vector<RecordedInstruction> &reference)
+{
+    TraceReader reader;
+    RecordedInstruction instr;
+    uint64_t errors = 0, count = 0;
+
+    if (!reader.open(path)) {
+        fprintf(stderr, "Cannot read trace file %s\n", path);
+        return reference.size() + 1;
+    }
+
+    while (reader.read(&instr)) {
+
+        if (count >= reference.size()) {
+            if (errors++ == 0) fprintf(stderr, "Surplus record %llu\n",
+                                       (unsigned long long)count);
+        } else if (!equal(instr, reference[count])) {
+            if (errors++ == 0) fprintf(stderr, "Record %llu differs\n",
+                                       (unsigned long long)count);
+        }
+        count++;
+    }
+
+    if (count < reference.size()) {
+        fprintf(stderr, "Missing %llu records\n",
+                (unsigned long long)(reference.size() - count));
+        errors += reference.size() - count;
+    }
+    return errors;
+}
+
+//! @brief    Compares the contents of two files
+static bool
+sameFiles(const char *path1, const char *path2)
+{
+    FILE *file1 = fopen(path1, "rb");
+    FILE *file2 = fopen(path2, "rb");
+    bool result = file1 && file2;
+
+    while (result) {
+        int c1 = fgetc(file1), c2 = fgetc(file2);
+        if (c1 != c2) result = false;
+        if (c1 == EOF) break;
+    }
+
+    if (file1) fclose(file1);
+    if (file2) fclose(file2);
+    return result;
+}
+
+//! @brief    Creates an instruction record
+static RecordedInstruction
+makeInstruction(uint64_t cycle, uint16_t pc, unsigned length, uint32_t bits)
+{
+    RecordedInstruction i;
+
+    memset(&i, 0, sizeof(i));
+    i.cycle = cycle;
+    i.pc = pc;
+    i.byte1 = (uint8_t)bits;
+    i.byte2 = length > 1 ? (uint8_t)(bits >> 8) : 0;
+    i.byte3 = length > 2 ? (uint8_t)(bits >> 16) : 0;
+    return i;
+}
+
+static bool
+checkSynthetic(uint64_t records)
+{
+    std::vector<RecordedInstruction> reference;
+    std::vector<uint8_t> lengths;
+    RecordedInstruction i;
+    char path[32];
+
+    // Corner cases of the delta encoding
+    const struct { uint64_t cycle; uint16_t pc; uint8_t length; } cases[] = {
+
+        { 0, 0x0000, 1 },                   // All values as initialized
+        { 127, 0x0001, 2 },                 // Largest one byte cycle delta
+        { 255, 0x0003, 3 },                 // Smallest two byte cycle delta
+        { 255, 0x0006, 1 },                 // No cycles elapsed
+        { 255 + (1ULL << 32), 0xFFFD, 3 },  // PC jump, large cycle gap
+        { 256 + (1ULL << 32), 0x0000, 1 },  // PC wraps around sequentially
+        { UINT64_MAX, 0xFFFF, 3 },          // Largest cycle delta
+        { 7, 0x0002, 2 },                   // Cycles running backwards
+        { 0, 0x0004, 1 }
+    };
+
+    for (unsigned c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+
+        i = makeInstruction(cases[c].cycle, cases[c].pc, cases[c].length, 0xA5C3E1);
+        i.a = (uint8_t)c; i.x = (uint8_t)(c * 3); i.flags = 0x20 | (uint8_t)c;
+        reference.push_back(i);
+        lengths.push_back(cases[c].length);
+    }
+
+    // Pseudo-random instructions, mostly executed in sequence
+    uint32_t seed = 12345;
+    for (uint64_t r = 0; r < records; r++) {
+
+        seed = seed * 1103515245 + 12345;
+        uint32_t rnd = seed >> 8;
+        unsigned length = 1 + rnd % 3;
+        uint16_t pc = reference.back().pc + lengths.back();
+        uint64_t cycle = reference.back().cycle + 2 + (rnd >> 2) % 6;
+
+        if ((rnd >> 5) % 4 == 0) pc = (uint16_t)(rnd >> 6);
+        if ((rnd >> 7) % 64 == 0) cycle += (rnd >> 3);
+
+        i = makeInstruction(cycle, pc, length, seed ^ (seed >> 16));
+        i.a = reference.back().a;
+        i.x = reference.back().x;
+        i.y = reference.back().y;
+        i.sp = reference.back().sp;
+        i.flags = reference.back().flags;
+
+        seed = seed * 1103515245 + 12345;
+        if (seed & 0x10000) i.a = (uint8_t)(seed >> 24);
+        if (seed & 0x20000) i.x = (uint8_t)(seed >> 20);
+        if (seed & 0x40000) i.y = (uint8_t)(seed >> 12);
+        if (seed & 0x80000) i.sp = (uint8_t)(seed >> 22);
+        if (seed & 0x100000) i.flags = (uint8_t)(seed >> 8);
+
+        reference.push_back(i);
+        lengths.push_back(length);
+    }
+
+    if (!makeTempFile(path)) {
+        fprintf(stderr, "Cannot create a temporary file\n");
+        return false;
+    }
+
+    TraceWriter writer;
+    bool success = writer.open(path);
+
+    for (size_t r = 0; success && r < reference.size(); r++) {
+        writer.record(reference[r], lengths[r]);
+    }
+    success &= writer.close();
+
+    uint64_t errors = success ? compare(path, reference) : reference.size();
+    printf("%-12s %10llu records %10llu errors\n", "Synthetic",
+           (unsigned long long)reference.size(), (unsigned long long)errors);
+
+    remove(path);
+    return success && errors == 0;
+}
+
+//! @brief    Creates an emulator instance running the built-in program
+static C64 *
+makeInstance(unsigned runAheadFrames)
+{
+    C64 *c64 = new C64();
+
+    memcpy(c64->mem.rom + 0xE000, program, sizeof(program));
+    memcpy(c64->mem.rom + 0xE100, handler, sizeof(handler));
+    c64->mem.rom[0xFFFC] = 0x00; c64->mem.rom[0xFFFD] = 0xE0;
+    c64->mem.rom[0xFFFE] = 0x00; c64->mem.rom[0xFFFF] = 0xE1;
+
+    // C64::reset() enters the Kernal at $FCE2 if the reset vector is in Rom
+    c64->mem.rom[0xFCE2] = 0x4C; c64->mem.rom[0xFCE3] = 0x00; c64->mem.rom[0xFCE4] = 0xE0;
+
+    c64->reset();
+    c64->setAlwaysWarp(true);
+    c64->setRunAheadFrames(runAheadFrames);
+    return c64;
+}
+
+static bool
+checkEmulator(uint64_t frames)
+{
+    std::vector<RecordedInstruction> reference;
+    char path1[32], path2[32];
+    bool success = true;
+
+    if (!makeTempFile(path1) || !makeTempFile(path2)) {
+        fprintf(stderr, "Cannot create a temporary file\n");
+        return false;
+    }
+
+    // Collect the reference from the trace buffer after each rasterline
+    C64 *c64 = makeInstance(0);
+    success &= c64->cpu.startStreaming(path1);
+
+    uint64_t last = c64->frame + frames;
+    while (success && c64->frame < last) {
+
+        success &= c64->executeOneLine();
+        while (c64->cpu.recordedInstructions()) {
+            reference.push_back(c64->cpu.readRecordedInstruction());
+        }
+    }
+    success &= c64->cpu.stopStreaming();
+    c64->setAlwaysWarp(false);
+    delete c64;
+
+    uint64_t errors = success ? compare(path1, reference) : reference.size();
+    printf("%-12s %10llu records %10llu errors\n", "Emulator",
+           (unsigned long long)reference.size(), (unsigned long long)errors);
+    success &= errors == 0;
+
+    // Run the same workload with run-ahead enabled. Note that run-ahead is
+    // performed by executeOneFrame() only.
+    c64 = makeInstance(2);
+    success &= c64->cpu.startStreaming(path2);
+    for (uint64_t f = 0; success && f < frames; f++) {
+        success &= c64->executeOneFrame();
+    }
+    success &= c64->cpu.stopStreaming();
+    c64->setAlwaysWarp(false);
+    delete c64;
+
+    bool same = sameFiles(path1, path2);
+    printf("%-12s %10s %18s\n", "Run-ahead", "", same ? "identical" : "MISMATCH");
+    success &= same;
+
+    remove(path1);
+    remove(path2);
+    return success;
+}
+
+int
+main(int argc, char *argv[])
+{
+    uint64_t frames = 50;
+    uint64_t records = 1000000;
+
+    // Parse command line
+    for (int i = 1; i < argc; i++) {
+
+        const char *arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if ((!strcmp(arg, "-f") || !strcmp(arg, "--frames")) && hasValue) {
+            frames = strtoull(argv[++i], NULL, 10);
+        } else if ((!strcmp(arg, "-n") || !strcmp(arg, "--records")) && hasValue) {
+            records = strtoull(argv[++i], NULL, 10);
+        } else {
+            usage(argv[0]);
+            return strcmp(arg, "-h") && strcmp(arg, "--help") ? 1 : 0;
+        }
+    }
+
+    bool success = true;
+    success &= checkSynthetic(records);
+    success &= checkEmulator(frames);
+
+    return success ? 0 : 3;
+}
@@ -0,0 +1,88 @@
+/*!
+ * @file        tracedump.cpp
+ * @author      Dirk W. Hoffmann, www.dirkwhoffmann.de
+ * @copyright   Dirk W. Hoffmann. All rights reserved.
+ */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+
+/* Trace file decoder
+ *
+ * Converts a trace file written by CPU::startStreaming() into text. Each
+ * instruction is printed in the format of the debugger's trace view, i.e.,
+ * as returned by CPU::disassemble().
+ */
+
+#include "C64.h"
+
+static void
+usage(const char *name)
+{
+    fprintf(stderr, "Usage: %s [options] <trace file>\n\n", name);
+    fprintf(stderr, "  -d, --decimal         Prints numbers in decimal format\n");
+    fprintf(stderr, "  -h, --help            Prints this message\n");
+}
+
+int
+main(int argc, char *argv[])
+{
+    const char *path = NULL;
+    bool hex = true;
+    
+    // Parse command line
+    for (int i = 1; i < argc; i++) {
+        
+        const char *arg = argv[i];
+        
+        if (!strcmp(arg, "-d") || !strcmp(arg, "--decimal")) {
+            hex = false;
+        } else if (arg[0] != '-' && !path) {
+            path = arg;
+        } else {
+            usage(argv[0]);
+            return strcmp(arg, "-h") && strcmp(arg, "--help") ? 1 : 0;
+        }
+    }
+    if (!path) {
+        usage(argv[0]);
+        return 1;
+    }
+    
+    TraceReader reader;
+    if (!reader.open(path)) {
+        fprintf(stderr, "Cannot read trace file %s\n", path);
+        return 1;
+    }
+    
+    // The disassembler only needs the opcode tables of a CPU
+    C64 *c64 = new C64();
+    RecordedInstruction instr;
+    uint64_t count = 0;
+    
+    while (reader.read(&instr)) {
+        
+        DisassembledInstruction d = c64->cpu.disassemble(instr, hex);
+        printf("%12llu  %s: %s %s %s  %-12s A=%s X=%s Y=%s SP=%s %s\n",
+               (unsigned long long)instr.cycle, d.pc,
+               d.byte1, d.byte2, d.byte3, d.command, d.a, d.x, d.y, d.sp, d.flags);
+        count++;
+    }
+    
+    fprintf(stderr, "%llu instructions\n", (unsigned long long)count);
+    delete c64;
+    return 0;
+}
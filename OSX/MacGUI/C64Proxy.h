@@ -239,6 +239,7 @@ struct AnyC64FileWrapper;
 - (RecordedInstruction) readRecordedInstruction:(NSInteger)previous;
 
 - (DisassembledInstruction) disassemble:(uint16_t)addr hex:(BOOL)h;
+- (NSInteger) disassemble:(uint16_t)addr count:(NSInteger)count hex:(BOOL)h into:(DisassembledInstruction *)lines;
 - (DisassembledInstruction) disassembleRecordedInstr:(RecordedInstruction)instr hex:(BOOL)h;
 
 @end
@@ -149,6 +149,10 @@ struct AnyC64FileWrapper { AnyC64File *file; };
 {
     return wrapper->cpu->disassemble(addr, h);
 }
+- (NSInteger) disassemble:(uint16_t)addr count:(NSInteger)count hex:(BOOL)h into:(DisassembledInstruction *)lines
+{
+    return wrapper->cpu->disassemble(addr, (unsigned)count, h, lines);
+}
 - (DisassembledInstruction) disassembleRecordedInstr:(RecordedInstruction)instr
                                                  hex:(BOOL)h;
 {
@@ -47,14 +47,14 @@ class CpuTableView : NSTableView {
 
         if c == nil { return }
         
-        var addr = Int(startAddr)
+        var lines = [DisassembledInstruction](repeating: DisassembledInstruction(), count: 256)
+        let count = c!.c64.cpu.disassemble(startAddr, count: 256, hex: hex, into: &lines)
         rowForAddress = [:]
         
         for i in 0...255 {
-            if (addr <= 0xFFFF) {
-                instructionAtRow[i] = c!.c64.cpu.disassemble(UInt16(addr), hex: hex)
-                rowForAddress[UInt16(addr)] = i
-                addr += Int(instructionAtRow[i]!.size)
+            if (i < count) {
+                instructionAtRow[i] = lines[i]
+                rowForAddress[lines[i].addr] = i
             } else {
                 instructionAtRow[i] = nil;
             }